@@ -1919,6 +1919,7 @@ void slurm_print_slurmd_status (FILE* out,
 				slurmd_status_t * slurmd_status_ptr)
 {
 	char time_str[32];
+	int i;
 
 	if (slurmd_status_ptr == NULL )
 		return ;
@@ -1964,6 +1965,25 @@ void slurm_print_slurmd_status (FILE* out,
 		slurmd_status_ptr->slurmd_logfile);
 	fprintf(out, "Version                  = %s\n",
 		slurmd_status_ptr->version);
+	fprintf(out, "Worker threads           = %u (%u busy)\n",
+		slurmd_status_ptr->worker_cnt, slurmd_status_ptr->worker_busy);
+	fprintf(out, "Queued connections       = %u\n",
+		slurmd_status_ptr->conn_queue_len);
+	fprintf(out, "Queued bulk requests     = %u\n",
+		slurmd_status_ptr->bulk_queue_len);
+
+	if (slurmd_status_ptr->rpc_type_size)
+		fprintf(out, "RPC statistics by message type\n");
+	for (i = 0; i < slurmd_status_ptr->rpc_type_size; i++) {
+		fprintf(out, "\t%-40s(%5u) count:%-6u "
+			"ave_time:%-6"PRIu64" total_time:%"PRIu64"\n",
+			rpc_num2string(slurmd_status_ptr->rpc_type_id[i]),
+			slurmd_status_ptr->rpc_type_id[i],
+			slurmd_status_ptr->rpc_type_cnt[i],
+			slurmd_status_ptr->rpc_type_time[i] /
+			slurmd_status_ptr->rpc_type_cnt[i],
+			slurmd_status_ptr->rpc_type_time[i]);
+	}
 	return;
 }
 
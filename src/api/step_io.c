@@ -35,6 +35,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -60,6 +61,9 @@
 
 #define STDIO_MAX_FREE_BUF 1024
 
+/* Queued messages gathered into a single writev() to an output file */
+#define FILE_WRITE_IOV 16
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -132,6 +136,7 @@ struct server_io_info {
  **********************************************************************/
 static bool _file_writable(eio_obj_t *obj);
 static int _file_write(eio_obj_t *obj, List objs);
+static int _file_writev(eio_obj_t *obj);
 
 struct io_operations file_write_ops = {
 	.writable = &_file_writable,
@@ -588,6 +593,10 @@ static int _file_write(eio_obj_t *obj, List objs)
 		info->out_remaining = info->out_msg->length;
 	}
 
+	if (!info->cio->label && (info->taskid == (uint32_t) -1) &&
+	    !info->eof)
+		return _file_writev(obj);
+
 	/*
 	 * Write message to file.
 	 */
@@ -626,6 +635,63 @@ static int _file_write(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Unlabelled output accepted from all tasks needs no per message work, so
+ * the message in progress and those queued behind it are written with one
+ * system call.
+ */
+static int _file_writev(eio_obj_t *obj)
+{
+	struct file_write_info *info = (struct file_write_info *) obj->arg;
+	struct iovec iov[FILE_WRITE_IOV];
+	struct io_buf *msg;
+	ListIterator msgs;
+	int i, iovcnt = 0;
+	ssize_t n;
+
+	iov[iovcnt].iov_base = info->out_msg->data +
+		(info->out_msg->length - info->out_remaining);
+	iov[iovcnt++].iov_len = info->out_remaining;
+	msgs = list_iterator_create(info->msg_queue);
+	while ((iovcnt < FILE_WRITE_IOV) && (msg = list_next(msgs))) {
+		iov[iovcnt].iov_base = msg->data;
+		iov[iovcnt++].iov_len = msg->length;
+	}
+	list_iterator_destroy(msgs);
+
+again:
+	if ((n = writev(obj->fd, iov, iovcnt)) < 0) {
+		if (errno == EINTR)
+			goto again;
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+			return SLURM_SUCCESS;
+		list_enqueue(info->cio->free_outgoing, info->out_msg);
+		info->out_msg = NULL;
+		info->eof = true;
+		return SLURM_ERROR;
+	}
+	debug3("  wrote %zd bytes from %d messages", n, iovcnt);
+
+	/* Free every message written in full */
+	for (i = 0; i < iovcnt; i++) {
+		if (n < info->out_remaining) {
+			info->out_remaining -= n;
+			break;
+		}
+		n -= info->out_remaining;
+		info->out_msg->ref_count--;
+		if (info->out_msg->ref_count == 0)
+			list_enqueue(info->cio->free_outgoing, info->out_msg);
+		info->out_msg = NULL;
+		if ((i + 1) < iovcnt) {
+			info->out_msg = list_dequeue(info->msg_queue);
+			info->out_remaining = info->out_msg->length;
+		}
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /**********************************************************************
  * File read functions
  **********************************************************************/
@@ -0,0 +1,531 @@
+/*****************************************************************************\
+ *  alist.c - unlocked, array backed list for single owner use
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+/*
+ * Items live in items[head .. head + count - 1]. Popping the first item just
+ * advances head, so a list used as a queue does not move its items. When the
+ * tail of the array is reached the items are moved back to the start if at
+ * least half of the array is free, otherwise the array is doubled.
+ *
+ * Iterators keep the index of the next item to return (pos) and of the last
+ * item returned (last, -1 if none or it was removed), both relative to head.
+ * They are adjusted on insertion and removal so that an AList iterator
+ * behaves exactly like a List iterator.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/alist.h"
+#include "src/common/macros.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+
+/*
+** Define slurm-specific aliases for use by plugins, see slurm_xlator.h
+** for details.
+*/
+strong_alias(alist_create,	slurm_alist_create);
+strong_alias(alist_destroy,	slurm_alist_destroy);
+strong_alias(alist_is_empty,	slurm_alist_is_empty);
+strong_alias(alist_count,	slurm_alist_count);
+strong_alias(alist_append,	slurm_alist_append);
+strong_alias(alist_transfer,	slurm_alist_transfer);
+strong_alias(alist_prepend,	slurm_alist_prepend);
+strong_alias(alist_find_first,	slurm_alist_find_first);
+strong_alias(alist_delete_all,	slurm_alist_delete_all);
+strong_alias(alist_for_each,	slurm_alist_for_each);
+strong_alias(alist_flush,	slurm_alist_flush);
+strong_alias(alist_sort,	slurm_alist_sort);
+strong_alias(alist_push,	slurm_alist_push);
+strong_alias(alist_pop,		slurm_alist_pop);
+strong_alias(alist_peek,	slurm_alist_peek);
+strong_alias(alist_enqueue,	slurm_alist_enqueue);
+strong_alias(alist_dequeue,	slurm_alist_dequeue);
+strong_alias(alist_iterator_create,	slurm_alist_iterator_create);
+strong_alias(alist_iterator_reset,	slurm_alist_iterator_reset);
+strong_alias(alist_iterator_destroy,	slurm_alist_iterator_destroy);
+strong_alias(alist_next,	slurm_alist_next);
+strong_alias(alist_peek_next,	slurm_alist_peek_next);
+strong_alias(alist_insert,	slurm_alist_insert);
+strong_alias(alist_find,	slurm_alist_find);
+strong_alias(alist_remove,	slurm_alist_remove);
+strong_alias(alist_delete_item,	slurm_alist_delete_item);
+
+#define ALIST_MAGIC	0x616c7374
+#define ALIST_MIN_SIZE	16
+
+struct xalistIterator {
+	struct xalist *list;		/* the list being iterated */
+	int pos;			/* index of next item to return */
+	int last;			/* index of last item returned or -1 */
+	struct xalistIterator *iNext;	/* iterator chain for alist_destroy() */
+#ifndef NDEBUG
+	unsigned int magic;		/* sentinel for asserting validity */
+#endif
+};
+
+struct xalist {
+	void **items;			/* array of items */
+	int head;			/* index of first item in items */
+	int count;			/* number of items in list */
+	int size;			/* number of slots in items */
+	struct xalistIterator *iNext;	/* iterator chain for alist_destroy() */
+	ListDelF fDel;			/* function to delete item data */
+#ifndef NDEBUG
+	unsigned int magic;		/* sentinel for asserting validity */
+#endif
+};
+
+/* Make room for one more item at the end of the array */
+static void _make_room(AList l)
+{
+	if ((l->head + l->count) < l->size)
+		return;
+
+	if (l->head && (l->head >= l->count)) {
+		memmove(l->items, l->items + l->head,
+			l->count * sizeof(void *));
+		l->head = 0;
+		return;
+	}
+
+	l->size = l->size ? (l->size * 2) : ALIST_MIN_SIZE;
+	xrealloc_nz(l->items, l->size * sizeof(void *));
+}
+
+/* Insert item x so it becomes the item at index n */
+static void *_insert_at(AList l, int n, void *x)
+{
+	struct xalistIterator *i;
+
+	xassert(x);
+	xassert((n >= 0) && (n <= l->count));
+
+	if (!n && l->head) {
+		l->head--;
+	} else {
+		_make_room(l);
+		memmove(l->items + l->head + n + 1, l->items + l->head + n,
+			(l->count - n) * sizeof(void *));
+	}
+	l->items[l->head + n] = x;
+	l->count++;
+
+	for (i = l->iNext; i; i = i->iNext) {
+		xassert(i->magic == ALIST_MAGIC);
+		if (i->last >= n)
+			i->last++;
+		if ((i->pos > n) || ((i->pos == n) && (i->last < 0)))
+			i->pos++;
+	}
+
+	return x;
+}
+
+/* Remove the item at index n and return it */
+static void *_remove_at(AList l, int n)
+{
+	struct xalistIterator *i;
+	void *v;
+
+	xassert((n >= 0) && (n < l->count));
+
+	v = l->items[l->head + n];
+	if (!n) {
+		l->head++;
+	} else {
+		memmove(l->items + l->head + n, l->items + l->head + n + 1,
+			(l->count - n - 1) * sizeof(void *));
+	}
+	if (!--l->count)
+		l->head = 0;
+
+	for (i = l->iNext; i; i = i->iNext) {
+		xassert(i->magic == ALIST_MAGIC);
+		if (i->last == n)
+			i->last = -1;
+		else if (i->last > n)
+			i->last--;
+		if (i->pos == n)
+			i->last = -1;
+		else if (i->pos > n)
+			i->pos--;
+	}
+
+	return v;
+}
+
+static void _reset_iterators(AList l)
+{
+	struct xalistIterator *i;
+
+	for (i = l->iNext; i; i = i->iNext) {
+		xassert(i->magic == ALIST_MAGIC);
+		i->pos = 0;
+		i->last = -1;
+	}
+}
+
+extern AList alist_create(ListDelF f)
+{
+	AList l = xmalloc(sizeof(*l));
+
+	l->fDel = f;
+	xassert((l->magic = ALIST_MAGIC));
+
+	return l;
+}
+
+extern void alist_destroy(AList l)
+{
+	struct xalistIterator *i, *iTmp;
+	int n;
+
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	for (i = l->iNext; i; i = iTmp) {
+		xassert(i->magic == ALIST_MAGIC);
+		iTmp = i->iNext;
+		xassert((i->magic = ~ALIST_MAGIC));
+		xfree(i);
+	}
+	if (l->fDel) {
+		for (n = 0; n < l->count; n++)
+			l->fDel(l->items[l->head + n]);
+	}
+	xfree(l->items);
+	xassert((l->magic = ~ALIST_MAGIC));
+	xfree(l);
+}
+
+extern int alist_is_empty(AList l)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	return (l->count == 0);
+}
+
+extern int alist_count(AList l)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	return l->count;
+}
+
+extern void *alist_append(AList l, void *x)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	return _insert_at(l, l->count, x);
+}
+
+extern int alist_transfer(AList l, AList sub)
+{
+	void *v;
+	int n = 0;
+
+	xassert(l);
+	xassert(sub);
+	xassert(l->fDel == sub->fDel);
+
+	while ((v = alist_pop(sub))) {
+		alist_append(l, v);
+		n++;
+	}
+
+	return n;
+}
+
+extern void *alist_prepend(AList l, void *x)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	return _insert_at(l, 0, x);
+}
+
+extern void *alist_find_first(AList l, ListFindF f, void *key)
+{
+	int n;
+
+	xassert(l);
+	xassert(f);
+	xassert(l->magic == ALIST_MAGIC);
+
+	for (n = 0; n < l->count; n++) {
+		if (f(l->items[l->head + n], key))
+			return l->items[l->head + n];
+	}
+
+	return NULL;
+}
+
+extern int alist_delete_all(AList l, ListFindF f, void *key)
+{
+	void *v;
+	int i, j, n = 0;
+
+	xassert(l);
+	xassert(f);
+	xassert(l->magic == ALIST_MAGIC);
+
+	if (l->iNext) {
+		/* Keep the iterators in step with each removal */
+		for (i = 0; i < l->count; ) {
+			if (!f(l->items[l->head + i], key)) {
+				i++;
+				continue;
+			}
+			v = _remove_at(l, i);
+			if (l->fDel)
+				l->fDel(v);
+			n++;
+		}
+		return n;
+	}
+
+	/* Compact the array in a single pass */
+	for (i = 0, j = 0; i < l->count; i++) {
+		v = l->items[l->head + i];
+		if (f(v, key)) {
+			if (l->fDel)
+				l->fDel(v);
+			n++;
+		} else
+			l->items[l->head + j++] = v;
+	}
+	if (!(l->count = j))
+		l->head = 0;
+
+	return n;
+}
+
+extern int alist_for_each(AList l, ListForF f, void *arg)
+{
+	int n;
+
+	xassert(l);
+	xassert(f);
+	xassert(l->magic == ALIST_MAGIC);
+
+	for (n = 0; n < l->count; n++) {
+		if (f(l->items[l->head + n], arg) < 0)
+			return -(n + 1);
+	}
+
+	return n;
+}
+
+extern int alist_flush(AList l)
+{
+	int n;
+
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	if (l->fDel) {
+		for (n = 0; n < l->count; n++)
+			l->fDel(l->items[l->head + n]);
+	}
+	n = l->count;
+	l->count = 0;
+	l->head = 0;
+	_reset_iterators(l);
+
+	return n;
+}
+
+extern void alist_sort(AList l, ListCmpF f)
+{
+	xassert(l);
+	xassert(f);
+	xassert(l->magic == ALIST_MAGIC);
+
+	if (l->count > 1)
+		qsort(l->items + l->head, l->count, sizeof(void *),
+		      (__compar_fn_t) f);
+	_reset_iterators(l);
+}
+
+extern void *alist_push(AList l, void *x)
+{
+	return alist_prepend(l, x);
+}
+
+extern void *alist_pop(AList l)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	if (!l->count)
+		return NULL;
+	return _remove_at(l, 0);
+}
+
+extern void *alist_peek(AList l)
+{
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	return l->count ? l->items[l->head] : NULL;
+}
+
+extern void *alist_enqueue(AList l, void *x)
+{
+	return alist_append(l, x);
+}
+
+extern void *alist_dequeue(AList l)
+{
+	return alist_pop(l);
+}
+
+extern AListIterator alist_iterator_create(AList l)
+{
+	AListIterator i;
+
+	xassert(l);
+	xassert(l->magic == ALIST_MAGIC);
+
+	i = xmalloc(sizeof(*i));
+	i->list = l;
+	i->last = -1;
+	i->iNext = l->iNext;
+	l->iNext = i;
+	xassert((i->magic = ALIST_MAGIC));
+
+	return i;
+}
+
+extern void alist_iterator_reset(AListIterator i)
+{
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	i->pos = 0;
+	i->last = -1;
+}
+
+extern void alist_iterator_destroy(AListIterator i)
+{
+	AListIterator *pi;
+
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	for (pi = &i->list->iNext; *pi; pi = &(*pi)->iNext) {
+		if (*pi == i) {
+			*pi = i->iNext;
+			break;
+		}
+	}
+	xassert((i->magic = ~ALIST_MAGIC));
+	xfree(i);
+}
+
+extern void *alist_next(AListIterator i)
+{
+	AList l;
+
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	l = i->list;
+	if (i->pos >= l->count) {
+		i->last = -1;
+		return NULL;
+	}
+	i->last = i->pos++;
+
+	return l->items[l->head + i->last];
+}
+
+extern void *alist_peek_next(AListIterator i)
+{
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	if (i->pos >= i->list->count)
+		return NULL;
+	return i->list->items[i->list->head + i->pos];
+}
+
+extern void *alist_insert(AListIterator i, void *x)
+{
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	return _insert_at(i->list, (i->last >= 0) ? i->last : i->pos, x);
+}
+
+extern void *alist_find(AListIterator i, ListFindF f, void *key)
+{
+	void *v;
+
+	xassert(i);
+	xassert(f);
+	xassert(i->magic == ALIST_MAGIC);
+
+	while ((v = alist_next(i)) && !f(v, key)) {;}
+
+	return v;
+}
+
+extern void *alist_remove(AListIterator i)
+{
+	xassert(i);
+	xassert(i->magic == ALIST_MAGIC);
+
+	if (i->last < 0)
+		return NULL;
+	return _remove_at(i->list, i->last);
+}
+
+extern int alist_delete_item(AListIterator i)
+{
+	void *v;
+
+	if (!(v = alist_remove(i)))
+		return 0;
+	if (i->list->fDel)
+		i->list->fDel(v);
+	return 1;
+}
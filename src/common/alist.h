@@ -0,0 +1,100 @@
+/*****************************************************************************\
+ *  alist.h - unlocked, array backed list for single owner use
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#ifndef _ALIST_H
+#define _ALIST_H
+
+#include "src/common/list.h"
+
+/*
+ * An AList has the interface of a List (see list.h), with the list_ prefix
+ * replaced by alist_, but does no locking and keeps its items in one
+ * contiguous array. It is meant for lists only ever used by one thread at a
+ * time, like the scheduler's job queue, where the per item node allocation
+ * and mutex of a List are pure overhead. The caller is responsible for
+ * serializing all access to an AList and its iterators.
+ *
+ * Appending, popping or dequeuing the head and sorting take no memory
+ * allocations beyond the growth of the array. Inserting or removing anywhere
+ * else moves the items behind it.
+ */
+
+#define FREE_NULL_ALIST(_X)			\
+	do {					\
+		if (_X) alist_destroy (_X);	\
+		_X	= NULL; 		\
+	} while (0)
+
+typedef struct xalist * AList;
+typedef struct xalistIterator * AListIterator;
+
+/* General-Purpose Functions, see list_create() etc. */
+extern AList alist_create(ListDelF f);
+extern void alist_destroy(AList l);
+extern int alist_is_empty(AList l);
+extern int alist_count(AList l);
+
+/* List Access Functions */
+extern void *alist_append(AList l, void *x);
+extern int alist_transfer(AList l, AList sub);
+extern void *alist_prepend(AList l, void *x);
+extern void *alist_find_first(AList l, ListFindF f, void *key);
+extern int alist_delete_all(AList l, ListFindF f, void *key);
+extern int alist_for_each(AList l, ListForF f, void *arg);
+extern int alist_flush(AList l);
+extern void alist_sort(AList l, ListCmpF f);
+
+/* Stack Access Functions */
+extern void *alist_push(AList l, void *x);
+extern void *alist_pop(AList l);
+extern void *alist_peek(AList l);
+
+/* Queue Access Functions */
+extern void *alist_enqueue(AList l, void *x);
+extern void *alist_dequeue(AList l);
+
+/* List Iterator Functions */
+extern AListIterator alist_iterator_create(AList l);
+extern void alist_iterator_reset(AListIterator i);
+extern void alist_iterator_destroy(AListIterator i);
+extern void *alist_next(AListIterator i);
+extern void *alist_peek_next(AListIterator i);
+extern void *alist_insert(AListIterator i, void *x);
+extern void *alist_find(AListIterator i, ListFindF f, void *key);
+extern void *alist_remove(AListIterator i);
+extern int alist_delete_item(AListIterator i);
+
+#endif /* !_ALIST_H */
@@ -0,0 +1,92 @@
+/*****************************************************************************\
+ *  gzip.h - gzip compression of a memory buffer
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SLURM_GZIP_H
+#define _SLURM_GZIP_H
+
+#include "config.h"
+
+#if HAVE_LIBZ
+
+#include <string.h>
+#include <zlib.h>
+
+#include "src/common/xmalloc.h"
+
+/*
+ * Kept in the header so that libslurm does not need zlib, only the plugins
+ * using it are built with $(ZLIB_CPPFLAGS) and linked with $(ZLIB_LIBS).
+ */
+
+/*
+ * Compress a buffer into a gzip stream, so the result can also be read with
+ * the usual tools or sent with "Content-Encoding: gzip".
+ * IN data - data to compress
+ * IN size - size of data
+ * OUT out_size - size of the compressed data
+ * RET xmalloc'd compressed data or NULL on error
+ */
+static inline char *gzip_deflate(const char *data, size_t size,
+				 size_t *out_size)
+{
+	z_stream strm;
+	char *out;
+	uLong out_len;
+
+	memset(&strm, 0, sizeof(strm));
+	/* 16 + MAX_WBITS adds a gzip header instead of a zlib one */
+	if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+			 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return NULL;
+	out_len = deflateBound(&strm, size);
+	out = xmalloc_nz(out_len);
+	strm.next_in = (Bytef *) data;
+	strm.avail_in = size;
+	strm.next_out = (Bytef *) out;
+	strm.avail_out = out_len;
+	if (deflate(&strm, Z_FINISH) != Z_STREAM_END) {
+		(void) deflateEnd(&strm);
+		xfree(out);
+		return NULL;
+	}
+	*out_size = strm.total_out;
+	(void) deflateEnd(&strm);
+
+	return out;
+}
+
+#endif	/* HAVE_LIBZ */
+
+#endif	/* _SLURM_GZIP_H */
@@ -85,6 +85,7 @@ strong_alias(hostlist_deranged_string_xmalloc,
 					slurm_hostlist_deranged_string_xmalloc);
 strong_alias(hostlist_destroy,		slurm_hostlist_destroy);
 strong_alias(hostlist_find,		slurm_hostlist_find);
+strong_alias(hostlist_for_each_range,	slurm_hostlist_for_each_range);
 strong_alias(hostlist_iterator_create,	slurm_hostlist_iterator_create);
 strong_alias(hostlist_iterator_destroy,	slurm_hostlist_iterator_destroy);
 strong_alias(hostlist_iterator_reset,	slurm_hostlist_iterator_reset);
@@ -116,11 +117,15 @@ strong_alias(hostset_copy,		slurm_hostset_copy);
 strong_alias(hostset_count,		slurm_hostset_count);
 strong_alias(hostset_create,		slurm_hostset_create);
 strong_alias(hostset_delete,		slurm_hostset_delete);
+strong_alias(hostset_delete_host,	slurm_hostset_delete_host);
 strong_alias(hostset_destroy,		slurm_hostset_destroy);
 strong_alias(hostset_find,		slurm_hostset_find);
 strong_alias(hostset_insert,		slurm_hostset_insert);
+strong_alias(hostset_intersect,	slurm_hostset_intersect);
 strong_alias(hostset_shift,		slurm_hostset_shift);
 strong_alias(hostset_shift_range,	slurm_hostset_shift_range);
+strong_alias(hostset_subtract,		slurm_hostset_subtract);
+strong_alias(hostset_union,		slurm_hostset_union);
 strong_alias(hostset_within,		slurm_hostset_within);
 strong_alias(hostset_nth,		slurm_hostset_nth);
 
@@ -247,6 +252,14 @@ struct hostlist {
 /* a hostset is a wrapper around a hostlist */
 struct hostset {
 	hostlist_t hl;
+
+	/* hosts ahead of each range of hl, for hostset_find(). Valid while
+	 * hl still has offset_nranges ranges and offset_nhosts hosts, hosts
+	 * are only added by hostset functions, which clear offset_nranges.
+	 */
+	int *offset;
+	int offset_nranges;
+	int offset_nhosts;
 };
 
 struct hostlist_iterator {
@@ -374,7 +387,7 @@ static void        hostlist_coalesce(hostlist_t hl);
 static void        hostlist_collapse(hostlist_t hl);
 static hostlist_t _hostlist_create(const char *, char *, char *, int);
 static void        hostlist_shift_iterators(hostlist_t, int, int, int);
-static int        _attempt_range_join(hostlist_t, int);
+static void       _hostlist_join_sorted(hostlist_t);
 static int        _is_bracket_needed(hostlist_t, int);
 
 static hostlist_iterator_t hostlist_iterator_new(void);
@@ -2409,6 +2422,29 @@ int hostlist_count(hostlist_t hl)
 	return retval;
 }
 
+int hostlist_for_each_range(hostlist_t hl,
+			    int (*f)(const char *prefix, unsigned long lo,
+				     unsigned long hi, int width, void *arg),
+			    void *arg)
+{
+	hostrange_t hr;
+	int i, rc = 0;
+
+	if (!hl)
+		return 0;
+
+	LOCK_HOSTLIST(hl);
+	for (i = 0; (i < hl->nranges) && !rc; i++) {
+		hr = hl->hr[i];
+		if (hr->singlehost)
+			rc = f(hr->prefix, 0, 0, -1, arg);
+		else
+			rc = f(hr->prefix, hr->lo, hr->hi, hr->width, arg);
+	}
+	UNLOCK_HOSTLIST(hl);
+	return rc;
+}
+
 int hostlist_find_dims(hostlist_t hl, const char *hostname, int dims)
 {
 	int i, count, ret = -1;
@@ -2556,28 +2592,30 @@ static void hostlist_coalesce(hostlist_t hl)
 
 }
 
-/* attempt to join ranges at loc and loc-1 in a hostlist  */
-/* delete duplicates, return the number of hosts deleted  */
+/* join overlapping and adjacent ranges of a sorted hostlist in one pass */
+/* rather than deleting one range at a time, drop duplicates from nhosts */
 /* assumes that the hostlist hl has been locked by caller */
-/* returns -1 if no range join occured */
-static int _attempt_range_join(hostlist_t hl, int loc)
+static void _hostlist_join_sorted(hostlist_t hl)
 {
-	int ndup;
-	assert(hl != NULL);
-	assert(hl->magic == HOSTLIST_MAGIC);
-	assert(loc > 0);
-	assert(loc < hl->nranges);
-	ndup = hostrange_join(hl->hr[loc - 1], hl->hr[loc]);
-	if (ndup >= 0) {
-		hostlist_delete_range(hl, loc);
-		hl->nhosts -= ndup;
+	int i, j = 0, ndup;
+
+	if (hl->nranges <= 1)
+		return;
+
+	for (i = 1; i < hl->nranges; i++) {
+		if ((ndup = hostrange_join(hl->hr[j], hl->hr[i])) >= 0) {
+			hostrange_destroy(hl->hr[i]);
+			hl->nhosts -= ndup;
+		} else
+			hl->hr[++j] = hl->hr[i];
 	}
-	return ndup;
+	for (i = j + 1; i < hl->nranges; i++)
+		hl->hr[i] = NULL;
+	hl->nranges = j + 1;
 }
 
 void hostlist_uniq(hostlist_t hl)
 {
-	int i = 1;
 	hostlist_iterator_t hli;
 	LOCK_HOSTLIST(hl);
 	if (hl->nranges <= 1) {
@@ -2586,10 +2624,7 @@ void hostlist_uniq(hostlist_t hl)
 	}
 	qsort(hl->hr, hl->nranges, sizeof(hostrange_t), &_cmp);
 
-	while (i < hl->nranges) {
-		if (_attempt_range_join(hl, i) < 0) /* No range join occurred */
-			i++;
-	}
+	_hostlist_join_sorted(hl);
 
 	/* reset all iterators */
 	for (hli = hl->ilist; hli; hli = hli->next)
@@ -3542,6 +3577,8 @@ hostset_t hostset_create(const char *hostlist)
 		free(new);
 		return NULL;
 	}
+	new->offset = NULL;
+	new->offset_nranges = -1;
 
 	hostlist_uniq(new->hl);
 	return new;
@@ -3555,6 +3592,8 @@ hostset_t hostset_copy(const hostset_t set)
 
 	if (!(new->hl = hostlist_copy(set->hl)))
 		goto error2;
+	new->offset = NULL;
+	new->offset_nranges = -1;
 
 	return new;
 error2:
@@ -3569,160 +3608,595 @@ void hostset_destroy(hostset_t set)
 	if (set == NULL)
 		return;
 	hostlist_destroy(set->hl);
+	free(set->offset);
 	free(set);
 }
 
-/* inserts a single range object into a hostset
- * Assumes that the set->hl lock is already held
- * Updates hl->nhosts
+/* compare hostname hn with hostrange hr in the order used by hostrange_cmp()
+ * returns:
+ *    < 0   if hn sorts before hr
+ *      0   if hn has the prefix of hr and a suffix within [lo, hi]
+ *    > 0   if hn sorts after hr
  */
-static int hostset_insert_range(hostset_t set, hostrange_t hr)
+static int _hostrange_hn_cmp(hostrange_t hr, hostname_t hn)
 {
-	int i = 0;
-	int inserted = 0;
-	int nhosts = 0;
-	int ndups = 0;
-	hostlist_t hl;
+	int single = !hostname_suffix_is_valid(hn);
+	int retval;
 
-	hl = set->hl;
+	retval = strnatcmp(single ? hn->hostname : hn->prefix, hr->prefix);
+	if (retval == 0)
+		retval = hr->singlehost - single;
+	if ((retval == 0) && !single) {
+		if (hn->num < hr->lo)
+			retval = -1;
+		else if (hn->num > hr->hi)
+			retval = 1;
+	}
 
-	if (hl->size == hl->nranges && !hostlist_expand(hl))
+	return retval;
+}
+
+/* return 1 if a binary search miss of hn next to hostrange hr can not be
+ * trusted, i.e. hr has the prefix of hn with an incompatible zero padding
+ * (so ranges are ordered by width rather than suffix), or hr's prefix holds
+ * leading digits of hn's suffix (e.g. nid0000[2-7] and nid00002), which
+ * hostrange_hn_within() matches on single dimension systems.
+ */
+static int _hostrange_hn_unsorted(hostrange_t hr, hostname_t hn)
+{
+	int wr, wn;
+	size_t len;
+
+	if (hr->singlehost || !hostname_suffix_is_valid(hn))
 		return 0;
 
-	nhosts = hostrange_count(hr);
+	if (strcmp(hr->prefix, hn->prefix) == 0) {
+		wr = hr->width;
+		wn = hostname_suffix_width(hn);
+		return !_width_equiv(hr->lo, &wr, hn->num, &wn);
+	}
+
+	len = strlen(hn->prefix);
+	return (strlen(hr->prefix) > len) &&
+		(strncmp(hr->prefix, hn->prefix, len) == 0);
+}
+
+/* binary search the sorted ranges of a hostset for hostname hn.
+ * Falls back to a linear search for names that may be stored out of
+ * suffix order (see _hostrange_hn_unsorted()).
+ * Assumes that the set->hl lock is already held
+ * Returns the index of the range holding hn or -1 if not found
+ */
+static int _hostset_find_range(hostlist_t hl, hostname_t hn, int dims)
+{
+	int lo = 0, hi = hl->nranges - 1, mid, cmp, i;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		cmp = _hostrange_hn_cmp(hl->hr[mid], hn);
+		if (cmp < 0)
+			hi = mid - 1;
+		else if (cmp > 0)
+			lo = mid + 1;
+		else if (hostrange_hn_within(hl->hr[mid], hn, dims))
+			return mid;
+		else
+			goto linear;
+	}
+
+	/* lo is where hn would be inserted, check its neighbors */
+	if (((lo > 0) && _hostrange_hn_unsorted(hl->hr[lo - 1], hn)) ||
+	    ((lo < hl->nranges) && _hostrange_hn_unsorted(hl->hr[lo], hn)))
+		goto linear;
+
+	return -1;
 
+linear:
 	for (i = 0; i < hl->nranges; i++) {
-		if (hostrange_cmp(hr, hl->hr[i]) <= 0) {
+		if (hostrange_hn_within(hl->hr[i], hn, dims))
+			return i;
+	}
+	return -1;
+}
 
-			if ((ndups = hostrange_join(hr, hl->hr[i])) >= 0)
-				hostlist_delete_range(hl, i);
-			else if (ndups < 0)
-				ndups = 0;
+/* return 1 if hostranges h1 and h2 hold hosts with the same prefix and
+ * compatible zero padding, so their suffixes may be compared directly.
+ */
+static int _hostrange_same_group(hostrange_t h1, hostrange_t h2)
+{
+	if (hostrange_prefix_cmp(h1, h2) != 0)
+		return 0;
+	if (h1->singlehost)
+		return (strcmp(h1->prefix, h2->prefix) == 0);
+	return hostrange_width_combine(h1, h2);
+}
+
+/* return 1 if hostrange comparison may disagree with hostname lookup for
+ * hostlist hl, i.e. on a single dimension system some range prefix ends
+ * in a digit (see _hostrange_hn_unsorted()).
+ * Assumes that the hostlist hl has been locked by caller
+ */
+static int _hostlist_digit_prefix(hostlist_t hl, int dims)
+{
+	int i;
+	size_t len;
 
-			hostlist_insert_range(hl, hr, i);
+	if (dims != 1)
+		return 0;
 
-			/* now attempt to join hr[i] and hr[i-1] */
-			if (i > 0) {
-				int m;
-				if ((m = _attempt_range_join(hl, i)) > 0)
-					ndups += m;
+	for (i = 0; i < hl->nranges; i++) {
+		if (hl->hr[i]->singlehost)
+			continue;
+		len = strlen(hl->hr[i]->prefix);
+		if (len && isdigit((int) hl->hr[i]->prefix[len - 1]))
+			return 1;
+	}
+	return 0;
+}
+
+/* replace the ranges of hostlist hl with those of src, src gets the old
+ * ranges of hl and should be destroyed by the caller.
+ * Assumes that the hostlist hl has been locked by caller
+ */
+static void _hostlist_swap_ranges(hostlist_t hl, hostlist_t src)
+{
+	hostrange_t *hr = hl->hr;
+	int size = hl->size, nranges = hl->nranges, nhosts = hl->nhosts;
+	hostlist_iterator_t hli;
+
+	hl->hr = src->hr;
+	hl->size = src->size;
+	hl->nranges = src->nranges;
+	hl->nhosts = src->nhosts;
+
+	src->hr = hr;
+	src->size = size;
+	src->nranges = nranges;
+	src->nhosts = nhosts;
+
+	for (hli = hl->ilist; hli; hli = hli->next)
+		hostlist_iterator_reset(hli);
+}
+
+/* merge the sorted ranges of h2 into the sorted hostlist h1 in a single
+ * pass, the ranges of h1 are moved rather than copied.
+ * Assumes that both hostlists have been locked by caller
+ * Returns the number of hosts added to h1
+ */
+/* insert a copy of hostrange hr into the sorted hostlist hl at the position
+ * found by binary search and join it with its neighbors, so adding a single
+ * range does not rebuild the whole array.
+ * Assumes that the hostlist hl has been locked by caller
+ * Returns the number of hosts added to hl
+ */
+static int _hostset_insert_range(hostlist_t hl, hostrange_t hr)
+{
+	int lo = 0, hi = hl->nranges, mid, i, ndup, joined = 0;
+	int nhosts = hl->nhosts;
+	hostlist_iterator_t hli;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (hostrange_cmp(hl->hr[mid], hr) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!hostlist_insert_range(hl, hr, lo))
+		seterrno_ret(ENOMEM, 0);
+	hl->nhosts += hostrange_count(hr);
+
+	/* join it into the range before it, or the ranges after it into it */
+	i = (lo > 0) ? lo - 1 : lo;
+	while (i + 1 < hl->nranges) {
+		if ((ndup = hostrange_join(hl->hr[i], hl->hr[i + 1])) < 0) {
+			if ((i == lo - 1) && !joined) {
+				i = lo;
+				continue;
 			}
-			hl->nhosts += nhosts - ndups;
-			inserted = 1;
 			break;
 		}
+		hostrange_destroy(hl->hr[i + 1]);
+		memmove(&hl->hr[i + 1], &hl->hr[i + 2],
+			(hl->nranges - i - 2) * sizeof(hostrange_t));
+		hl->hr[--hl->nranges] = NULL;
+		hl->nhosts -= ndup;
+		joined = 1;
+	}
+
+	for (hli = hl->ilist; hli; hli = hli->next)
+		hostlist_iterator_reset(hli);
+
+	return hl->nhosts - nhosts;
+}
+
+static int _hostset_union(hostlist_t h1, hostlist_t h2)
+{
+	int i = 0, j = 0, k = 0, nhosts = h1->nhosts;
+	int size = h1->nranges + h2->nranges + HOSTLIST_CHUNK;
+	hostrange_t *hr;
+	hostlist_iterator_t hli;
+
+	if (h2->nranges == 0)
+		return 0;
+	if (h2->nranges == 1)
+		return _hostset_insert_range(h1, h2->hr[0]);
+
+	if (!(hr = calloc(size, sizeof(hostrange_t))))
+		seterrno_ret(ENOMEM, 0);
+
+	while ((i < h1->nranges) || (j < h2->nranges)) {
+		if ((j == h2->nranges) ||
+		    ((i < h1->nranges) &&
+		     (hostrange_cmp(h1->hr[i], h2->hr[j]) <= 0)))
+			hr[k++] = h1->hr[i++];
+		else
+			hr[k++] = hostrange_copy(h2->hr[j++]);
 	}
 
-	if (inserted == 0) {
-		hl->hr[hl->nranges++] = hostrange_copy(hr);
-		hl->nhosts += nhosts;
-		if (hl->nranges > 1) {
-			if ((ndups = _attempt_range_join(hl, hl->nranges - 1)) <= 0)
-				ndups = 0;
+	free(h1->hr);
+	h1->hr = hr;
+	h1->size = size;
+	h1->nranges = k;
+	h1->nhosts += h2->nhosts;
+	_hostlist_join_sorted(h1);
+
+	for (hli = h1->ilist; hli; hli = hli->next)
+		hostlist_iterator_reset(hli);
+
+	return h1->nhosts - nhosts;
+}
+
+/* walk the sorted ranges of h1 and h2 in step, pushing the hosts found in
+ * both onto hostlist out if it is not NULL.
+ * Assumes that h1 and h2 have been locked by caller
+ * Returns the number of hosts in both h1 and h2
+ */
+static int _hostset_intersect(hostlist_t h1, hostlist_t h2, hostlist_t out)
+{
+	int i = 0, j = 0, n = 0;
+	unsigned long lo, hi;
+	hostrange_t a, b;
+
+	while ((i < h1->nranges) && (j < h2->nranges)) {
+		a = h1->hr[i];
+		b = h2->hr[j];
+		if (!_hostrange_same_group(a, b)) {
+			if (hostrange_cmp(a, b) < 0)
+				i++;
+			else
+				j++;
+			continue;
+		}
+		if (a->singlehost) {
+			if (out)
+				hostlist_push_range(out, a);
+			n++;
+			i++;
+			j++;
+			continue;
 		}
+		lo = MAX(a->lo, b->lo);
+		hi = MIN(a->hi, b->hi);
+		if (lo <= hi) {
+			if (out)
+				hostlist_push_hr(out, a->prefix, lo, hi,
+						 a->width);
+			n += hi - lo + 1;
+		}
+		if (a->hi < b->hi)
+			i++;
+		else
+			j++;
 	}
 
-	/*
-	 *  Return the number of unique hosts inserted
-	 */
-	return nhosts - ndups;
+	return n;
+}
+
+/* walk the sorted ranges of h1 and h2 in step, pushing the hosts of h1 that
+ * are not in h2 onto hostlist out.
+ * Assumes that h1 and h2 have been locked by caller
+ * Returns the number of hosts of h1 found in h2
+ */
+static int _hostset_subtract(hostlist_t h1, hostlist_t h2, hostlist_t out)
+{
+	int i, j = 0, n = 0, gone;
+	unsigned long lo, kept;
+	hostrange_t a, b;
+
+	for (i = 0; i < h1->nranges; i++) {
+		a = h1->hr[i];
+		lo = a->lo;
+		kept = 0;
+		gone = 0;
+		for ( ; j < h2->nranges; j++) {
+			b = h2->hr[j];
+			if (!_hostrange_same_group(a, b)) {
+				if (hostrange_cmp(a, b) < 0)
+					break;
+				continue;
+			}
+			if (a->singlehost) {
+				gone = 1;
+				break;
+			}
+			if (b->hi < lo)
+				continue;
+			if (b->lo > a->hi)
+				break;
+			if (b->lo > lo) {
+				hostlist_push_hr(out, a->prefix, lo, b->lo - 1,
+						 a->width);
+				kept += b->lo - lo;
+			}
+			if (b->hi >= a->hi) {
+				gone = 1;
+				break;
+			}
+			lo = b->hi + 1;
+		}
+		if (!gone) {
+			if (a->singlehost) {
+				hostlist_push_range(out, a);
+				kept = 1;
+			} else {
+				hostlist_push_hr(out, a->prefix, lo, a->hi,
+						 a->width);
+				kept += a->hi - lo + 1;
+			}
+		}
+		n += hostrange_count(a) - kept;
+	}
+
+	return n;
+}
+
+/* lock the hostlists of two different hostsets, always in the same order
+ * so two threads working on the same pair can not deadlock.
+ */
+static void _hostset_lock_pair(hostset_t set, hostset_t other)
+{
+	if (set->hl < other->hl) {
+		LOCK_HOSTLIST(set->hl);
+		LOCK_HOSTLIST(other->hl);
+	} else {
+		LOCK_HOSTLIST(other->hl);
+		LOCK_HOSTLIST(set->hl);
+	}
+}
+
+/* return the number of hosts of hostset "set" ahead of range n, keeping
+ * the offsets of all ranges so repeated lookups do not sum them again.
+ * Assumes that the set->hl lock is already held
+ */
+static int _hostset_offset(hostset_t set, int n)
+{
+	hostlist_t hl = set->hl;
+	int i, *offset;
+
+	if ((set->offset_nranges != hl->nranges) ||
+	    (set->offset_nhosts != hl->nhosts)) {
+		if (!(offset = realloc(set->offset,
+				       (hl->nranges + 1) * sizeof(int))))
+			seterrno_ret(ENOMEM, -1);
+		set->offset = offset;
+		offset[0] = 0;
+		for (i = 0; i < hl->nranges; i++)
+			offset[i + 1] = offset[i] + hostrange_count(hl->hr[i]);
+		set->offset_nranges = hl->nranges;
+		set->offset_nhosts = hl->nhosts;
+	}
+
+	return set->offset[n];
 }
 
 int hostset_insert(hostset_t set, const char *hosts)
 {
-	int i, n = 0;
+	int n;
 	hostlist_t hl = hostlist_create(hosts);
 	if (!hl)
 		return 0;
 
 	hostlist_uniq(hl);
 	LOCK_HOSTLIST(set->hl);
-	for (i = 0; i < hl->nranges; i++)
-		n += hostset_insert_range(set, hl->hr[i]);
+	n = _hostset_union(set->hl, hl);
+	set->offset_nranges = -1;
 	UNLOCK_HOSTLIST(set->hl);
 	hostlist_destroy(hl);
 	return n;
 }
 
+int hostset_union(hostset_t set, hostset_t other)
+{
+	int n;
+
+	if (set == other)
+		return 0;
 
-/* linear search through N ranges for hostname "host"
+	_hostset_lock_pair(set, other);
+	n = _hostset_union(set->hl, other->hl);
+	set->offset_nranges = -1;
+	UNLOCK_HOSTLIST(other->hl);
+	UNLOCK_HOSTLIST(set->hl);
+	return n;
+}
+
+int hostset_intersect(hostset_t set, hostset_t other)
+{
+	int n;
+	hostlist_t out;
+
+	if (set == other)
+		return hostset_count(set);
+
+	out = hostlist_new();
+	_hostset_lock_pair(set, other);
+	n = _hostset_intersect(set->hl, other->hl, out);
+	UNLOCK_HOSTLIST(other->hl);
+	_hostlist_swap_ranges(set->hl, out);
+	set->offset_nranges = -1;
+	UNLOCK_HOSTLIST(set->hl);
+	hostlist_destroy(out);
+	return n;
+}
+
+int hostset_subtract(hostset_t set, hostset_t other)
+{
+	int n;
+	hostlist_t out = hostlist_new();
+
+	if (set != other)
+		_hostset_lock_pair(set, other);
+	else
+		LOCK_HOSTLIST(set->hl);
+	n = _hostset_subtract(set->hl, other->hl, out);
+	if (set != other)
+		UNLOCK_HOSTLIST(other->hl);
+	_hostlist_swap_ranges(set->hl, out);
+	set->offset_nranges = -1;
+	UNLOCK_HOSTLIST(set->hl);
+	hostlist_destroy(out);
+	return n;
+}
+
+/* binary search through N ranges for hostname "host"
  * */
 static int hostset_find_host(hostset_t set, const char *host)
 {
-	int i;
-	int retval = 0;
+	int retval;
 	hostname_t hn;
 	LOCK_HOSTLIST(set->hl);
 	hn = hostname_create(host);
-	for (i = 0; i < set->hl->nranges; i++) {
-		/*
-		 * FIXME: THIS WILL NOT ALWAYS WORK CORRECTLY IF CALLED FROM A
-		 * LOCATION THAT COULD HAVE DIFFERENT DIMENSIONS
-		 * (i.e. slurmdbd).
-		 */
-		if (hostrange_hn_within(set->hl->hr[i], hn, 0)) {
-			retval = 1;
-			goto done;
-		}
-	}
-done:
+	/*
+	 * FIXME: THIS WILL NOT ALWAYS WORK CORRECTLY IF CALLED FROM A
+	 * LOCATION THAT COULD HAVE DIFFERENT DIMENSIONS
+	 * (i.e. slurmdbd).
+	 */
+	retval = (_hostset_find_range(set->hl, hn, 0) >= 0);
 	UNLOCK_HOSTLIST(set->hl);
 	hostname_destroy(hn);
 	return retval;
 }
 
-int hostset_intersects(hostset_t set, const char *hosts)
+/* count the unique hosts of "hosts" found in hostset "set", setting nhosts
+ * to the number of unique hosts in "hosts". Walks both sorted range lists
+ * unless names could be matched by leading digits of a prefix, in which
+ * case each host is looked up on its own.
+ * Returns -1 if "hosts" can not be parsed.
+ */
+static int _hostset_count_within(hostset_t set, const char *hosts,
+				 int *nhosts, int stop_at_first)
 {
-	int retval = 0;
+	int dims = slurmdb_setup_cluster_name_dims();
+	int nfound = 0, slow;
 	hostlist_t hl;
 	char *hostname;
 
-	assert(set->hl->magic == HOSTLIST_MAGIC);
+	if (!(hl = hostlist_create(hosts)))
+		return -1;
+	hostlist_uniq(hl);
+	*nhosts = hostlist_count(hl);
 
-	hl = hostlist_create(hosts);
-	while ((hostname = hostlist_pop(hl)) != NULL) {
-		retval += hostset_find_host(set, hostname);
-		free(hostname);
-		if (retval)
-			break;
+	LOCK_HOSTLIST(set->hl);
+	LOCK_HOSTLIST(hl);
+	slow = _hostlist_digit_prefix(set->hl, dims) ||
+		_hostlist_digit_prefix(hl, dims);
+	UNLOCK_HOSTLIST(hl);
+	UNLOCK_HOSTLIST(set->hl);
+
+	if (slow) {
+		while ((hostname = hostlist_pop(hl)) != NULL) {
+			nfound += hostset_find_host(set, hostname);
+			free(hostname);
+			if (nfound && stop_at_first)
+				break;
+		}
+	} else {
+		LOCK_HOSTLIST(set->hl);
+		LOCK_HOSTLIST(hl);
+		nfound = _hostset_intersect(set->hl, hl, NULL);
+		UNLOCK_HOSTLIST(hl);
+		UNLOCK_HOSTLIST(set->hl);
 	}
 
 	hostlist_destroy(hl);
 
-	return retval;
+	return nfound;
+}
+
+int hostset_intersects(hostset_t set, const char *hosts)
+{
+	int nhosts;
+
+	assert(set->hl->magic == HOSTLIST_MAGIC);
+
+	return (_hostset_count_within(set, hosts, &nhosts, 1) > 0);
 }
 
 int hostset_within(hostset_t set, const char *hosts)
 {
 	int nhosts, nfound;
-	hostlist_t hl;
-	char *hostname;
 
 	assert(set->hl->magic == HOSTLIST_MAGIC);
 
-	if (!(hl = hostlist_create(hosts)))
+	if ((nfound = _hostset_count_within(set, hosts, &nhosts, 0)) < 0)
 		return (0);
-	nhosts = hostlist_count(hl);
-	nfound = 0;
-
-	while ((hostname = hostlist_pop(hl)) != NULL) {
-		nfound += hostset_find_host(set, hostname);
-		free(hostname);
-	}
-
-	hostlist_destroy(hl);
 
 	return (nhosts == nfound);
 }
 
 int hostset_delete(hostset_t set, const char *hosts)
 {
-	return hostlist_delete(set->hl, hosts);
+	int n, slow;
+	hostset_t del;
+	int dims = slurmdb_setup_cluster_name_dims();
+
+	if (!(del = hostset_create(hosts)))
+		return 0;
+
+	LOCK_HOSTLIST(set->hl);
+	LOCK_HOSTLIST(del->hl);
+	slow = _hostlist_digit_prefix(set->hl, dims) ||
+		_hostlist_digit_prefix(del->hl, dims);
+	UNLOCK_HOSTLIST(del->hl);
+	UNLOCK_HOSTLIST(set->hl);
+
+	if (slow)
+		n = hostlist_delete(set->hl, hosts);
+	else
+		n = hostset_subtract(set, del);
+
+	hostset_destroy(del);
+	return n;
 }
 
 int hostset_delete_host(hostset_t set, const char *hostname)
 {
-	return hostlist_delete_host(set->hl, hostname);
+	int i;
+	hostname_t hn;
+	hostrange_t hr, new;
+
+	if (!hostname)
+		return 0;
+
+	hn = hostname_create(hostname);
+	LOCK_HOSTLIST(set->hl);
+	if ((i = _hostset_find_range(set->hl, hn, 0)) >= 0) {
+		hr = set->hl->hr[i];
+		if (hr->singlehost)
+			hostlist_delete_range(set->hl, i);
+		else if ((new = hostrange_delete_host(hr, hn->num))) {
+			hostlist_insert_range(set->hl, new, i + 1);
+			hostrange_destroy(new);
+		} else if (hostrange_empty(hr))
+			hostlist_delete_range(set->hl, i);
+		set->hl->nhosts--;
+		set->offset_nranges = -1;
+	}
+	UNLOCK_HOSTLIST(set->hl);
+	hostname_destroy(hn);
+
+	return (i >= 0) ? 1 : 0;
 }
 
 char *hostset_shift(hostset_t set)
@@ -3767,7 +4241,23 @@ char * hostset_nth(hostset_t set, int n)
 
 int hostset_find(hostset_t set, const char *hostname)
 {
-	return hostlist_find(set->hl, hostname);
+	int n, count = -1;
+	hostname_t hn;
+
+	if (!hostname)
+		return -1;
+
+	hn = hostname_create(hostname);
+	LOCK_HOSTLIST(set->hl);
+	if ((n = _hostset_find_range(set->hl, hn, 0)) >= 0) {
+		count = _hostset_offset(set, n);
+		if ((count >= 0) && hostname_suffix_is_valid(hn))
+			count += hn->num - set->hl->hr[n]->lo;
+	}
+	UNLOCK_HOSTLIST(set->hl);
+	hostname_destroy(hn);
+
+	return count;
 }
 
 #if TEST_MAIN
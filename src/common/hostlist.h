@@ -319,6 +319,22 @@ int hostlist_delete_nth(hostlist_t hl, int n);
  */
 int hostlist_count(hostlist_t hl);
 
+/* hostlist_for_each_range():
+ *
+ * Call f() on each range of hostlist hl without expanding it into host
+ * names. The hosts of a range are prefix followed by each number from lo
+ * to hi, zero padded to width digits. Width is -1 for a host without a
+ * numeric suffix, in which case prefix is the full host name. f() must
+ * not modify hl.
+ *
+ * Stops at and returns the first non-zero value returned by f(), else
+ * returns 0.
+ */
+int hostlist_for_each_range(hostlist_t hl,
+			    int (*f)(const char *prefix, unsigned long lo,
+				     unsigned long hi, int width, void *arg),
+			    void *arg);
+
 /* hostlist_is_empty(): return true if hostlist is empty. */
 #define hostlist_is_empty(__hl) ( hostlist_count(__hl) == 0 )
 
@@ -508,6 +524,34 @@ int hostset_insert(hostset_t set, const char *hosts);
  */
 int hostset_delete(hostset_t set, const char *hosts);
 
+/* hostset_delete_host():
+ * Delete the single host "hostname" from hostset "set."
+ * Returns 1 if the host was deleted, 0 if it was not in the set.
+ */
+int hostset_delete_host(hostset_t set, const char *hostname);
+
+/* hostset_union():
+ * Add all hosts of hostset "other" into hostset "set", merging the two
+ * sorted sets in a single pass.
+ *
+ * Returns number of hosts added to "set"
+ */
+int hostset_union(hostset_t set, hostset_t other);
+
+/* hostset_intersect():
+ * Remove all hosts from hostset "set" which are not in hostset "other".
+ *
+ * Returns number of hosts left in "set"
+ */
+int hostset_intersect(hostset_t set, hostset_t other);
+
+/* hostset_subtract():
+ * Remove all hosts of hostset "other" from hostset "set".
+ *
+ * Returns number of hosts deleted from "set"
+ */
+int hostset_subtract(hostset_t set, hostset_t other);
+
 /* hostset_intersects():
  * Return 1 if any of the hosts specified by "hosts" are within the hostset "set"
  * Return 0 if all host in "hosts" is not in the hostset "set"
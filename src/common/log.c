@@ -153,6 +153,27 @@ static log_t            *sched_log = NULL;
 static volatile log_level_t highest_log_level = LOG_LEVEL_END;
 static volatile log_level_t highest_sched_log_level = LOG_LEVEL_QUIET;
 
+/*
+ * Asynchronous log file writer. Callers format and timestamp each line,
+ * then queue it under log_lock; a dedicated thread writes queued lines to
+ * the log files in batches without holding log_lock.
+ */
+#define LOG_ASYNC_QUEUE_SIZE 16384
+
+typedef struct {
+	int fd;			/* log file descriptor to write to */
+	char *line;		/* formatted line, including newline */
+} log_async_rec_t;
+
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t async_space_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t async_thread;
+static log_async_rec_t *async_queue = NULL;
+static uint32_t async_head = 0, async_cnt = 0;
+static uint64_t async_drop_cnt = 0, async_drop_reported = 0;
+static bool async_writing = false, async_stop = false;
+static volatile bool async_running = false;
+
 #define LOG_INITIALIZED ((log != NULL) && (log->initialized))
 #define SCHED_LOG_INITIALIZED ((sched_log != NULL) && (sched_log->initialized))
 /* define a default argv0 */
@@ -171,7 +192,22 @@ extern char * program_invocation_name;
  */
 static void _atfork_prep()   { slurm_mutex_lock(&log_lock);   }
 static void _atfork_parent() { slurm_mutex_unlock(&log_lock); }
-static void _atfork_child()  { slurm_mutex_unlock(&log_lock); }
+static void _atfork_child()
+{
+	/*
+	 * The writer thread does not exist in the child, so write directly.
+	 * Queued lines are left to the parent (and leaked here rather than
+	 * freed, as the child usually calls exec() next).
+	 */
+	async_head = async_cnt = 0;
+	async_running = false;
+	async_writing = false;
+	async_stop = false;
+	/* Drop waiters inherited from threads that are gone */
+	slurm_cond_init(&async_cond, NULL);
+	slurm_cond_init(&async_space_cond, NULL);
+	slurm_mutex_unlock(&log_lock);
+}
 static bool at_forked = false;
 #define atfork_install_handlers()					\
 	while (!at_forked) {						\
@@ -180,6 +216,7 @@ static bool at_forked = false;
 	}
 
 static void _log_flush(log_t *log);
+static void _log_async_drain(void);
 
 static log_level_t _highest_level(log_level_t a, log_level_t b, log_level_t c)
 {
@@ -299,6 +336,8 @@ _log_init(char *prog, log_options_t opt, log_facility_t fac, char *logfile )
 {
 	int rc = 0;
 
+	_log_async_drain();
+
 	if (!log)  {
 		log = xmalloc(sizeof(log_t));
 		log->logfp = NULL;
@@ -399,6 +438,8 @@ _sched_log_init(char *prog, log_options_t opt, log_facility_t fac,
 {
 	int rc = 0;
 
+	_log_async_drain();
+
 	if (!sched_log) {
 		sched_log = xmalloc(sizeof(log_t));
 		atfork_install_handlers();
@@ -517,6 +558,8 @@ void log_fini(void)
 	if (!log)
 		return;
 
+	log_set_async(false);
+
 	slurm_mutex_lock(&log_lock);
 	_log_flush(log);
 	xfree(log->argv0);
@@ -538,6 +581,7 @@ void sched_log_fini(void)
 		return;
 
 	slurm_mutex_lock(&log_lock);
+	_log_async_drain();
 	_log_flush(sched_log);
 	xfree(sched_log->argv0);
 	xfree(sched_log->fpfx);
@@ -1151,6 +1195,180 @@ _log_printf(log_t *log, cbuf_t cb, FILE *stream, const char *fmt, ...)
 
 }
 
+/* Write all of buf to fd, give up on errors other than EINTR/EAGAIN */
+static void _log_async_write(int fd, char *buf, size_t len)
+{
+	ssize_t rc;
+
+	while (len > 0) {
+		rc = write(fd, buf, len);
+		if (rc < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			return;
+		}
+		buf += rc;
+		len -= rc;
+	}
+}
+
+/*
+ * Take every queued line at once and write runs of lines for the same file
+ * with one write() each. log_lock is only held to empty the queue, so
+ * callers never wait on the disk unless the queue is full.
+ */
+static void *_log_async_writer(void *arg)
+{
+	log_async_rec_t *batch;
+	char *out = NULL;
+	size_t out_size = 0, out_len, len;
+	uint32_t i, cnt;
+	int fd;
+
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "log_writer", NULL, NULL, NULL) < 0) {
+		error("%s: cannot set my name to %s %m", __func__,
+		      "log_writer");
+	}
+#endif
+
+	batch = xmalloc(sizeof(log_async_rec_t) * (LOG_ASYNC_QUEUE_SIZE + 1));
+
+	slurm_mutex_lock(&log_lock);
+	while (!async_stop || async_cnt) {
+		if (!async_cnt) {
+			slurm_cond_wait(&async_cond, &log_lock);
+			continue;
+		}
+		for (cnt = 0; cnt < async_cnt; cnt++) {
+			batch[cnt] = async_queue[async_head];
+			async_head = (async_head + 1) % LOG_ASYNC_QUEUE_SIZE;
+		}
+		async_cnt = 0;
+		if ((async_drop_cnt != async_drop_reported) &&
+		    log && log->logfp) {
+			batch[cnt].fd = fileno(log->logfp);
+			batch[cnt].line = NULL;
+			xlogfmtcat(&batch[cnt].line,
+				   "[%M] error: Log queue full, dropped %"PRIu64
+				   " messages\n",
+				   async_drop_cnt - async_drop_reported);
+			async_drop_reported = async_drop_cnt;
+			cnt++;
+		}
+		async_writing = true;
+		slurm_cond_broadcast(&async_space_cond);
+		slurm_mutex_unlock(&log_lock);
+
+		for (i = 0; i < cnt; ) {
+			fd = batch[i].fd;
+			out_len = 0;
+			for ( ; (i < cnt) && (batch[i].fd == fd); i++) {
+				len = strlen(batch[i].line);
+				if ((out_len + len) > out_size) {
+					out_size = MAX(out_size * 2,
+						       out_len + len);
+					xrealloc_nz(out, out_size);
+				}
+				memcpy(out + out_len, batch[i].line, len);
+				out_len += len;
+				xfree(batch[i].line);
+			}
+			_log_async_write(fd, out, out_len);
+		}
+
+		slurm_mutex_lock(&log_lock);
+		async_writing = false;
+		slurm_cond_broadcast(&async_space_cond);
+	}
+	async_running = false;
+	slurm_cond_broadcast(&async_space_cond);
+	slurm_mutex_unlock(&log_lock);
+
+	xfree(batch);
+	xfree(out);
+	return NULL;
+}
+
+/*
+ * Queue a formatted line for the writer thread, taking ownership of it.
+ * When the queue is full, messages above LOG_LEVEL_ERROR are dropped and
+ * counted while errors wait for room. Call with log_lock held.
+ */
+static void _log_async_queue(log_level_t level, log_t *log, char *line)
+{
+	uint32_t inx;
+
+	while (async_running && (async_cnt >= LOG_ASYNC_QUEUE_SIZE)) {
+		if (level > LOG_LEVEL_ERROR) {
+			async_drop_cnt++;
+			xfree(line);
+			return;
+		}
+		slurm_cond_wait(&async_space_cond, &log_lock);
+	}
+	/* The log file may have been closed while we waited */
+	if (!log->logfp) {
+		xfree(line);
+		return;
+	}
+	if (!async_running) {
+		/* writer stopped while we waited */
+		_log_async_write(fileno(log->logfp), line, strlen(line));
+		xfree(line);
+		return;
+	}
+
+	inx = (async_head + async_cnt) % LOG_ASYNC_QUEUE_SIZE;
+	async_queue[inx].fd = fileno(log->logfp);
+	async_queue[inx].line = line;
+	if (async_cnt++ == 0)
+		slurm_cond_signal(&async_cond);
+}
+
+/*
+ * Wait for the writer thread to write every queued line, done before log
+ * files are reopened or closed. Call with log_lock held.
+ */
+static void _log_async_drain(void)
+{
+	while (async_running && (async_cnt || async_writing))
+		slurm_cond_wait(&async_space_cond, &log_lock);
+}
+
+extern void log_set_async(bool async)
+{
+	slurm_mutex_lock(&log_lock);
+	if (async == async_running) {
+		slurm_mutex_unlock(&log_lock);
+		return;
+	}
+	if (async) {
+		if (!async_queue)
+			async_queue = xmalloc(sizeof(log_async_rec_t) *
+					      LOG_ASYNC_QUEUE_SIZE);
+		async_running = true;
+		slurm_mutex_unlock(&log_lock);
+		slurm_thread_create(&async_thread, _log_async_writer, NULL);
+		return;
+	}
+
+	/* The writer empties the queue before it exits */
+	async_stop = true;
+	slurm_cond_broadcast(&async_cond);
+	slurm_mutex_unlock(&log_lock);
+	pthread_join(async_thread, NULL);
+	async_stop = false;
+}
+
+extern void log_get_async_stats(uint32_t *queue_len, uint64_t *drop_cnt)
+{
+	slurm_mutex_lock(&log_lock);
+	*queue_len = async_cnt;
+	*drop_cnt = async_drop_cnt;
+	slurm_mutex_unlock(&log_lock);
+}
+
 /*
  * log a message at the specified level to facilities that have been
  * configured to receive messages at that level
@@ -1160,7 +1378,18 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 	char *pfx = "";
 	char *buf = NULL;
 	char *msgbuf = NULL;
+	char *stamp = NULL;
 	int priority = LOG_INFO;
+	bool async;
+
+	/*
+	 * With the asynchronous writer, format the message and capture its
+	 * timestamp before taking log_lock.
+	 */
+	if (async_running) {
+		buf = vxstrfmt(fmt, args);
+		xlogfmtcat(&stamp, "[%M]");
+	}
 
 	slurm_mutex_lock(&log_lock);
 
@@ -1168,20 +1397,31 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 		log_options_t opts = LOG_OPTS_STDERR_ONLY;
 		_log_init(NULL, opts, 0, NULL);
 	}
+	async = stamp && async_running;
 
 	if (SCHED_LOG_INITIALIZED && sched &&
 	    (highest_sched_log_level > LOG_LEVEL_QUIET)) {
-		buf = vxstrfmt(fmt, args);
-		xlogfmtcat(&msgbuf, "[%M] %s%s%s", sched_log->fpfx, pfx, buf);
-		_log_printf(sched_log, sched_log->fbuf, sched_log->logfp,
-			    "sched: %s\n", msgbuf);
-		fflush(sched_log->logfp);
-		xfree(msgbuf);
+		if (!buf)
+			buf = vxstrfmt(fmt, args);
+		if (async && sched_log->logfp) {
+			xstrfmtcat(msgbuf, "sched: %s %s%s%s\n", stamp,
+				   sched_log->fpfx, pfx, buf);
+			_log_async_queue(level, sched_log, msgbuf);
+			msgbuf = NULL;
+		} else {
+			xlogfmtcat(&msgbuf, "[%M] %s%s%s", sched_log->fpfx,
+				   pfx, buf);
+			_log_printf(sched_log, sched_log->fbuf,
+				    sched_log->logfp, "sched: %s\n", msgbuf);
+			fflush(sched_log->logfp);
+			xfree(msgbuf);
+		}
 	}
 
 	if (level > highest_log_level) {
 		slurm_mutex_unlock(&log_lock);
 		xfree(buf);
+		xfree(stamp);
 		return;
 	}
 
@@ -1257,7 +1497,13 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 		fflush(stderr);
 	}
 
-	if ((level <= log->opt.logfile_level) && (log->logfp != NULL)) {
+	if ((level <= log->opt.logfile_level) && (log->logfp != NULL) &&
+	    async) {
+		xstrfmtcat(msgbuf, "%s %s%s%s\n", stamp, log->fpfx, pfx, buf);
+		_log_async_queue(level, log, msgbuf);
+		msgbuf = NULL;
+	} else if ((level <= log->opt.logfile_level) &&
+		   (log->logfp != NULL)) {
 
 		xlogfmtcat(&msgbuf, "[%M] %s%s%s", log->fpfx, pfx, buf);
 		_log_printf(log, log->fbuf, log->logfp, "%s\n", msgbuf);
@@ -1282,6 +1528,7 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 	slurm_mutex_unlock(&log_lock);
 
 	xfree(buf);
+	xfree(stamp);
 }
 
 bool
@@ -1311,6 +1558,7 @@ void
 log_flush()
 {
 	slurm_mutex_lock(&log_lock);
+	_log_async_drain();
 	_log_flush(log);
 	slurm_mutex_unlock(&log_lock);
 }
@@ -46,6 +46,7 @@
 #ifndef _LOG_H
 #define _LOG_H
 
+#include <inttypes.h>
 #include <syslog.h>
 #include <stdio.h>
 
@@ -223,6 +224,18 @@ bool log_has_data(void);
  */
 void log_flush(void);
 
+/*
+ * log_set_async()
+ * Start (or stop) a thread that writes log file and scheduler log file
+ * messages. Callers then only format the message and queue it; when the
+ * queue is full messages less severe than errors are dropped and counted.
+ * Stopping the thread writes all queued messages first.
+ */
+extern void log_set_async(bool async);
+
+/* Return the number of queued and dropped asynchronous log messages */
+extern void log_get_async_stats(uint32_t *queue_len, uint64_t *drop_cnt);
+
 /* log_set_debug_flags()
  * Set or reset the debug flags based on the configuration
  * file or the scontrol command.
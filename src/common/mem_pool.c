@@ -0,0 +1,344 @@
+/*****************************************************************************\
+ *  mem_pool.c - typed slab allocator for fixed size records
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Theory of operation:
+ * - Each pool hands out objects of a single size carved out of larger slabs.
+ *   Every object is preceded by a small header pointing back at its slab, so
+ *   freeing needs no pool argument and no search.
+ * - Freed objects are threaded onto a per-slab free list through their own
+ *   body. Objects never handed out are taken from the slab with a bump index,
+ *   so a new slab costs one allocation and no initialization loop.
+ * - Slabs with free objects are kept on the "partial" list, slabs with none
+ *   on the "full" list. A slab whose last object is freed is released to the
+ *   heap, except for a single empty slab cached per pool to avoid thrashing
+ *   when a record is repeatedly created and purged.
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/mem_pool.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#define MEM_POOL_MAGIC		0x6d706f6c
+#define MEM_OBJ_MAGIC		0x6d6f626a
+#define MEM_OBJ_FREE_MAGIC	0x66726565
+#define DEFAULT_OBJS_PER_SLAB	64
+#define MEM_ALIGN		16
+#define ALIGN_UP(x)		(((x) + (MEM_ALIGN - 1)) & ~(MEM_ALIGN - 1))
+
+typedef struct mem_slab mem_slab_t;
+
+typedef struct {
+	mem_slab_t *slab;
+	uint32_t magic;
+} obj_hdr_t;
+
+struct mem_slab {
+	mem_pool_t *pool;
+	mem_slab_t *next;
+	mem_slab_t *prev;
+	void *free_list;	/* freed object bodies, linked through body */
+	uint32_t in_use;
+	uint32_t bump;		/* index of first never used object */
+	char *objs;		/* start of first object header */
+};
+
+struct mem_pool {
+	uint32_t magic;
+	char *name;
+	size_t obj_size;
+	size_t stride;		/* header plus aligned object */
+	uint32_t objs_per_slab;
+	mem_slab_t *partial;	/* slabs with at least one free object */
+	mem_slab_t *full;	/* slabs with no free object */
+	mem_slab_t *empty;	/* one cached slab with no object in use */
+	uint32_t slab_cnt;
+	uint32_t obj_in_use;
+	uint64_t alloc_cnt;
+	uint64_t slab_free_cnt;
+	pthread_mutex_t mutex;
+};
+
+static pthread_mutex_t pools_mutex = PTHREAD_MUTEX_INITIALIZER;
+static mem_pool_t **pools = NULL;
+static uint32_t pool_cnt = 0;
+
+static void _slab_unlink(mem_slab_t **head, mem_slab_t *slab)
+{
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		*head = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+	slab->next = slab->prev = NULL;
+}
+
+static void _slab_push(mem_slab_t **head, mem_slab_t *slab)
+{
+	slab->prev = NULL;
+	slab->next = *head;
+	if (*head)
+		(*head)->prev = slab;
+	*head = slab;
+}
+
+static void _free_slab_chain(mem_slab_t *slab)
+{
+	mem_slab_t *next;
+
+	while (slab) {
+		next = slab->next;
+		xfree(slab);
+		slab = next;
+	}
+}
+
+static mem_slab_t *_slab_create(mem_pool_t *pool)
+{
+	mem_slab_t *slab;
+	size_t hdr_size = ALIGN_UP(sizeof(mem_slab_t));
+
+	/* Objects are zeroed on allocation, no need to zero the slab here */
+	slab = xmalloc_nz(hdr_size + (pool->stride * pool->objs_per_slab));
+	slab->pool = pool;
+	slab->next = slab->prev = NULL;
+	slab->free_list = NULL;
+	slab->in_use = 0;
+	slab->bump = 0;
+	slab->objs = (char *) slab + hdr_size;
+	pool->slab_cnt++;
+
+	return slab;
+}
+
+extern mem_pool_t *mem_pool_create(const char *name, size_t obj_size,
+				   uint32_t objs_per_slab)
+{
+	mem_pool_t *pool = xmalloc(sizeof(mem_pool_t));
+
+	if (obj_size < sizeof(void *))
+		obj_size = sizeof(void *);
+
+	pool->magic = MEM_POOL_MAGIC;
+	pool->name = xstrdup(name);
+	pool->obj_size = obj_size;
+	pool->stride = ALIGN_UP(sizeof(obj_hdr_t)) + ALIGN_UP(obj_size);
+	pool->objs_per_slab = objs_per_slab ? objs_per_slab :
+					      DEFAULT_OBJS_PER_SLAB;
+	slurm_mutex_init(&pool->mutex);
+
+	slurm_mutex_lock(&pools_mutex);
+	xrealloc(pools, sizeof(mem_pool_t *) * (pool_cnt + 1));
+	pools[pool_cnt++] = pool;
+	slurm_mutex_unlock(&pools_mutex);
+
+	return pool;
+}
+
+extern void mem_pool_destroy(mem_pool_t *pool)
+{
+	uint32_t i;
+
+	if (!pool)
+		return;
+
+	xassert(pool->magic == MEM_POOL_MAGIC);
+
+	slurm_mutex_lock(&pool->mutex);
+	if (pool->obj_in_use) {
+		error("%s: pool %s still has %u objects in use, not destroyed",
+		      __func__, pool->name, pool->obj_in_use);
+		slurm_mutex_unlock(&pool->mutex);
+		return;
+	}
+	slurm_mutex_unlock(&pool->mutex);
+
+	slurm_mutex_lock(&pools_mutex);
+	for (i = 0; i < pool_cnt; i++) {
+		if (pools[i] != pool)
+			continue;
+		pools[i] = pools[--pool_cnt];
+		break;
+	}
+	if (!pool_cnt)
+		xfree(pools);
+	slurm_mutex_unlock(&pools_mutex);
+
+	_free_slab_chain(pool->partial);
+	_free_slab_chain(pool->full);
+	xfree(pool->empty);
+	slurm_mutex_destroy(&pool->mutex);
+	pool->magic = ~MEM_POOL_MAGIC;
+	xfree(pool->name);
+	xfree(pool);
+}
+
+extern void *mem_pool_alloc(mem_pool_t *pool)
+{
+	mem_slab_t *slab;
+	obj_hdr_t *hdr;
+	void *obj;
+
+	xassert(pool);
+	xassert(pool->magic == MEM_POOL_MAGIC);
+
+	slurm_mutex_lock(&pool->mutex);
+	if (!(slab = pool->partial)) {
+		if ((slab = pool->empty))
+			pool->empty = NULL;
+		else
+			slab = _slab_create(pool);
+		_slab_push(&pool->partial, slab);
+	}
+
+	if (slab->free_list) {
+		obj = slab->free_list;
+		slab->free_list = *(void **) obj;
+		hdr = (obj_hdr_t *) ((char *) obj -
+				     ALIGN_UP(sizeof(obj_hdr_t)));
+		xassert(hdr->magic == MEM_OBJ_FREE_MAGIC);
+	} else {
+		xassert(slab->bump < pool->objs_per_slab);
+		hdr = (obj_hdr_t *) (slab->objs +
+				     (pool->stride * slab->bump++));
+		hdr->slab = slab;
+		obj = (char *) hdr + ALIGN_UP(sizeof(obj_hdr_t));
+	}
+	hdr->magic = MEM_OBJ_MAGIC;
+
+	if ((++slab->in_use == pool->objs_per_slab)) {
+		_slab_unlink(&pool->partial, slab);
+		_slab_push(&pool->full, slab);
+	}
+	pool->obj_in_use++;
+	pool->alloc_cnt++;
+	slurm_mutex_unlock(&pool->mutex);
+
+	memset(obj, 0, pool->obj_size);
+	return obj;
+}
+
+extern void slurm_mem_pool_free(void **obj_pptr)
+{
+	mem_pool_t *pool;
+	mem_slab_t *slab;
+	obj_hdr_t *hdr;
+	void *obj;
+
+	if (!obj_pptr || !(obj = *obj_pptr))
+		return;
+
+	hdr = (obj_hdr_t *) ((char *) obj - ALIGN_UP(sizeof(obj_hdr_t)));
+	if (hdr->magic != MEM_OBJ_MAGIC) {
+		error("%s: invalid object %p (magic %x)",
+		      __func__, obj, hdr->magic);
+		xassert(0);
+		return;
+	}
+	slab = hdr->slab;
+	pool = slab->pool;
+	xassert(pool->magic == MEM_POOL_MAGIC);
+
+	slurm_mutex_lock(&pool->mutex);
+	hdr->magic = MEM_OBJ_FREE_MAGIC;
+	*(void **) obj = slab->free_list;
+	slab->free_list = obj;
+
+	if (slab->in_use == pool->objs_per_slab) {
+		_slab_unlink(&pool->full, slab);
+		_slab_push(&pool->partial, slab);
+	}
+	pool->obj_in_use--;
+	if (--slab->in_use == 0) {
+		_slab_unlink(&pool->partial, slab);
+		if (!pool->empty) {
+			pool->empty = slab;
+		} else {
+			pool->slab_cnt--;
+			pool->slab_free_cnt++;
+			xfree(slab);
+		}
+	}
+	slurm_mutex_unlock(&pool->mutex);
+
+	*obj_pptr = NULL;
+}
+
+extern uint32_t mem_pool_get_stats(mem_pool_stats_t **stats)
+{
+	mem_pool_stats_t *rec;
+	mem_pool_t *pool;
+	uint32_t i, cnt;
+
+	slurm_mutex_lock(&pools_mutex);
+	cnt = pool_cnt;
+	*stats = xmalloc(sizeof(mem_pool_stats_t) * (cnt ? cnt : 1));
+	for (i = 0; i < cnt; i++) {
+		pool = pools[i];
+		rec = &(*stats)[i];
+		slurm_mutex_lock(&pool->mutex);
+		rec->name = xstrdup(pool->name);
+		rec->obj_size = pool->obj_size;
+		rec->objs_per_slab = pool->objs_per_slab;
+		rec->slab_cnt = pool->slab_cnt;
+		rec->obj_in_use = pool->obj_in_use;
+		rec->obj_free = (pool->slab_cnt * pool->objs_per_slab) -
+				pool->obj_in_use;
+		rec->alloc_cnt = pool->alloc_cnt;
+		rec->slab_free_cnt = pool->slab_free_cnt;
+		slurm_mutex_unlock(&pool->mutex);
+	}
+	slurm_mutex_unlock(&pools_mutex);
+
+	return cnt;
+}
+
+extern void mem_pool_stats_free(mem_pool_stats_t *stats, uint32_t cnt)
+{
+	uint32_t i;
+
+	if (!stats)
+		return;
+	for (i = 0; i < cnt; i++)
+		xfree(stats[i].name);
+	xfree(stats);
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************\
+ *  mem_pool.h - typed slab allocator for fixed size records
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _MEM_POOL_H
+#define _MEM_POOL_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+typedef struct mem_pool mem_pool_t;
+
+typedef struct {
+	char *name;
+	uint32_t obj_size;	/* bytes requested per object */
+	uint32_t objs_per_slab;
+	uint32_t slab_cnt;	/* slabs currently allocated */
+	uint32_t obj_in_use;	/* objects handed out and not yet freed */
+	uint32_t obj_free;	/* objects available without a new slab */
+	uint64_t alloc_cnt;	/* lifetime object allocations */
+	uint64_t slab_free_cnt;	/* slabs returned to the heap */
+} mem_pool_stats_t;
+
+/*
+ * Create a new pool of objects of obj_size bytes. Objects are carved out of
+ * slabs holding objs_per_slab records each. Slabs which become entirely
+ * unused are returned to the heap (one empty slab is kept cached), so memory
+ * is given back once a large number of records are purged.
+ * IN name - label used for statistics, copied
+ * IN obj_size - size of each object
+ * IN objs_per_slab - objects per slab, 0 for a default
+ * RET pool, destroy with mem_pool_destroy()
+ */
+extern mem_pool_t *mem_pool_create(const char *name, size_t obj_size,
+				   uint32_t objs_per_slab);
+
+/*
+ * Release all memory of a pool. If objects are still in use the pool is left
+ * intact and an error is logged.
+ */
+extern void mem_pool_destroy(mem_pool_t *pool);
+
+/* Return a zeroed object from the pool, never returns NULL */
+extern void *mem_pool_alloc(mem_pool_t *pool);
+
+/*
+ * Return an object obtained from mem_pool_alloc() to its pool and set the
+ * pointer to NULL. Passing a NULL pointer is a no-op.
+ */
+#define mem_pool_free(__p) slurm_mem_pool_free((void **)&(__p))
+extern void slurm_mem_pool_free(void **obj);
+
+/*
+ * Get statistics for every pool in existence.
+ * OUT stats - xmalloc'd array, free with mem_pool_stats_free()
+ * RET count of records in stats
+ */
+extern uint32_t mem_pool_get_stats(mem_pool_stats_t **stats);
+
+extern void mem_pool_stats_free(mem_pool_stats_t *stats, uint32_t cnt);
+
+#endif /* !_MEM_POOL_H */
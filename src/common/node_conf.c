@@ -49,6 +49,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -84,6 +85,35 @@ int node_record_count = 0;		/* count in node_record_table_ptr */
 uint16_t *cr_node_num_cores = NULL;
 uint32_t *cr_node_cores_offset = NULL;
 
+/*
+ * Index of the node names ending in digits, sorted by the name before those
+ * digits, the count of digits and their value. Lets hostlist ranges be
+ * mapped to node indexes without building each host name. Built on first
+ * use and discarded whenever the node table changes.
+ */
+typedef struct {
+	char *name;		/* node name, first prefix_len bytes used */
+	int prefix_len;
+	int width;		/* count of trailing digits */
+	uint64_t num;		/* value of trailing digits */
+	int node_inx;
+} node_range_t;
+
+#define NODE_RANGE_MAX_DIGITS 18	/* largest width held in uint64_t */
+
+static pthread_mutex_t node_range_mutex = PTHREAD_MUTEX_INITIALIZER;
+static node_range_t *node_range_inx = NULL;
+static int node_range_cnt = 0;
+static struct node_record *node_range_table = NULL;
+static int node_range_node_cnt = 0;
+
+typedef struct {
+	bitstr_t *bitmap;
+	bool best_effort;
+	const char *caller;
+	int rc;
+} range2bitmap_args_t;
+
 /* Local function defiitions */
 static int	_build_single_nodeline_info(slurm_conf_node_t *node_ptr,
 					    struct config_record *config_ptr);
@@ -96,6 +126,8 @@ static struct node_record *
 static void	_list_delete_config (void *config_entry);
 static int	_list_find_config (void *config_entry, void *key);
 static const char* _node_record_hash_identity (void* item);
+static void	_node_range_inx_free(void);
+static int	_node_table_size(int node_cnt);
 
 /*
  * _build_single_nodeline_info - From the slurm.conf reader, build table,
@@ -617,6 +649,17 @@ extern struct config_record * create_config_record (void)
 	return config_ptr;
 }
 
+/* Bytes allocated for a node table holding node_cnt records */
+static int _node_table_size(int node_cnt)
+{
+	int need = node_cnt * sizeof(struct node_record);
+	int size = BUF_SIZE;
+
+	while (size <= need)
+		size *= 2;
+	return size;
+}
+
 /*
  * create_node_record - create a node record and set its values to defaults
  * IN config_ptr - pointer to node's configuration information
@@ -634,15 +677,14 @@ extern struct node_record *create_node_record (
 	last_node_update = time (NULL);
 	xassert(config_ptr);
 	xassert(node_name);
-
-	/* round up the buffer size to reduce overhead of xrealloc */
-	old_buffer_size = (node_record_count) * sizeof (struct node_record);
-	old_buffer_size =
-		((int) ((old_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
-	new_buffer_size =
-		(node_record_count + 1) * sizeof (struct node_record);
-	new_buffer_size =
-		((int) ((new_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
+	_node_range_inx_free();
+
+	/*
+	 * Grow the buffer geometrically, each xrealloc also requires the
+	 * node hash table to be rebuilt
+	 */
+	old_buffer_size = _node_table_size(node_record_count);
+	new_buffer_size = _node_table_size(node_record_count + 1);
 	if (!node_record_table_ptr) {
 		node_record_table_ptr = xmalloc(new_buffer_size);
 	} else if (old_buffer_size != new_buffer_size) {
@@ -792,6 +834,7 @@ extern int init_node_conf (void)
 	node_record_count = 0;
 	xfree(node_record_table_ptr);
 	xhash_free(node_hash_table);
+	_node_range_inx_free();
 
 	if (config_list)	/* delete defunct configuration entries */
 		(void) _delete_config_record ();
@@ -822,9 +865,237 @@ extern void node_fini2 (void)
 
 	xfree(node_record_table_ptr);
 	node_record_count = 0;
+	_node_range_inx_free();
 }
 
 
+static void _node_range_inx_free(void)
+{
+	slurm_mutex_lock(&node_range_mutex);
+	xfree(node_range_inx);
+	node_range_cnt = 0;
+	node_range_table = NULL;
+	node_range_node_cnt = 0;
+	slurm_mutex_unlock(&node_range_mutex);
+}
+
+/* Compare a node range index entry with a key */
+static int _node_range_cmp(node_range_t *ent, const char *prefix,
+			   int prefix_len, int width, uint64_t num)
+{
+	int rc;
+
+	rc = memcmp(ent->name, prefix, MIN(ent->prefix_len, prefix_len));
+	if (rc)
+		return rc;
+	if (ent->prefix_len != prefix_len)
+		return (ent->prefix_len < prefix_len) ? -1 : 1;
+	if (ent->width != width)
+		return (ent->width < width) ? -1 : 1;
+	if (ent->num != num)
+		return (ent->num < num) ? -1 : 1;
+	return 0;
+}
+
+static int _node_range_sort(const void *x, const void *y)
+{
+	const node_range_t *ent = y;
+
+	return _node_range_cmp((node_range_t *) x, ent->name, ent->prefix_len,
+			       ent->width, ent->num);
+}
+
+/*
+ * Build the node range index if the node table changed since it was built
+ * NOTE: The caller's node locks keep the index valid while it is used
+ */
+static void _node_range_inx_get(void)
+{
+	struct node_record *node_ptr = node_record_table_ptr;
+	node_range_t *ent;
+	char *name;
+	int i, len, digits;
+
+	slurm_mutex_lock(&node_range_mutex);
+	if (node_range_inx && (node_range_table == node_record_table_ptr) &&
+	    (node_range_node_cnt == node_record_count)) {
+		slurm_mutex_unlock(&node_range_mutex);
+		return;
+	}
+
+	xfree(node_range_inx);
+	node_range_cnt = 0;
+	node_range_inx = xcalloc(MAX(node_record_count, 1),
+				 sizeof(node_range_t));
+	for (i = 0; i < node_record_count; i++, node_ptr++) {
+		if (!(name = node_ptr->name))
+			continue;	/* vestigial record */
+		len = strlen(name);
+		for (digits = 0; (digits < len) &&
+		     isdigit((int) name[len - digits - 1]); digits++)
+			;
+		if (!digits || (digits > NODE_RANGE_MAX_DIGITS))
+			continue;
+		ent = &node_range_inx[node_range_cnt++];
+		ent->name = name;
+		ent->prefix_len = len - digits;
+		ent->width = digits;
+		ent->num = strtoull(name + ent->prefix_len, NULL, 10);
+		ent->node_inx = i;
+	}
+	qsort(node_range_inx, node_range_cnt, sizeof(node_range_t),
+	      _node_range_sort);
+	node_range_table = node_record_table_ptr;
+	node_range_node_cnt = node_record_count;
+	slurm_mutex_unlock(&node_range_mutex);
+}
+
+/*
+ * Set the bits of the nodes named prefix followed by width digits with a
+ * value from lo to hi. RET count of nodes found
+ */
+static uint64_t _node_range_set(const char *prefix, int prefix_len,
+				int width, uint64_t lo, uint64_t hi,
+				bitstr_t *bitmap)
+{
+	node_range_t *ent;
+	int first = 0, last = node_range_cnt, mid;
+	uint64_t cnt = 0;
+
+	/* Find the first entry not less than the start of the range */
+	while (first < last) {
+		mid = (first + last) / 2;
+		if (_node_range_cmp(&node_range_inx[mid], prefix, prefix_len,
+				    width, lo) < 0)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+	for (ent = &node_range_inx[first];
+	     ent < &node_range_inx[node_range_cnt]; ent++) {
+		if (_node_range_cmp(ent, prefix, prefix_len, width, hi) > 0)
+			break;
+		bit_set(bitmap, ent->node_inx);
+		cnt++;
+	}
+
+	return cnt;
+}
+
+/* Set the bit of one named node, logging an invalid name */
+static void _name2bitmap(char *name, range2bitmap_args_t *args)
+{
+	struct node_record *node_ptr;
+
+	node_ptr = _find_node_record(name, args->best_effort, true);
+	if (node_ptr) {
+		bit_set(args->bitmap,
+			(bitoff_t) (node_ptr - node_record_table_ptr));
+	} else {
+		error("%s: invalid node specified %s", args->caller, name);
+		if (!args->best_effort)
+			args->rc = EINVAL;
+	}
+}
+
+static int _digit_cnt(uint64_t num)
+{
+	int cnt = 1;
+
+	while (num >= 10) {
+		num /= 10;
+		cnt++;
+	}
+	return cnt;
+}
+
+/*
+ * hostlist_for_each_range() callback setting the bits of the nodes in one
+ * range. Each run of numbers printed with the same number of digits maps to
+ * a run of the node range index. Names missing from the index go through
+ * _find_node_record() one at a time, which also handles NodeHostname
+ * aliases and logging.
+ */
+static int _range2bitmap(const char *prefix, unsigned long lo,
+			 unsigned long hi, int width, void *arg)
+{
+	range2bitmap_args_t *args = arg;
+	int len, prefix_len, digits, num_width;
+	uint64_t base, pow10, i, seg_hi, seg_lo;
+	char *name;
+
+	if (width < 0) {
+		name = xstrdup(prefix);
+		_name2bitmap(name, args);
+		xfree(name);
+		return 0;
+	}
+
+	/* Digits at the end of the prefix are part of the node's number */
+	len = strlen(prefix);
+	for (prefix_len = len; (prefix_len > 0) &&
+	     isdigit((int) prefix[prefix_len - 1]); prefix_len--)
+		;
+	digits = len - prefix_len;
+
+	for (seg_lo = lo; seg_lo <= hi; seg_lo = seg_hi + 1) {
+		num_width = MAX(width, _digit_cnt(seg_lo));
+		seg_hi = hi;
+		if ((digits + num_width) <= NODE_RANGE_MAX_DIGITS) {
+			for (i = 0, pow10 = 1; i < num_width; i++)
+				pow10 *= 10;
+			seg_hi = MIN(hi, pow10 - 1);
+			base = 0;
+			if (digits)
+				base = strtoull(prefix + prefix_len, NULL, 10) *
+				       pow10;
+			if (_node_range_set(prefix, prefix_len,
+					    digits + num_width, base + seg_lo,
+					    base + seg_hi, args->bitmap) ==
+			    (seg_hi - seg_lo + 1))
+				continue;
+		}
+		for (i = seg_lo; i <= seg_hi; i++) {
+			name = xstrdup_printf("%s%0*"PRIu64, prefix, width, i);
+			_name2bitmap(name, args);
+			xfree(name);
+		}
+		if (seg_hi == hi)
+			break;	/* hi may be the largest value */
+	}
+
+	return 0;
+}
+
+/* Set the bits of all nodes in a hostlist */
+static int _hostlist2bitmap(hostlist_t hl, bool best_effort,
+			    bitstr_t *bitmap, const char *caller)
+{
+	range2bitmap_args_t args = {
+		.bitmap = bitmap,
+		.best_effort = best_effort,
+		.caller = caller,
+		.rc = SLURM_SUCCESS,
+	};
+	hostlist_iterator_t hi;
+	char *name;
+
+	if (slurmdb_setup_cluster_name_dims() <= 1) {
+		_node_range_inx_get();
+		hostlist_for_each_range(hl, _range2bitmap, &args);
+		return args.rc;
+	}
+
+	/* Multi-dimensional names are not simple numeric ranges */
+	hi = hostlist_iterator_create(hl);
+	while ((name = hostlist_next(hi))) {
+		_name2bitmap(name, &args);
+		free(name);
+	}
+	hostlist_iterator_destroy(hi);
+	return args.rc;
+}
+
 /*
  * node_name2bitmap - given a node name regular expression, build a bitmap
  *	representation
@@ -838,7 +1109,6 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 			     bitstr_t **bitmap)
 {
 	int rc = SLURM_SUCCESS;
-	char *this_node_name;
 	bitstr_t *my_bitmap;
 	hostlist_t host_list;
 
@@ -858,20 +1128,8 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 		return rc;
 	}
 
-	while ( (this_node_name = hostlist_shift (host_list)) ) {
-		struct node_record *node_ptr;
-		node_ptr = _find_node_record(this_node_name, best_effort, true);
-		if (node_ptr) {
-			bit_set (my_bitmap, (bitoff_t) (node_ptr -
-							node_record_table_ptr));
-		} else {
-			error ("node_name2bitmap: invalid node specified %s",
-			       this_node_name);
-			if (!best_effort)
-				rc = EINVAL;
-		}
-		free (this_node_name);
-	}
+	rc = _hostlist2bitmap(host_list, best_effort, my_bitmap,
+			      "node_name2bitmap");
 	hostlist_destroy (host_list);
 
 	return rc;
@@ -886,34 +1144,37 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
  */
 extern int hostlist2bitmap (hostlist_t hl, bool best_effort, bitstr_t **bitmap)
 {
-	int rc = SLURM_SUCCESS;
 	bitstr_t *my_bitmap;
-	char *name;
-	hostlist_iterator_t hi;
 
 	FREE_NULL_BITMAP(*bitmap);
 	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
 	*bitmap = my_bitmap;
 
-	hi = hostlist_iterator_create(hl);
-	while ((name = hostlist_next(hi))) {
-		struct node_record *node_ptr;
-		node_ptr = _find_node_record(name, best_effort, true);
-		if (node_ptr) {
-			bit_set (my_bitmap, (bitoff_t) (node_ptr -
-							node_record_table_ptr));
-		} else {
-			error ("hostlist2bitmap: invalid node specified %s",
-			       name);
-			if (!best_effort)
-				rc = EINVAL;
+	return _hostlist2bitmap(hl, best_effort, my_bitmap, "hostlist2bitmap");
+}
+
+/*
+ * node_conf_fingerprint - return a hash of the node names in table order.
+ *	Node bitmaps built against a table with the same fingerprint are
+ *	valid as is, without rebuilding them from node name lists.
+ */
+extern uint64_t node_conf_fingerprint(void)
+{
+	struct node_record *node_ptr = node_record_table_ptr;
+	uint64_t hash = 0xcbf29ce484222325ULL;	/* 64-bit FNV-1a */
+	char *name;
+	int i;
+
+	for (i = 0; i < node_record_count; i++, node_ptr++) {
+		for (name = node_ptr->name; name && *name; name++) {
+			hash ^= (unsigned char) *name;
+			hash *= 0x100000001b3ULL;
 		}
-		free (name);
+		/* Mix in the end of each name too */
+		hash *= 0x100000001b3ULL;
 	}
 
-	hostlist_iterator_destroy(hi);
-	return rc;
-
+	return hash;
 }
 
 /* Purge the contents of a node record */
@@ -953,6 +1214,7 @@ extern void rehash_node (void)
 
 	xhash_free (node_hash_table);
 	node_hash_table = xhash_init(_node_record_hash_identity, NULL);
+	_node_range_inx_free();
 	for (i = 0; i < node_record_count; i++, node_ptr++) {
 		if ((node_ptr->name == NULL) ||
 		    (node_ptr->name[0] == '\0'))
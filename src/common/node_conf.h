@@ -308,6 +308,13 @@ extern void node_fini2 (void);
 extern int node_name2bitmap (char *node_names, bool best_effort,
 			     bitstr_t **bitmap);
 
+/*
+ * node_conf_fingerprint - return a hash of the node names in table order.
+ *	Node bitmaps built against a table with the same fingerprint are
+ *	valid as is, without rebuilding them from node name lists.
+ */
+extern uint64_t node_conf_fingerprint(void);
+
 /* Purge the contents of a node record */
 extern void purge_node_rec (struct node_record *node_ptr);
 
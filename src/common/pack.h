@@ -81,6 +81,8 @@ Buf	create_mmap_buf(char *file);
 void	free_buf(Buf my_buf);
 Buf	init_buf(uint32_t size);
 void    grow_buf (Buf my_buf, uint32_t size);
+int	try_grow_buf(Buf my_buf, uint32_t size);
+int	try_grow_buf_remaining(Buf my_buf, uint32_t size);
 void	*xfer_buf_data(Buf my_buf);
 
 void	pack_time(time_t val, Buf buffer);
@@ -323,6 +325,52 @@ int	unpackmem_array(char *valp, uint32_t size_valp, Buf buffer);
 		*bitmap = NULL;						\
 } while (0)
 
+/*
+ * Pack a bitmap as its size and the (first, last) bit pairs of its runs of
+ * set bits (see bitstr2inx()). Unlike the hex mask, the size of this does
+ * not grow with the bitmap but with the number of runs, so the mostly
+ * contiguous node sets of jobs and steps stay small on large systems.
+ */
+#define pack_bit_str_runs(bitmap,buf) do {			\
+	assert(buf->magic == BUF_MAGIC);			\
+	if (bitmap) {						\
+		int32_t *_inx = bitstr2inx(bitmap);		\
+		uint32_t _cnt = 0;				\
+		while (_inx[_cnt] != -1)			\
+			_cnt++;					\
+		pack32((uint32_t) bit_size(bitmap), buf);	\
+		pack32_array((uint32_t *) _inx, _cnt, buf);	\
+		xfree(_inx);					\
+	} else							\
+		pack32(NO_VAL, buf);				\
+} while (0)
+
+#define unpack_bit_str_runs(bitmap,buf) do {				\
+	uint32_t _size, _cnt = 0, _i, *_inx = NULL;			\
+	assert(*bitmap == NULL);					\
+	assert(buf->magic == BUF_MAGIC);				\
+	safe_unpack32(&_size, buf);					\
+	if (_size != NO_VAL) {						\
+		if (unpack32_array(&_inx, &_cnt, buf) || (_cnt & 1)) {	\
+			xfree(_inx);					\
+			goto unpack_error;				\
+		}							\
+		*bitmap = bit_alloc(_size);				\
+		for (_i = 0; _i < _cnt; _i += 2) {			\
+			if ((_inx[_i] > _inx[_i + 1]) ||		\
+			    (_inx[_i + 1] >= _size))			\
+				break;					\
+			bit_nset(*bitmap, _inx[_i], _inx[_i + 1]);	\
+		}							\
+		xfree(_inx);						\
+		if (_i < _cnt) {					\
+			FREE_NULL_BITMAP(*bitmap);			\
+			goto unpack_error;				\
+		}							\
+	} else								\
+		*bitmap = NULL;						\
+} while (0)
+
 /* note: this would be faster if collapsed into a single function
  * rather than a combination of unpack_bit_str_hex and bitstr2inx */
 #define unpack_bit_str_hex_as_inx(inx, buf) do {	\
@@ -0,0 +1,282 @@
+/*****************************************************************************\
+ *  pack_schema.c - table driven packing of fixed layout records
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+/*
+ * Theory of operation:
+ * - A schema is a PACK_END terminated array of pack_field_t in wire order.
+ *   Fields newer than the protocol version in use are skipped.
+ * - Packing stores every field straight into the buffer through a local
+ *   cursor, growing the buffer only when the cursor reaches its end. The
+ *   callbacks of PACK_FIELD_FUNC entries use the usual pack.h functions and
+ *   grow the buffer themselves.
+ * - Unpacking checks the remaining length once for each run of consecutive
+ *   fixed width fields and then decodes them without further checks.
+ *   Strings go through unpackstr_xmalloc_chooser() so they are handled as
+ *   with safe_unpackstr_xmalloc().
+ */
+
+#include <arpa/inet.h>
+#include <string.h>
+
+#include "slurm/slurm_errno.h"
+
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/pack_schema.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+
+#define FIELD_PTR(_rec, _field) ((char *) (_rec) + (_field)->offset)
+
+static bool _is_fixed(pack_field_type_t type)
+{
+	return ((type == PACK_FIELD_U16) || (type == PACK_FIELD_U32) ||
+		(type == PACK_FIELD_U64) || (type == PACK_FIELD_TIME));
+}
+
+/* Size of a packed string, as packstr() would store it */
+static uint32_t _str_size(const char *str)
+{
+	size_t len;
+
+	if (!str)
+		return 0;
+	len = strlen(str) + 1;
+	if (len > MAX_PACK_MEM_LEN)
+		return 0;	/* packed as NULL, see _pack_run() */
+	return len;
+}
+
+static uint32_t _field_size(const pack_field_t *field, void *rec)
+{
+	switch (field->type) {
+	case PACK_FIELD_U16:
+		return sizeof(uint16_t);
+	case PACK_FIELD_U32:
+		return sizeof(uint32_t);
+	case PACK_FIELD_U64:
+	case PACK_FIELD_TIME:
+		return sizeof(uint64_t);
+	case PACK_FIELD_STR:
+		return sizeof(uint32_t) +
+		       _str_size(*(char **) FIELD_PTR(rec, field));
+	default:
+		return 0;
+	}
+}
+
+extern uint32_t pack_schema_size(const pack_field_t *schema, void *rec,
+				 uint16_t protocol_version)
+{
+	const pack_field_t *field;
+	uint32_t size = 0;
+
+	for (field = schema; field->type != PACK_FIELD_END; field++) {
+		if (protocol_version >= field->min_version)
+			size += _field_size(field, rec);
+	}
+
+	return size;
+}
+
+/* Make room for need more bytes, RET false if the buffer can not grow */
+static bool _reserve(Buf buffer, char **ptr, char **end, uint32_t need)
+{
+	bool rc;
+
+	buffer->processed = *ptr - buffer->head;
+	rc = (try_grow_buf_remaining(buffer, need) == SLURM_SUCCESS);
+	*ptr = &buffer->head[buffer->processed];
+	*end = &buffer->head[buffer->size];
+
+	return rc;
+}
+
+extern void pack_schema(const pack_field_t *schema, void *rec,
+			uint16_t protocol_version, Buf buffer)
+{
+	const pack_field_t *field;
+	char *ptr, *end, *str;
+	uint16_t n16;
+	uint32_t n32, len;
+	uint64_t n64;
+
+	xassert(buffer->magic == BUF_MAGIC);
+
+	/*
+	 * The cursor is kept in locals and only written back to the buffer
+	 * around callbacks and growth, which is where the gain over a pack.h
+	 * call per field comes from.
+	 */
+	ptr = &buffer->head[buffer->processed];
+	end = &buffer->head[buffer->size];
+	for (field = schema; field->type != PACK_FIELD_END; field++) {
+		if (protocol_version < field->min_version)
+			continue;
+		if ((field->type != PACK_FIELD_STR) &&
+		    (field->type != PACK_FIELD_FUNC) &&
+		    ((end - ptr) < sizeof(uint64_t)) &&
+		    !_reserve(buffer, &ptr, &end, sizeof(uint64_t)))
+			return;
+
+		switch (field->type) {
+		case PACK_FIELD_U16:
+			n16 = htons(*(uint16_t *) FIELD_PTR(rec, field));
+			memcpy(ptr, &n16, sizeof(n16));
+			ptr += sizeof(n16);
+			break;
+		case PACK_FIELD_U32:
+			n32 = htonl(*(uint32_t *) FIELD_PTR(rec, field));
+			memcpy(ptr, &n32, sizeof(n32));
+			ptr += sizeof(n32);
+			break;
+		case PACK_FIELD_U64:
+			n64 = HTON_uint64(*(uint64_t *) FIELD_PTR(rec, field));
+			memcpy(ptr, &n64, sizeof(n64));
+			ptr += sizeof(n64);
+			break;
+		case PACK_FIELD_TIME:
+			n64 = HTON_int64((int64_t)
+					 *(time_t *) FIELD_PTR(rec, field));
+			memcpy(ptr, &n64, sizeof(n64));
+			ptr += sizeof(n64);
+			break;
+		case PACK_FIELD_STR:
+			str = *(char **) FIELD_PTR(rec, field);
+			if (!(len = _str_size(str)) && str)
+				error("%s: string too large to pack, sent as NULL",
+				      __func__);
+			if (((end - ptr) < (sizeof(n32) + len)) &&
+			    !_reserve(buffer, &ptr, &end, sizeof(n32) + len))
+				return;
+			n32 = htonl(len);
+			memcpy(ptr, &n32, sizeof(n32));
+			ptr += sizeof(n32);
+			if (len) {
+				memcpy(ptr, str, len);
+				ptr += len;
+			}
+			break;
+		case PACK_FIELD_FUNC:
+			buffer->processed = ptr - buffer->head;
+			(field->pack)(rec, protocol_version, buffer);
+			ptr = &buffer->head[buffer->processed];
+			end = &buffer->head[buffer->size];
+			break;
+		default:
+			break;
+		}
+	}
+	buffer->processed = ptr - buffer->head;
+}
+
+extern int unpack_schema(const pack_field_t *schema, void *rec,
+			 uint16_t protocol_version, Buf buffer)
+{
+	const pack_field_t *field = schema, *run;
+	uint16_t n16;
+	uint32_t n32, size;
+	uint64_t n64;
+	char *ptr;
+
+	xassert(buffer->magic == BUF_MAGIC);
+
+	while (field->type != PACK_FIELD_END) {
+		if (protocol_version < field->min_version) {
+			field++;
+			continue;
+		}
+		if (field->type == PACK_FIELD_FUNC) {
+			if ((field->unpack)(rec, protocol_version, buffer))
+				return SLURM_ERROR;
+			field++;
+			continue;
+		}
+		if (field->type == PACK_FIELD_STR) {
+			if (unpackstr_xmalloc_chooser(
+				    (char **) FIELD_PTR(rec, field), &n32,
+				    buffer))
+				return SLURM_ERROR;
+			field++;
+			continue;
+		}
+
+		size = 0;
+		for (run = field; _is_fixed(run->type); run++) {
+			if (protocol_version >= run->min_version)
+				size += _field_size(run, rec);
+		}
+		if (remaining_buf(buffer) < size)
+			return SLURM_ERROR;
+
+		ptr = &buffer->head[buffer->processed];
+		for (; field != run; field++) {
+			if (protocol_version < field->min_version)
+				continue;
+			switch (field->type) {
+			case PACK_FIELD_U16:
+				memcpy(&n16, ptr, sizeof(n16));
+				*(uint16_t *) FIELD_PTR(rec, field) =
+					ntohs(n16);
+				ptr += sizeof(n16);
+				break;
+			case PACK_FIELD_U32:
+				memcpy(&n32, ptr, sizeof(n32));
+				*(uint32_t *) FIELD_PTR(rec, field) =
+					ntohl(n32);
+				ptr += sizeof(n32);
+				break;
+			case PACK_FIELD_U64:
+				memcpy(&n64, ptr, sizeof(n64));
+				*(uint64_t *) FIELD_PTR(rec, field) =
+					NTOH_uint64(n64);
+				ptr += sizeof(n64);
+				break;
+			case PACK_FIELD_TIME:
+				memcpy(&n64, ptr, sizeof(n64));
+				*(time_t *) FIELD_PTR(rec, field) =
+					(time_t) NTOH_int64((int64_t) n64);
+				ptr += sizeof(n64);
+				break;
+			default:
+				break;
+			}
+		}
+		buffer->processed = ptr - buffer->head;
+	}
+
+	return SLURM_SUCCESS;
+}
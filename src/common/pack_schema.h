@@ -0,0 +1,122 @@
+/*****************************************************************************\
+ *  pack_schema.h - table driven packing of fixed layout records
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#ifndef _PACK_SCHEMA_H
+#define _PACK_SCHEMA_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "src/common/pack.h"
+
+/*
+ * A record layout is described once as a table of fields, in wire order,
+ * each tagged with the protocol version it first appeared in. The same table
+ * drives packing, unpacking and sizing, replacing the hand written sequences
+ * of pack32()/packstr() calls repeated for every protocol version.
+ *
+ * Fields are encoded exactly as the matching pack.h function would, so a
+ * table can replace existing hand written code without changing the wire.
+ */
+typedef enum {
+	PACK_FIELD_END = 0,
+	PACK_FIELD_U16,		/* pack16() */
+	PACK_FIELD_U32,		/* pack32() */
+	PACK_FIELD_U64,		/* pack64() */
+	PACK_FIELD_TIME,	/* pack_time() */
+	PACK_FIELD_STR,		/* packstr() */
+	PACK_FIELD_FUNC,	/* anything else, through callbacks */
+} pack_field_type_t;
+
+typedef void (*pack_field_pack_f)(void *rec, uint16_t protocol_version,
+				  Buf buffer);
+typedef int (*pack_field_unpack_f)(void *rec, uint16_t protocol_version,
+				   Buf buffer);
+
+typedef struct {
+	pack_field_type_t type;
+	uint16_t min_version;	/* first protocol version with this field */
+	uint32_t offset;	/* of the member in the record */
+	pack_field_pack_f pack;		/* PACK_FIELD_FUNC only */
+	pack_field_unpack_f unpack;	/* PACK_FIELD_FUNC only */
+} pack_field_t;
+
+/* Fails to compile if the member is not of the size the wire type needs */
+#define _PACK_MEMBER(_type, _member, _size)				\
+	(offsetof(_type, _member) +					\
+	 0 * sizeof(char[(sizeof(((_type *) 0)->_member) == (_size)) ?	\
+			 1 : -1]))
+
+#define PACK_U16(_type, _member, _ver)					\
+	{ PACK_FIELD_U16, _ver, _PACK_MEMBER(_type, _member, 2), NULL, NULL }
+#define PACK_U32(_type, _member, _ver)					\
+	{ PACK_FIELD_U32, _ver, _PACK_MEMBER(_type, _member, 4), NULL, NULL }
+#define PACK_U64(_type, _member, _ver)					\
+	{ PACK_FIELD_U64, _ver, _PACK_MEMBER(_type, _member, 8), NULL, NULL }
+#define PACK_TIME(_type, _member, _ver)					\
+	{ PACK_FIELD_TIME, _ver,					\
+	  _PACK_MEMBER(_type, _member, sizeof(time_t)), NULL, NULL }
+#define PACK_STR(_type, _member, _ver)					\
+	{ PACK_FIELD_STR, _ver,						\
+	  _PACK_MEMBER(_type, _member, sizeof(char *)), NULL, NULL }
+/* The callbacks are given the whole record */
+#define PACK_FUNC(_pack, _unpack, _ver)					\
+	{ PACK_FIELD_FUNC, _ver, 0, _pack, _unpack }
+#define PACK_END							\
+	{ PACK_FIELD_END, 0, 0, NULL, NULL }
+
+/*
+ * Return the number of bytes the fields of the table, other than
+ * PACK_FIELD_FUNC ones, take once packed. Use it to size a buffer before
+ * packing many records.
+ */
+extern uint32_t pack_schema_size(const pack_field_t *schema, void *rec,
+				 uint16_t protocol_version);
+
+/* Pack rec as described by schema */
+extern void pack_schema(const pack_field_t *schema, void *rec,
+			uint16_t protocol_version, Buf buffer);
+
+/*
+ * Unpack into rec as described by schema. The length of each run of fixed
+ * width fields is checked at once. Strings are xmalloc'd. On error the
+ * fields already unpacked are left in rec to be freed by the caller.
+ * RET SLURM_SUCCESS or SLURM_ERROR
+ */
+extern int unpack_schema(const pack_field_t *schema, void *rec,
+			 uint16_t protocol_version, Buf buffer);
+
+#endif /* !_PACK_SCHEMA_H */
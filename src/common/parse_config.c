@@ -40,7 +40,6 @@
 \*****************************************************************************/
 
 #include <ctype.h>
-#include <regex.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -88,33 +87,6 @@ strong_alias(transfer_s_p_options,	slurm_transfer_s_p_options);
 
 #define CONF_HASH_LEN 173
 
-static regex_t keyvalue_re;
-static char *keyvalue_pattern =
-	"^[[:space:]]*"
-	"([[:alnum:]_.]+)" /* key */
-	"[[:space:]]*([-*+/]?)=[[:space:]]*"
-	"((\"([^\"]*)\")|([^[:space:]]+))" /* value: quoted with whitespace,
-					    * or unquoted and no whitespace */
-	"([[:space:]]|$)";
-static bool keyvalue_initialized = false;
-static bool pthread_atfork_set = false;
-
-/* The following mutex and atfork() handler protect against receiving
- * a corrupted keyvalue_re state in a forked() child. While regexec() itself
- * appears to be thread-safe (due to internal locking), a process fork()'d
- * while a regexec() is running in a separate thread will inherit an internally
- * locked keyvalue_re leading to deadlock. This appears to have been fixed in
- * glibc with a release in 2013, although I do not know the exact version.
- */
-static pthread_mutex_t s_p_lock = PTHREAD_MUTEX_INITIALIZER;
-
-static void _s_p_atfork_child(void)
-{
-	slurm_mutex_init(&s_p_lock);
-	keyvalue_initialized = false;
-	pthread_atfork_set = false;
-}
-
 struct s_p_values {
 	char *key;
 	int type;
@@ -290,35 +262,6 @@ void s_p_hashtbl_destroy(s_p_hashtbl_t *hashtbl) {
 		}
 	}
 	xfree(hashtbl);
-
-	/*
-	 * Now clear the global variables to free their memory as well.
-	 */
-	slurm_mutex_lock(&s_p_lock);
-	if (keyvalue_initialized) {
-		regfree(&keyvalue_re);
-		keyvalue_initialized = false;
-	}
-	slurm_mutex_unlock(&s_p_lock);
-
-}
-
-static void _keyvalue_regex_init(void)
-{
-	slurm_mutex_lock(&s_p_lock);
-	if (!keyvalue_initialized) {
-		if (regcomp(&keyvalue_re, keyvalue_pattern,
-			    REG_EXTENDED) != 0) {
-			/* FIXME - should be fatal? */
-			error("keyvalue regex compilation failed");
-		}
-		keyvalue_initialized = true;
-	}
-	if (!pthread_atfork_set) {
-		pthread_atfork(NULL, NULL, _s_p_atfork_child);
-		pthread_atfork_set = true;
-	}
-	slurm_mutex_unlock(&s_p_lock);
 }
 
 /*
@@ -328,52 +271,71 @@ static void _keyvalue_regex_init(void)
  * OUT remaining - pointer into the "line" string denoting the start
  *                 of the unsearched portion of the string
  * Return 0 when a key-value pair is found, and -1 otherwise.
+ *
+ * The pair is optional white space, a key of alphanumeric characters, '_'
+ * and '.', optional white space, an optional operator ('+', '-', '*' or '/'),
+ * '=', optional white space and a value. The value is either enclosed in
+ * double quotes, which are removed and may contain white space, or runs up to
+ * the next white space. The value must be followed by white space or the end
+ * of the line.
  */
-static int _keyvalue_regex(const char *line,
+static int _keyvalue_parse(const char *line,
 			   char **key, char **value, char **remaining,
 			   slurm_parser_operator_t *operator)
 {
-	size_t nmatch = 8;
-	regmatch_t pmatch[8];
-	char op;
+	const char *ptr = line, *key_start, *key_end, *val_start, *val_end;
+	slurm_parser_operator_t op = S_P_OPERATOR_SET;
 
 	*key = NULL;
 	*value = NULL;
 	*remaining = (char *)line;
 	*operator = S_P_OPERATOR_SET;
-	memset(pmatch, 0, sizeof(regmatch_t)*nmatch);
 
-	if (regexec(&keyvalue_re, line, nmatch, pmatch, 0)
-	    == REG_NOMATCH) {
+	while (isspace((unsigned char) *ptr))
+		ptr++;
+	key_start = ptr;
+	while (isalnum((unsigned char) *ptr) || (*ptr == '_') || (*ptr == '.'))
+		ptr++;
+	if (ptr == key_start)
 		return -1;
-	}
-
-	*key = (char *)(xstrndup(line + pmatch[1].rm_so,
-				 pmatch[1].rm_eo - pmatch[1].rm_so));
-	if (pmatch[2].rm_so != -1 &&
-	    (pmatch[2].rm_so != pmatch[2].rm_eo)) {
-		op = *(line + pmatch[2].rm_so);
-		if (op == '+') {
-			*operator = S_P_OPERATOR_ADD;
-		} else if (op == '-') {
-			*operator = S_P_OPERATOR_SUB;
-		} else if (op == '*') {
-			*operator = S_P_OPERATOR_MUL;
-		} else if (op == '/') {
-			*operator = S_P_OPERATOR_DIV;
-		}
-	}
-	if (pmatch[5].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[5].rm_so,
-					   pmatch[5].rm_eo - pmatch[5].rm_so));
-	} else if (pmatch[6].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[6].rm_so,
-					   pmatch[6].rm_eo - pmatch[6].rm_so));
+	key_end = ptr;
+
+	while (isspace((unsigned char) *ptr))
+		ptr++;
+	if (*ptr == '+')
+		op = S_P_OPERATOR_ADD;
+	else if (*ptr == '-')
+		op = S_P_OPERATOR_SUB;
+	else if (*ptr == '*')
+		op = S_P_OPERATOR_MUL;
+	else if (*ptr == '/')
+		op = S_P_OPERATOR_DIV;
+	if (op != S_P_OPERATOR_SET)
+		ptr++;
+	if (*ptr != '=')
+		return -1;
+	ptr++;
+	while (isspace((unsigned char) *ptr))
+		ptr++;
+
+	if ((*ptr == '"') && (val_end = strchr(ptr + 1, '"')) &&
+	    ((val_end[1] == '\0') || isspace((unsigned char) val_end[1]))) {
+		val_start = ptr + 1;
+		ptr = val_end + 1;
 	} else {
-		*value = xstrdup("");
+		/* Also used for a quoted value not followed by white space */
+		val_start = ptr;
+		while (*ptr && !isspace((unsigned char) *ptr))
+			ptr++;
+		if (ptr == val_start)
+			return -1;
+		val_end = ptr;
 	}
 
-	*remaining = (char *)(line + pmatch[3].rm_eo);
+	*key = xstrndup(key_start, key_end - key_start);
+	*value = xstrndup(val_start, val_end - val_start);
+	*operator = op;
+	*remaining = (char *)ptr;
 
 	return 0;
 }
@@ -1011,9 +973,7 @@ int s_p_parse_line(s_p_hashtbl_t *hashtbl, const char *line, char **leftover)
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	_keyvalue_regex_init();
-
-	while (_keyvalue_regex(ptr, &key, &value, &new_leftover, &op) == 0) {
+	while (_keyvalue_parse(ptr, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			_handle_keyvalue_match(p, value,
@@ -1045,9 +1005,7 @@ static int _parse_next_key(s_p_hashtbl_t *hashtbl,
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	_keyvalue_regex_init();
-
-	if (_keyvalue_regex(line, &key, &value, &new_leftover, &op) == 0) {
+	if (_keyvalue_parse(line, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			_handle_keyvalue_match(p, value,
@@ -1193,7 +1151,6 @@ int s_p_parse_file(s_p_hashtbl_t *hashtbl, uint32_t *hash_val, char *filename,
 		return SLURM_ERROR;
 	}
 
-	_keyvalue_regex_init();
 	for (i = 0; ; i++) {
 		if (i == 1) {	/* Long once, on first retry */
 			error("s_p_parse_file: unable to status file %s: %m, "
@@ -1279,7 +1236,6 @@ int s_p_parse_buffer(s_p_hashtbl_t *hashtbl, uint32_t *hash_val,
 	}
 
 	line_number = 0;
-	_keyvalue_regex_init();
 	while (remaining_buf(buffer) > 0) {
 		safe_unpackstr_xmalloc(&tmp_str, &utmp32, buffer);
 		if (tmp_str != NULL) {
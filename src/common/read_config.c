@@ -123,7 +123,6 @@ static bool     no_addr_cache = false;
 inline static void _normalize_debug_level(uint16_t *level);
 static int _init_slurm_conf(const char *file_name);
 
-#define NAME_HASH_LEN 512
 typedef struct names_ll_s {
 	char *alias;	/* NodeName */
 	char *hostname;	/* NodeHostname */
@@ -139,12 +138,25 @@ typedef struct names_ll_s {
 	uint64_t mem_spec_limit;
 	slurm_addr_t addr;
 	bool addr_initialized;
-	struct names_ll_s *next_alias;
-	struct names_ll_s *next_hostname;
 } names_ll_t;
 static bool nodehash_initialized = false;
-static names_ll_t *host_to_node_hashtbl[NAME_HASH_LEN] = {NULL};
-static names_ll_t *node_to_host_hashtbl[NAME_HASH_LEN] = {NULL};
+static names_ll_t **name_recs = NULL;	/* in the order registered */
+static int name_rec_cnt = 0;
+static int name_rec_size = 0;
+
+/*
+ * NodeName, NodeHostname and NodeAddr indexes of name_recs. Each is an open
+ * addressing hash table of name_inx_size slots (a power of 2) kept at most
+ * half full, so records with equal keys are found in the order registered.
+ */
+#define NAME_INX_ALIAS		0
+#define NAME_INX_HOSTNAME	1
+#define NAME_INX_ADDRESS	2
+#define NAME_INX_CNT		3
+static names_ll_t **name_inx[NAME_INX_CNT] = { NULL };
+static uint32_t name_inx_size = 0;
+static uint32_t name_inx_used = 0;	/* slots used, including removed */
+static names_ll_t name_removed;		/* marks the slot of a removed key */
 
 typedef struct slurm_conf_server {
 	char *hostname;
@@ -1973,22 +1985,23 @@ extern int slurm_conf_downnodes_array(slurm_conf_downnodes_t **ptr_array[])
 static void _free_name_hashtbl(void)
 {
 	int i;
-	names_ll_t *p, *q;
-
-	for (i=0; i<NAME_HASH_LEN; i++) {
-		p = node_to_host_hashtbl[i];
-		while (p) {
-			xfree(p->address);
-			xfree(p->alias);
-			xfree(p->cpu_spec_list);
-			xfree(p->hostname);
-			q = p->next_alias;
-			xfree(p);
-			p = q;
-		}
-		node_to_host_hashtbl[i] = NULL;
-		host_to_node_hashtbl[i] = NULL;
+	names_ll_t *p;
+
+	for (i = 0; i < name_rec_cnt; i++) {
+		p = name_recs[i];
+		xfree(p->address);
+		xfree(p->alias);
+		xfree(p->cpu_spec_list);
+		xfree(p->hostname);
+		xfree(p);
 	}
+	xfree(name_recs);
+	name_rec_cnt = 0;
+	name_rec_size = 0;
+	for (i = 0; i < NAME_INX_CNT; i++)
+		xfree(name_inx[i]);
+	name_inx_size = 0;
+	name_inx_used = 0;
 	nodehash_initialized = false;
 }
 
@@ -1997,25 +2010,117 @@ static void _init_name_hashtbl(void)
 	return;
 }
 
-static int _get_hash_idx(const char *name)
+static char *_name_key(names_ll_t *p, int inx)
 {
-	int index = 0;
-	int j;
+	if (inx == NAME_INX_ALIAS)
+		return p->alias;
+	if (inx == NAME_INX_HOSTNAME)
+		return p->hostname;
+	return p->address;
+}
 
-	if (name == NULL)
-		return 0;	/* degenerate case */
+static uint32_t _name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;	/* 32-bit FNV-1a */
 
-	/* Multiply each character by its numerical position in the
-	 * name string to add a bit of entropy, because host names such
-	 * as cluster[0001-1000] can cause excessive index collisions.
-	 */
-	for (j = 1; *name; name++, j++)
-		index += (int)*name * j;
-	index %= NAME_HASH_LEN;
-	while (index < 0) /* Coverity thinks "index" could be negative with "if" */
-		index += NAME_HASH_LEN;
+	for ( ; *name; name++) {
+		hash ^= (unsigned char) *name;
+		hash *= 16777619;
+	}
+	return hash;
+}
+
+static void _name_inx_add(int inx, names_ll_t *p)
+{
+	char *key = _name_key(p, inx);
+	uint32_t mask = name_inx_size - 1, slot;
+
+	if (!key)
+		return;
+	slot = _name_hash(key) & mask;
+	while (name_inx[inx][slot])
+		slot = (slot + 1) & mask;
+	name_inx[inx][slot] = p;
+}
+
+/* Rebuild all indexes from name_recs, leaving them at most 1/4 full */
+static void _name_inx_rebuild(void)
+{
+	int i, j;
+
+	name_inx_size = 64;
+	while (name_inx_size < (name_rec_cnt * 4))
+		name_inx_size *= 2;
+	for (j = 0; j < NAME_INX_CNT; j++) {
+		xfree(name_inx[j]);
+		name_inx[j] = xcalloc(name_inx_size, sizeof(names_ll_t *));
+		for (i = 0; i < name_rec_cnt; i++)
+			_name_inx_add(j, name_recs[i]);
+	}
+	name_inx_used = name_rec_cnt;
+}
+
+/*
+ * Return the next record with the given key from an index
+ * IN/OUT slot - position of the previous match, NO_VAL on the first call
+ */
+static names_ll_t *_name_inx_next(int inx, const char *key, uint32_t *slot)
+{
+	uint32_t mask = name_inx_size - 1;
+	names_ll_t *p;
+
+	if (!name_inx_size || !key)
+		return NULL;
+	if (*slot == NO_VAL)
+		*slot = _name_hash(key) & mask;
+	else
+		*slot = (*slot + 1) & mask;
+	while ((p = name_inx[inx][*slot])) {
+		if ((p != &name_removed) && !xstrcmp(_name_key(p, inx), key))
+			return p;
+		*slot = (*slot + 1) & mask;
+	}
+	return NULL;
+}
+
+static names_ll_t *_name_inx_find(int inx, const char *key)
+{
+	uint32_t slot = NO_VAL;
 
-	return index;
+	return _name_inx_next(inx, key, &slot);
+}
+
+/* Change the NodeHostname or NodeAddr of a record and its index entry */
+static void _name_inx_update(int inx, names_ll_t *p, char *key)
+{
+	uint32_t slot = NO_VAL;
+	names_ll_t *q;
+
+	while ((q = _name_inx_next(inx, _name_key(p, inx), &slot))) {
+		if (q == p) {
+			name_inx[inx][slot] = &name_removed;
+			break;
+		}
+	}
+	if (inx == NAME_INX_HOSTNAME) {
+		xfree(p->hostname);
+		p->hostname = xstrdup(key);
+	} else {
+		xfree(p->address);
+		p->address = xstrdup(key);
+	}
+	/*
+	 * Records sharing a key are found in registration order. Adding p at
+	 * the end of its probe chain would put it after records registered
+	 * later, so rebuild if the new key is already in use.
+	 */
+	if ((((name_inx_used + 1) * 2) > name_inx_size) ||
+	    _name_inx_find(inx, key)) {
+		_name_inx_rebuild();
+	} else {
+		_name_inx_add(inx, p);
+		name_inx_used++;
+	}
 }
 
 static void _push_to_hashtbls(char *alias, char *hostname,
@@ -2027,54 +2132,43 @@ static void _push_to_hashtbls(char *alias, char *hostname,
 			      uint64_t mem_spec_limit, slurm_addr_t *addr,
 			      bool initialized)
 {
-	int hostname_idx, alias_idx;
+	int i;
 	names_ll_t *p, *new;
 
-	alias_idx = _get_hash_idx(alias);
-	hostname_idx = _get_hash_idx(hostname);
-
 #if !defined(HAVE_FRONT_END) && !defined(MULTIPLE_SLURMD)
 	/* Ensure only one slurmd configured on each host */
-	p = host_to_node_hashtbl[hostname_idx];
-	while (p) {
-		if (xstrcmp(p->hostname, hostname) == 0) {
-			error("Duplicated NodeHostName %s in the config file",
-			      hostname);
-			return;
-		}
-		p = p->next_hostname;
+	if (_name_inx_find(NAME_INX_HOSTNAME, hostname)) {
+		error("Duplicated NodeHostName %s in the config file",
+		      hostname);
+		return;
 	}
 #endif
 	/* Ensure only one instance of each NodeName */
-	p = node_to_host_hashtbl[alias_idx];
-	while (p) {
-		if (xstrcmp(p->alias, alias) == 0) {
-			if (front_end) {
-				if (local_test_config) {
-					error("Frontend not configured correctly "
-					      "in slurm.conf.  See man slurm.conf "
-					      "look for frontendname.");
-					local_test_config = 1;
-				} else {
-					fatal("Frontend not configured correctly "
-					      "in slurm.conf.  See man slurm.conf "
-					      "look for frontendname.");
-				}
-			}
+	if ((p = _name_inx_find(NAME_INX_ALIAS, alias))) {
+		if (front_end) {
 			if (local_test_config) {
-				error("Duplicated NodeName %s in the config file",
-				      p->alias);
+				error("Frontend not configured correctly "
+				      "in slurm.conf.  See man slurm.conf "
+				      "look for frontendname.");
 				local_test_config = 1;
 			} else {
-				fatal("Duplicated NodeName %s in the config file",
-				      p->alias);
+				fatal("Frontend not configured correctly "
+				      "in slurm.conf.  See man slurm.conf "
+				      "look for frontendname.");
 			}
-			return;
 		}
-		p = p->next_alias;
+		if (local_test_config) {
+			error("Duplicated NodeName %s in the config file",
+			      p->alias);
+			local_test_config = 1;
+		} else {
+			fatal("Duplicated NodeName %s in the config file",
+			      p->alias);
+		}
+		return;
 	}
 
-	/* Create the new data structure and link it into the hash tables */
+	/* Create the new data structure and add it to the indexes */
 	new = xmalloc(sizeof(*new));
 	new->alias	= xstrdup(alias);
 	new->hostname	= xstrdup(hostname);
@@ -2093,25 +2187,17 @@ static void _push_to_hashtbls(char *alias, char *hostname,
 	if (addr)
 		memcpy(&new->addr, addr, sizeof(slurm_addr_t));
 
-	/* Put on end of each list */
-	new->next_alias	= NULL;
-	if (node_to_host_hashtbl[alias_idx]) {
-		p = node_to_host_hashtbl[alias_idx];
-		while (p->next_alias)
-			p = p->next_alias;
-		p->next_alias = new;
-	} else {
-		node_to_host_hashtbl[alias_idx] = new;
+	if (name_rec_cnt >= name_rec_size) {
+		name_rec_size = MAX(64, name_rec_size * 2);
+		xrealloc(name_recs, name_rec_size * sizeof(names_ll_t *));
 	}
-
-	new->next_hostname = NULL;
-	if (host_to_node_hashtbl[hostname_idx]) {
-		p = host_to_node_hashtbl[hostname_idx];
-		while (p->next_hostname)
-			p = p->next_hostname;
-		p->next_hostname = new;
+	name_recs[name_rec_cnt++] = new;
+	if (((name_inx_used + 1) * 2) > name_inx_size) {
+		_name_inx_rebuild();
 	} else {
-		host_to_node_hashtbl[hostname_idx] = new;
+		for (i = 0; i < NAME_INX_CNT; i++)
+			_name_inx_add(i, new);
+		name_inx_used++;
 	}
 }
 
@@ -2367,19 +2453,12 @@ static void _init_slurmd_nodehash(void)
  */
 static char *_internal_get_hostname(const char *node_name)
 {
-	int idx;
 	names_ll_t *p;
 
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-			return xstrdup(p->hostname);
-		}
-		p = p->next_alias;
-	}
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name)))
+		return xstrdup(p->hostname);
 	return NULL;
 }
 
@@ -2406,7 +2485,6 @@ extern char *slurm_conf_get_hostname(const char *node_name)
 extern char *slurm_conf_get_nodename(const char *node_hostname)
 {
 	char *alias = NULL;
-	int idx;
 	names_ll_t *p;
 #ifdef HAVE_FRONT_END
 	slurm_conf_frontend_t *front_end_ptr = NULL;
@@ -2429,15 +2507,8 @@ extern char *slurm_conf_get_nodename(const char *node_hostname)
 #endif
 
 	_init_slurmd_nodehash();
-	idx = _get_hash_idx(node_hostname);
-	p = host_to_node_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->hostname, node_hostname) == 0) {
-			alias = xstrdup(p->alias);
-			break;
-		}
-		p = p->next_hostname;
-	}
+	if ((p = _name_inx_find(NAME_INX_HOSTNAME, node_hostname)))
+		alias = xstrdup(p->alias);
 	slurm_conf_unlock();
 
 	return alias;
@@ -2453,27 +2524,21 @@ extern char *slurm_conf_get_nodename(const char *node_hostname)
  */
 extern char *slurm_conf_get_aliases(const char *node_hostname)
 {
-	int idx;
+	uint32_t slot = NO_VAL;
 	names_ll_t *p;
 	char *aliases = NULL;
 	char *s = NULL;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
-	idx = _get_hash_idx(node_hostname);
-
-	p = host_to_node_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->hostname, node_hostname) == 0) {
-			if ( aliases == NULL )
-				aliases = xstrdup(p->alias);
-			else {
-				s = xstrdup_printf("%s %s",aliases,p->alias);
-				xfree(aliases);
-				aliases = s;
-			}
+	while ((p = _name_inx_next(NAME_INX_HOSTNAME, node_hostname, &slot))) {
+		if ( aliases == NULL )
+			aliases = xstrdup(p->alias);
+		else {
+			s = xstrdup_printf("%s %s",aliases,p->alias);
+			xfree(aliases);
+			aliases = s;
 		}
-		p = p->next_hostname;
 	}
 	slurm_conf_unlock();
 
@@ -2488,25 +2553,18 @@ extern char *slurm_conf_get_aliases(const char *node_hostname)
  */
 extern char *slurm_conf_get_nodeaddr(const char *node_hostname)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
-	idx = _get_hash_idx(node_hostname);
-
-	p = host_to_node_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->hostname, node_hostname) == 0) {
-			char *nodeaddr;
-			if (p->address != NULL)
-				nodeaddr = xstrdup(p->address);
-			else
-				nodeaddr = NULL;
-			slurm_conf_unlock();
-			return nodeaddr;
-		}
-		p = p->next_hostname;
+	if ((p = _name_inx_find(NAME_INX_HOSTNAME, node_hostname))) {
+		char *nodeaddr;
+		if (p->address != NULL)
+			nodeaddr = xstrdup(p->address);
+		else
+			nodeaddr = NULL;
+		slurm_conf_unlock();
+		return nodeaddr;
 	}
 	slurm_conf_unlock();
 
@@ -2524,24 +2582,34 @@ extern char *slurm_conf_get_nodename_from_addr(const char *node_addr)
 	char hostname[NI_MAXHOST];
 	unsigned long addr = inet_addr(node_addr);
 	char *start_name, *ret_name = NULL, *dot_ptr;
+	uint32_t slot = NO_VAL;
+	names_ll_t *p;
 
 	if (get_name_info((struct sockaddr *)&addr,
-			  sizeof(addr), hostname) != 0) {
-		error("%s: No node found with addr %s", __func__, node_addr);
-		return NULL;
-	}
+			  sizeof(addr), hostname) == 0) {
+		if (!xstrcmp(hostname, "localhost")) {
+			start_name = xshort_hostname();
+		} else {
+			start_name = xstrdup(hostname);
+			dot_ptr = strchr(start_name, '.');
+			if (dot_ptr)
+				dot_ptr[0] = '\0';
+		}
 
-	if (!xstrcmp(hostname, "localhost")) {
-		start_name = xshort_hostname();
-	} else {
-		start_name = xstrdup(hostname);
-		dot_ptr = strchr(start_name, '.');
-		if (dot_ptr)
-			dot_ptr[0] = '\0';
+		ret_name = slurm_conf_get_aliases(start_name);
+		xfree(start_name);
+		if (ret_name)
+			return ret_name;
 	}
 
-	ret_name = slurm_conf_get_aliases(start_name);
-	xfree(start_name);
+	/* No name from reverse DNS, try the nodes configured with NodeAddr */
+	slurm_conf_lock();
+	_init_slurmd_nodehash();
+	while ((p = _name_inx_next(NAME_INX_ADDRESS, node_addr, &slot)))
+		xstrfmtcat(ret_name, "%s%s", ret_name ? " " : "", p->alias);
+	slurm_conf_unlock();
+	if (!ret_name)
+		error("%s: No node found with addr %s", __func__, node_addr);
 
 	return ret_name;
 }
@@ -2603,24 +2671,18 @@ extern char *slurm_conf_get_aliased_nodename()
  */
 extern uint16_t slurm_conf_get_port(const char *node_name)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-			uint16_t port;
-			if (!p->port)
-				p->port = (uint16_t) conf_ptr->slurmd_port;
-			port = p->port;
-			slurm_conf_unlock();
-			return port;
-		}
-		p = p->next_alias;
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name))) {
+		uint16_t port;
+		if (!p->port)
+			p->port = (uint16_t) conf_ptr->slurmd_port;
+		port = p->port;
+		slurm_conf_unlock();
+		return port;
 	}
 	slurm_conf_unlock();
 
@@ -2633,28 +2695,18 @@ extern uint16_t slurm_conf_get_port(const char *node_name)
 extern void slurm_reset_alias(char *node_name, char *node_addr,
 			      char *node_hostname)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-			if (node_addr) {
-				xfree(p->address);
-				p->address = xstrdup(node_addr);
-				p->addr_initialized = false;
-			}
-			if (node_hostname) {
-				xfree(p->hostname);
-				p->hostname = xstrdup(node_hostname);
-			}
-			break;
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name))) {
+		if (node_addr) {
+			_name_inx_update(NAME_INX_ADDRESS, p, node_addr);
+			p->addr_initialized = false;
 		}
-		p = p->next_alias;
+		if (node_hostname)
+			_name_inx_update(NAME_INX_HOSTNAME, p, node_hostname);
 	}
 	slurm_conf_unlock();
 
@@ -2667,33 +2719,27 @@ extern void slurm_reset_alias(char *node_name, char *node_addr,
  */
 extern int slurm_conf_get_addr(const char *node_name, slurm_addr_t *address)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-			if (!p->port)
-				p->port = (uint16_t) conf_ptr->slurmd_port;
-			if (!p->addr_initialized) {
-				slurm_set_addr(&p->addr, p->port, p->address);
-				if (p->addr.sin_family == 0 &&
-				    p->addr.sin_port == 0) {
-					slurm_conf_unlock();
-					return SLURM_ERROR;
-				}
-				if (!no_addr_cache)
-					p->addr_initialized = true;
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name))) {
+		if (!p->port)
+			p->port = (uint16_t) conf_ptr->slurmd_port;
+		if (!p->addr_initialized) {
+			slurm_set_addr(&p->addr, p->port, p->address);
+			if (p->addr.sin_family == 0 &&
+			    p->addr.sin_port == 0) {
+				slurm_conf_unlock();
+				return SLURM_ERROR;
 			}
-			*address = p->addr;
-			slurm_conf_unlock();
-			return SLURM_SUCCESS;
+			if (!no_addr_cache)
+				p->addr_initialized = true;
 		}
-		p = p->next_alias;
+		*address = p->addr;
+		slurm_conf_unlock();
+		return SLURM_SUCCESS;
 	}
 	slurm_conf_unlock();
 
@@ -2711,30 +2757,24 @@ extern int slurm_conf_get_cpus_bsct(const char *node_name,
 				    uint16_t *sockets, uint16_t *cores,
 				    uint16_t *threads)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-		    	if (cpus)
-				*cpus    = p->cpus;
-			if (boards)
-				*boards  = p->boards;
-			if (sockets)
-				*sockets = p->sockets;
-			if (cores)
-				*cores   = p->cores;
-			if (threads)
-				*threads = p->threads;
-			slurm_conf_unlock();
-			return SLURM_SUCCESS;
-		}
-		p = p->next_alias;
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name))) {
+		if (cpus)
+			*cpus    = p->cpus;
+		if (boards)
+			*boards  = p->boards;
+		if (sockets)
+			*sockets = p->sockets;
+		if (cores)
+			*cores   = p->cores;
+		if (threads)
+			*threads = p->threads;
+		slurm_conf_unlock();
+		return SLURM_SUCCESS;
 	}
 	slurm_conf_unlock();
 
@@ -2751,26 +2791,20 @@ extern int slurm_conf_get_res_spec_info(const char *node_name,
 					uint16_t *core_spec_cnt,
 					uint64_t *mem_spec_limit)
 {
-	int idx;
 	names_ll_t *p;
 
 	slurm_conf_lock();
 	_init_slurmd_nodehash();
 
-	idx = _get_hash_idx(node_name);
-	p = node_to_host_hashtbl[idx];
-	while (p) {
-		if (xstrcmp(p->alias, node_name) == 0) {
-			if (core_spec_cnt)
-				*cpu_spec_list = xstrdup(p->cpu_spec_list);
-			if (core_spec_cnt)
-				*core_spec_cnt  = p->core_spec_cnt;
-			if (mem_spec_limit)
-				*mem_spec_limit = p->mem_spec_limit;
-			slurm_conf_unlock();
-			return SLURM_SUCCESS;
-		}
-		p = p->next_alias;
+	if ((p = _name_inx_find(NAME_INX_ALIAS, node_name))) {
+		if (core_spec_cnt)
+			*cpu_spec_list = xstrdup(p->cpu_spec_list);
+		if (core_spec_cnt)
+			*core_spec_cnt  = p->core_spec_cnt;
+		if (mem_spec_limit)
+			*mem_spec_limit = p->mem_spec_limit;
+		slurm_conf_unlock();
+		return SLURM_SUCCESS;
 	}
 	slurm_conf_unlock();
 
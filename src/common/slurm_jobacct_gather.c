@@ -758,6 +758,34 @@ extern jobacctinfo_t *jobacct_gather_stat_task(pid_t pid)
 	return NULL;
 }
 
+extern int jobacct_gather_stat_all_task(jobacctinfo_t *jobacct)
+{
+	struct jobacctinfo *task_jobacct = NULL;
+	ListIterator itr = NULL;
+	int task_cnt = 0;
+
+	if (!plugin_polling || _jobacct_shutdown_test())
+		return 0;
+
+	_poll_data(0);
+
+	slurm_mutex_lock(&task_list_lock);
+	if (!task_list) {
+		error("no task list created!");
+		slurm_mutex_unlock(&task_list_lock);
+		return 0;
+	}
+	itr = list_iterator_create(task_list);
+	while ((task_jobacct = list_next(itr))) {
+		jobacctinfo_aggregate(jobacct, task_jobacct);
+		task_cnt++;
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&task_list_lock);
+
+	return task_cnt;
+}
+
 extern jobacctinfo_t *jobacct_gather_remove_task(pid_t pid)
 {
 	struct jobacctinfo *jobacct = NULL;
@@ -143,6 +143,13 @@ extern int jobacct_gather_add_task(pid_t pid, jobacct_id_t *jobacct_id,
 				   int poll);
 /* must free jobacctinfo_t if not NULL */
 extern jobacctinfo_t *jobacct_gather_stat_task(pid_t pid);
+/*
+ * Poll once and aggregate the usage of every task being tracked into
+ * jobacct. Cheaper than calling jobacct_gather_stat_task() for each task,
+ * which polls every time.
+ * RET count of tasks aggregated
+ */
+extern int jobacct_gather_stat_all_task(jobacctinfo_t *jobacct);
 /* must free jobacctinfo_t if not NULL */
 extern jobacctinfo_t *jobacct_gather_remove_task(pid_t pid);
 
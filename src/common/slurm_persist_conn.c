@@ -747,13 +747,13 @@ extern int slurm_persist_conn_process_msg(slurm_persist_conn_t *persist_conn,
 
 /* Wait until a file is writeable,
  * RET 1 if file can be written now,
- *     0 if can not be written to within 5 seconds
+ *     0 if can not be written to within write_timeout msec
  *     -1 if file has been closed POLLHUP
  */
-extern int slurm_persist_conn_writeable(slurm_persist_conn_t *persist_conn)
+static int _conn_writeable(slurm_persist_conn_t *persist_conn,
+			   int write_timeout)
 {
 	struct pollfd ufds;
-	int write_timeout = 5000;
 	int rc, time_left;
 	struct timeval tstart;
 	char temp[2];
@@ -782,10 +782,11 @@ extern int slurm_persist_conn_writeable(slurm_persist_conn_t *persist_conn)
 		 * If not then exit out and notify the conn.  This
 		 * is here since a write doesn't always tell you the
 		 * socket is gone, but getting 0 back from a
-		 * nonblocking read means just that.
+		 * nonblocking read means just that. Only peek, the
+		 * peer may already be answering a pipelined message.
 		 */
 		if (ufds.revents & POLLHUP ||
-		    (recv(persist_conn->fd, &temp, 1, 0) == 0)) {
+		    (recv(persist_conn->fd, &temp, 1, MSG_PEEK) == 0)) {
 			debug2("persistent connection is closed");
 			if (persist_conn->trigger_callbacks.dbd_fail)
 				(persist_conn->trigger_callbacks.dbd_fail)();
@@ -815,6 +816,16 @@ extern int slurm_persist_conn_writeable(slurm_persist_conn_t *persist_conn)
 	return 0;
 }
 
+/* Wait until a file is writeable,
+ * RET 1 if file can be written now,
+ *     0 if can not be written to within 5 seconds
+ *     -1 if file has been closed POLLHUP
+ */
+extern int slurm_persist_conn_writeable(slurm_persist_conn_t *persist_conn)
+{
+	return _conn_writeable(persist_conn, 5000);
+}
+
 extern int slurm_persist_send_msg(
 	slurm_persist_conn_t *persist_conn, Buf buffer)
 {
@@ -831,9 +842,9 @@ extern int slurm_persist_send_msg(
 	if (!buffer)
 		return SLURM_ERROR;
 
+	/* Nothing is written yet, so the connection can be reopened */
 	rc = slurm_persist_conn_writeable(persist_conn);
-	if (rc == -1) {
-	re_open:
+	while (rc == -1) {
 		if (retry_cnt++ > 3)
 			return EAGAIN;
 		/* if errno is ACCESS_DENIED do not try to reopen to
@@ -853,24 +864,58 @@ extern int slurm_persist_send_msg(
 	msg_size = get_buf_offset(buffer);
 	nw_size = htonl(msg_size);
 	msg_wrote = write(persist_conn->fd, &nw_size, sizeof(nw_size));
-	if (msg_wrote != sizeof(nw_size))
+	if (msg_wrote <= 0)
 		return EAGAIN;
+	if (msg_wrote != sizeof(nw_size))
+		goto torn;
 
+	/*
+	 * The peer may still be busy with earlier pipelined messages, so
+	 * allow the full connection timeout for the rest. If it can not be
+	 * written the connection is dropped, a torn message would garble
+	 * everything sent after it.
+	 */
 	msg = get_buf_data(buffer);
 	while (msg_size > 0) {
-		rc = slurm_persist_conn_writeable(persist_conn);
-		if (rc == -1)
-			goto re_open;
+		rc = _conn_writeable(persist_conn, persist_conn->timeout ?
+				     persist_conn->timeout : 5000);
 		if (rc < 1)
-			return EAGAIN;
+			goto torn;
 		msg_wrote = write(persist_conn->fd, msg, msg_size);
+		if ((msg_wrote == -1) &&
+		    ((errno == EAGAIN) || (errno == EINTR)))
+			continue;
 		if (msg_wrote <= 0)
-			return EAGAIN;
+			goto torn;
 		msg += msg_wrote;
 		msg_size -= msg_wrote;
 	}
 
 	return SLURM_SUCCESS;
+
+torn:
+	error("%s: unable to send whole message to %s:%u, closing connection",
+	      __func__, persist_conn->rem_host, persist_conn->rem_port);
+	slurm_persist_conn_close(persist_conn);
+	return EAGAIN;
+}
+
+extern int slurm_persist_send_msgs(slurm_persist_conn_t *persist_conn,
+				   Buf *buffers, int cnt, int *rc)
+{
+	uint16_t flags = persist_conn->flags;
+	int sent;
+
+	*rc = SLURM_SUCCESS;
+	for (sent = 0; sent < cnt; sent++) {
+		*rc = slurm_persist_send_msg(persist_conn, buffers[sent]);
+		if (*rc != SLURM_SUCCESS)
+			break;
+		persist_conn->flags &= ~PERSIST_FLAG_RECONNECT;
+	}
+	persist_conn->flags = flags;
+
+	return sent;
 }
 
 extern Buf slurm_persist_recv_msg(slurm_persist_conn_t *persist_conn)
@@ -166,6 +166,16 @@ extern int slurm_persist_conn_writeable(slurm_persist_conn_t *persist_conn);
 
 extern int slurm_persist_send_msg(
 	slurm_persist_conn_t *persist_conn, Buf buffer);
+
+/*
+ * Send several messages without reading the replies in between.
+ * The connection is only reopened before the first message. Messages
+ * already written would be lost with a connection reopened after them.
+ * OUT rc - result of the last message sent or tried
+ * RET count of messages sent
+ */
+extern int slurm_persist_send_msgs(slurm_persist_conn_t *persist_conn,
+				   Buf *buffers, int cnt, int *rc);
 extern Buf slurm_persist_recv_msg(slurm_persist_conn_t *persist_conn);
 
 
@@ -1567,6 +1567,15 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 			xfree(msg->rpc_dump_hostlist[i]);
 		}
 		xfree(msg->rpc_dump_hostlist);
+		for (i = 0; msg->pool_name && (i < msg->pool_count); i++)
+			xfree(msg->pool_name[i]);
+		xfree(msg->pool_name);
+		xfree(msg->pool_obj_size);
+		xfree(msg->pool_slab_cnt);
+		xfree(msg->pool_obj_in_use);
+		xfree(msg->pool_obj_free);
+		xfree(msg->pool_alloc_cnt);
+		xfree(msg->pool_slab_free_cnt);
 		xfree(msg);
 	}
 }
@@ -3953,6 +3962,9 @@ extern void slurm_free_slurmd_status(slurmd_status_t* slurmd_status_ptr)
 		xfree(slurmd_status_ptr->slurmd_logfile);
 		xfree(slurmd_status_ptr->step_list);
 		xfree(slurmd_status_ptr->version);
+		xfree(slurmd_status_ptr->rpc_type_id);
+		xfree(slurmd_status_ptr->rpc_type_cnt);
+		xfree(slurmd_status_ptr->rpc_type_time);
 		xfree(slurmd_status_ptr);
 	}
 }
@@ -4565,6 +4577,19 @@ extern void slurm_free_control_status_msg(control_status_msg_t *msg)
 	xfree(msg);
 }
 
+extern void slurm_free_sched_trace_msg(sched_trace_msg_t *msg)
+{
+	int i;
+
+	if (msg) {
+		xfree(msg->recs);
+		for (i = 0; msg->thread_name && (i < msg->thread_cnt); i++)
+			xfree(msg->thread_name[i]);
+		xfree(msg->thread_name);
+		xfree(msg);
+	}
+}
+
 extern void slurm_free_bb_status_req_msg(bb_status_req_msg_t *msg)
 {
 	int i;
@@ -4829,6 +4854,7 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_RECONFIGURE:
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
+	case REQUEST_SCHED_TRACE:
 	case REQUEST_TAKEOVER:
 	case REQUEST_SHUTDOWN_IMMEDIATE:
 	case RESPONSE_FORWARD_FAILED:
@@ -4977,6 +5003,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case RESPONSE_BURST_BUFFER_STATUS:
 		slurm_free_bb_status_resp_msg(data);
 		break;
+	case RESPONSE_SCHED_TRACE:
+		slurm_free_sched_trace_msg(data);
+		break;
 	default:
 		error("invalid type trying to be freed %u", type);
 		break;
@@ -5252,6 +5281,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_BURST_BUFFER_STATUS";
 	case RESPONSE_BURST_BUFFER_STATUS:
 		return "RESPONSE_BURST_BUFFER_STATUS";
+	case REQUEST_SCHED_TRACE:
+		return "REQUEST_SCHED_TRACE";
+	case RESPONSE_SCHED_TRACE:
+		return "RESPONSE_SCHED_TRACE";
 
 	case REQUEST_UPDATE_JOB:				/* 3001 */
 		return "REQUEST_UPDATE_JOB";
@@ -277,6 +277,8 @@ typedef enum {
 	RESPONSE_CONTROL_STATUS,
 	REQUEST_BURST_BUFFER_STATUS,
 	RESPONSE_BURST_BUFFER_STATUS,
+	REQUEST_SCHED_TRACE,
+	RESPONSE_SCHED_TRACE,		/* 2060 */
 
 	REQUEST_UPDATE_JOB = 3001,
 	REQUEST_UPDATE_NODE,
@@ -937,6 +939,29 @@ typedef struct control_status_msg {
 	time_t control_time;	/* Time we became primary slurmctld (or 0) */
 } control_status_msg_t;
 
+/* Event types in the slurmctld scheduling trace */
+#define SCHED_TRACE_JOB_TEST	1	/* arg: return code of the test */
+#define SCHED_TRACE_PLACE	2	/* arg: allocated node count */
+#define SCHED_TRACE_YIELD	3	/* arg: RPCs pending */
+#define SCHED_TRACE_RESERVE	4	/* arg: planned start time */
+#define SCHED_TRACE_PREEMPT	5	/* arg: preemptor job id */
+
+typedef struct {
+	uint64_t start;		/* microseconds since the epoch */
+	uint32_t duration;	/* microseconds, 0 for instant events */
+	uint32_t job_id;
+	uint32_t arg;		/* depends upon type, see SCHED_TRACE_* */
+	uint16_t type;		/* SCHED_TRACE_* */
+	uint16_t thread;	/* index into thread_name */
+} sched_trace_rec_t;
+
+typedef struct sched_trace_msg {
+	uint32_t rec_cnt;
+	sched_trace_rec_t *recs;	/* oldest first within each thread */
+	uint32_t thread_cnt;
+	char **thread_name;
+} sched_trace_msg_t;
+
 /*
  * Note: We include the node list here for reliable cleanup on XCPU systems.
  *
@@ -1529,6 +1554,7 @@ extern void slurm_free_network_callerid_resp(network_callerid_resp_t *resp);
 extern void slurm_free_set_fs_dampening_factor_msg(
 	set_fs_dampening_factor_msg_t *msg);
 extern void slurm_free_control_status_msg(control_status_msg_t *msg);
+extern void slurm_free_sched_trace_msg(sched_trace_msg_t *msg);
 
 extern void slurm_free_bb_status_req_msg(bb_status_req_msg_t *msg);
 extern void slurm_free_bb_status_resp_msg(bb_status_resp_msg_t *msg);
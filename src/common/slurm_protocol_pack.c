@@ -1018,6 +1018,7 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 	case REQUEST_PING:
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
+	case REQUEST_SCHED_TRACE:
 	case REQUEST_TAKEOVER:
 	case REQUEST_DAEMON_STATUS:
 	case REQUEST_HEALTH_CHECK:
@@ -1581,6 +1582,10 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 		_pack_bb_status_resp_msg((bb_status_resp_msg_t *)(msg->data),
 					 buffer, msg->protocol_version);
 		break;
+	case RESPONSE_SCHED_TRACE:
+		pack_sched_trace_msg((sched_trace_msg_t *)(msg->data),
+				     buffer, msg->protocol_version);
+		break;
 	default:
 		debug("No pack method for msg type %u", msg->msg_type);
 		return EINVAL;
@@ -1589,6 +1594,34 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 	return SLURM_SUCCESS;
 }
 
+/* pack_msg_prepacked
+ * IN msg - the message to check
+ * RET true if pack_msg() would only copy the msg->data_size bytes of
+ *	msg->data into the buffer (see _pack_buffer_msg())
+ */
+extern bool pack_msg_prepacked(slurm_msg_t const *msg)
+{
+	if (msg->protocol_version < SLURM_MIN_PROTOCOL_VERSION)
+		return false;
+
+	switch (msg->msg_type) {
+	case RESPONSE_JOB_INFO:
+	case RESPONSE_PARTITION_INFO:
+	case RESPONSE_NODE_INFO:
+	case RESPONSE_RESERVATION_INFO:
+	case RESPONSE_LAYOUT_INFO:
+	case RESPONSE_JOB_STEP_INFO:
+	case RESPONSE_BURST_BUFFER_INFO:
+	case RESPONSE_FRONT_END_INFO:
+	case RESPONSE_STATS_INFO:
+	case RESPONSE_LICENSE_INFO:
+	case RESPONSE_ASSOC_MGR_INFO:
+		return true;
+	default:
+		return false;
+	}
+}
+
 /* unpack_msg
  * unpacks a generic slurm protocol message body
  * OUT msg - the body structure to unpack (note: includes message type)
@@ -1722,6 +1755,7 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 	case REQUEST_PING:
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
+	case REQUEST_SCHED_TRACE:
 	case REQUEST_TAKEOVER:
 	case REQUEST_DAEMON_STATUS:
 	case REQUEST_HEALTH_CHECK:
@@ -2339,6 +2373,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 			(bb_status_resp_msg_t **)&(msg->data), buffer,
 			msg->protocol_version);
 		break;
+	case RESPONSE_SCHED_TRACE:
+		rc = unpack_sched_trace_msg(
+			(sched_trace_msg_t **)&(msg->data), buffer,
+			msg->protocol_version);
+		break;
 	default:
 		debug("No unpack method for msg type %u", msg->msg_type);
 		return EINVAL;
@@ -13690,7 +13729,35 @@ static void _pack_slurmd_status(slurmd_status_t *msg, Buf buffer,
 {
 	xassert(msg);
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
+		pack_time(msg->booted, buffer);
+		pack_time(msg->last_slurmctld_msg, buffer);
+
+		pack16(msg->slurmd_debug, buffer);
+		pack16(msg->actual_cpus, buffer);
+		pack16(msg->actual_boards, buffer);
+		pack16(msg->actual_sockets, buffer);
+		pack16(msg->actual_cores, buffer);
+		pack16(msg->actual_threads, buffer);
+
+		pack64(msg->actual_real_mem, buffer);
+		pack32(msg->actual_tmp_disk, buffer);
+		pack32(msg->pid, buffer);
+
+		packstr(msg->hostname, buffer);
+		packstr(msg->slurmd_logfile, buffer);
+		packstr(msg->step_list, buffer);
+		packstr(msg->version, buffer);
+
+		pack16_array(msg->rpc_type_id, msg->rpc_type_size, buffer);
+		pack32_array(msg->rpc_type_cnt, msg->rpc_type_size, buffer);
+		pack64_array(msg->rpc_type_time, msg->rpc_type_size, buffer);
+
+		pack32(msg->worker_cnt, buffer);
+		pack32(msg->worker_busy, buffer);
+		pack32(msg->conn_queue_len, buffer);
+		pack32(msg->bulk_queue_len, buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack_time(msg->booted, buffer);
 		pack_time(msg->last_slurmctld_msg, buffer);
 
@@ -13725,7 +13792,44 @@ static int _unpack_slurmd_status(slurmd_status_t **msg_ptr, Buf buffer,
 
 	msg = xmalloc(sizeof(slurmd_status_t));
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
+		safe_unpack_time(&msg->booted, buffer);
+		safe_unpack_time(&msg->last_slurmctld_msg, buffer);
+
+		safe_unpack16(&msg->slurmd_debug, buffer);
+		safe_unpack16(&msg->actual_cpus, buffer);
+		safe_unpack16(&msg->actual_boards, buffer);
+		safe_unpack16(&msg->actual_sockets, buffer);
+		safe_unpack16(&msg->actual_cores, buffer);
+		safe_unpack16(&msg->actual_threads, buffer);
+
+		safe_unpack64(&msg->actual_real_mem, buffer);
+		safe_unpack32(&msg->actual_tmp_disk, buffer);
+		safe_unpack32(&msg->pid, buffer);
+
+		safe_unpackstr_xmalloc(&msg->hostname,
+					&uint32_tmp, buffer);
+		safe_unpackstr_xmalloc(&msg->slurmd_logfile,
+					&uint32_tmp, buffer);
+		safe_unpackstr_xmalloc(&msg->step_list,
+					&uint32_tmp, buffer);
+		safe_unpackstr_xmalloc(&msg->version,
+					&uint32_tmp, buffer);
+
+		safe_unpack16_array(&msg->rpc_type_id, &msg->rpc_type_size,
+				    buffer);
+		safe_unpack32_array(&msg->rpc_type_cnt, &uint32_tmp, buffer);
+		if (uint32_tmp != msg->rpc_type_size)
+			goto unpack_error;
+		safe_unpack64_array(&msg->rpc_type_time, &uint32_tmp, buffer);
+		if (uint32_tmp != msg->rpc_type_size)
+			goto unpack_error;
+
+		safe_unpack32(&msg->worker_cnt, buffer);
+		safe_unpack32(&msg->worker_busy, buffer);
+		safe_unpack32(&msg->conn_queue_len, buffer);
+		safe_unpack32(&msg->bulk_queue_len, buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack_time(&msg->booted, buffer);
 		safe_unpack_time(&msg->last_slurmctld_msg, buffer);
 
@@ -14294,6 +14398,38 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 				     buffer);
 		if (uint32_tmp != msg->rpc_dump_count)
 			goto unpack_error;
+
+		if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
+			safe_unpackstr_array(&msg->pool_name,
+					     &msg->pool_count, buffer);
+			safe_unpack32_array(&msg->pool_obj_size,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+			safe_unpack32_array(&msg->pool_slab_cnt,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+			safe_unpack32_array(&msg->pool_obj_in_use,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+			safe_unpack32_array(&msg->pool_obj_free,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->pool_alloc_cnt,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->pool_slab_free_cnt,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->pool_count)
+				goto unpack_error;
+
+			safe_unpack32(&msg->log_queue_len, buffer);
+			safe_unpack64(&msg->log_drop_cnt, buffer);
+		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->parts_packed,	buffer);
 		if (msg->parts_packed) {
@@ -14790,6 +14926,62 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+extern void pack_sched_trace_msg(sched_trace_msg_t *msg, Buf buffer,
+				 uint16_t protocol_version)
+{
+	sched_trace_rec_t *rec;
+	uint32_t i;
+
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
+		pack32(msg->rec_cnt, buffer);
+		for (i = 0, rec = msg->recs; i < msg->rec_cnt; i++, rec++) {
+			pack64(rec->start, buffer);
+			pack32(rec->duration, buffer);
+			pack32(rec->job_id, buffer);
+			pack32(rec->arg, buffer);
+			pack16(rec->type, buffer);
+			pack16(rec->thread, buffer);
+		}
+		packstr_array(msg->thread_name, msg->thread_cnt, buffer);
+	}
+}
+
+extern int unpack_sched_trace_msg(sched_trace_msg_t **msg_ptr, Buf buffer,
+				  uint16_t protocol_version)
+{
+	sched_trace_msg_t *msg;
+	sched_trace_rec_t *rec;
+	uint32_t i;
+
+	msg = xmalloc(sizeof(sched_trace_msg_t));
+	*msg_ptr = msg;
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->rec_cnt, buffer);
+		/* each record takes 24 bytes */
+		if (msg->rec_cnt > (remaining_buf(buffer) / 24))
+			goto unpack_error;
+		safe_xcalloc(msg->recs, msg->rec_cnt,
+			     sizeof(sched_trace_rec_t));
+		for (i = 0, rec = msg->recs; i < msg->rec_cnt; i++, rec++) {
+			safe_unpack64(&rec->start, buffer);
+			safe_unpack32(&rec->duration, buffer);
+			safe_unpack32(&rec->job_id, buffer);
+			safe_unpack32(&rec->arg, buffer);
+			safe_unpack16(&rec->type, buffer);
+			safe_unpack16(&rec->thread, buffer);
+		}
+		safe_unpackstr_array(&msg->thread_name, &msg->thread_cnt,
+				     buffer);
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_sched_trace_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
 static void _pack_bb_status_req_msg(bb_status_req_msg_t *msg, Buf buffer,
 				    uint16_t protocol_version)
 {
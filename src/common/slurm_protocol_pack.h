@@ -80,6 +80,13 @@ extern int unpack_header ( header_t * header , Buf buffer );
  */
 extern int pack_msg ( slurm_msg_t const * msg , Buf buffer );
 
+/* pack_msg_prepacked
+ * IN msg - the message to check
+ * RET true if pack_msg() would only copy the msg->data_size bytes of
+ *	msg->data into the buffer, so the caller may send msg->data as is
+ */
+extern bool pack_msg_prepacked(slurm_msg_t const *msg);
+
 /* unpack_msg
  * unpacks a generic slurm protocol message body
  * OUT msg - the body structure to unpack (note: includes message type)
@@ -160,4 +167,9 @@ extern void pack_multi_core_data (multi_core_data_t *multi_core, Buf buffer,
 				  uint16_t protocol_version);
 extern int unpack_multi_core_data (multi_core_data_t **multi_core, Buf buffer,
 				   uint16_t protocol_version);
+
+extern void pack_sched_trace_msg(sched_trace_msg_t *msg, Buf buffer,
+				 uint16_t protocol_version);
+extern int unpack_sched_trace_msg(sched_trace_msg_t **msg_ptr, Buf buffer,
+				  uint16_t protocol_version);
 #endif
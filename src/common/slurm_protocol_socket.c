@@ -51,6 +51,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "slurm/slurm_errno.h"
@@ -81,6 +82,8 @@
 /* Static functions */
 static int _slurm_connect(int __fd, struct sockaddr const * __addr,
 			  socklen_t __len);
+static int _send_iov_timeout(int fd, struct iovec *iov, int iovcnt,
+			     uint32_t flags, int timeout);
 
 /****************************************************************
  * MIDDLE LAYER MSG FUNCTIONS
@@ -169,10 +172,40 @@ extern ssize_t slurm_msg_sendto(int fd, char *buffer, size_t size)
 
 ssize_t slurm_msg_sendto_timeout(int fd, char *buffer,
 				 size_t size, int timeout)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+
+	return slurm_msg_sendv_timeout(fd, &iov, 1, timeout);
+}
+
+extern ssize_t slurm_msg_sendv(int fd, struct iovec *iov, int iovcnt)
+{
+	return slurm_msg_sendv_timeout(fd, iov, iovcnt,
+				       (slurm_get_msg_timeout() * 1000));
+}
+
+extern ssize_t slurm_msg_sendv_timeout(int fd, struct iovec *iov, int iovcnt,
+				       int timeout)
 {
 	int   len;
 	uint32_t usize;
+	size_t size = 0;
+	struct iovec *msg_iov;
 	SigFunc *ohandler;
+	int i;
+
+	for (i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+
+	/* The length prefix goes out in the same sendmsg() as the data */
+	usize = htonl(size);
+	msg_iov = xmalloc(sizeof(struct iovec) * (iovcnt + 1));
+	msg_iov[0].iov_base = &usize;
+	msg_iov[0].iov_len = sizeof(usize);
+	memcpy(&msg_iov[1], iov, sizeof(struct iovec) * iovcnt);
 
 	/*
 	 *  Ignore SIGPIPE so that send can return a error code if the
@@ -180,29 +213,29 @@ ssize_t slurm_msg_sendto_timeout(int fd, char *buffer,
 	 */
 	ohandler = xsignal(SIGPIPE, SIG_IGN);
 
-	usize = htonl(size);
-
-	if ((len = slurm_send_timeout(
-				fd, (char *)&usize, sizeof(usize), 0,
-				timeout)) < 0)
-		goto done;
-
-	if ((len = slurm_send_timeout(fd, buffer, size, 0, timeout)) < 0)
-		goto done;
+	len = _send_iov_timeout(fd, msg_iov, iovcnt + 1, 0, timeout);
+	if (len > 0)
+		len -= sizeof(usize);
 
-
-     done:
 	xsignal(SIGPIPE, ohandler);
+	xfree(msg_iov);
 	return len;
 }
 
-/* Send slurm message with timeout
- * RET message size (as specified in argument) or SLURM_ERROR on error */
-extern int slurm_send_timeout(int fd, char *buf, size_t size,
-			      uint32_t flags, int timeout)
+/*
+ * Send the iovcnt segments of iov with one sendmsg() call per poll() wakeup,
+ * so a message made of several buffers goes out without first being copied
+ * into a single one. The iov array is modified as data is sent.
+ * RET total size of all segments or SLURM_ERROR on error
+ */
+static int _send_iov_timeout(int fd, struct iovec *iov, int iovcnt,
+			     uint32_t flags, int timeout)
 {
 	int rc;
 	int sent = 0;
+	size_t size = 0;
+	struct msghdr msg;
+	int i;
 	int fd_flags;
 	struct pollfd ufds;
 	struct timeval tstart;
@@ -215,6 +248,12 @@ extern int slurm_send_timeout(int fd, char *buf, size_t size,
 	fd_flags = fcntl(fd, F_GETFL);
 	fd_set_nonblocking(fd);
 
+	for (i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = iovcnt;
+
 	gettimeofday(&tstart, NULL);
 
 	while (sent < size) {
@@ -265,7 +304,7 @@ extern int slurm_send_timeout(int fd, char *buf, size_t size,
 			      ufds.revents);
 		}
 
-		rc = send(fd, &buf[sent], (size - sent), flags);
+		rc = sendmsg(fd, &msg, flags);
 		if (rc < 0) {
  			if (errno == EINTR)
 				continue;
@@ -289,6 +328,18 @@ extern int slurm_send_timeout(int fd, char *buf, size_t size,
 		}
 
 		sent += rc;
+
+		/* Skip over whatever has been sent */
+		while (rc && ((size_t) rc >= msg.msg_iov->iov_len)) {
+			rc -= msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+		if (rc) {
+			msg.msg_iov->iov_base = (char *) msg.msg_iov->iov_base
+						+ rc;
+			msg.msg_iov->iov_len -= rc;
+		}
 	}
 
     done:
@@ -304,6 +355,20 @@ extern int slurm_send_timeout(int fd, char *buf, size_t size,
 
 }
 
+/* Send slurm message with timeout
+ * RET message size (as specified in argument) or SLURM_ERROR on error */
+extern int slurm_send_timeout(int fd, char *buf, size_t size,
+			      uint32_t flags, int timeout)
+{
+	struct iovec iov;
+
+	iov.iov_base = buf;
+	iov.iov_len = size;
+
+	return _send_iov_timeout(fd, &iov, 1, flags, timeout);
+}
+
+
 /* Get slurm message with timeout
  * RET message size (as specified in argument) or SLURM_ERROR on error */
 extern int slurm_recv_timeout(int fd, char *buffer, size_t size,
@@ -70,6 +70,34 @@
 
 #if USE_ALIAS
 
+/* alist.[ch] functions */
+#define	alist_create		slurm_alist_create
+#define	alist_destroy		slurm_alist_destroy
+#define	alist_is_empty		slurm_alist_is_empty
+#define	alist_count		slurm_alist_count
+#define	alist_append		slurm_alist_append
+#define	alist_transfer		slurm_alist_transfer
+#define	alist_prepend		slurm_alist_prepend
+#define	alist_find_first	slurm_alist_find_first
+#define	alist_delete_all	slurm_alist_delete_all
+#define	alist_for_each		slurm_alist_for_each
+#define	alist_flush		slurm_alist_flush
+#define	alist_sort		slurm_alist_sort
+#define	alist_push		slurm_alist_push
+#define	alist_pop		slurm_alist_pop
+#define	alist_peek		slurm_alist_peek
+#define	alist_enqueue		slurm_alist_enqueue
+#define	alist_dequeue		slurm_alist_dequeue
+#define	alist_iterator_create	slurm_alist_iterator_create
+#define	alist_iterator_reset	slurm_alist_iterator_reset
+#define	alist_iterator_destroy	slurm_alist_iterator_destroy
+#define	alist_next		slurm_alist_next
+#define	alist_peek_next		slurm_alist_peek_next
+#define	alist_insert		slurm_alist_insert
+#define	alist_find		slurm_alist_find
+#define	alist_remove		slurm_alist_remove
+#define	alist_delete_item	slurm_alist_delete_item
+
 /* bitstring.[ch] functions*/
 #define	bit_alloc		slurm_bit_alloc
 #define	bit_test		slurm_bit_test
@@ -128,6 +156,7 @@
 				slurm_hostlist_deranged_string_xmalloc
 #define	hostlist_destroy	slurm_hostlist_destroy
 #define	hostlist_find		slurm_hostlist_find
+#define	hostlist_for_each_range	slurm_hostlist_for_each_range
 #define	hostlist_iterator_create  slurm_hostlist_iterator_create
 #define	hostlist_iterator_destroy slurm_hostlist_iterator_destroy
 #define	hostlist_iterator_reset	slurm_hostlist_iterator_reset
@@ -153,10 +182,14 @@
 #define	hostset_count		slurm_hostset_count
 #define	hostset_create		slurm_hostset_create
 #define	hostset_delete		slurm_hostset_delete
+#define	hostset_delete_host	slurm_hostset_delete_host
 #define	hostset_destroy		slurm_hostset_destroy
 #define	hostset_insert		slurm_hostset_insert
+#define	hostset_intersect	slurm_hostset_intersect
 #define	hostset_shift		slurm_hostset_shift
 #define	hostset_shift_range	slurm_hostset_shift_range
+#define	hostset_subtract	slurm_hostset_subtract
+#define	hostset_union		slurm_hostset_union
 #define	hostset_within		slurm_hostset_within
 
 /* gres.[ch] functions */
@@ -238,6 +271,8 @@
 #define	free_buf		slurm_free_buf
 #define grow_buf		slurm_grow_buf
 #define	init_buf		slurm_init_buf
+#define	try_grow_buf		slurm_try_grow_buf
+#define	try_grow_buf_remaining	slurm_try_grow_buf_remaining
 #define	xfer_buf_data		slurm_xfer_buf_data
 #define	pack_time		slurm_pack_time
 #define	unpack_time		slurm_unpack_time
@@ -319,12 +354,14 @@
 
 /* xstring.[ch] functions */
 #define	_xstrcat		slurm_xstrcat
+#define	_xstrcatat		slurm_xstrcatat
 #define	_xstrncat		slurm_xstrncat
 #define	_xstrcatchar		slurm_xstrcatchar
 #define	_xstrftimecat		slurm_xstrftimecat
 #define	_xiso8601timecat	slurm_xiso8601timecat
 #define	_xrfc5424timecat	slurm_xrfc5424timecat
 #define	_xstrfmtcat		slurm_xstrfmtcat
+#define	_xstrfmtcatat		slurm_xstrfmtcatat
 #define	_xmemcat		slurm_xmemcat
 #define	xstrdup			slurm_xstrdup
 #define	xstrdup_printf		slurm_xstrdup_printf
@@ -44,6 +44,7 @@
 #include "slurm_jobacct_gather.h"
 #include "list.h"
 #include "pack.h"
+#include "pack_schema.h"
 
 #define KB_ADJ 1024
 #define MB_ADJ 1048576
@@ -6219,540 +6220,164 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
-extern void slurmdb_pack_job_rec(void *object, uint16_t protocol_version,
-				 Buf buffer)
+/* The stats and steps of a job, which sit in the middle of the record */
+static void _pack_job_stats_steps(void *object, uint16_t protocol_version,
+				  Buf buffer)
 {
 	slurmdb_job_rec_t *job = (slurmdb_job_rec_t *)object;
 	ListIterator itr = NULL;
 	slurmdb_step_rec_t *step = NULL;
 	uint32_t count = 0;
 
-	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
-		packstr(job->account, buffer);
-		packstr(job->admin_comment, buffer);
-		packstr(job->alloc_gres, buffer);
-		pack32(job->alloc_nodes, buffer);
-		pack32(job->array_job_id, buffer);
-		pack32(job->array_max_tasks, buffer);
-		pack32(job->array_task_id, buffer);
-		packstr(job->array_task_str, buffer);
-
-		pack32(job->associd, buffer);
-		packstr(job->blockid, buffer);
-		packstr(job->cluster, buffer);
-		packstr(job->constraints, buffer);
-		pack32((uint32_t)job->derived_ec, buffer);
-		packstr(job->derived_es, buffer);
-		pack32(job->elapsed, buffer);
-		pack_time(job->eligible, buffer);
-		pack_time(job->end, buffer);
-		pack32((uint32_t)job->exitcode, buffer);
-		pack32(job->flags, buffer);
-		/* the first_step_ptr
-		   is set up on the client side so does
-		   not need to be packed */
-		pack32(job->gid, buffer);
-		pack32(job->jobid, buffer);
-		packstr(job->jobname, buffer);
-		pack32(job->lft, buffer);
-		packstr(job->mcs_label, buffer);
-		packstr(job->nodes, buffer);
-		pack32(job->pack_job_id, buffer);
-		pack32(job->pack_job_offset, buffer);
-		packstr(job->partition, buffer);
-		pack32(job->priority, buffer);
-		pack32(job->qosid, buffer);
-		pack32(job->req_cpus, buffer);
-		packstr(job->req_gres, buffer);
-		pack64(job->req_mem, buffer);
-		pack32(job->requid, buffer);
-		packstr(job->resv_name, buffer);
-		pack32(job->resvid, buffer);
-		pack32(job->show_full, buffer);
-		pack_time(job->start, buffer);
-		pack32(job->state, buffer);
-		pack32(job->state_reason_prev, buffer);
-		_pack_slurmdb_stats(&job->stats, protocol_version, buffer);
-
-		if (job->steps)
-			count = list_count(job->steps);
-		else
-			count = 0;
+	_pack_slurmdb_stats(&job->stats, protocol_version, buffer);
 
-		pack32(count, buffer);
-		if (count) {
-			itr = list_iterator_create(job->steps);
-			while ((step = list_next(itr))) {
-				slurmdb_pack_step_rec(step, protocol_version,
-						      buffer);
-			}
-			list_iterator_destroy(itr);
-		}
-		pack_time(job->submit, buffer);
-		pack32(job->suspended, buffer);
-		packstr(job->system_comment, buffer);
-		pack32(job->sys_cpu_sec, buffer);
-		pack32(job->sys_cpu_usec, buffer);
-		pack32(job->timelimit, buffer);
-		pack32(job->tot_cpu_sec, buffer);
-		pack32(job->tot_cpu_usec, buffer);
-		pack16(job->track_steps, buffer);
-
-		packstr(job->tres_alloc_str, buffer);
-		packstr(job->tres_req_str, buffer);
-
-		pack32(job->uid, buffer);
-		packstr(job->user, buffer);
-		pack32(job->user_cpu_sec, buffer);
-		pack32(job->user_cpu_usec, buffer);
-		packstr(job->wckey, buffer);
-		pack32(job->wckeyid, buffer);
-		packstr(job->work_dir, buffer);
-	} else if (protocol_version >= SLURM_18_08_PROTOCOL_VERSION) {
-		packstr(job->account, buffer);
-		packstr(job->admin_comment, buffer);
-		packstr(job->alloc_gres, buffer);
-		pack32(job->alloc_nodes, buffer);
-		pack32(job->array_job_id, buffer);
-		pack32(job->array_max_tasks, buffer);
-		pack32(job->array_task_id, buffer);
-		packstr(job->array_task_str, buffer);
-
-		pack32(job->associd, buffer);
-		packstr(job->blockid, buffer);
-		packstr(job->cluster, buffer);
-		pack32((uint32_t)job->derived_ec, buffer);
-		packstr(job->derived_es, buffer);
-		pack32(job->elapsed, buffer);
-		pack_time(job->eligible, buffer);
-		pack_time(job->end, buffer);
-		pack32((uint32_t)job->exitcode, buffer);
-		/* the first_step_ptr
-		   is set up on the client side so does
-		   not need to be packed */
-		pack32(job->gid, buffer);
-		pack32(job->jobid, buffer);
-		packstr(job->jobname, buffer);
-		pack32(job->lft, buffer);
-		packstr(job->mcs_label, buffer);
-		packstr(job->nodes, buffer);
-		pack32(job->pack_job_id, buffer);
-		pack32(job->pack_job_offset, buffer);
-		packstr(job->partition, buffer);
-		pack32(job->priority, buffer);
-		pack32(job->qosid, buffer);
-		pack32(job->req_cpus, buffer);
-		packstr(job->req_gres, buffer);
-		pack64(job->req_mem, buffer);
-		pack32(job->requid, buffer);
-		packstr(job->resv_name, buffer);
-		pack32(job->resvid, buffer);
-		pack32(job->show_full, buffer);
-		pack_time(job->start, buffer);
-		pack32(job->state, buffer);
-		_pack_slurmdb_stats(&job->stats, protocol_version, buffer);
-
-		if (job->steps)
-			count = list_count(job->steps);
-		else
-			count = 0;
+	if (job->steps)
+		count = list_count(job->steps);
+	else
+		count = 0;
 
-		pack32(count, buffer);
-		if (count) {
-			itr = list_iterator_create(job->steps);
-			while ((step = list_next(itr))) {
-				slurmdb_pack_step_rec(step, protocol_version,
-						      buffer);
-			}
-			list_iterator_destroy(itr);
-		}
-		pack_time(job->submit, buffer);
-		pack32(job->suspended, buffer);
-		packstr(job->system_comment, buffer);
-		pack32(job->sys_cpu_sec, buffer);
-		pack32(job->sys_cpu_usec, buffer);
-		pack32(job->timelimit, buffer);
-		pack32(job->tot_cpu_sec, buffer);
-		pack32(job->tot_cpu_usec, buffer);
-		pack16(job->track_steps, buffer);
-
-		packstr(job->tres_alloc_str, buffer);
-		packstr(job->tres_req_str, buffer);
-
-		pack32(job->uid, buffer);
-		packstr(job->user, buffer);
-		pack32(job->user_cpu_sec, buffer);
-		pack32(job->user_cpu_usec, buffer);
-		packstr(job->wckey, buffer);
-		pack32(job->wckeyid, buffer);
-		packstr(job->work_dir, buffer);
-	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
-		packstr(job->account, buffer);
-		packstr(job->admin_comment, buffer);
-		packstr(job->alloc_gres, buffer);
-		pack32(job->alloc_nodes, buffer);
-		pack32(job->array_job_id, buffer);
-		pack32(job->array_max_tasks, buffer);
-		pack32(job->array_task_id, buffer);
-		packstr(job->array_task_str, buffer);
-
-		pack32(job->associd, buffer);
-		packstr(job->blockid, buffer);
-		packstr(job->cluster, buffer);
-		pack32((uint32_t)job->derived_ec, buffer);
-		packstr(job->derived_es, buffer);
-		pack32(job->elapsed, buffer);
-		pack_time(job->eligible, buffer);
-		pack_time(job->end, buffer);
-		pack32((uint32_t)job->exitcode, buffer);
-		/* the first_step_ptr
-		   is set up on the client side so does
-		   not need to be packed */
-		pack32(job->gid, buffer);
-		pack32(job->jobid, buffer);
-		packstr(job->jobname, buffer);
-		pack32(job->lft, buffer);
-		packstr(job->mcs_label, buffer);
-		packstr(job->nodes, buffer);
-		pack32(job->pack_job_id, buffer);
-		pack32(job->pack_job_offset, buffer);
-		packstr(job->partition, buffer);
-		pack32(job->priority, buffer);
-		pack32(job->qosid, buffer);
-		pack32(job->req_cpus, buffer);
-		packstr(job->req_gres, buffer);
-		pack64(job->req_mem, buffer);
-		pack32(job->requid, buffer);
-		packstr(job->resv_name, buffer);
-		pack32(job->resvid, buffer);
-		pack32(job->show_full, buffer);
-		pack_time(job->start, buffer);
-		pack32(job->state, buffer);
-		_pack_slurmdb_stats(&job->stats, protocol_version, buffer);
-
-		if (job->steps)
-			count = list_count(job->steps);
-		else
-			count = 0;
-
-		pack32(count, buffer);
-		if (count) {
-			itr = list_iterator_create(job->steps);
-			while ((step = list_next(itr))) {
-				slurmdb_pack_step_rec(step, protocol_version,
-						      buffer);
-			}
-			list_iterator_destroy(itr);
+	pack32(count, buffer);
+	if (count) {
+		itr = list_iterator_create(job->steps);
+		while ((step = list_next(itr))) {
+			slurmdb_pack_step_rec(step, protocol_version, buffer);
 		}
-		pack_time(job->submit, buffer);
-		pack32(job->suspended, buffer);
-		pack32(job->sys_cpu_sec, buffer);
-		pack32(job->sys_cpu_usec, buffer);
-		pack32(job->timelimit, buffer);
-		pack32(job->tot_cpu_sec, buffer);
-		pack32(job->tot_cpu_usec, buffer);
-		pack16(job->track_steps, buffer);
-
-		packstr(job->tres_alloc_str, buffer);
-		packstr(job->tres_req_str, buffer);
-
-		pack32(job->uid, buffer);
-		packstr(job->user, buffer);
-		pack32(job->user_cpu_sec, buffer);
-		pack32(job->user_cpu_usec, buffer);
-		packstr(job->wckey, buffer);
-		pack32(job->wckeyid, buffer);
-		packstr(job->work_dir, buffer);
-	} else {
-		error("%s: protocol_version %hu not supported",
-		      __func__, protocol_version);
+		list_iterator_destroy(itr);
 	}
 }
 
-extern int slurmdb_unpack_job_rec(void **job, uint16_t protocol_version,
-				  Buf buffer)
+static int _unpack_job_stats_steps(void *object, uint16_t protocol_version,
+				   Buf buffer)
 {
-	slurmdb_job_rec_t *job_ptr = xmalloc(sizeof(slurmdb_job_rec_t));
-	int i = 0;
+	slurmdb_job_rec_t *job_ptr = (slurmdb_job_rec_t *)object;
 	slurmdb_step_rec_t *step = NULL;
 	uint32_t count = 0;
-	uint32_t uint32_tmp;
+	int i;
 
-	*job = job_ptr;
+	if (_unpack_slurmdb_stats(&job_ptr->stats, protocol_version, buffer)
+	    != SLURM_SUCCESS)
+		goto unpack_error;
 
-	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
-		safe_unpackstr_xmalloc(&job_ptr->account, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->admin_comment, &uint32_tmp,
-				       buffer);
-		safe_unpackstr_xmalloc(&job_ptr->alloc_gres, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->alloc_nodes, buffer);
-		safe_unpack32(&job_ptr->array_job_id, buffer);
-		safe_unpack32(&job_ptr->array_max_tasks, buffer);
-		safe_unpack32(&job_ptr->array_task_id, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->array_task_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->associd, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->blockid, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->cluster, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->constraints,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->derived_ec = (int32_t)uint32_tmp;
-		safe_unpackstr_xmalloc(&job_ptr->derived_es, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->elapsed, buffer);
-		safe_unpack_time(&job_ptr->eligible, buffer);
-		safe_unpack_time(&job_ptr->end, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->exitcode = (int32_t)uint32_tmp;
-		safe_unpack32(&job_ptr->flags, buffer);
-
-		safe_unpack32(&job_ptr->gid, buffer);
-		safe_unpack32(&job_ptr->jobid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->jobname, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->lft, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->mcs_label,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->nodes, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->pack_job_id, buffer);
-		safe_unpack32(&job_ptr->pack_job_offset, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->partition, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->priority, buffer);
-		safe_unpack32(&job_ptr->qosid, buffer);
-		safe_unpack32(&job_ptr->req_cpus, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->req_gres, &uint32_tmp, buffer);
-		safe_unpack64(&job_ptr->req_mem, buffer);
-		safe_unpack32(&job_ptr->requid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->resv_name, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->resvid, buffer);
-		safe_unpack32(&job_ptr->show_full, buffer);
-		safe_unpack_time(&job_ptr->start, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->state = uint32_tmp;
-		safe_unpack32(&job_ptr->state_reason_prev, buffer);
-		if (_unpack_slurmdb_stats(&job_ptr->stats, protocol_version,
-					  buffer)
-		    != SLURM_SUCCESS)
+	safe_unpack32(&count, buffer);
+	job_ptr->steps = list_create(slurmdb_destroy_step_rec);
+	for (i = 0; i < count; i++) {
+		if (slurmdb_unpack_step_rec(&step, protocol_version, buffer)
+		    == SLURM_ERROR)
 			goto unpack_error;
 
-		safe_unpack32(&count, buffer);
-		job_ptr->steps = list_create(slurmdb_destroy_step_rec);
-		for (i = 0; i < count; i++) {
-			if (slurmdb_unpack_step_rec(&step, protocol_version,
-						    buffer)
-			    == SLURM_ERROR)
-				goto unpack_error;
+		step->job_ptr = job_ptr;
+		if (!job_ptr->first_step_ptr)
+			job_ptr->first_step_ptr = step;
+		list_append(job_ptr->steps, step);
+	}
 
-			step->job_ptr = job_ptr;
-			if (!job_ptr->first_step_ptr)
-				job_ptr->first_step_ptr = step;
-			list_append(job_ptr->steps, step);
-		}
+	return SLURM_SUCCESS;
 
-		safe_unpack_time(&job_ptr->submit, buffer);
-		safe_unpack32(&job_ptr->suspended, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->system_comment, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->sys_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->sys_cpu_usec, buffer);
-		safe_unpack32(&job_ptr->timelimit, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_usec, buffer);
-		safe_unpack16(&job_ptr->track_steps, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_alloc_str,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_req_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->uid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->user, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->user_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->user_cpu_usec, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->wckey, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->wckeyid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->work_dir, &uint32_tmp, buffer);
-	} else if (protocol_version >= SLURM_18_08_PROTOCOL_VERSION) {
-		safe_unpackstr_xmalloc(&job_ptr->account, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->admin_comment, &uint32_tmp,
-				       buffer);
-		safe_unpackstr_xmalloc(&job_ptr->alloc_gres, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->alloc_nodes, buffer);
-		safe_unpack32(&job_ptr->array_job_id, buffer);
-		safe_unpack32(&job_ptr->array_max_tasks, buffer);
-		safe_unpack32(&job_ptr->array_task_id, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->array_task_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->associd, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->blockid, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->cluster, &uint32_tmp, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->derived_ec = (int32_t)uint32_tmp;
-		safe_unpackstr_xmalloc(&job_ptr->derived_es, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->elapsed, buffer);
-		safe_unpack_time(&job_ptr->eligible, buffer);
-		safe_unpack_time(&job_ptr->end, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->exitcode = (int32_t)uint32_tmp;
-		safe_unpack32(&job_ptr->gid, buffer);
-		safe_unpack32(&job_ptr->jobid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->jobname, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->lft, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->mcs_label,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->nodes, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->pack_job_id, buffer);
-		safe_unpack32(&job_ptr->pack_job_offset, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->partition, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->priority, buffer);
-		safe_unpack32(&job_ptr->qosid, buffer);
-		safe_unpack32(&job_ptr->req_cpus, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->req_gres, &uint32_tmp, buffer);
-		safe_unpack64(&job_ptr->req_mem, buffer);
-		safe_unpack32(&job_ptr->requid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->resv_name, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->resvid, buffer);
-		safe_unpack32(&job_ptr->show_full, buffer);
-		safe_unpack_time(&job_ptr->start, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->state = uint32_tmp;
-		if (_unpack_slurmdb_stats(&job_ptr->stats, protocol_version,
-					  buffer)
-		    != SLURM_SUCCESS)
-			goto unpack_error;
+unpack_error:
+	return SLURM_ERROR;
+}
 
-		safe_unpack32(&count, buffer);
-		job_ptr->steps = list_create(slurmdb_destroy_step_rec);
-		for (i = 0; i < count; i++) {
-			if (slurmdb_unpack_step_rec(&step, protocol_version,
-						    buffer)
-			    == SLURM_ERROR)
-				goto unpack_error;
+/*
+ * Layout of slurmdb_job_rec_t on the wire. The first_step_ptr is set up on
+ * the client side so does not need to be packed. derived_ec and exitcode are
+ * signed but travel as 32 bit unsigned values.
+ */
+static const pack_field_t job_rec_schema[] = {
+	PACK_STR(slurmdb_job_rec_t, account, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, admin_comment, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, alloc_gres, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, alloc_nodes, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, array_job_id, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, array_max_tasks,
+		 SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, array_task_id, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, array_task_str, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, associd, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, blockid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, cluster, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, constraints, SLURM_19_05_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, derived_ec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, derived_es, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, elapsed, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_TIME(slurmdb_job_rec_t, eligible, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_TIME(slurmdb_job_rec_t, end, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, exitcode, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, flags, SLURM_19_05_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, gid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, jobid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, jobname, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, lft, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, mcs_label, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, nodes, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, pack_job_id, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, pack_job_offset,
+		 SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, partition, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, priority, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, qosid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, req_cpus, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, req_gres, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U64(slurmdb_job_rec_t, req_mem, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, requid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, resv_name, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, resvid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, show_full, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_TIME(slurmdb_job_rec_t, start, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, state, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, state_reason_prev,
+		 SLURM_19_05_PROTOCOL_VERSION),
+	PACK_FUNC(_pack_job_stats_steps, _unpack_job_stats_steps,
+		  SLURM_MIN_PROTOCOL_VERSION),
+	PACK_TIME(slurmdb_job_rec_t, submit, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, suspended, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, system_comment,
+		 SLURM_18_08_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, sys_cpu_sec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, sys_cpu_usec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, timelimit, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, tot_cpu_sec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, tot_cpu_usec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U16(slurmdb_job_rec_t, track_steps, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, tres_alloc_str, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, tres_req_str, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, uid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, user, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, user_cpu_sec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, user_cpu_usec, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, wckey, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(slurmdb_job_rec_t, wckeyid, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(slurmdb_job_rec_t, work_dir, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_END
+};
 
-			step->job_ptr = job_ptr;
-			if (!job_ptr->first_step_ptr)
-				job_ptr->first_step_ptr = step;
-			list_append(job_ptr->steps, step);
-		}
+extern void slurmdb_pack_job_rec(void *object, uint16_t protocol_version,
+				 Buf buffer)
+{
+	if (protocol_version < SLURM_MIN_PROTOCOL_VERSION) {
+		error("%s: protocol_version %hu not supported",
+		      __func__, protocol_version);
+		return;
+	}
 
-		safe_unpack_time(&job_ptr->submit, buffer);
-		safe_unpack32(&job_ptr->suspended, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->system_comment, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->sys_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->sys_cpu_usec, buffer);
-		safe_unpack32(&job_ptr->timelimit, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_usec, buffer);
-		safe_unpack16(&job_ptr->track_steps, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_alloc_str,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_req_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->uid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->user, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->user_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->user_cpu_usec, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->wckey, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->wckeyid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->work_dir, &uint32_tmp, buffer);
-	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
-		safe_unpackstr_xmalloc(&job_ptr->account, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->admin_comment, &uint32_tmp,
-				       buffer);
-		safe_unpackstr_xmalloc(&job_ptr->alloc_gres, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->alloc_nodes, buffer);
-		safe_unpack32(&job_ptr->array_job_id, buffer);
-		safe_unpack32(&job_ptr->array_max_tasks, buffer);
-		safe_unpack32(&job_ptr->array_task_id, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->array_task_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->associd, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->blockid, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->cluster, &uint32_tmp, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->derived_ec = (int32_t)uint32_tmp;
-		safe_unpackstr_xmalloc(&job_ptr->derived_es, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->elapsed, buffer);
-		safe_unpack_time(&job_ptr->eligible, buffer);
-		safe_unpack_time(&job_ptr->end, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->exitcode = (int32_t)uint32_tmp;
-		safe_unpack32(&job_ptr->gid, buffer);
-		safe_unpack32(&job_ptr->jobid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->jobname, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->lft, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->mcs_label,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->nodes, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->pack_job_id, buffer);
-		safe_unpack32(&job_ptr->pack_job_offset, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->partition, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->priority, buffer);
-		safe_unpack32(&job_ptr->qosid, buffer);
-		safe_unpack32(&job_ptr->req_cpus, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->req_gres, &uint32_tmp, buffer);
-		safe_unpack64(&job_ptr->req_mem, buffer);
-		safe_unpack32(&job_ptr->requid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->resv_name, &uint32_tmp,
-				       buffer);
-		safe_unpack32(&job_ptr->resvid, buffer);
-		safe_unpack32(&job_ptr->show_full, buffer);
-		safe_unpack_time(&job_ptr->start, buffer);
-		safe_unpack32(&uint32_tmp, buffer);
-		job_ptr->state = uint32_tmp;
-		if (_unpack_slurmdb_stats(&job_ptr->stats, protocol_version,
-					  buffer)
-		    != SLURM_SUCCESS)
-			goto unpack_error;
+	pack_schema(job_rec_schema, object, protocol_version, buffer);
+}
 
-		safe_unpack32(&count, buffer);
-		job_ptr->steps = list_create(slurmdb_destroy_step_rec);
-		for (i = 0; i < count; i++) {
-			if (slurmdb_unpack_step_rec(&step, protocol_version,
-						    buffer)
-			    == SLURM_ERROR)
-				goto unpack_error;
+extern int slurmdb_unpack_job_rec(void **job, uint16_t protocol_version,
+				  Buf buffer)
+{
+	slurmdb_job_rec_t *job_ptr = xmalloc(sizeof(slurmdb_job_rec_t));
 
-			step->job_ptr = job_ptr;
-			if (!job_ptr->first_step_ptr)
-				job_ptr->first_step_ptr = step;
-			list_append(job_ptr->steps, step);
-		}
-
-		safe_unpack_time(&job_ptr->submit, buffer);
-		safe_unpack32(&job_ptr->suspended, buffer);
-		safe_unpack32(&job_ptr->sys_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->sys_cpu_usec, buffer);
-		safe_unpack32(&job_ptr->timelimit, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->tot_cpu_usec, buffer);
-		safe_unpack16(&job_ptr->track_steps, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_alloc_str,
-				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->tres_req_str,
-				       &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->uid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->user, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->user_cpu_sec, buffer);
-		safe_unpack32(&job_ptr->user_cpu_usec, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->wckey, &uint32_tmp, buffer);
-		safe_unpack32(&job_ptr->wckeyid, buffer);
-		safe_unpackstr_xmalloc(&job_ptr->work_dir, &uint32_tmp, buffer);
-	} else {
+	*job = job_ptr;
+
+	if (protocol_version < SLURM_MIN_PROTOCOL_VERSION) {
 		error("%s: protocol_version %hu not supported",
 		      __func__, protocol_version);
 		goto unpack_error;
 	}
 
+	if (unpack_schema(job_rec_schema, job_ptr, protocol_version, buffer))
+		goto unpack_error;
+
 	return SLURM_SUCCESS;
 
 unpack_error:
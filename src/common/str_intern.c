@@ -0,0 +1,178 @@
+/*****************************************************************************\
+ *  str_intern.c - reference counted table of shared strings
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Theory of operation:
+ * - Each distinct string is stored once in a single allocation holding a
+ *   reference count followed by the string itself, and indexed by content in
+ *   an xhash table. The pointer handed out points at the string, so callers
+ *   can use it anywhere a "const char *" is expected.
+ * - Taking an extra reference or releasing one recovers the record from the
+ *   string pointer, so neither needs a table lookup. Only str_intern() and
+ *   the release of the last reference touch the table.
+ * - A single mutex protects the table and all reference counts. Interning is
+ *   done when records are created or renamed, never on lookup paths, so the
+ *   lock is not contended.
+ */
+
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/str_intern.h"
+#include "src/common/xassert.h"
+#include "src/common/xhash.h"
+#include "src/common/xmalloc.h"
+
+#define INTERN_MAGIC 0x69737472
+
+typedef struct {
+	uint32_t magic;
+	uint32_t refcnt;
+	char str[];
+} intern_rec_t;
+
+static pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *intern_table = NULL;
+static uint64_t intern_refs = 0;
+static uint64_t intern_bytes = 0;
+
+static const char *_intern_id(void *item)
+{
+	return ((intern_rec_t *) item)->str;
+}
+
+static intern_rec_t *_intern_rec(char *istr)
+{
+	intern_rec_t *rec;
+
+	rec = (intern_rec_t *) (istr - offsetof(intern_rec_t, str));
+	if (rec->magic != INTERN_MAGIC) {
+		error("%s: %p is not an interned string", __func__, istr);
+		xassert(0);
+		return NULL;
+	}
+	return rec;
+}
+
+extern char *str_intern(const char *str)
+{
+	intern_rec_t *rec;
+	size_t len;
+
+	if (!str)
+		return NULL;
+
+	slurm_mutex_lock(&intern_lock);
+	if (!intern_table)
+		intern_table = xhash_init(_intern_id, NULL);
+	if (!(rec = xhash_get(intern_table, str))) {
+		len = strlen(str) + 1;
+		rec = xmalloc_nz(sizeof(intern_rec_t) + len);
+		rec->magic = INTERN_MAGIC;
+		rec->refcnt = 0;
+		memcpy(rec->str, str, len);
+		xhash_add(intern_table, rec);
+		intern_bytes += len;
+	}
+	rec->refcnt++;
+	intern_refs++;
+	slurm_mutex_unlock(&intern_lock);
+
+	return rec->str;
+}
+
+extern char *slurm_str_intern_xfer(char **str)
+{
+	char *istr;
+
+	if (!str || !*str)
+		return NULL;
+
+	istr = str_intern(*str);
+	xfree(*str);
+
+	return istr;
+}
+
+extern char *str_intern_ref(char *istr)
+{
+	intern_rec_t *rec;
+
+	if (!istr || !(rec = _intern_rec(istr)))
+		return NULL;
+
+	slurm_mutex_lock(&intern_lock);
+	rec->refcnt++;
+	intern_refs++;
+	slurm_mutex_unlock(&intern_lock);
+
+	return istr;
+}
+
+extern void slurm_str_intern_free(char **istr)
+{
+	intern_rec_t *rec;
+
+	if (!istr || !*istr)
+		return;
+	if (!(rec = _intern_rec(*istr)))
+		return;
+
+	slurm_mutex_lock(&intern_lock);
+	xassert(rec->refcnt);
+	intern_refs--;
+	if (--rec->refcnt == 0) {
+		xhash_pop(intern_table, rec->str);
+		intern_bytes -= strlen(rec->str) + 1;
+		rec->magic = ~INTERN_MAGIC;
+		xfree(rec);
+	}
+	slurm_mutex_unlock(&intern_lock);
+
+	*istr = NULL;
+}
+
+extern void str_intern_stats(uint32_t *strings, uint64_t *refs,
+			     uint64_t *bytes)
+{
+	slurm_mutex_lock(&intern_lock);
+	*strings = intern_table ? xhash_count(intern_table) : 0;
+	*refs = intern_refs;
+	*bytes = intern_bytes;
+	slurm_mutex_unlock(&intern_lock);
+}
@@ -0,0 +1,90 @@
+/*****************************************************************************\
+ *  str_intern.h - reference counted table of shared strings
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _STR_INTERN_H
+#define _STR_INTERN_H
+
+#include <inttypes.h>
+
+/*
+ * Interned strings are shared, read-only copies of strings which appear many
+ * times (e.g. account, partition and user names of job records). Each caller
+ * holds a reference which must be released with str_intern_free(). Interned
+ * strings must never be modified, xfree()'d or used with xstrcat() and
+ * friends.
+ *
+ * Two interned strings are equal if and only if their pointers are equal.
+ */
+
+/*
+ * Return an interned copy of str, adding a reference to it.
+ * RET interned string or NULL if str is NULL
+ */
+extern char *str_intern(const char *str);
+
+/*
+ * Intern the contents of an xmalloc()'d string, xfree() the original and set
+ * the pointer to NULL.
+ * RET interned string or NULL if *str is NULL
+ */
+#define str_intern_xfer(__p) slurm_str_intern_xfer(&(__p))
+extern char *slurm_str_intern_xfer(char **str);
+
+/*
+ * Add a reference to a string already returned by str_intern().
+ * RET istr
+ */
+extern char *str_intern_ref(char *istr);
+
+/*
+ * Release a reference to an interned string and set the pointer to NULL.
+ * The string is freed when its last reference is released.
+ */
+#define str_intern_free(__p) slurm_str_intern_free(&(__p))
+extern void slurm_str_intern_free(char **istr);
+
+/*
+ * Return true if both interned strings (or NULL) are the same string.
+ */
+#define str_intern_eq(__a, __b) ((__a) == (__b))
+
+/*
+ * Report the number of distinct strings, references held and bytes of
+ * string data stored in the table.
+ */
+extern void str_intern_stats(uint32_t *strings, uint64_t *refs,
+			     uint64_t *bytes);
+
+#endif /* !_STR_INTERN_H */
@@ -41,6 +41,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include "src/common/write_labelled_message.h"
 #include "slurm/slurm_errno.h"
@@ -50,7 +51,10 @@
 
 static char *_build_label(int task_id, int task_id_width, uint32_t pack_offset,
 			  uint32_t task_offset);
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len);
+static int _write_lines(int fd, struct iovec *iov, int iovcnt);
+
+/* Lines gathered into a single writev() call when labelling output */
+#define LINES_PER_WRITE 32
 
 /*
  * fd             is the file descriptor to write to
@@ -75,44 +79,64 @@ extern int write_labelled_message(int fd, void *buf, int len, int task_id,
 				  uint32_t pack_offset, uint32_t task_offset,
 				  bool label, int task_id_width)
 {
+	struct iovec iov[LINES_PER_WRITE * 3];
 	void *start, *end;
-	char *prefix = NULL, *suffix = NULL;
+	char *prefix = NULL;
+	int prefix_len, iovcnt = 0, batch_len = 0;
 	int remaining = len;
 	int written = 0;
 	int line_len;
 	int rc = -1;
 
-	if (label) {
-		prefix = _build_label(task_id, task_id_width, pack_offset,
-				      task_offset);
+	if (!label) {
+		/* No per line work to do, write the whole message at once */
+		if (len > 0) {
+			iov[0].iov_base = buf;
+			iov[0].iov_len = len;
+			if (_write_lines(fd, iov, 1) == 0)
+				rc = len;
+		}
+		return rc;
 	}
 
+	prefix = _build_label(task_id, task_id_width, pack_offset,
+			      task_offset);
+	prefix_len = strlen(prefix);
+
+	/*
+	 * Each labelled line is written with a single writev() of the prefix,
+	 * the line and (for a partial last line) a newline, so output from
+	 * multiple pack-job components is not interleaved within a line.
+	 * Up to LINES_PER_WRITE lines are gathered into one system call.
+	 */
 	while (remaining > 0) {
-		start = buf + written;
+		start = buf + written + batch_len;
 		end = memchr(start, '\n', remaining);
-		if (end == NULL) { /* no newline found */
-			if (label)
-				suffix = "\n";
-			rc = _write_line(fd, prefix, suffix, start, remaining);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
-		} else {
+		if (end == NULL)	/* no newline found */
+			line_len = remaining;
+		else
 			line_len = (int)(end - start) + 1;
-			rc = _write_line(fd, prefix, suffix, start, line_len);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
+
+		iov[iovcnt].iov_base = prefix;
+		iov[iovcnt++].iov_len = prefix_len;
+		iov[iovcnt].iov_base = start;
+		iov[iovcnt++].iov_len = line_len;
+		if (end == NULL) {
+			iov[iovcnt].iov_base = "\n";
+			iov[iovcnt++].iov_len = 1;
 		}
+		batch_len += line_len;
+		remaining -= line_len;
 
+		if ((remaining == 0) ||
+		    (iovcnt > ((LINES_PER_WRITE - 1) * 3))) {
+			if ((rc = _write_lines(fd, iov, iovcnt)) < 0)
+				break;
+			written += batch_len;
+			batch_len = 0;
+			iovcnt = 0;
+		}
 	}
-done:
 	xfree(prefix);
 	if (written > 0)
 		return written;
@@ -144,50 +168,34 @@ static char *_build_label(int task_id, int task_id_width,
 }
 
 /*
- * Blocks until write is complete, regardless of the file descriptor being in
- * non-blocking mode.
- * I/O from multiple pack-jobs may be present, so add prefix/suffix to buffer
- * before issuing write to avoid interleaved output from multiple components.
+ * Blocks until all of iov is written, regardless of the file descriptor being
+ * in non-blocking mode. The iov array is modified.
+ * RET 0 on success or -1 on error
  */
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len)
+static int _write_lines(int fd, struct iovec *iov, int iovcnt)
 {
-	int left, n, pre = 0, post = 0;
-	void *ptr, *tmp = NULL;
-
-	if (prefix || suffix) {
-		if (prefix)
-			pre = strlen(prefix);
-		if (suffix)
-			post = strlen(suffix);
-		tmp = xmalloc(pre + len + post);
-		if (prefix)
-			memcpy(tmp, prefix, pre);
-		memcpy(tmp + pre, buf, len);
-		if (suffix)
-			memcpy(tmp + pre + len, suffix, post);
-		ptr = tmp;
-		left = pre + len + post;
-	} else {
-		ptr = buf;
-		left = len;
-	}
+	ssize_t n;
 
-	while (left > 0) {
-	again:
-		if ((n = write(fd, ptr, left)) < 0) {
+	while (iovcnt > 0) {
+		if ((n = writev(fd, iov, iovcnt)) < 0) {
 			if (errno == EINTR)
-				goto again;
+				continue;
 			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-				debug3("  got EAGAIN in _write_line");
-				goto again;
+				debug3("  got EAGAIN in _write_lines");
+				continue;
 			}
-			len = -1;
-			break;
+			return -1;
+		}
+		while ((iovcnt > 0) && (n >= iov->iov_len)) {
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (n > 0) {
+			iov->iov_base += n;
+			iov->iov_len -= n;
 		}
-		left -= n;
-		ptr += n;
 	}
-	xfree(tmp);
 
-	return len;
+	return 0;
 }
@@ -62,6 +62,7 @@
 #include "src/common/xstring.h"
 
 #define XFGETS_CHUNKSIZE 64
+#define XSTRFMT_BUFSIZE  1024	/* formatted on the stack if it fits */
 
 /* Static functions. */
 static char *_xstrdup_vprintf(const char *_fmt, va_list _ap);
@@ -71,10 +72,12 @@ static char *_xstrdup_vprintf(const char *_fmt, va_list _ap);
  * for details.
  */
 strong_alias(_xstrcat,		slurm_xstrcat);
+strong_alias(_xstrcatat,	slurm_xstrcatat);
 strong_alias(_xstrncat,		slurm_xstrncat);
 strong_alias(_xstrcatchar,	slurm_xstrcatchar);
 strong_alias(_xstrftimecat,	slurm_xstrftimecat);
 strong_alias(_xstrfmtcat,	slurm_xstrfmtcat);
+strong_alias(_xstrfmtcatat,	slurm_xstrfmtcatat);
 strong_alias(_xmemcat,		slurm_xmemcat);
 strong_alias(xstrdup,		slurm_xstrdup);
 strong_alias(xstrdup_printf,	slurm_xstrdup_printf);
@@ -96,14 +99,15 @@ strong_alias(xstrcasestr,       slurm_xstrcasestr);
 /*
  * Ensure that a string has enough space to add 'needed' characters.
  * If the string is uninitialized, it should be NULL.
+ * str_len is the current length of the string, -1 if unknown.
  */
-static void makespace(char **str, int needed)
+static void makespace(char **str, int str_len, int needed)
 {
 	if (*str == NULL)
 		*str = xmalloc(needed + 1);
 	else {
 		int actual_size;
-		int used = strlen(*str) + 1;
+		int used = ((str_len < 0) ? strlen(*str) : str_len) + 1;
 		int min_new_size = used + needed;
 		int cur_size = xsize(*str);
 		if (min_new_size > cur_size) {
@@ -121,18 +125,56 @@ static void makespace(char **str, int needed)
 	}
 }
 
+/*
+ * Return the length of str. pos, if set, points to its terminating NUL.
+ * A pos left behind by another function reallocating str is no longer
+ * within it, the length is then found again.
+ */
+static int _xstrlen(const char *str, char **pos)
+{
+	if (str == NULL)
+		return 0;
+	if (pos && *pos && (*pos >= str) && (*pos < str + xsize(str)) &&
+	    (**pos == '\0')) {
+		xassert(strlen(str) == (*pos - str));
+		return *pos - str;
+	}
+	return strlen(str);
+}
+
+/* Append len bytes of str2 at the end of str1, len1 bytes in length */
+static void _xstrcat_len(char **str1, int len1, const char *str2, int len2,
+			 char **pos)
+{
+	makespace(str1, len1, len2);
+	memcpy(*str1 + len1, str2, len2);
+	(*str1)[len1 + len2] = '\0';
+	if (pos)
+		*pos = *str1 + len1 + len2;
+}
+
 /*
  * Concatenate str2 onto str1, expanding str1 as needed.
  *   str1 (IN/OUT)	target string (pointer to in case of expansion)
  *   str2 (IN)		source string
  */
 void _xstrcat(char **str1, const char *str2)
+{
+	_xstrcatat(str1, NULL, str2);
+}
+
+/*
+ * Concatenate str2 onto str1 at pos, expanding str1 as needed.
+ *   str1 (IN/OUT)	target string (pointer to in case of expansion)
+ *   pos (IN/OUT)	end of str1, NULL if unknown. Set to the new end.
+ *   str2 (IN)		source string
+ */
+void _xstrcatat(char **str1, char **pos, const char *str2)
 {
 	if (str2 == NULL)
 		str2 = "(null)";
 
-	makespace(str1, strlen(str2));
-	strcat(*str1, str2);
+	_xstrcat_len(str1, _xstrlen(*str1, pos), str2, strlen(str2), pos);
 }
 
 /*
@@ -146,7 +188,7 @@ void _xstrncat(char **str1, const char *str2, size_t len)
 	if (str2 == NULL)
 		str2 = "(null)";
 
-	makespace(str1, len);
+	makespace(str1, -1, len);
 	strncat(*str1, str2, len);
 }
 
@@ -168,7 +210,7 @@ static void strcatchar(char *str, char c)
  */
 void _xstrcatchar(char **str, char c)
 {
-	makespace(str, 1);
+	makespace(str, -1, 1);
 	strcatchar(*str, c);
 }
 
@@ -259,6 +301,51 @@ void _xrfc5424timecat(char **buf, bool msec)
 		_xstrfmtcat(buf, "%s%s", p, z);
 }
 
+/*
+ * Append formatted string at pos, expanding str as needed. Short results
+ * are formatted on the stack, as the arguments may point into str.
+ */
+static int _xstrvfmtcatat(char **str, char **pos, const char *fmt,
+			  va_list ap)
+{
+	char buf[XSTRFMT_BUFSIZE], *p;
+	va_list our_ap;
+	int n, len;
+
+	va_copy(our_ap, ap);
+	n = vsnprintf(buf, sizeof(buf), fmt, our_ap);
+	va_end(our_ap);
+	if (n < 0)
+		return 0;
+
+	len = _xstrlen(*str, pos);
+	if (n < sizeof(buf)) {
+		_xstrcat_len(str, len, buf, n, pos);
+		return n;
+	}
+
+	/*
+	 * Too long for the stack, n is now known so this is formatted only
+	 * once more. Arguments may point into str, so the result goes to str
+	 * directly only when str is still empty.
+	 */
+	va_copy(our_ap, ap);
+	if (*str == NULL) {
+		makespace(str, 0, n);
+		vsnprintf(*str, n + 1, fmt, our_ap);
+		if (pos)
+			*pos = *str + n;
+	} else {
+		p = xmalloc_nz(n + 1);
+		vsnprintf(p, n + 1, fmt, our_ap);
+		_xstrcat_len(str, len, p, n, pos);
+		xfree(p);
+	}
+	va_end(our_ap);
+
+	return n;
+}
+
 /*
  * append formatted string with printf-style args to buf, expanding
  * buf as needed
@@ -266,19 +353,27 @@ void _xrfc5424timecat(char **buf, bool msec)
 int _xstrfmtcat(char **str, const char *fmt, ...)
 {
 	int n;
-	char *p = NULL;
 	va_list ap;
 
 	va_start(ap, fmt);
-	p = _xstrdup_vprintf(fmt, ap);
+	n = _xstrvfmtcatat(str, NULL, fmt, ap);
 	va_end(ap);
 
-	if (p == NULL)
-		return 0;
+	return n;
+}
 
-	n = strlen(p);
-	xstrcat(*str, p);
-	xfree(p);
+/*
+ * append formatted string with printf-style args to buf at pos, expanding
+ * buf as needed
+ */
+int _xstrfmtcatat(char **str, char **pos, const char *fmt, ...)
+{
+	int n;
+	va_list ap;
+
+	va_start(ap, fmt);
+	n = _xstrvfmtcatat(str, pos, fmt, ap);
+	va_end(ap);
 
 	return n;
 }
@@ -431,7 +526,7 @@ bool _xstrsubstitute(char **str, const char *pattern, const char *replacement)
 
 	end_copy = xstrdup(ptr + pat_len);
 	if (rep_len != 0) {
-		makespace(str, rep_len-pat_len);
+		makespace(str, -1, rep_len-pat_len);
 		strcpy((*str)+pat_offset, replacement);
 	}
 	strcpy((*str)+pat_offset+rep_len, end_copy);
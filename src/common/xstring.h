@@ -43,12 +43,15 @@
 #include "src/common/macros.h"
 
 #define xstrcat(__p, __q)		_xstrcat(&(__p), __q)
+#define xstrcatat(__p, __q, __s)	_xstrcatat(&(__p), __q, __s)
 #define xstrncat(__p, __q, __l)		_xstrncat(&(__p), __q, __l)
 #define xstrcatchar(__p, __c)		_xstrcatchar(&(__p), __c)
 #define xstrftimecat(__p, __fmt)	_xstrftimecat(&(__p), __fmt)
 #define xiso8601timecat(__p, __msec)            _xiso8601timecat(&(__p), __msec)
 #define xrfc5424timecat(__p, __msec)            _xrfc5424timecat(&(__p), __msec)
 #define xstrfmtcat(__p, __fmt, args...)	_xstrfmtcat(&(__p), __fmt, ## args)
+#define xstrfmtcatat(__p, __q, __fmt, args...) \
+	_xstrfmtcatat(&(__p), __q, __fmt, ## args)
 #define xmemcat(__p, __s, __e)          _xmemcat(&(__p), __s, __e)
 #define xstrsubstitute(__p, __pat, __rep) _xstrsubstitute(&(__p), __pat, __rep)
 #define xstrsubstituteall(__p, __pat, __rep)			\
@@ -71,6 +74,24 @@
 */
 void _xstrcat(char **str1, const char *str2);
 
+/*
+** The "at" variants also take a pointer to the end of str1, which saves
+** finding it again on each call when building long strings:
+**
+**	char *str = NULL, *pos = NULL;
+**	for (...)
+**		xstrfmtcatat(str, &pos, "%s,", name);
+**
+** pos must be NULL if the end of str is unknown and is set to the new
+** end. Calls that change str by other means should reset pos to NULL, a
+** pos that no longer lies within str or at its end is not used.
+*/
+
+/*
+** cat str2 onto str1 at pos, expanding str1 as necessary
+*/
+void _xstrcatat(char **str1, char **pos, const char *str2);
+
 /*
 ** cat len of str2 onto str1, expanding str1 as necessary
 */
@@ -104,6 +125,13 @@ void _xrfc5424timecat(char **str, bool);
 int _xstrfmtcat(char **str, const char *fmt, ...)
   __attribute__ ((format (printf, 2, 3)));
 
+/*
+** concatenate printf-style formatted string onto str at pos
+** return value is result from vsnprintf(3)
+*/
+int _xstrfmtcatat(char **str, char **pos, const char *fmt, ...)
+  __attribute__ ((format (printf, 3, 4)));
+
 /*
 ** concatenate range of memory from start to end (not including end)
 ** onto str.
@@ -40,7 +40,10 @@
 
 #include "config.h"
 
+#include <ctype.h>
+
 #include "mysql_common.h"
+#include "src/common/macros.h"
 #include "src/common/log.h"
 #include "src/common/xstring.h"
 #include "src/common/xmalloc.h"
@@ -48,6 +51,9 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/read_config.h"
 
+/* Flush deferred statements before the batch exceeds this many bytes */
+#define MAX_BATCH_SIZE (512 * 1024)
+
 static char *table_defs_table = "table_defs_table";
 
 typedef struct {
@@ -181,6 +187,39 @@ end_it:
 	return rc;
 }
 
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static void _reset_batch(mysql_conn_t *mysql_conn)
+{
+	if (mysql_conn->batch_query)
+		mysql_conn->batch_query[0] = '\0';
+	mysql_conn->batch_len = 0;
+	mysql_conn->batch_cnt = 0;
+}
+
+/*
+ * Send any statements queued with mysql_db_query_batch() as one
+ * multi-statement query. MySQL stops executing at the first failing
+ * statement, the caller is expected to roll back on error.
+ * NOTE: Ensure that mysql_conn->lock is set on function entry
+ */
+static int _flush_batch(mysql_conn_t *mysql_conn)
+{
+	int rc;
+
+	if (!mysql_conn->batch_len)
+		return SLURM_SUCCESS;
+
+	if ((rc = _mysql_query_internal(mysql_conn->db_conn,
+					mysql_conn->batch_query)) == SLURM_SUCCESS)
+		rc = _clear_results(mysql_conn->db_conn);
+	if (rc != SLURM_SUCCESS)
+		error("%s: batch of %u statements failed",
+		      __func__, mysql_conn->batch_cnt);
+	_reset_batch(mysql_conn);
+
+	return rc;
+}
+
 /* NOTE: Ensure that mysql_conn->lock is NOT set on function entry */
 static int _mysql_make_table_current(mysql_conn_t *mysql_conn, char *table_name,
 				     storage_field_t *fields, char *ending)
@@ -642,6 +681,7 @@ extern int destroy_mysql_conn(mysql_conn_t *mysql_conn)
 {
 	if (mysql_conn) {
 		mysql_db_close_db_connection(mysql_conn);
+		xfree(mysql_conn->batch_query);
 		xfree(mysql_conn->pre_commit_query);
 		xfree(mysql_conn->cluster_name);
 		slurm_mutex_destroy(&mysql_conn->lock);
@@ -784,6 +824,8 @@ extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 		mysql_close(mysql_conn->db_conn);
 		mysql_conn->db_conn = NULL;
 	}
+	/* Uncommitted work is gone with the connection */
+	_reset_batch(mysql_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return SLURM_SUCCESS;
 }
@@ -810,7 +852,51 @@ extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
-	rc = _mysql_query_internal(mysql_conn->db_conn, query);
+	if ((rc = _flush_batch(mysql_conn)) == SLURM_SUCCESS)
+		rc = _mysql_query_internal(mysql_conn->db_conn, query);
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return rc;
+}
+
+extern int mysql_db_query_batch(mysql_conn_t *mysql_conn, char *query)
+{
+	int rc = SLURM_SUCCESS;
+	size_t len;
+
+	if (!mysql_conn || !mysql_conn->db_conn) {
+		fatal("You haven't inited this storage yet.");
+		return 0;	/* For CLANG false positive */
+	}
+	if (!mysql_conn->rollback)
+		return mysql_db_query(mysql_conn, query);
+
+	/* Statements are joined with ';', an empty one would be an error */
+	len = strlen(query);
+	while (len && ((query[len - 1] == ';') || isspace(query[len - 1])))
+		len--;
+	if (!len)
+		return SLURM_SUCCESS;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	if (mysql_conn->batch_len &&
+	    ((mysql_conn->batch_len + len + 1) > MAX_BATCH_SIZE))
+		rc = _flush_batch(mysql_conn);
+	if (rc == SLURM_SUCCESS) {
+		if ((mysql_conn->batch_len + len + 2) >
+		    mysql_conn->batch_size) {
+			mysql_conn->batch_size = MAX(mysql_conn->batch_size * 2,
+						     mysql_conn->batch_len +
+						     len + 2);
+			xrealloc_nz(mysql_conn->batch_query,
+				    mysql_conn->batch_size);
+		}
+		memcpy(mysql_conn->batch_query + mysql_conn->batch_len,
+		       query, len);
+		mysql_conn->batch_len += len;
+		mysql_conn->batch_query[mysql_conn->batch_len++] = ';';
+		mysql_conn->batch_query[mysql_conn->batch_len] = '\0';
+		mysql_conn->batch_cnt++;
+	}
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
 }
@@ -828,7 +914,9 @@ extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
-	if (!(rc = _mysql_query_internal(mysql_conn->db_conn, query)))
+	if ((rc = _flush_batch(mysql_conn)) != SLURM_SUCCESS)
+		rc = -1;
+	else if (!(rc = _mysql_query_internal(mysql_conn->db_conn, query)))
 		rc = mysql_affected_rows(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
@@ -863,6 +951,11 @@ extern int mysql_db_commit(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	if (_flush_batch(mysql_conn) != SLURM_SUCCESS) {
+		/* Leave the transaction open for the caller to roll back */
+		slurm_mutex_unlock(&mysql_conn->lock);
+		return SLURM_ERROR;
+	}
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_commit(mysql_conn->db_conn)) {
@@ -884,6 +977,7 @@ extern int mysql_db_rollback(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_reset_batch(mysql_conn);
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_rollback(mysql_conn->db_conn)) {
@@ -910,6 +1004,8 @@ extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	if (_flush_batch(mysql_conn) != SLURM_SUCCESS)
+		goto fini;
 	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
 		if (mysql_errno(mysql_conn->db_conn) == ER_NO_SUCH_TABLE)
 			goto fini;
@@ -934,13 +1030,42 @@ fini:
 	return result;
 }
 
+extern MYSQL_RES *mysql_db_query_use(mysql_conn_t *mysql_conn, char *query)
+{
+	MYSQL_RES *result = NULL;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	if (_flush_batch(mysql_conn) != SLURM_SUCCESS)
+		goto fini;
+	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
+		if (mysql_errno(mysql_conn->db_conn) == ER_NO_SUCH_TABLE)
+			goto fini;
+		result = mysql_use_result(mysql_conn->db_conn);
+		/*
+		 * Starting in MariaDB 10.2 many of the api commands started
+		 * setting errno erroneously.
+		 */
+		errno = 0;
+		if (!result && mysql_field_count(mysql_conn->db_conn)) {
+			/* should have returned data */
+			error("We should have gotten a result: '%m' '%s'",
+			      mysql_error(mysql_conn->db_conn));
+		}
+	}
+
+fini:
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return result;
+}
+
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 {
 	int rc = SLURM_SUCCESS;
 
 	slurm_mutex_lock(&mysql_conn->lock);
-	if ((rc = _mysql_query_internal(
-		     mysql_conn->db_conn, query)) != SLURM_ERROR)
+	if (((rc = _flush_batch(mysql_conn)) == SLURM_SUCCESS) &&
+	    ((rc = _mysql_query_internal(
+		      mysql_conn->db_conn, query)) != SLURM_ERROR))
 		rc = _clear_results(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
@@ -951,7 +1076,8 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 	uint64_t new_id = 0;
 
 	slurm_mutex_lock(&mysql_conn->lock);
-	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
+	if ((_flush_batch(mysql_conn) == SLURM_SUCCESS) &&
+	    (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)) {
 		new_id = mysql_insert_id(mysql_conn->db_conn);
 		if (!new_id) {
 			/* should have new id */
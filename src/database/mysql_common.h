@@ -63,6 +63,10 @@ typedef struct {
 	char *cluster_name;
 	MYSQL *db_conn;
 	pthread_mutex_t lock;
+	char *batch_query;	/* statements deferred until the next query */
+	uint32_t batch_cnt;	/* statements in batch_query */
+	size_t batch_len;	/* strlen(batch_query) */
+	size_t batch_size;	/* bytes allocated to batch_query */
 	char *pre_commit_query;
 	bool rollback;
 	List update_list;
@@ -93,6 +97,15 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn);
 extern int mysql_db_cleanup();
 extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query);
+/*
+ * Queue a statement which returns no data for execution in the same round
+ * trip as the following statements on this connection. The queued statements
+ * are sent as one multi-statement query before any other query, commit or
+ * when the batch grows too large, so ordering is preserved. Errors are
+ * reported by the call which flushes the batch, usually mysql_db_commit().
+ * Connections without rollback (autocommit) run the query immediately.
+ */
+extern int mysql_db_query_batch(mysql_conn_t *mysql_conn, char *query);
 extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query);
 extern int mysql_db_ping(mysql_conn_t *mysql_conn);
 extern int mysql_db_commit(mysql_conn_t *mysql_conn);
@@ -100,6 +113,14 @@ extern int mysql_db_rollback(mysql_conn_t *mysql_conn);
 
 extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 				     char *query, bool last);
+/*
+ * Like mysql_db_query_ret() for a single select, but rows are read from the
+ * server as they are fetched (mysql_use_result()) instead of all being
+ * copied into memory first. Every row must be fetched and the result freed
+ * before anything else is run on this connection. A fetch error ends the rows
+ * early and leaves mysql_errno() set.
+ */
+extern MYSQL_RES *mysql_db_query_use(mysql_conn_t *mysql_conn, char *query);
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query);
 
 extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query);
@@ -36,13 +36,20 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include "config.h"
+
 #include <fcntl.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#if HAVE_LIBZ
+# include <zlib.h>
+#endif
+
 #include "src/common/env.h"
+#include "src/common/gzip.h"
 #include "src/common/slurmdbd_defs.h"
 #include "src/common/slurm_auth.h"
 #include "src/common/slurm_time.h"
@@ -66,6 +73,10 @@ extern char *wckey_month_table;
 extern __thread bool drop_priv;
 #endif
 
+/* First bytes of a gzip stream */
+#define GZIP_MAGIC_0 0x1f
+#define GZIP_MAGIC_1 0x8b
+
 /*
  * We want SLURMDB_MODIFY_ASSOC always to be the last
  */
@@ -875,6 +886,142 @@ static char *_make_archive_name(time_t period_start, time_t period_end,
 			      start_char, end_char);
 }
 
+/*
+ * Inflate a gzip compressed archive.
+ * IN/OUT data - compressed data, replaced by the xmalloc'd inflated data
+ * IN/OUT size - size of data
+ * RET SLURM_SUCCESS or an errno value
+ */
+static int _archive_inflate(char **data, uint32_t *size)
+{
+#if HAVE_LIBZ
+	z_stream strm;
+	unsigned char *in = (unsigned char *) *data;
+	char *out;
+	uint64_t out_size;
+	int rc;
+
+	/* The gzip trailer holds the inflated size modulo 2^32 */
+	out_size = in[*size - 4] | (in[*size - 3] << 8) |
+		   (in[*size - 2] << 16) | ((uint32_t) in[*size - 1] << 24);
+	/* Don't trust the trailer of a damaged file, deflate tops at 1032:1 */
+	if ((out_size >= MAX_BUF_SIZE) ||
+	    (out_size > ((uint64_t) *size * 1032)))
+		out_size = (uint64_t) *size * 4;
+	out_size = MIN(MAX(out_size, *size) + 1, MAX_BUF_SIZE);
+	out = xmalloc_nz(out_size);
+
+	memset(&strm, 0, sizeof(strm));
+	if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
+		error("%s: inflateInit2 failed", __func__);
+		xfree(out);
+		return EINVAL;
+	}
+	strm.next_in = in;
+	strm.avail_in = *size;
+	while (1) {
+		strm.next_out = (Bytef *) out + strm.total_out;
+		/* Leave room for the terminating NUL */
+		strm.avail_out = out_size - strm.total_out - 1;
+		rc = inflate(&strm, Z_NO_FLUSH);
+		if (rc == Z_STREAM_END)
+			break;
+		if ((rc != Z_OK) && (rc != Z_BUF_ERROR)) {
+			error("%s: corrupt compressed archive: %s", __func__,
+			      strm.msg ? strm.msg : "unknown error");
+			(void) inflateEnd(&strm);
+			xfree(out);
+			return EINVAL;
+		}
+		if (!strm.avail_in && strm.avail_out) {
+			error("%s: compressed archive is truncated", __func__);
+			(void) inflateEnd(&strm);
+			xfree(out);
+			return EINVAL;
+		}
+		/* The inflated data must fit in a Buf to be unpacked */
+		if (out_size >= MAX_BUF_SIZE) {
+			error("%s: inflated archive is larger than %u bytes",
+			      __func__, MAX_BUF_SIZE);
+			(void) inflateEnd(&strm);
+			xfree(out);
+			return EINVAL;
+		}
+		out_size = MIN(out_size * 2, MAX_BUF_SIZE);
+		xrealloc_nz(out, out_size);
+	}
+	out[strm.total_out] = '\0';
+	*size = strm.total_out;
+	(void) inflateEnd(&strm);
+
+	xfree(*data);
+	*data = out;
+	return SLURM_SUCCESS;
+#else
+	error("Archive is compressed but Slurm was built without zlib");
+	return EINVAL;
+#endif
+}
+
+extern int archive_read_file(char *file_name, char **data,
+			     uint32_t *data_size)
+{
+	struct stat stat_buf;
+	uint32_t size = 0, alloc_size;
+	ssize_t data_read;
+	char *buf;
+	int fd;
+
+	*data = NULL;
+	*data_size = 0;
+
+	if ((fd = open(file_name, O_RDONLY)) < 0) {
+		info("Could not open archive file `%s`: %m", file_name);
+		return errno;
+	}
+
+	/* The file size is only a hint, keep reading until EOF */
+	if (!fstat(fd, &stat_buf) && (stat_buf.st_size > 0))
+		alloc_size = stat_buf.st_size + 1;
+	else
+		alloc_size = BUF_SIZE + 1;
+	buf = xmalloc_nz(alloc_size);
+
+	while (1) {
+		if (size + 1 >= alloc_size) {
+			alloc_size *= 2;
+			xrealloc_nz(buf, alloc_size);
+		}
+		data_read = read(fd, buf + size, alloc_size - size - 1);
+		if (data_read < 0) {
+			if (errno == EINTR)
+				continue;
+			error("Read error on %s: %m", file_name);
+			close(fd);
+			xfree(buf);
+			return errno;
+		}
+		if (data_read == 0)	/* eof */
+			break;
+		size += data_read;
+	}
+	close(fd);
+	buf[size] = '\0';
+
+	if ((size > 18) && ((unsigned char) buf[0] == GZIP_MAGIC_0) &&
+	    ((unsigned char) buf[1] == GZIP_MAGIC_1)) {
+		int rc;
+		if ((rc = _archive_inflate(&buf, &size)) != SLURM_SUCCESS) {
+			xfree(buf);
+			return rc;
+		}
+	}
+
+	*data = buf;
+	*data_size = size;
+	return SLURM_SUCCESS;
+}
+
 extern int archive_write_file(Buf buffer, char *cluster_name,
 			      time_t period_start, time_t period_end,
 			      char *arch_dir, char *arch_type,
@@ -883,6 +1030,9 @@ extern int archive_write_file(Buf buffer, char *cluster_name,
 	int fd = 0;
 	int rc = SLURM_SUCCESS;
 	char *old_file = NULL, *new_file = NULL, *reg_file = NULL;
+	int pos = 0, nwrite = get_buf_offset(buffer), amount;
+	char *data = (char *)get_buf_data(buffer);
+	char *zdata = NULL;
 	static int high_buffer_size = (1024 * 1024);
 	static pthread_mutex_t local_file_lock = PTHREAD_MUTEX_INITIALIZER;
 
@@ -895,6 +1045,23 @@ extern int archive_write_file(Buf buffer, char *cluster_name,
 				      cluster_name, arch_dir,
 				      arch_type, archive_period);
 
+	high_buffer_size = MAX(nwrite, high_buffer_size);
+#if HAVE_LIBZ
+	/*
+	 * Packed archive records repeat the same accounts, partitions,
+	 * TRES strings and close timestamps and shrink many times.
+	 * Compressed archives get a .gz suffix.
+	 */
+	size_t zsize;
+	if ((zdata = gzip_deflate(data, nwrite, &zsize))) {
+		data = zdata;
+		nwrite = zsize;
+		xstrcat(reg_file, ".gz");
+	} else
+		error("Can't compress archive %s, writing it uncompressed",
+		      reg_file);
+#endif
+
 	debug("Storing %s archive for %s at %s",
 	      arch_type, cluster_name, reg_file);
 	old_file = xstrdup_printf("%s.old", reg_file);
@@ -905,9 +1072,6 @@ extern int archive_write_file(Buf buffer, char *cluster_name,
 		error("Can't save archive, create file %s error %m", new_file);
 		rc = SLURM_ERROR;
 	} else {
-		int pos = 0, nwrite = get_buf_offset(buffer), amount;
-		char *data = (char *)get_buf_data(buffer);
-		high_buffer_size = MAX(nwrite, high_buffer_size);
 		while (nwrite > 0) {
 			amount = write(fd, &data[pos], nwrite);
 			if ((amount < 0) && (errno != EINTR)) {
@@ -921,6 +1085,7 @@ extern int archive_write_file(Buf buffer, char *cluster_name,
 		fsync(fd);
 		close(fd);
 	}
+	xfree(zdata);
 
 	if (rc)
 		(void) unlink(new_file);
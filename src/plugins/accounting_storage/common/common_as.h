@@ -80,9 +80,23 @@ extern char* acct_get_db_name(void);
 extern time_t archive_setup_end_time(time_t last_submit, uint32_t purge);
 extern int archive_run_script(slurmdb_archive_cond_t *arch_cond,
 			      char *cluster_name, time_t last_submit);
+/*
+ * Write an archive buffer to its file, gzip compressed when Slurm is built
+ * with zlib.
+ */
 extern int archive_write_file(Buf buffer, char *cluster_name,
 			      time_t period_start, time_t period_end,
 			      char *arch_dir, char *arch_type,
 			      uint32_t archive_period);
 
+/*
+ * Read an archive file written by archive_write_file(), or an older plain
+ * one, into memory. Compressed files are inflated.
+ * OUT data - xmalloc'd contents, always NUL terminated
+ * OUT data_size - size of data, not counting the terminating NUL
+ * RET SLURM_SUCCESS or an errno value
+ */
+extern int archive_read_file(char *file_name, char **data,
+			     uint32_t *data_size);
+
 #endif
@@ -2727,6 +2727,7 @@ extern int acct_storage_p_close_connection(mysql_conn_t **mysql_conn)
 extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 {
 	int rc = check_connection(mysql_conn);
+	int commit_rc = SLURM_SUCCESS;
 
 	/* always reset this here */
 	if (mysql_conn)
@@ -2765,9 +2766,16 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 			if (rc != SLURM_SUCCESS) {
 				if (mysql_db_rollback(mysql_conn))
 					error("rollback failed");
-			} else {
-				if (mysql_db_commit(mysql_conn))
-					error("commit failed");
+			} else if (mysql_db_commit(mysql_conn)) {
+				/*
+				 * Statements batched with mysql_db_query_batch()
+				 * are only sent here, don't leave half of them
+				 * applied and let the caller know to resend.
+				 */
+				error("commit failed");
+				if (mysql_db_rollback(mysql_conn))
+					error("rollback failed");
+				commit_rc = SLURM_ERROR;
 			}
 		}
 	}
@@ -2835,7 +2843,7 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 	xfree(mysql_conn->pre_commit_query);
 	list_flush(mysql_conn->update_list);
 
-	return SLURM_SUCCESS;
+	return commit_rc;
 }
 
 extern int acct_storage_p_add_users(mysql_conn_t *mysql_conn, uint32_t uid,
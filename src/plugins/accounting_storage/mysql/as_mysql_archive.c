@@ -2272,12 +2272,35 @@ static Buf _pack_archive_events(MYSQL_RES *result, char *cluster_name,
 	return buffer;
 }
 
+/*
+ * Add the values of one record to the insert statement built by the _load_*
+ * functions. insert_len tracks the end of the statement so it is not scanned
+ * again for every one of the many thousand records an archive can hold.
+ */
+static void _append_record(char **insert, size_t *insert_len, char *rec,
+			   int rec_inx)
+{
+	size_t rec_len = strlen(rec);
+	size_t need = *insert_len + rec_len + 3;
+
+	if (need > xsize(*insert))
+		xrealloc_nz(*insert, MAX(need, xsize(*insert) * 2));
+	if (rec_inx) {
+		memcpy(*insert + *insert_len, ", ", 2);
+		*insert_len += 2;
+	}
+	memcpy(*insert + *insert_len, rec, rec_len + 1);
+	*insert_len += rec_len;
+}
+
 /* returns sql statement from archived data or NULL on error */
 static char *
 _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 	     uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_event_t object;
 	int i = 0;
 
@@ -2289,6 +2312,7 @@ _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ");");
 
 	for (i=0; i<rec_cnt; i++) {
@@ -2301,10 +2325,7 @@ _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.period_start,
 			   object.period_end,
 			   object.node_name,
@@ -2313,6 +2334,8 @@ _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 			   object.reason_uid,
 			   object.state,
 			   object.tres_str);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 
 		if (rpc_version < SLURM_15_08_PROTOCOL_VERSION)
 			xfree(object.tres_str);
@@ -2398,6 +2421,8 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 			char *cluster_name, uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_job_t object;
 	int i = 0;
 
@@ -2409,6 +2434,7 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i = 0; i < rec_cnt; i++) {
 
@@ -2420,10 +2446,7 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.account,
 			   object.array_max_tasks,
 			   object.alloc_nodes,
@@ -2467,6 +2490,8 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 			   object.work_dir,
 			   object.tres_alloc_str,
 			   object.tres_req_str);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 
 		if (rpc_version < SLURM_15_08_PROTOCOL_VERSION) {
 			xfree(object.tres_alloc_str);
@@ -2523,6 +2548,8 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 			 char *cluster_name, uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_resv_t object;
 	int i = 0;
 
@@ -2534,6 +2561,7 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_resv_t));
@@ -2545,10 +2573,7 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.id,
 			   object.assocs,
 			   object.flags,
@@ -2559,6 +2584,8 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 			   object.time_start,
 			   object.time_end,
 			   object.unused_wall);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 
 		if (rpc_version < SLURM_15_08_PROTOCOL_VERSION)
 			xfree(object.tres_str);
@@ -2651,6 +2678,8 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 			 char *cluster_name, uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_step_t object;
 	int i;
 
@@ -2662,6 +2691,7 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for (i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_step_t));
@@ -2673,10 +2703,7 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.job_db_inx,
 			   object.stepid,
 			   object.period_start,
@@ -2717,6 +2744,8 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 			   object.tres_usage_out_min_nodeid,
 			   object.tres_usage_out_min_taskid,
 			   object.tres_usage_out_tot);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 
 		if (rpc_version < SLURM_18_08_PROTOCOL_VERSION) {
 			xfree(object.tres_usage_in_ave);
@@ -2780,6 +2809,8 @@ static char *_load_suspend(uint16_t rpc_version, Buf buffer,
 			   char *cluster_name, uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_suspend_t object;
 	int i = 0;
 
@@ -2791,6 +2822,7 @@ static char *_load_suspend(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_suspend_t));
@@ -2802,14 +2834,13 @@ static char *_load_suspend(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.job_db_inx,
 			   object.associd,
 			   object.period_start,
 			   object.period_end);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 	}
 //	END_TIMER2("suspend query");
 //	info("suspend query took %s", TIME_STR);
@@ -2859,6 +2890,8 @@ static char *_load_txn(uint16_t rpc_version, Buf buffer,
 		       char *cluster_name, uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_txn_t object;
 	char *tmp = NULL;
 	int i = 0;
@@ -2871,6 +2904,7 @@ static char *_load_txn(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_txn_t));
@@ -2882,12 +2916,9 @@ static char *_load_txn(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
 		/* object.info has a bunch of "'" in it */
 		tmp = slurm_add_slash_to_quotes(object.info);
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.id,
 			   object.timestamp,
 			   object.action,
@@ -2895,6 +2926,8 @@ static char *_load_txn(uint16_t rpc_version, Buf buffer,
 			   object.actor,
 			   tmp,
 			   object.cluster);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 		xfree(tmp);
 	}
 //	END_TIMER2("txn query");
@@ -2945,6 +2978,8 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 			 uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL, *my_usage_table = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_usage_t object;
 	int i = 0;
 
@@ -2997,6 +3032,7 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_usage_t));
@@ -3008,14 +3044,13 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.id,
 			   object.tres_id,
 			   object.time_start,
 			   object.alloc_secs);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 	}
 //	END_TIMER2("usage query");
 //	info("usage query took %s", TIME_STR);
@@ -3070,6 +3105,8 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 				 uint32_t rec_cnt)
 {
 	char *insert = NULL, *format = NULL, *my_usage_table = NULL;
+	char *rec = NULL;
+	size_t insert_len;
 	local_cluster_usage_t object;
 	int i = 0;
 
@@ -3097,6 +3134,7 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 		xstrcat(format, ", '%s'");
 	}
 	xstrcat(insert, ") values ");
+	insert_len = strlen(insert);
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_cluster_usage_t));
@@ -3108,10 +3146,7 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 			break;
 		}
 
-		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
+		xstrfmtcat(rec, format,
 			   object.tres_id,
 			   object.time_start,
 			   object.tres_cnt,
@@ -3121,6 +3156,8 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 			   object.idle_secs,
 			   object.resv_secs,
 			   object.over_secs);
+		_append_record(&insert, &insert_len, rec, i);
+		xfree(rec);
 	}
 //	END_TIMER2("usage query");
 //	info("usage query took %s", TIME_STR);
@@ -3679,41 +3716,10 @@ extern int as_mysql_jobacct_process_archive_load(
 	if (arch_rec->insert) {
 		data = xstrdup(arch_rec->insert);
 	} else if (arch_rec->archive_file) {
-		int data_allocated, data_read = 0;
-		int state_fd = open(arch_rec->archive_file, O_RDONLY);
-		if (state_fd < 0) {
-			info("Could not open archive file `%s`: %m",
-			     arch_rec->archive_file);
-			error_code = errno;
-		} else {
-			data_allocated = BUF_SIZE + 1;
-			data = xmalloc_nz(data_allocated);
-			while (1) {
-				data_read = read(state_fd, &data[data_size],
-						 BUF_SIZE);
-				if (data_read < 0) {
-					data[data_size] = '\0';
-					if (errno == EINTR)
-						continue;
-					else {
-						error("Read error on %s: %m",
-						      arch_rec->archive_file);
-						break;
-					}
-				}
-				data[data_size + data_read] = '\0';
-				if (data_read == 0)	/* eof */
-					break;
-				data_size      += data_read;
-				data_allocated += data_read;
-				xrealloc_nz(data, data_allocated);
-			}
-			close(state_fd);
-		}
-		if (error_code != SLURM_SUCCESS) {
-			xfree(data);
+		error_code = archive_read_file(arch_rec->archive_file,
+					       &data, &data_size);
+		if (error_code != SLURM_SUCCESS)
 			return error_code;
-		}
 	} else {
 		error("Nothing was set in your "
 		      "slurmdb_archive_rec so I am unable to process.");
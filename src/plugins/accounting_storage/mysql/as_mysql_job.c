@@ -53,7 +53,7 @@
 static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 				 int tres_cnt, int tasks)
 {
-	char *ret_str = NULL;
+	char *ret_str = NULL, *pos = NULL;
 	int i;
 
 	/*
@@ -66,9 +66,9 @@ static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 	for (i = 0; i < tres_cnt; i++) {
 		if (tres_cnts[i] == INFINITE64)
 			continue;
-		xstrfmtcat(ret_str, "%s%u=%"PRIu64,
-			   ret_str ? "," : "",
-			   tres_ids[i], tres_cnts[i] / (uint64_t)tasks);
+		xstrfmtcatat(ret_str, &pos, "%s%u=%"PRIu64,
+			     ret_str ? "," : "",
+			     tres_ids[i], tres_cnts[i] / (uint64_t)tasks);
 	}
 
 	if (!ret_str)
@@ -76,6 +76,20 @@ static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 	return ret_str;
 }
 
+/*
+ * Run a statement which only updates job, step or suspend records. When
+ * slurmdbd commits after every RPC from the slurmctld the statement is queued
+ * and sent together with the rest of the RPC's writes in one round trip (see
+ * mysql_db_query_batch()). A failure then shows up at commit time, the whole
+ * transaction is rolled back and the slurmctld resends the RPC.
+ */
+static int _job_write(mysql_conn_t *mysql_conn, char *query)
+{
+	if (slurmdbd_conf && !slurmdbd_conf->commit_delay)
+		return mysql_db_query_batch(mysql_conn, query);
+	return mysql_db_query(mysql_conn, query);
+}
+
 /* Used in job functions for getting the database index based off the
  * submit time and job.  0 is returned if none is found
  */
@@ -271,7 +285,7 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn,
 	char *nodes = NULL, *jname = NULL;
 	int track_steps = 0;
 	char *partition = NULL;
-	char *query = NULL;
+	char *query = NULL, *pos = NULL;
 	int reinit = 0;
 	time_t begin_time, check_time, start_time, submit_time;
 	uint32_t wckeyid = 0;
@@ -466,160 +480,173 @@ no_rollup_change:
 			mysql_conn->cluster_name, job_table);
 
 		if (wckeyid)
-			xstrcat(query, ", id_wckey");
+			xstrcatat(query, &pos, ", id_wckey");
 		if (job_ptr->mcs_label)
-			xstrcat(query, ", mcs_label");
+			xstrcatat(query, &pos, ", mcs_label");
 		if (job_ptr->account)
-			xstrcat(query, ", account");
+			xstrcatat(query, &pos, ", account");
 		if (partition)
-			xstrcat(query, ", `partition`");
+			xstrcatat(query, &pos, ", `partition`");
 		if (job_ptr->wckey)
-			xstrcat(query, ", wckey");
+			xstrcatat(query, &pos, ", wckey");
 		if (job_ptr->network)
-			xstrcat(query, ", node_inx");
+			xstrcatat(query, &pos, ", node_inx");
 		if (job_ptr->gres_req)
-			xstrcat(query, ", gres_req");
+			xstrcatat(query, &pos, ", gres_req");
 		if (job_ptr->gres_alloc)
-			xstrcat(query, ", gres_alloc");
+			xstrcatat(query, &pos, ", gres_alloc");
 		if (array_recs && array_recs->task_id_str)
-			xstrcat(query, ", array_task_str, array_max_tasks, "
-				"array_task_pending");
+			xstrcatat(query, &pos,
+				  ", array_task_str, array_max_tasks, "
+				  "array_task_pending");
 		else
-			xstrcat(query, ", array_task_str, array_task_pending");
+			xstrcatat(query, &pos,
+				  ", array_task_str, array_task_pending");
 
 		if (job_ptr->tres_alloc_str || tres_alloc_str)
-			xstrcat(query, ", tres_alloc");
+			xstrcatat(query, &pos, ", tres_alloc");
 		if (job_ptr->tres_req_str)
-			xstrcat(query, ", tres_req");
+			xstrcatat(query, &pos, ", tres_req");
 		if (job_ptr->details->work_dir)
-			xstrcat(query, ", work_dir");
+			xstrcatat(query, &pos, ", work_dir");
 		if (job_ptr->details->features)
-			xstrcat(query, ", constraints");
-
-		xstrfmtcat(query,
-			   ") values (%u, UNIX_TIMESTAMP(), "
-			   "%u, %u, %u, %u, %u, %u, %u, %u, "
-			   "'%s', %u, %u, %ld, %ld, %ld, "
-			   "'%s', %u, %u, %u, %u, %u, %"PRIu64", %u, %u",
-			   job_ptr->job_id,
-			   job_ptr->array_job_id, array_task_id,
-			   job_ptr->pack_job_id, job_ptr->pack_job_offset,
-			   job_ptr->assoc_id, job_ptr->qos_id,
-			   job_ptr->user_id, job_ptr->group_id, nodes,
-			   job_ptr->resv_id, job_ptr->time_limit,
-			   begin_time, submit_time, start_time,
-			   jname, track_steps, job_state,
-			   job_ptr->priority, job_ptr->details->min_cpus,
-			   job_ptr->total_nodes,
-			   job_ptr->details->pn_min_memory,
-			   job_ptr->db_flags,
-			   job_ptr->state_reason_prev_db);
+			xstrcatat(query, &pos, ", constraints");
+
+		xstrfmtcatat(query, &pos,
+			     ") values (%u, UNIX_TIMESTAMP(), "
+			     "%u, %u, %u, %u, %u, %u, %u, %u, "
+			     "'%s', %u, %u, %ld, %ld, %ld, "
+			     "'%s', %u, %u, %u, %u, %u, %"PRIu64", %u, %u",
+			     job_ptr->job_id,
+			     job_ptr->array_job_id, array_task_id,
+			     job_ptr->pack_job_id, job_ptr->pack_job_offset,
+			     job_ptr->assoc_id, job_ptr->qos_id,
+			     job_ptr->user_id, job_ptr->group_id, nodes,
+			     job_ptr->resv_id, job_ptr->time_limit,
+			     begin_time, submit_time, start_time,
+			     jname, track_steps, job_state,
+			     job_ptr->priority, job_ptr->details->min_cpus,
+			     job_ptr->total_nodes,
+			     job_ptr->details->pn_min_memory,
+			     job_ptr->db_flags,
+			     job_ptr->state_reason_prev_db);
 
 		if (wckeyid)
-			xstrfmtcat(query, ", %u", wckeyid);
+			xstrfmtcatat(query, &pos, ", %u", wckeyid);
 		if (job_ptr->mcs_label)
-			xstrfmtcat(query, ", '%s'", job_ptr->mcs_label);
+			xstrfmtcatat(query, &pos, ", '%s'", job_ptr->mcs_label);
 		if (job_ptr->account)
-			xstrfmtcat(query, ", '%s'", job_ptr->account);
+			xstrfmtcatat(query, &pos, ", '%s'", job_ptr->account);
 		if (partition)
-			xstrfmtcat(query, ", '%s'", partition);
+			xstrfmtcatat(query, &pos, ", '%s'", partition);
 		if (job_ptr->wckey)
-			xstrfmtcat(query, ", '%s'", job_ptr->wckey);
+			xstrfmtcatat(query, &pos, ", '%s'", job_ptr->wckey);
 		if (job_ptr->network)
-			xstrfmtcat(query, ", '%s'", job_ptr->network);
+			xstrfmtcatat(query, &pos, ", '%s'", job_ptr->network);
 		if (job_ptr->gres_req)
-			xstrfmtcat(query, ", '%s'", job_ptr->gres_req);
+			xstrfmtcatat(query, &pos, ", '%s'", job_ptr->gres_req);
 		if (job_ptr->gres_alloc)
-			xstrfmtcat(query, ", '%s'", job_ptr->gres_alloc);
+			xstrfmtcatat(query, &pos, ", '%s'",
+				     job_ptr->gres_alloc);
 		if (array_recs && array_recs->task_id_str)
-			xstrfmtcat(query, ", '%s', %u, %u",
-				   array_recs->task_id_str,
-				   array_recs->max_run_tasks,
-				   array_recs->task_cnt);
+			xstrfmtcatat(query, &pos, ", '%s', %u, %u",
+				     array_recs->task_id_str,
+				     array_recs->max_run_tasks,
+				     array_recs->task_cnt);
 		else
-			xstrcat(query, ", NULL, 0");
+			xstrcatat(query, &pos, ", NULL, 0");
 
 		if (tres_alloc_str)
-			xstrfmtcat(query, ", '%s'", tres_alloc_str);
+			xstrfmtcatat(query, &pos, ", '%s'", tres_alloc_str);
 		else if (job_ptr->tres_alloc_str)
-			xstrfmtcat(query, ", '%s'", job_ptr->tres_alloc_str);
+			xstrfmtcatat(query, &pos, ", '%s'",
+				     job_ptr->tres_alloc_str);
 		if (job_ptr->tres_req_str)
-			xstrfmtcat(query, ", '%s'", job_ptr->tres_req_str);
+			xstrfmtcatat(query, &pos, ", '%s'",
+				     job_ptr->tres_req_str);
 		if (job_ptr->details->work_dir)
-			xstrfmtcat(query, ", '%s'",
-				   job_ptr->details->work_dir);
+			xstrfmtcatat(query, &pos, ", '%s'",
+				     job_ptr->details->work_dir);
 		if (job_ptr->details->features)
-			xstrfmtcat(query, ", '%s'",
-				   job_ptr->details->features);
-
-		xstrfmtcat(query,
-			   ") on duplicate key update "
-			   "job_db_inx=LAST_INSERT_ID(job_db_inx), "
-			   "id_assoc=%u, id_user=%u, id_group=%u, "
-			   "nodelist='%s', id_resv=%u, timelimit=%u, "
-			   "time_submit=%ld, time_eligible=%ld, "
-			   "time_start=%ld, mod_time=UNIX_TIMESTAMP(), "
-			   "job_name='%s', track_steps=%u, id_qos=%u, "
-			   "state=greatest(state, %u), priority=%u, "
-			   "cpus_req=%u, nodes_alloc=%u, "
-			   "mem_req=%"PRIu64", id_array_job=%u, id_array_task=%u, "
-			   "pack_job_id=%u, pack_job_offset=%u, flags=%u, "
-			   "state_reason_prev=%u",
-			   job_ptr->assoc_id, job_ptr->user_id,
-			   job_ptr->group_id, nodes,
-			   job_ptr->resv_id, job_ptr->time_limit,
-			   submit_time, begin_time, start_time,
-			   jname, track_steps, job_ptr->qos_id, job_state,
-			   job_ptr->priority, job_ptr->details->min_cpus,
-			   job_ptr->total_nodes,
-			   job_ptr->details->pn_min_memory,
-			   job_ptr->array_job_id, array_task_id,
-			   job_ptr->pack_job_id, job_ptr->pack_job_offset,
-			   job_ptr->db_flags,
-			   job_ptr->state_reason_prev_db);
+			xstrfmtcatat(query, &pos, ", '%s'",
+				     job_ptr->details->features);
+
+		xstrfmtcatat(query, &pos,
+			     ") on duplicate key update "
+			     "job_db_inx=LAST_INSERT_ID(job_db_inx), "
+			     "id_assoc=%u, id_user=%u, id_group=%u, "
+			     "nodelist='%s', id_resv=%u, timelimit=%u, "
+			     "time_submit=%ld, time_eligible=%ld, "
+			     "time_start=%ld, mod_time=UNIX_TIMESTAMP(), "
+			     "job_name='%s', track_steps=%u, id_qos=%u, "
+			     "state=greatest(state, %u), priority=%u, "
+			     "cpus_req=%u, nodes_alloc=%u, "
+			     "mem_req=%"PRIu64", id_array_job=%u, "
+			     "id_array_task=%u, "
+			     "pack_job_id=%u, pack_job_offset=%u, flags=%u, "
+			     "state_reason_prev=%u",
+			     job_ptr->assoc_id, job_ptr->user_id,
+			     job_ptr->group_id, nodes,
+			     job_ptr->resv_id, job_ptr->time_limit,
+			     submit_time, begin_time, start_time,
+			     jname, track_steps, job_ptr->qos_id, job_state,
+			     job_ptr->priority, job_ptr->details->min_cpus,
+			     job_ptr->total_nodes,
+			     job_ptr->details->pn_min_memory,
+			     job_ptr->array_job_id, array_task_id,
+			     job_ptr->pack_job_id, job_ptr->pack_job_offset,
+			     job_ptr->db_flags,
+			     job_ptr->state_reason_prev_db);
 
 		if (wckeyid)
-			xstrfmtcat(query, ", id_wckey=%u", wckeyid);
+			xstrfmtcatat(query, &pos, ", id_wckey=%u", wckeyid);
 		if (job_ptr->mcs_label)
-			xstrfmtcat(query, ", mcs_label='%s'",
-				   job_ptr->mcs_label);
+			xstrfmtcatat(query, &pos, ", mcs_label='%s'",
+				     job_ptr->mcs_label);
 		if (job_ptr->account)
-			xstrfmtcat(query, ", account='%s'", job_ptr->account);
+			xstrfmtcatat(query, &pos, ", account='%s'",
+				     job_ptr->account);
 		if (partition)
-			xstrfmtcat(query, ", `partition`='%s'", partition);
+			xstrfmtcatat(query, &pos, ", `partition`='%s'",
+				     partition);
 		if (job_ptr->wckey)
-			xstrfmtcat(query, ", wckey='%s'", job_ptr->wckey);
+			xstrfmtcatat(query, &pos, ", wckey='%s'",
+				     job_ptr->wckey);
 		if (job_ptr->network)
-			xstrfmtcat(query, ", node_inx='%s'", job_ptr->network);
+			xstrfmtcatat(query, &pos, ", node_inx='%s'",
+				     job_ptr->network);
 		if (job_ptr->gres_req)
-			xstrfmtcat(query, ", gres_req='%s'", job_ptr->gres_req);
+			xstrfmtcatat(query, &pos, ", gres_req='%s'",
+				     job_ptr->gres_req);
 		if (job_ptr->gres_alloc)
-			xstrfmtcat(query, ", gres_alloc='%s'",
-				   job_ptr->gres_alloc);
+			xstrfmtcatat(query, &pos, ", gres_alloc='%s'",
+				     job_ptr->gres_alloc);
 		if (array_recs && array_recs->task_id_str)
-			xstrfmtcat(query, ", array_task_str='%s', "
-				   "array_max_tasks=%u, array_task_pending=%u",
-				   array_recs->task_id_str,
-				   array_recs->max_run_tasks,
-				   array_recs->task_cnt);
+			xstrfmtcatat(query, &pos, ", array_task_str='%s', "
+				     "array_max_tasks=%u, "
+				     "array_task_pending=%u",
+				     array_recs->task_id_str,
+				     array_recs->max_run_tasks,
+				     array_recs->task_cnt);
 		else
-			xstrfmtcat(query, ", array_task_str=NULL, "
-				   "array_task_pending=0");
+			xstrfmtcatat(query, &pos, ", array_task_str=NULL, "
+				     "array_task_pending=0");
 
 		if (tres_alloc_str)
-			xstrfmtcat(query, ", tres_alloc='%s'", tres_alloc_str);
+			xstrfmtcatat(query, &pos, ", tres_alloc='%s'",
+				     tres_alloc_str);
 		else if (job_ptr->tres_alloc_str)
-			xstrfmtcat(query, ", tres_alloc='%s'",
-				   job_ptr->tres_alloc_str);
+			xstrfmtcatat(query, &pos, ", tres_alloc='%s'",
+				     job_ptr->tres_alloc_str);
 		if (job_ptr->tres_req_str)
-			xstrfmtcat(query, ", tres_req='%s'",
-				   job_ptr->tres_req_str);
+			xstrfmtcatat(query, &pos, ", tres_req='%s'",
+				     job_ptr->tres_req_str);
 		if (job_ptr->details->work_dir)
-			xstrfmtcat(query, ", work_dir='%s'",
-				   job_ptr->details->work_dir);
+			xstrfmtcatat(query, &pos, ", work_dir='%s'",
+				     job_ptr->details->work_dir);
 		if (job_ptr->details->features)
-			xstrfmtcat(query, ", constraints='%s'",
-				   job_ptr->details->features);
+			xstrfmtcatat(query, &pos, ", constraints='%s'",
+				     job_ptr->details->features);
 
 		if (debug_flags & DEBUG_FLAG_DB_JOB)
 			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
@@ -642,69 +669,74 @@ no_rollup_change:
 				       job_table, nodes);
 
 		if (wckeyid)
-			xstrfmtcat(query, "id_wckey=%u, ", wckeyid);
+			xstrfmtcatat(query, &pos, "id_wckey=%u, ", wckeyid);
 		if (job_ptr->mcs_label)
-			xstrfmtcat(query, "mcs_label='%s', ",
-				   job_ptr->mcs_label);
+			xstrfmtcatat(query, &pos, "mcs_label='%s', ",
+				     job_ptr->mcs_label);
 		if (job_ptr->account)
-			xstrfmtcat(query, "account='%s', ", job_ptr->account);
+			xstrfmtcatat(query, &pos, "account='%s', ",
+				     job_ptr->account);
 		if (partition)
-			xstrfmtcat(query, "`partition`='%s', ", partition);
+			xstrfmtcatat(query, &pos, "`partition`='%s', ",
+				     partition);
 		if (job_ptr->wckey)
-			xstrfmtcat(query, "wckey='%s', ", job_ptr->wckey);
+			xstrfmtcatat(query, &pos, "wckey='%s', ",
+				     job_ptr->wckey);
 		if (job_ptr->network)
-			xstrfmtcat(query, "node_inx='%s', ", job_ptr->network);
+			xstrfmtcatat(query, &pos, "node_inx='%s', ",
+				     job_ptr->network);
 		if (job_ptr->gres_req)
-			xstrfmtcat(query, "gres_req='%s', ",
-				   job_ptr->gres_req);
+			xstrfmtcatat(query, &pos, "gres_req='%s', ",
+				     job_ptr->gres_req);
 		if (job_ptr->gres_alloc)
-			xstrfmtcat(query, "gres_alloc='%s', ",
-				   job_ptr->gres_alloc);
+			xstrfmtcatat(query, &pos, "gres_alloc='%s', ",
+				     job_ptr->gres_alloc);
 		if (array_recs && array_recs->task_id_str)
-			xstrfmtcat(query, "array_task_str='%s', "
-				   "array_max_tasks=%u, "
-				   "array_task_pending=%u, ",
-				   array_recs->task_id_str,
-				   array_recs->max_run_tasks,
-				   array_recs->task_cnt);
+			xstrfmtcatat(query, &pos, "array_task_str='%s', "
+				     "array_max_tasks=%u, "
+				     "array_task_pending=%u, ",
+				     array_recs->task_id_str,
+				     array_recs->max_run_tasks,
+				     array_recs->task_cnt);
 		else
-			xstrfmtcat(query, "array_task_str=NULL, "
-				   "array_task_pending=0, ");
+			xstrfmtcatat(query, &pos, "array_task_str=NULL, "
+				     "array_task_pending=0, ");
 
 		if (tres_alloc_str)
-			xstrfmtcat(query, "tres_alloc='%s', ", tres_alloc_str);
+			xstrfmtcatat(query, &pos, "tres_alloc='%s', ",
+				     tres_alloc_str);
 		else if (job_ptr->tres_alloc_str)
-			xstrfmtcat(query, "tres_alloc='%s', ",
-				   job_ptr->tres_alloc_str);
+			xstrfmtcatat(query, &pos, "tres_alloc='%s', ",
+				     job_ptr->tres_alloc_str);
 		if (job_ptr->tres_req_str)
-			xstrfmtcat(query, "tres_req='%s', ",
-				   job_ptr->tres_req_str);
+			xstrfmtcatat(query, &pos, "tres_req='%s', ",
+				     job_ptr->tres_req_str);
 		if (job_ptr->details->work_dir)
-			xstrfmtcat(query, "work_dir='%s', ",
-				   job_ptr->details->work_dir);
+			xstrfmtcatat(query, &pos, "work_dir='%s', ",
+				     job_ptr->details->work_dir);
 		if (job_ptr->details->features)
-			xstrfmtcat(query, "constraints='%s', ",
-				   job_ptr->details->features);
-
-		xstrfmtcat(query, "time_start=%ld, job_name='%s', "
-			   "state=greatest(state, %u), "
-			   "nodes_alloc=%u, id_qos=%u, "
-			   "id_assoc=%u, id_resv=%u, "
-			   "timelimit=%u, mem_req=%"PRIu64", "
-			   "id_array_job=%u, id_array_task=%u, "
-			   "pack_job_id=%u, pack_job_offset=%u, "
-			   "flags=%u, state_reason_prev=%u, "
-			   "time_eligible=%ld, mod_time=UNIX_TIMESTAMP() "
-			   "where job_db_inx=%"PRIu64,
-			   start_time, jname, job_state,
-			   job_ptr->total_nodes, job_ptr->qos_id,
-			   job_ptr->assoc_id,
-			   job_ptr->resv_id, job_ptr->time_limit,
-			   job_ptr->details->pn_min_memory,
-			   job_ptr->array_job_id, array_task_id,
-			   job_ptr->pack_job_id, job_ptr->pack_job_offset,
-			   job_ptr->db_flags, job_ptr->state_reason_prev_db,
-			   begin_time, job_ptr->db_index);
+			xstrfmtcatat(query, &pos, "constraints='%s', ",
+				     job_ptr->details->features);
+
+		xstrfmtcatat(query, &pos, "time_start=%ld, job_name='%s', "
+			     "state=greatest(state, %u), "
+			     "nodes_alloc=%u, id_qos=%u, "
+			     "id_assoc=%u, id_resv=%u, "
+			     "timelimit=%u, mem_req=%"PRIu64", "
+			     "id_array_job=%u, id_array_task=%u, "
+			     "pack_job_id=%u, pack_job_offset=%u, "
+			     "flags=%u, state_reason_prev=%u, "
+			     "time_eligible=%ld, mod_time=UNIX_TIMESTAMP() "
+			     "where job_db_inx=%"PRIu64,
+			     start_time, jname, job_state,
+			     job_ptr->total_nodes, job_ptr->qos_id,
+			     job_ptr->assoc_id,
+			     job_ptr->resv_id, job_ptr->time_limit,
+			     job_ptr->details->pn_min_memory,
+			     job_ptr->array_job_id, array_task_id,
+			     job_ptr->pack_job_id, job_ptr->pack_job_offset,
+			     job_ptr->db_flags, job_ptr->state_reason_prev_db,
+			     begin_time, job_ptr->db_index);
 
 		if (debug_flags & DEBUG_FLAG_DB_JOB)
 			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
@@ -982,7 +1014,7 @@ extern int as_mysql_job_complete(mysql_conn_t *mysql_conn,
 
 	if (debug_flags & DEBUG_FLAG_DB_JOB)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = _job_write(mysql_conn, query);
 	xfree(query);
 
 	xfree(tres_alloc_str);
@@ -1130,7 +1162,7 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 		step_ptr->tres_alloc_str);
 	if (debug_flags & DEBUG_FLAG_DB_STEP)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = _job_write(mysql_conn, query);
 	xfree(query);
 
 	return rc;
@@ -1379,7 +1411,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 		   step_ptr->job_ptr->db_index, step_ptr->step_id);
 	if (debug_flags & DEBUG_FLAG_DB_STEP)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = _job_write(mysql_conn, query);
 	xfree(query);
 
 	/* set the energy for the entire job. */
@@ -1392,7 +1424,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			step_ptr->job_ptr->db_index);
 		if (debug_flags & DEBUG_FLAG_DB_STEP)
 			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = _job_write(mysql_conn, query);
 		xfree(query);
 	}
 
@@ -1477,7 +1509,7 @@ extern int as_mysql_suspend(mysql_conn_t *mysql_conn,
 	if (debug_flags & DEBUG_FLAG_DB_JOB)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
 
-	rc = mysql_db_query(mysql_conn, query);
+	rc = _job_write(mysql_conn, query);
 
 	xfree(query);
 	if (rc != SLURM_ERROR) {
@@ -1488,7 +1520,7 @@ extern int as_mysql_suspend(mysql_conn_t *mysql_conn,
 			   mysql_conn->cluster_name, step_table,
 			   (int)job_ptr->suspend_time,
 			   job_ptr->job_state, job_ptr->db_index);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = _job_write(mysql_conn, query);
 		xfree(query);
 	}
 
@@ -1502,9 +1534,9 @@ extern int as_mysql_flush_jobs_on_cluster(
 	/* put end times for a clean start */
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
-	char *query = NULL;
-	char *id_char = NULL;
-	char *suspended_char = NULL;
+	char *query = NULL, *pos = NULL;
+	char *id_char = NULL, *id_pos = NULL;
+	char *suspended_char = NULL, *suspended_pos = NULL;
 
 	if (check_connection(mysql_conn) != SLURM_SUCCESS)
 		return ESLURM_DB_CONNECTION;
@@ -1529,53 +1561,54 @@ extern int as_mysql_flush_jobs_on_cluster(
 		int state = slurm_atoul(row[1]);
 		if (state == JOB_SUSPENDED) {
 			if (suspended_char)
-				xstrfmtcat(suspended_char,
-					   ", %s", row[0]);
+				xstrfmtcatat(suspended_char, &suspended_pos,
+					     ", %s", row[0]);
 			else
-				xstrfmtcat(suspended_char, "job_db_inx in (%s",
-					   row[0]);
+				xstrfmtcatat(suspended_char, &suspended_pos,
+					     "job_db_inx in (%s", row[0]);
 		}
 
 		if (id_char)
-			xstrfmtcat(id_char, ", %s", row[0]);
+			xstrfmtcatat(id_char, &id_pos, ", %s", row[0]);
 		else
-			xstrfmtcat(id_char, "job_db_inx in (%s", row[0]);
+			xstrfmtcatat(id_char, &id_pos, "job_db_inx in (%s",
+				     row[0]);
 	}
 	mysql_free_result(result);
 
 	if (suspended_char) {
-		xstrfmtcat(suspended_char, ")");
-		xstrfmtcat(query,
-			   "update \"%s_%s\" set "
-			   "time_suspended=%ld-time_suspended "
-			   "where %s;",
-			   mysql_conn->cluster_name, job_table,
-			   event_time, suspended_char);
-		xstrfmtcat(query,
-			   "update \"%s_%s\" set "
-			   "time_suspended=%ld-time_suspended "
-			   "where %s;",
-			   mysql_conn->cluster_name, step_table,
-			   event_time, suspended_char);
-		xstrfmtcat(query,
-			   "update \"%s_%s\" set time_end=%ld where (%s) "
-			   "&& time_end=0;",
-			   mysql_conn->cluster_name, suspend_table,
-			   event_time, suspended_char);
+		xstrfmtcatat(suspended_char, &suspended_pos, ")");
+		xstrfmtcatat(query, &pos,
+			     "update \"%s_%s\" set "
+			     "time_suspended=%ld-time_suspended "
+			     "where %s;",
+			     mysql_conn->cluster_name, job_table,
+			     event_time, suspended_char);
+		xstrfmtcatat(query, &pos,
+			     "update \"%s_%s\" set "
+			     "time_suspended=%ld-time_suspended "
+			     "where %s;",
+			     mysql_conn->cluster_name, step_table,
+			     event_time, suspended_char);
+		xstrfmtcatat(query, &pos,
+			     "update \"%s_%s\" set time_end=%ld where (%s) "
+			     "&& time_end=0;",
+			     mysql_conn->cluster_name, suspend_table,
+			     event_time, suspended_char);
 		xfree(suspended_char);
 	}
 	if (id_char) {
-		xstrfmtcat(id_char, ")");
-		xstrfmtcat(query,
-			   "update \"%s_%s\" set state=%d, "
-			   "time_end=%ld where %s;",
-			   mysql_conn->cluster_name, job_table,
-			   JOB_CANCELLED, event_time, id_char);
-		xstrfmtcat(query,
-			   "update \"%s_%s\" set state=%d, "
-			   "time_end=%ld where %s;",
-			   mysql_conn->cluster_name, step_table,
-			   JOB_CANCELLED, event_time, id_char);
+		xstrfmtcatat(id_char, &id_pos, ")");
+		xstrfmtcatat(query, &pos,
+			     "update \"%s_%s\" set state=%d, "
+			     "time_end=%ld where %s;",
+			     mysql_conn->cluster_name, job_table,
+			     JOB_CANCELLED, event_time, id_char);
+		xstrfmtcatat(query, &pos,
+			     "update \"%s_%s\" set state=%d, "
+			     "time_end=%ld where %s;",
+			     mysql_conn->cluster_name, step_table,
+			     JOB_CANCELLED, event_time, id_char);
 		xfree(id_char);
 	}
 
@@ -453,6 +453,290 @@ static void _destroy_local_cluster(void *object)
 	}
 }
 
+/* A job waiting for its steps from _get_job_steps() */
+typedef struct {
+	uint64_t db_inx;
+	slurmdb_job_rec_t *job;
+	bool job_ended;
+	slurmdb_step_rec_t *last_step;
+	int start;		/* start time from the database for node_inx */
+} step_parent_t;
+
+/* Most jobs to request the steps of in one query */
+#define STEP_QUERY_JOBS 1000
+
+static slurmdb_step_rec_t *_make_step(MYSQL_ROW step_row,
+				      slurmdb_job_rec_t *job, bool job_ended,
+				      slurmdb_job_cond_t *job_cond, time_t now)
+{
+	slurmdb_step_rec_t *step;
+
+	step = slurmdb_create_step_rec();
+	step->tot_cpu_sec = 0;
+	step->tot_cpu_usec = 0;
+	step->job_ptr = job;
+	if (!job->first_step_ptr)
+		job->first_step_ptr = step;
+	list_append(job->steps, step);
+	step->stepid = slurm_atoul(step_row[STEP_REQ_STEPID]);
+	/* info("got step %u.%u", */
+/* 			     job->header.jobnum, step->stepnum); */
+	step->state = slurm_atoul(step_row[STEP_REQ_STATE]);
+	step->exitcode =
+		slurm_atoul(step_row[STEP_REQ_EXIT_CODE]);
+	step->nnodes = slurm_atoul(step_row[STEP_REQ_NODES]);
+
+	step->ntasks = slurm_atoul(step_row[STEP_REQ_TASKS]);
+	step->task_dist =
+		slurm_atoul(step_row[STEP_REQ_TASKDIST]);
+
+	step->start = slurm_atoul(step_row[STEP_REQ_START]);
+
+	step->end = slurm_atoul(step_row[STEP_REQ_END]);
+	/* if the job has ended end the step also */
+	if (!step->end && job_ended) {
+		step->end = job->end;
+		step->state = job->state;
+	}
+
+	if (job_cond &&
+	    !(job_cond->flags & JOBCOND_FLAG_NO_TRUNC)
+	    && job_cond->usage_start) {
+		if (step->start
+		    && (step->start < job_cond->usage_start))
+			step->start = job_cond->usage_start;
+
+		if (!step->start && step->end)
+			step->start = step->end;
+
+		if (!step->end
+		    || (step->end > job_cond->usage_end))
+			step->end = job_cond->usage_end;
+
+		if (step->start && step->end &&
+		   (step->start > step->end))
+			step->start = step->end = 0;
+	}
+
+	/* figure this out by start stop */
+	step->suspended =
+		slurm_atoul(step_row[STEP_REQ_SUSPENDED]);
+
+	/* fix the suspended number to be correct */
+	if (step->state == JOB_SUSPENDED)
+		step->suspended = now - step->suspended;
+	if (!step->start) {
+		step->elapsed = 0;
+	} else if (!step->end) {
+		step->elapsed = now - step->start;
+	} else {
+		step->elapsed = step->end - step->start;
+	}
+	step->elapsed -= step->suspended;
+
+	if ((int)step->elapsed < 0)
+		step->elapsed = 0;
+
+	step->req_cpufreq_min = slurm_atoul(
+		step_row[STEP_REQ_REQ_CPUFREQ_MIN]);
+	step->req_cpufreq_max = slurm_atoul(
+		step_row[STEP_REQ_REQ_CPUFREQ_MAX]);
+	step->req_cpufreq_gov =	slurm_atoul(
+		step_row[STEP_REQ_REQ_CPUFREQ_GOV]);
+
+	step->stepname = xstrdup(step_row[STEP_REQ_NAME]);
+	step->nodes = xstrdup(step_row[STEP_REQ_NODELIST]);
+	step->requid =
+		slurm_atoul(step_row[STEP_REQ_KILL_REQUID]);
+
+	step->user_cpu_sec = slurm_atoul(
+		step_row[STEP_REQ_USER_SEC]);
+	step->user_cpu_usec = slurm_atoul(
+		step_row[STEP_REQ_USER_USEC]);
+	step->sys_cpu_sec =
+		slurm_atoul(step_row[STEP_REQ_SYS_SEC]);
+	step->sys_cpu_usec = slurm_atoul(
+		step_row[STEP_REQ_SYS_USEC]);
+	step->tot_cpu_sec +=
+		step->user_cpu_sec + step->sys_cpu_sec;
+	step->tot_cpu_usec += step->user_cpu_usec +
+		step->sys_cpu_usec;
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MAX])
+		step->stats.tres_usage_in_max =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MAX_TASKID])
+		step->stats.tres_usage_in_max_taskid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX_TASKID]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MAX_NODEID])
+		step->stats.tres_usage_in_max_nodeid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX_NODEID]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_AVE])
+		step->stats.tres_usage_in_ave =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_AVE]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MIN])
+		step->stats.tres_usage_in_min =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MIN_TASKID])
+		step->stats.tres_usage_in_min_taskid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN_TASKID]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_MIN_NODEID])
+		step->stats.tres_usage_in_min_nodeid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN_NODEID]);
+	if (step_row[STEP_REQ_TRES_USAGE_IN_TOT])
+		step->stats.tres_usage_in_tot =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_TOT]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX])
+		step->stats.tres_usage_out_max =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX_TASKID])
+		step->stats.tres_usage_out_max_taskid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX_TASKID]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX_NODEID])
+		step->stats.tres_usage_out_max_nodeid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX_NODEID]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_AVE])
+		step->stats.tres_usage_out_ave =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_AVE]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN])
+		step->stats.tres_usage_out_min =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN_TASKID])
+		step->stats.tres_usage_out_min_taskid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN_TASKID]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN_NODEID])
+		step->stats.tres_usage_out_min_nodeid =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN_NODEID]);
+	if (step_row[STEP_REQ_TRES_USAGE_OUT_TOT])
+		step->stats.tres_usage_out_tot =
+			xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_TOT]);
+	step->stats.act_cpufreq =
+		atof(step_row[STEP_REQ_ACT_CPUFREQ]);
+	step->stats.consumed_energy = slurm_atoull(
+		step_row[STEP_REQ_CONSUMED_ENERGY]);
+
+	if (step_row[STEP_REQ_TRES])
+		step->tres_alloc_str =
+			xstrdup(step_row[STEP_REQ_TRES]);
+
+	return step;
+}
+
+/* step is the last step added to the job, if any */
+static void _set_track_steps(slurmdb_job_rec_t *job, slurmdb_step_rec_t *step)
+{
+	if (!job->track_steps) {
+		uint64_t j_cpus, s_cpus;
+		/* If we don't have track_steps we want to see
+		   if we have multiple steps.  If we only have
+		   1 step check the job name against the step
+		   name in most all cases it will be
+		   different.  If it is different print out
+		   the step separate.  It could also be a single
+		   step/allocation where the job was allocated more than
+		   the step requested (eg. CR_Socket).
+		*/
+		if (list_count(job->steps) > 1)
+			job->track_steps = 1;
+		else if (step &&
+			 (xstrcmp(step->stepname, job->jobname) ||
+			  (((j_cpus = slurmdb_find_tres_count_in_string(
+				     job->tres_alloc_str, TRES_CPU))
+			    != INFINITE64) &&
+			   ((s_cpus = slurmdb_find_tres_count_in_string(
+				     step->tres_alloc_str, TRES_CPU))
+			    != INFINITE64) &&
+			  j_cpus != s_cpus)))
+				job->track_steps = 1;
+	}
+}
+
+static int _sort_step_parent(const void *x, const void *y)
+{
+	uint64_t inx_x = ((step_parent_t *) x)->db_inx;
+	uint64_t inx_y = ((step_parent_t *) y)->db_inx;
+
+	if (inx_x < inx_y)
+		return -1;
+	if (inx_x > inx_y)
+		return 1;
+	return 0;
+}
+
+/*
+ * Get the steps of all the jobs found with one query per STEP_QUERY_JOBS
+ * jobs instead of one query per job. The job_db_inx lists are in primary key
+ * order so each query is a range scan of the step table, rows are matched
+ * back to their job with a binary search.
+ */
+static int _get_job_steps(mysql_conn_t *mysql_conn, char *cluster_name,
+			  char *step_fields, step_parent_t *parents,
+			  int parent_cnt, slurmdb_job_cond_t *job_cond,
+			  List local_cluster_list, void **curr_cluster,
+			  time_t now)
+{
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+	step_parent_t key, *parent;
+	char *query, *inx_str;
+	int i, j, end, offset;
+	size_t inx_size;
+
+	qsort(parents, parent_cnt, sizeof(step_parent_t), _sort_step_parent);
+
+	/* 20 digits and a comma for every job_db_inx */
+	inx_size = (MIN(parent_cnt, STEP_QUERY_JOBS) * 21) + 1;
+	inx_str = xmalloc(inx_size);
+
+	for (i = 0; i < parent_cnt; i = end) {
+		end = MIN(i + STEP_QUERY_JOBS, parent_cnt);
+		offset = 0;
+		for (j = i; j < end; j++)
+			offset += snprintf(inx_str + offset, inx_size - offset,
+					   "%s%"PRIu64, (j == i) ? "" : ",",
+					   parents[j].db_inx);
+
+		query = xstrdup_printf("select %s, t1.job_db_inx "
+				       "from \"%s_%s\" as t1 "
+				       "where t1.job_db_inx in (%s)",
+				       step_fields, cluster_name, step_table,
+				       inx_str);
+		if (debug_flags & DEBUG_FLAG_DB_STEP)
+			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+		if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+			xfree(query);
+			xfree(inx_str);
+			return SLURM_ERROR;
+		}
+		xfree(query);
+
+		while ((row = mysql_fetch_row(result))) {
+			key.db_inx = slurm_atoull(row[STEP_REQ_COUNT]);
+			if (!(parent = bsearch(&key, parents + i, end - i,
+					       sizeof(step_parent_t),
+					       _sort_step_parent)))
+				continue;
+			/* check the bitmap to see if this is one of the steps
+			   we are looking for */
+			if (!good_nodes_from_inx(local_cluster_list,
+						 curr_cluster,
+						 row[STEP_REQ_NODE_INX],
+						 parent->start))
+				continue;
+
+			parent->last_step = _make_step(row, parent->job,
+						       parent->job_ended,
+						       job_cond, now);
+		}
+		mysql_free_result(result);
+	}
+	xfree(inx_str);
+
+	for (i = 0; i < parent_cnt; i++)
+		_set_track_steps(parents[i].job, parents[i].last_step);
+
+	return SLURM_SUCCESS;
+}
+
 static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 			     slurmdb_user_rec_t *user,
 			     slurmdb_job_cond_t *job_cond,
@@ -478,6 +762,25 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 	int rc = SLURM_SUCCESS;
 	int last_id = -1, curr_id = -1;
 	local_cluster_t *curr_cluster = NULL;
+	step_parent_t *parents = NULL;
+	int parent_cnt = 0, parent_size = 0;
+	bool get_steps = false, per_job_steps = false, stream;
+
+	if (!only_pending &&
+	    !(job_cond && (job_cond->flags & (JOBCOND_FLAG_NO_STEP |
+					      JOBCOND_FLAG_RUNAWAY)))) {
+		get_steps = true;
+		/* Selected steps need a different filter for every job */
+		if (job_cond && job_cond->step_list &&
+		    list_count(job_cond->step_list))
+			per_job_steps = true;
+	}
+	/*
+	 * Rows can only be streamed from the server if nothing else is run
+	 * on the connection until they have all been read.
+	 */
+	stream = !per_job_steps &&
+		 (!job_cond || (job_cond->flags & JOBCOND_FLAG_NO_TRUNC));
 
 	/* This is here to make sure we are looking at only this user
 	 * if this flag is set.  We also include any accounts they may be
@@ -581,16 +884,6 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 	*/
 	xstrcat(query, " group by id_job, time_submit desc");
 
-	if (debug_flags & DEBUG_FLAG_DB_JOB)
-		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
-		xfree(query);
-		rc = SLURM_ERROR;
-		goto end_it;
-	}
-	xfree(query);
-
-
 	/* Here we set up environment to check used nodes of jobs.
 	   Since we store the bitmap of the entire cluster we can use
 	   that to set up a hostlist and set up the bitmap to make
@@ -601,12 +894,25 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 		local_cluster_list = setup_cluster_list_with_inx(
 			mysql_conn, job_cond, (void **)&curr_cluster);
 		if (!local_cluster_list) {
-			mysql_free_result(result);
+			xfree(query);
 			rc = SLURM_ERROR;
 			goto end_it;
 		}
 	}
 
+	if (debug_flags & DEBUG_FLAG_DB_JOB)
+		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+	if (stream)
+		result = mysql_db_query_use(mysql_conn, query);
+	else
+		result = mysql_db_query_ret(mysql_conn, query, 0);
+	if (!result) {
+		xfree(query);
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+	xfree(query);
+
 	while ((row = mysql_fetch_row(result))) {
 		char *db_inx_char = row[JOB_REQ_DB_INX];
 		bool job_ended = 0;
@@ -752,8 +1058,8 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 				if (!(result2 = mysql_db_query_ret(
 					      mysql_conn,
 					      query, 0))) {
-					FREE_NULL_LIST(job_list);
-					job_list = NULL;
+					xfree(query);
+					rc = SLURM_ERROR;
 					break;
 				}
 				xfree(query);
@@ -842,12 +1148,26 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 		if (row[JOB_REQ_TRESR])
 			job->tres_req_str = xstrdup(row[JOB_REQ_TRESR]);
 
-		if (only_pending ||
-		    (job_cond &&
-		     (job_cond->flags & (JOBCOND_FLAG_NO_STEP |
-					 JOBCOND_FLAG_RUNAWAY))))
+		if (!get_steps)
 			goto skip_steps;
 
+		if (!per_job_steps) {
+			/* Picked up by _get_job_steps() once all jobs are in */
+			if (parent_cnt >= parent_size) {
+				parent_size = parent_size ? parent_size * 2 :
+							    1024;
+				xrealloc(parents,
+					 sizeof(step_parent_t) * parent_size);
+			}
+			parents[parent_cnt].db_inx = slurm_atoull(db_inx_char);
+			parents[parent_cnt].job = job;
+			parents[parent_cnt].job_ended = job_ended;
+			parents[parent_cnt].last_step = NULL;
+			parents[parent_cnt].start = start;
+			parent_cnt++;
+			goto skip_steps;
+		}
+
 		if (job_cond && job_cond->step_list
 		    && list_count(job_cond->step_list)) {
 			set = 0;
@@ -917,10 +1237,6 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 		}
 		xfree(query);
 
-		/* Querying the steps in the fashion was faster than
-		   doing only 1 query and then matching the steps up
-		   later with the job.
-		*/
 		while ((step_row = mysql_fetch_row(step_result))) {
 			/* check the bitmap to see if this is one of the steps
 			   we are looking for */
@@ -930,186 +1246,32 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 						 start))
 				continue;
 
-			step = slurmdb_create_step_rec();
-			step->tot_cpu_sec = 0;
-			step->tot_cpu_usec = 0;
-			step->job_ptr = job;
-			if (!job->first_step_ptr)
-				job->first_step_ptr = step;
-			list_append(job->steps, step);
-			step->stepid = slurm_atoul(step_row[STEP_REQ_STEPID]);
-			/* info("got step %u.%u", */
-/* 			     job->header.jobnum, step->stepnum); */
-			step->state = slurm_atoul(step_row[STEP_REQ_STATE]);
-			step->exitcode =
-				slurm_atoul(step_row[STEP_REQ_EXIT_CODE]);
-			step->nnodes = slurm_atoul(step_row[STEP_REQ_NODES]);
-
-			step->ntasks = slurm_atoul(step_row[STEP_REQ_TASKS]);
-			step->task_dist =
-				slurm_atoul(step_row[STEP_REQ_TASKDIST]);
-
-			step->start = slurm_atoul(step_row[STEP_REQ_START]);
-
-			step->end = slurm_atoul(step_row[STEP_REQ_END]);
-			/* if the job has ended end the step also */
-			if (!step->end && job_ended) {
-				step->end = job->end;
-				step->state = job->state;
-			}
-
-			if (job_cond &&
-			    !(job_cond->flags & JOBCOND_FLAG_NO_TRUNC)
-			    && job_cond->usage_start) {
-				if (step->start
-				    && (step->start < job_cond->usage_start))
-					step->start = job_cond->usage_start;
-
-				if (!step->start && step->end)
-					step->start = step->end;
-
-				if (!step->end
-				    || (step->end > job_cond->usage_end))
-					step->end = job_cond->usage_end;
-
-				if (step->start && step->end &&
-				   (step->start > step->end))
-					step->start = step->end = 0;
-			}
-
-			/* figure this out by start stop */
-			step->suspended =
-				slurm_atoul(step_row[STEP_REQ_SUSPENDED]);
-
-			/* fix the suspended number to be correct */
-			if (step->state == JOB_SUSPENDED)
-				step->suspended = now - step->suspended;
-			if (!step->start) {
-				step->elapsed = 0;
-			} else if (!step->end) {
-				step->elapsed = now - step->start;
-			} else {
-				step->elapsed = step->end - step->start;
-			}
-			step->elapsed -= step->suspended;
-
-			if ((int)step->elapsed < 0)
-				step->elapsed = 0;
-
-			step->req_cpufreq_min = slurm_atoul(
-				step_row[STEP_REQ_REQ_CPUFREQ_MIN]);
-			step->req_cpufreq_max = slurm_atoul(
-				step_row[STEP_REQ_REQ_CPUFREQ_MAX]);
-			step->req_cpufreq_gov =	slurm_atoul(
-				step_row[STEP_REQ_REQ_CPUFREQ_GOV]);
-
-			step->stepname = xstrdup(step_row[STEP_REQ_NAME]);
-			step->nodes = xstrdup(step_row[STEP_REQ_NODELIST]);
-			step->requid =
-				slurm_atoul(step_row[STEP_REQ_KILL_REQUID]);
-
-			step->user_cpu_sec = slurm_atoul(
-				step_row[STEP_REQ_USER_SEC]);
-			step->user_cpu_usec = slurm_atoul(
-				step_row[STEP_REQ_USER_USEC]);
-			step->sys_cpu_sec =
-				slurm_atoul(step_row[STEP_REQ_SYS_SEC]);
-			step->sys_cpu_usec = slurm_atoul(
-				step_row[STEP_REQ_SYS_USEC]);
-			step->tot_cpu_sec +=
-				step->user_cpu_sec + step->sys_cpu_sec;
-			step->tot_cpu_usec += step->user_cpu_usec +
-				step->sys_cpu_usec;
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MAX])
-				step->stats.tres_usage_in_max =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MAX_TASKID])
-				step->stats.tres_usage_in_max_taskid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX_TASKID]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MAX_NODEID])
-				step->stats.tres_usage_in_max_nodeid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MAX_NODEID]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_AVE])
-				step->stats.tres_usage_in_ave =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_AVE]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MIN])
-				step->stats.tres_usage_in_min =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MIN_TASKID])
-				step->stats.tres_usage_in_min_taskid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN_TASKID]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_MIN_NODEID])
-				step->stats.tres_usage_in_min_nodeid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_MIN_NODEID]);
-			if (step_row[STEP_REQ_TRES_USAGE_IN_TOT])
-				step->stats.tres_usage_in_tot =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_IN_TOT]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX])
-				step->stats.tres_usage_out_max =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX_TASKID])
-				step->stats.tres_usage_out_max_taskid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX_TASKID]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MAX_NODEID])
-				step->stats.tres_usage_out_max_nodeid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MAX_NODEID]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_AVE])
-				step->stats.tres_usage_out_ave =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_AVE]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN])
-				step->stats.tres_usage_out_min =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN_TASKID])
-				step->stats.tres_usage_out_min_taskid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN_TASKID]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_MIN_NODEID])
-				step->stats.tres_usage_out_min_nodeid =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_MIN_NODEID]);
-			if (step_row[STEP_REQ_TRES_USAGE_OUT_TOT])
-				step->stats.tres_usage_out_tot =
-					xstrdup(step_row[STEP_REQ_TRES_USAGE_OUT_TOT]);
-			step->stats.act_cpufreq =
-				atof(step_row[STEP_REQ_ACT_CPUFREQ]);
-			step->stats.consumed_energy = slurm_atoull(
-				step_row[STEP_REQ_CONSUMED_ENERGY]);
-
-			if (step_row[STEP_REQ_TRES])
-				step->tres_alloc_str =
-					xstrdup(step_row[STEP_REQ_TRES]);
+			step = _make_step(step_row, job, job_ended, job_cond,
+					  now);
 		}
 		mysql_free_result(step_result);
 
-		if (!job->track_steps) {
-			uint64_t j_cpus, s_cpus;
-			/* If we don't have track_steps we want to see
-			   if we have multiple steps.  If we only have
-			   1 step check the job name against the step
-			   name in most all cases it will be
-			   different.  If it is different print out
-			   the step separate.  It could also be a single
-			   step/allocation where the job was allocated more than
-			   the step requested (eg. CR_Socket).
-			*/
-			if (list_count(job->steps) > 1)
-				job->track_steps = 1;
-			else if (step &&
-				 (xstrcmp(step->stepname, job->jobname) ||
-				  (((j_cpus = slurmdb_find_tres_count_in_string(
-					     job->tres_alloc_str, TRES_CPU))
-				    != INFINITE64) &&
-				   ((s_cpus = slurmdb_find_tres_count_in_string(
-					     step->tres_alloc_str, TRES_CPU))
-				    != INFINITE64) &&
-				  j_cpus != s_cpus)))
-					job->track_steps = 1;
-		}
+		_set_track_steps(job, step);
 	skip_steps:
 		/* need to reset here to make the above test valid */
 		step = NULL;
 	}
+	if (stream && mysql_errno(mysql_conn->db_conn)) {
+		error("%s: reading jobs failed: %d %s", __func__,
+		      mysql_errno(mysql_conn->db_conn),
+		      mysql_error(mysql_conn->db_conn));
+		rc = SLURM_ERROR;
+	}
 	mysql_free_result(result);
 
+	if ((rc == SLURM_SUCCESS) && parent_cnt)
+		rc = _get_job_steps(mysql_conn, cluster_name, step_fields,
+				    parents, parent_cnt, job_cond,
+				    local_cluster_list,
+				    (void **)&curr_cluster, now);
+
 end_it:
+	xfree(parents);
 	if (itr2)
 		list_iterator_destroy(itr2);
 
@@ -67,11 +67,24 @@ typedef struct {
 	uint64_t total_time;
 } local_tres_usage_t;
 
-typedef struct {
+typedef struct local_id_usage {
 	int id;
 	List loc_tres;
+	struct local_id_usage *next_hash; /* next in id_usage_hash_t bucket */
 } local_id_usage_t;
 
+/* Must be a power of 2 */
+#define ID_USAGE_HASH_SIZE 1024
+
+/*
+ * Index of the local_id_usage_t records of an hour by id, so each job does
+ * not have to scan every association or wckey seen so far. The records
+ * themselves are owned and freed by the hour's List.
+ */
+typedef struct {
+	local_id_usage_t *bucket[ID_USAGE_HASH_SIZE];
+} id_usage_hash_t;
+
 typedef struct {
 	time_t end;
 	int id; /*only needed for reservations */
@@ -136,14 +149,34 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
+static local_id_usage_t *_find_id_usage(id_usage_hash_t *hash, uint32_t id)
 {
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
+	local_id_usage_t *usage = hash->bucket[id & (ID_USAGE_HASH_SIZE - 1)];
 
-	if (loc->id == id)
-		return 1;
-	return 0;
+	while (usage && ((uint32_t)usage->id != id))
+		usage = usage->next_hash;
+
+	return usage;
+}
+
+/* Return the usage record for id, making a new one if not found */
+static local_id_usage_t *_get_id_usage(List usage_list, id_usage_hash_t *hash,
+				       uint32_t id)
+{
+	local_id_usage_t *usage;
+	int inx;
+
+	if ((usage = _find_id_usage(hash, id)))
+		return usage;
+
+	usage = xmalloc(sizeof(local_id_usage_t));
+	usage->id = id;
+	inx = id & (ID_USAGE_HASH_SIZE - 1);
+	usage->next_hash = hash->bucket[inx];
+	hash->bucket[inx] = usage;
+	list_append(usage_list, usage);
+
+	return usage;
 }
 
 static void _remove_job_tres_time_from_cluster(List c_tres, List j_tres,
@@ -973,6 +1006,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	local_resv_usage_t *r_usage = NULL;
 	local_id_usage_t *a_usage = NULL;
 	local_id_usage_t *w_usage = NULL;
+	id_usage_hash_t *assoc_hash = xmalloc(sizeof(id_usage_hash_t));
+	id_usage_hash_t *wckey_hash = xmalloc(sizeof(id_usage_hash_t));
 	/* char start_char[20], end_char[20]; */
 
 	char *job_req_inx[] = {
@@ -1304,9 +1339,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			}
 
 			if (last_id != assoc_id) {
-				a_usage = xmalloc(sizeof(local_id_usage_t));
-				a_usage->id = assoc_id;
-				list_append(assoc_usage_list, a_usage);
+				a_usage = _get_id_usage(assoc_usage_list,
+							assoc_hash, assoc_id);
 				last_id = assoc_id;
 				/* a_usage->loc_tres is made later,
 				   don't do it here.
@@ -1319,20 +1353,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
-
-				if (!w_usage) {
-					w_usage = xmalloc(
-						sizeof(local_id_usage_t));
-					w_usage->id = wckey_id;
-					list_append(wckey_usage_list,
-						    w_usage);
+				w_usage = _get_id_usage(wckey_usage_list,
+							wckey_hash, wckey_id);
+				if (!w_usage->loc_tres)
 					w_usage->loc_tres = list_create(
 						_destroy_local_tres_usage);
-				}
 				last_wckeyid = wckey_id;
 			}
 
@@ -1560,20 +1585,15 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 					r_usage->local_assocs);
 				while ((assoc = list_next(tmp_itr))) {
 					uint32_t associd = slurm_atoul(assoc);
-					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
-						a_usage = xmalloc(
-							sizeof(local_id_usage_t));
-						a_usage->id = associd;
-						list_append(assoc_usage_list,
-							    a_usage);
+					if (last_id != associd) {
+						a_usage = _get_id_usage(
+							assoc_usage_list,
+							assoc_hash, associd);
 						last_id = associd;
+					}
+					if (!a_usage->loc_tres)
 						a_usage->loc_tres = list_create(
 							_destroy_local_tres_usage);
-					}
 
 					_add_time_tres(a_usage->loc_tres,
 						       TIME_ALLOC, loc_tres->id,
@@ -1666,6 +1686,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		list_flush(cluster_down_list);
 		list_flush(wckey_usage_list);
 		list_flush(resv_usage_list);
+		memset(assoc_hash, 0, sizeof(id_usage_hash_t));
+		memset(wckey_hash, 0, sizeof(id_usage_hash_t));
 		curr_start = curr_end;
 		curr_end = curr_start + add_sec;
 	}
@@ -1689,6 +1711,8 @@ end_it:
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(wckey_usage_list);
 	FREE_NULL_LIST(resv_usage_list);
+	xfree(assoc_hash);
+	xfree(wckey_hash);
 
 /* 	info("stop start %s", slurm_ctime2(&curr_start)); */
 /* 	info("stop end %s", slurm_ctime2(&curr_end)); */
@@ -37,6 +37,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <sys/stat.h>
+
 #include "src/common/slurm_xlator.h"
 #include "src/common/slurmdbd_pack.h"
 #include "src/common/xsignal.h"
@@ -47,6 +49,10 @@
 #define DBD_MAGIC		0xDEAD3219
 #define MAX_AGENT_QUEUE		10000
 #define SLURMDBD_TIMEOUT	900	/* Seconds SlurmDBD for response */
+#define SPOOL_MEM_RECS		MAX_AGENT_QUEUE	/* spooled RPCs in memory */
+#define MAX_MULT_MSG		1000	/* RPCs in one DBD_SEND_MULT_MSG */
+#define MAX_PIPELINE		4	/* DBD_SEND_MULT_MSG awaiting reply */
+#define SPOOL_SEG_SIZE		(16 * 1024 * 1024) /* bytes per spool file */
 
 static pthread_mutex_t agent_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
@@ -54,6 +60,7 @@ static List      agent_list     = (List) NULL;
 static pthread_t agent_tid      = 0;
 
 static bool      halt_agent          = 0;
+static int       agent_in_flight     = 0; /* records at head being sent */
 static time_t    slurmdbd_shutdown   = 0;
 static char *    slurmdbd_cluster    = NULL;
 
@@ -61,6 +68,7 @@ static slurm_persist_conn_t *slurmdbd_conn = NULL;
 static pthread_mutex_t slurmdbd_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  slurmdbd_cond = PTHREAD_COND_INITIALIZER;
 
+static void _spool_ack(int cnt);
 
 static int _send_fini_msg(void)
 {
@@ -156,7 +164,12 @@ static int _get_return_code(void)
 	return rc;
 }
 
-static int _handle_mult_rc_ret(void)
+/*
+ * Read the reply to one DBD_SEND_MULT_MSG
+ * IN recs - the records of agent_list packed in the message, those accepted
+ *	     are emptied to mark them delivered
+ */
+static int _handle_mult_rc_ret(List recs)
 {
 	Buf buffer;
 	uint16_t msg_type;
@@ -167,7 +180,7 @@ static int _handle_mult_rc_ret(void)
 
 	buffer = slurm_persist_recv_msg(slurmdbd_conn);
 	if (buffer == NULL)
-		return rc;
+		return SLURM_COMMUNICATIONS_RECEIVE_ERROR;
 
 	safe_unpack16(&msg_type, buffer);
 	switch (msg_type) {
@@ -180,27 +193,36 @@ static int _handle_mult_rc_ret(void)
 			break;
 		}
 
+		/*
+		 * The SlurmDBD goes on with the rest of the batch after a
+		 * record returned an error, only the failed records stay.
+		 * Records without a reply were not processed.
+		 */
+		rc = SLURM_SUCCESS;
 		slurm_mutex_lock(&agent_lock);
 		if (agent_list) {
 			ListIterator itr =
 				list_iterator_create(list_msg->my_list);
 			while ((out_buf = list_next(itr))) {
 				Buf b;
-				if ((rc = _unpack_return_code(
-					     slurmdbd_conn->version, out_buf))
-				    != SLURM_SUCCESS)
-					break;
+				int rec_rc = _unpack_return_code(
+					slurmdbd_conn->version, out_buf);
 
-				if ((b = list_dequeue(agent_list))) {
-					free_buf(b);
-				} else {
+				if (!(b = list_pop(recs))) {
 					error("slurmdbd: DBD_GOT_MULT_MSG "
 					      "unpack message error");
+					break;
 				}
+				if (rec_rc == SLURM_SUCCESS)
+					set_buf_offset(b, 0);
+				else if (rc == SLURM_SUCCESS)
+					rc = rec_rc;
 			}
 			list_iterator_destroy(itr);
 		}
 		slurm_mutex_unlock(&agent_lock);
+		if ((rc == SLURM_SUCCESS) && list_count(recs))
+			rc = SLURM_ERROR;
 		slurmdbd_free_list_msg(list_msg);
 		break;
 	case PERSIST_RC:
@@ -244,6 +266,126 @@ unpack_error:
 	return rc;
 }
 
+/*
+ * Remove the records at the head of agent_list that were delivered
+ * NOTE: Call with agent_lock held
+ */
+static void _dequeue_delivered(void)
+{
+	Buf buffer;
+	int acked = 0;
+
+	while ((buffer = list_peek(agent_list)) && !get_buf_offset(buffer)) {
+		free_buf(list_dequeue(agent_list));
+		acked++;
+	}
+	if (acked)
+		_spool_ack(acked);
+}
+
+/*
+ * Send several DBD_SEND_MULT_MSG batches before reading any reply. The
+ * SlurmDBD handles the RPCs of a connection one at a time and replies in
+ * order, so the batches queue up in the socket rather than each one waiting
+ * a full round trip. The replies are small, so the few left unread while
+ * sending cannot fill the socket.
+ *
+ * The SlurmDBD commits every batch it gets, even after an earlier one
+ * failed, so each reply marks the records of its own batch delivered. Those
+ * behind a failed record stay in agent_list, emptied, until the records
+ * ahead of them are delivered too, and are never sent again.
+ * IN batch - packed batches holding consecutive records from the head of
+ *	      agent_list, oldest first
+ * IN recs - the records packed in each batch
+ * RET SLURM_SUCCESS if every record was accepted
+ */
+static int _send_mult_msgs(Buf *batch, List *recs, int batch_cnt)
+{
+	int i, sent, rc = SLURM_SUCCESS, send_rc, ret_rc;
+
+	/*
+	 * Only the first batch may reopen the connection. The replies to
+	 * batches written to a lost connection must not be taken from a new
+	 * one, those batches are left undelivered and sent again.
+	 */
+	sent = slurm_persist_send_msgs(slurmdbd_conn, batch, batch_cnt,
+				       &send_rc);
+	if (send_rc != SLURM_SUCCESS)
+		error("slurmdbd: Failure sending message: %d: %m", send_rc);
+
+	for (i = 0; i < sent; i++) {
+		ret_rc = _handle_mult_rc_ret(recs[i]);
+		if (rc == SLURM_SUCCESS)
+			rc = ret_rc;
+		/* A connection lost while waiting was already reopened */
+		if (ret_rc == SLURM_COMMUNICATIONS_RECEIVE_ERROR)
+			break;
+	}
+
+	slurm_mutex_lock(&agent_lock);
+	if (agent_list)
+		_dequeue_delivered();
+	agent_in_flight = 0;
+	slurm_mutex_unlock(&agent_lock);
+
+	if (rc == SLURM_SUCCESS)
+		rc = send_rc;
+	return rc;
+}
+
+/*
+ * Pack the records at the head of agent_list into up to MAX_PIPELINE
+ * DBD_SEND_MULT_MSG batches of at most MAX_MULT_MSG records each.
+ * Records already delivered are skipped.
+ * NOTE: Call with agent_lock held
+ * IN pipeline - if not set only one batch is packed
+ * OUT batch - packed batches
+ * OUT recs - the records packed in each batch, free with FREE_NULL_LIST
+ * RET count of batches
+ */
+static int _pack_mult_msgs(Buf *batch, List *recs, bool pipeline)
+{
+	slurmdbd_msg_t list_req;
+	dbd_list_msg_t list_msg;
+	ListIterator itr;
+	Buf buffer;
+	int batch_cnt = 0, max_batch = MAX_PIPELINE, pos = 0;
+
+	/* Older SlurmDBDs garble pipelined messages */
+	if (!pipeline ||
+	    (slurmdbd_conn->version < SLURM_19_05_PROTOCOL_VERSION))
+		max_batch = 1;
+
+	memset(&list_msg, 0, sizeof(dbd_list_msg_t));
+	list_msg.my_list = list_create(NULL);
+	list_req.msg_type = DBD_SEND_MULT_MSG;
+	list_req.data = &list_msg;
+
+	itr = list_iterator_create(agent_list);
+	while (batch_cnt < max_batch) {
+		if ((buffer = list_next(itr))) {
+			pos++;
+			if (!get_buf_offset(buffer))
+				continue;
+			list_enqueue(list_msg.my_list, buffer);
+		}
+		if (list_count(list_msg.my_list) &&
+		    (!buffer || (list_count(list_msg.my_list) == MAX_MULT_MSG))) {
+			batch[batch_cnt] = pack_slurmdbd_msg(
+				&list_req, SLURM_PROTOCOL_VERSION);
+			recs[batch_cnt++] = list_msg.my_list;
+			list_msg.my_list = list_create(NULL);
+			agent_in_flight = pos;
+		}
+		if (!buffer)
+			break;
+	}
+	list_iterator_destroy(itr);
+	FREE_NULL_LIST(list_msg.my_list);
+
+	return batch_cnt;
+}
+
 /****************************************************************************
  * Functions for agent to manage queue of pending message for the Slurm DBD
  ****************************************************************************/
@@ -296,6 +438,481 @@ static Buf _load_dbd_rec(int fd)
 	return buffer;
 }
 
+static int _save_dbd_rec(int fd, Buf buffer)
+{
+	ssize_t size, wrote;
+	uint32_t msg_size = get_buf_offset(buffer);
+	uint32_t magic = DBD_MAGIC;
+	char *msg = get_buf_data(buffer);
+
+	size = sizeof(msg_size);
+	wrote = write(fd, &msg_size, size);
+	if (wrote != size) {
+		error("slurmdbd: state save error: %m");
+		return SLURM_ERROR;
+	}
+
+	wrote = 0;
+	while (wrote < msg_size) {
+		wrote = write(fd, msg, msg_size);
+		if (wrote > 0) {
+			msg += wrote;
+			msg_size -= wrote;
+		} else if ((wrote == -1) && (errno == EINTR))
+			continue;
+		else {
+			error("slurmdbd: state save error: %m");
+			return SLURM_ERROR;
+		}
+	}
+
+	size = sizeof(magic);
+	wrote = write(fd, &magic, size);
+	if (wrote != size) {
+		error("slurmdbd: state save error: %m");
+		return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
+/****************************************************************************
+ * Functions to keep the agent queue in a spool on disk
+ *
+ * Every queued message is appended to the newest of a series of segment
+ * files, StateSaveLocation/dbd.spool.<id>, each starting with the same
+ * version record as dbd.messages. Segments are written as messages arrive,
+ * so the queue survives a slurmctld crash and is never rewritten as a whole.
+ * At most SPOOL_MEM_RECS messages are kept in agent_list, the rest are read
+ * back in order as the agent drains the list. Once every record of a
+ * segment has been accepted by the SlurmDBD the segment is removed. The
+ * oldest segment id and the count of its records already delivered are kept
+ * in dbd.spool.ack, so a restart only resends what was not acknowledged.
+ *
+ * If the spool can not be written the remaining backlog is read into memory
+ * and the agent goes back to saving dbd.messages on shutdown.
+ ****************************************************************************/
+typedef struct {
+	uint32_t id;
+	int rd_fd;		/* open while records remain to be loaded */
+	off_t rd_off;		/* offset of the first record not loaded */
+	off_t size;		/* bytes written */
+	uint32_t rec_cnt;	/* records written */
+	uint32_t loaded;	/* records moved to agent_list */
+	uint32_t acked;		/* records accepted by the SlurmDBD */
+	uint16_t rpc_version;
+} spool_seg_t;
+
+static bool      spool_active        = false;
+static char *    spool_dir           = NULL;
+static List      spool_segs          = NULL; /* oldest first */
+static spool_seg_t *spool_wr_seg     = NULL; /* last in spool_segs */
+static int       spool_wr_fd         = -1;
+static int       spool_ack_fd        = -1;
+static uint32_t  spool_backlog       = 0;    /* records only on disk */
+
+static void _spool_seg_free(void *x)
+{
+	spool_seg_t *seg = x;
+
+	if (seg->rd_fd >= 0)
+		(void) close(seg->rd_fd);
+	xfree(seg);
+}
+
+static char *_spool_fname(uint32_t id)
+{
+	return xstrdup_printf("%s/dbd.spool.%u", spool_dir, id);
+}
+
+/* Convert a message packed with an older protocol version */
+static Buf _repack_dbd_rec(Buf buffer, uint16_t rpc_version)
+{
+	slurmdbd_msg_t msg;
+	int rc;
+
+	if (rpc_version == SLURM_PROTOCOL_VERSION)
+		return buffer;
+
+	set_buf_offset(buffer, 0);
+	rc = unpack_slurmdbd_msg(&msg, rpc_version, buffer);
+	free_buf(buffer);
+	if (rc != SLURM_SUCCESS)
+		return NULL;
+	return pack_slurmdbd_msg(&msg, SLURM_PROTOCOL_VERSION);
+}
+
+static void _spool_write_ack(void)
+{
+	spool_seg_t *seg = list_peek(spool_segs);
+	uint32_t ack[2];
+
+	ack[0] = seg->id;
+	ack[1] = seg->acked;
+	if (pwrite(spool_ack_fd, ack, sizeof(ack), 0) != sizeof(ack))
+		error("slurmdbd: writing spool acknowledgment: %m");
+}
+
+/* Start a new segment to append to, RET SLURM_SUCCESS or SLURM_ERROR */
+static int _spool_new_seg(uint32_t id)
+{
+	char curr_ver_str[10];
+	char *fname = _spool_fname(id);
+	spool_seg_t *seg;
+	Buf buffer;
+	int fd, rc;
+
+	if ((fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0) {
+		error("slurmdbd: Creating spool file %s: %m", fname);
+		xfree(fname);
+		return SLURM_ERROR;
+	}
+
+	snprintf(curr_ver_str, sizeof(curr_ver_str),
+		 "VER%d", SLURM_PROTOCOL_VERSION);
+	buffer = init_buf(strlen(curr_ver_str));
+	packstr(curr_ver_str, buffer);
+	rc = _save_dbd_rec(fd, buffer);
+	if (rc != SLURM_SUCCESS) {
+		free_buf(buffer);
+		(void) close(fd);
+		(void) unlink(fname);
+		xfree(fname);
+		return rc;
+	}
+	xfree(fname);
+
+	seg = xmalloc(sizeof(spool_seg_t));
+	seg->id = id;
+	seg->rd_fd = -1;
+	seg->size = seg->rd_off = sizeof(uint32_t) * 2 +
+				  get_buf_offset(buffer);
+	seg->rpc_version = SLURM_PROTOCOL_VERSION;
+	free_buf(buffer);
+
+	if (spool_wr_fd >= 0)
+		(void) close(spool_wr_fd);
+	spool_wr_fd = fd;
+	spool_wr_seg = seg;
+	list_append(spool_segs, seg);
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Scan a segment left by an earlier slurmctld. A record cut short by a crash
+ * is truncated away. The first ack_cnt records were already delivered.
+ * RET segment or NULL if it does not exist or holds nothing usable
+ */
+static spool_seg_t *_spool_recover_seg(uint32_t id, uint32_t ack_cnt)
+{
+	char *fname = _spool_fname(id), *ver_str = NULL;
+	uint32_t ver_str_len;
+	spool_seg_t *seg;
+	struct stat stat_buf;
+	Buf buffer;
+	int fd;
+
+	if ((fd = open(fname, O_RDWR)) < 0) {
+		if (errno != ENOENT)
+			error("slurmdbd: Opening spool file %s: %m", fname);
+		xfree(fname);
+		return NULL;
+	}
+
+	seg = xmalloc(sizeof(spool_seg_t));
+	seg->id = id;
+	seg->rd_fd = -1;
+
+	if (!(buffer = _load_dbd_rec(fd)))
+		goto bad;
+	seg->size = seg->rd_off = sizeof(uint32_t) * 2 +
+				  get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	safe_unpackstr_xmalloc(&ver_str, &ver_str_len, buffer);
+	if (!ver_str || xstrncmp(ver_str, "VER", 3))
+		goto unpack_error;
+	seg->rpc_version = slurm_atoul(ver_str + 3);
+	xfree(ver_str);
+	free_buf(buffer);
+
+	while ((buffer = _load_dbd_rec(fd))) {
+		seg->size += sizeof(uint32_t) * 2 + get_buf_offset(buffer);
+		if (++seg->rec_cnt == ack_cnt)
+			seg->rd_off = seg->size;
+		free_buf(buffer);
+	}
+	if (!fstat(fd, &stat_buf) && (stat_buf.st_size > seg->size)) {
+		error("slurmdbd: truncating partial record in spool file %s",
+		      fname);
+		if (ftruncate(fd, seg->size))
+			error("slurmdbd: truncating %s: %m", fname);
+	}
+	(void) close(fd);
+
+	seg->loaded = seg->acked = MIN(ack_cnt, seg->rec_cnt);
+	if (seg->loaded == seg->rec_cnt) {
+		(void) unlink(fname);
+		xfree(fname);
+		xfree(seg);
+		return NULL;
+	}
+	xfree(fname);
+	return seg;
+
+unpack_error:
+	xfree(ver_str);
+	free_buf(buffer);
+bad:
+	error("slurmdbd: spool file %s is corrupt, removing", fname);
+	(void) close(fd);
+	(void) unlink(fname);
+	xfree(fname);
+	xfree(seg);
+	return NULL;
+}
+
+/* Open or create the spool, RET SLURM_SUCCESS or SLURM_ERROR */
+static int _spool_init(void)
+{
+	char *fname;
+	uint32_t ack[2] = { 1, 0 }, id, recovered = 0;
+	spool_seg_t *seg;
+
+	spool_dir = slurm_get_state_save_location();
+	spool_segs = list_create(_spool_seg_free);
+	spool_backlog = 0;
+
+	fname = xstrdup_printf("%s/dbd.spool.ack", spool_dir);
+	if ((spool_ack_fd = open(fname, O_RDWR | O_CREAT, 0600)) < 0) {
+		error("slurmdbd: Opening spool file %s: %m", fname);
+		xfree(fname);
+		goto fail;
+	}
+	xfree(fname);
+	if ((read(spool_ack_fd, ack, sizeof(ack)) != sizeof(ack)) || !ack[0]) {
+		ack[0] = 1;
+		ack[1] = 0;
+	}
+
+	/* Segments are removed oldest first, so the rest are consecutive */
+	for (id = ack[0]; ; id++) {
+		seg = _spool_recover_seg(id, (id == ack[0]) ? ack[1] : 0);
+		if (!seg) {
+			char *next = _spool_fname(id + 1);
+			bool more = !access(next, F_OK);
+			xfree(next);
+			if (more)
+				continue;
+			break;
+		}
+		list_append(spool_segs, seg);
+		spool_backlog += seg->rec_cnt - seg->loaded;
+		recovered += seg->rec_cnt - seg->loaded;
+	}
+
+	if (_spool_new_seg(id) != SLURM_SUCCESS)
+		goto fail;
+	_spool_write_ack();
+
+	spool_active = true;
+	verbose("slurmdbd: recovered %u pending RPCs from spool", recovered);
+	return SLURM_SUCCESS;
+
+fail:
+	error("slurmdbd: unable to use spool, pending RPCs kept in memory");
+	if (spool_ack_fd >= 0) {
+		(void) close(spool_ack_fd);
+		spool_ack_fd = -1;
+	}
+	FREE_NULL_LIST(spool_segs);
+	xfree(spool_dir);
+	return SLURM_ERROR;
+}
+
+/* Close the spool, leaving pending records on disk unless remove is set */
+static void _spool_fini(bool remove)
+{
+	spool_seg_t *seg;
+	char *fname;
+
+	if (!spool_segs)
+		return;
+
+	if (remove) {
+		while ((seg = list_pop(spool_segs))) {
+			fname = _spool_fname(seg->id);
+			(void) unlink(fname);
+			xfree(fname);
+			_spool_seg_free(seg);
+		}
+		fname = xstrdup_printf("%s/dbd.spool.ack", spool_dir);
+		(void) unlink(fname);
+		xfree(fname);
+	}
+	if (spool_wr_fd >= 0)
+		(void) close(spool_wr_fd);
+	if (spool_ack_fd >= 0)
+		(void) close(spool_ack_fd);
+	spool_wr_fd = spool_ack_fd = -1;
+	spool_wr_seg = NULL;
+	FREE_NULL_LIST(spool_segs);
+	xfree(spool_dir);
+	spool_active = false;
+	spool_backlog = 0;
+}
+
+/* Move records from the spool to agent_list, up to max_cnt in the list */
+static void _spool_load(uint32_t max_cnt)
+{
+	ListIterator itr;
+	spool_seg_t *seg;
+	char *fname;
+	Buf buffer;
+
+	if (!spool_backlog)
+		return;
+
+	itr = list_iterator_create(spool_segs);
+	while (spool_backlog &&
+	       ((uint32_t) list_count(agent_list) < max_cnt) &&
+	       (seg = list_next(itr))) {
+		if (seg->loaded == seg->rec_cnt)
+			continue;
+		if (seg->rd_fd < 0) {
+			fname = _spool_fname(seg->id);
+			seg->rd_fd = open(fname, O_RDONLY);
+			if (seg->rd_fd < 0)
+				error("slurmdbd: Opening spool file %s: %m",
+				      fname);
+			xfree(fname);
+		}
+		if ((seg->rd_fd >= 0) &&
+		    (lseek(seg->rd_fd, seg->rd_off, SEEK_SET) < 0)) {
+			(void) close(seg->rd_fd);
+			seg->rd_fd = -1;
+		}
+		while ((seg->rd_fd >= 0) && (seg->loaded < seg->rec_cnt) &&
+		       ((uint32_t) list_count(agent_list) < max_cnt)) {
+			if (!(buffer = _load_dbd_rec(seg->rd_fd)))
+				break;
+			seg->rd_off += sizeof(uint32_t) * 2 +
+				       get_buf_offset(buffer);
+			seg->loaded++;
+			spool_backlog--;
+			if (!(buffer = _repack_dbd_rec(buffer,
+						       seg->rpc_version))) {
+				/*
+				 * Queue an empty record in its place. It is
+				 * acked once the records ahead of it are, so
+				 * the ack stays aligned.
+				 */
+				error("slurmdbd: unpack error in spool record");
+				buffer = init_buf(0);
+			}
+			list_enqueue(agent_list, buffer);
+		}
+		if (seg->loaded < seg->rec_cnt) {
+			if ((uint32_t) list_count(agent_list) >= max_cnt)
+				break;
+			/* Unreadable, give up on the rest of the segment */
+			error("slurmdbd: discarding %u unreadable records from spool segment %u",
+			      seg->rec_cnt - seg->loaded, seg->id);
+			spool_backlog -= seg->rec_cnt - seg->loaded;
+			seg->rec_cnt = seg->loaded;
+		}
+		if ((seg->rd_fd >= 0) && (seg->loaded == seg->rec_cnt) &&
+		    (seg != spool_wr_seg)) {
+			(void) close(seg->rd_fd);
+			seg->rd_fd = -1;
+		}
+	}
+	list_iterator_destroy(itr);
+}
+
+/* Note cnt records at the head of agent_list were accepted by the SlurmDBD */
+static void _spool_ack(int cnt)
+{
+	spool_seg_t *seg;
+	char *fname;
+	uint32_t acked;
+
+	if (!spool_active)
+		return;
+
+	while ((seg = list_peek(spool_segs))) {
+		acked = MIN(cnt, seg->loaded - seg->acked);
+		seg->acked += acked;
+		cnt -= acked;
+		/* The segment being written is never removed */
+		if ((seg->acked < seg->rec_cnt) ||
+		    (list_count(spool_segs) == 1))
+			break;
+		fname = _spool_fname(seg->id);
+		(void) unlink(fname);
+		xfree(fname);
+		seg = list_pop(spool_segs);
+		_spool_seg_free(seg);
+	}
+	_spool_write_ack();
+}
+
+/* Read the whole spool into memory and stop writing to it */
+static void _spool_disable(void)
+{
+	_spool_load(INFINITE);
+	if (spool_wr_fd >= 0) {
+		(void) close(spool_wr_fd);
+		spool_wr_fd = -1;
+	}
+	spool_active = false;
+	error("slurmdbd: spool disabled, pending RPCs kept in memory");
+}
+
+/*
+ * Append a message to the spool. On success the buffer is moved to
+ * agent_list or freed, on failure it is left to the caller.
+ * RET SLURM_SUCCESS or SLURM_ERROR
+ */
+static int _spool_append(Buf buffer)
+{
+	spool_seg_t *seg = spool_wr_seg;
+
+	if (_save_dbd_rec(spool_wr_fd, buffer) != SLURM_SUCCESS) {
+		if (ftruncate(spool_wr_fd, seg->size))
+			error("slurmdbd: truncating spool: %m");
+		_spool_disable();
+		return SLURM_ERROR;
+	}
+	seg->size += sizeof(uint32_t) * 2 + get_buf_offset(buffer);
+	seg->rec_cnt++;
+
+	/* Keep queue order, only bypass the disk if nothing is waiting */
+	if (!spool_backlog && (list_count(agent_list) < SPOOL_MEM_RECS)) {
+		seg->loaded++;
+		seg->rd_off = seg->size;
+		list_enqueue(agent_list, buffer);
+	} else {
+		spool_backlog++;
+		free_buf(buffer);
+	}
+
+	if ((seg->size >= SPOOL_SEG_SIZE) &&
+	    (_spool_new_seg(seg->id + 1) != SLURM_SUCCESS))
+		_spool_disable();
+
+	return SLURM_SUCCESS;
+}
+
+/* Queue a message for the agent, through the spool when in use */
+static void _agent_enqueue(Buf buffer)
+{
+	if (spool_active && (_spool_append(buffer) == SLURM_SUCCESS))
+		return;
+	if (!list_enqueue(agent_list, buffer))
+		fatal("slurmdbd: list_enqueue, no memory");
+}
+
 static void _load_dbd_state(void)
 {
 	char *dbd_fname;
@@ -344,29 +961,15 @@ static void _load_dbd_state(void)
 				buffer = _load_dbd_rec(fd);
 			if (buffer == NULL)
 				break;
-			if (rpc_version != SLURM_PROTOCOL_VERSION) {
-				/* unpack and repack with new
-				 * PROTOCOL_VERSION just so we keep
-				 * things up to date.
-				 */
-				slurmdbd_msg_t msg;
-				int rc;
-				set_buf_offset(buffer, 0);
-				rc = unpack_slurmdbd_msg(
-					&msg, rpc_version, buffer);
-				free_buf(buffer);
-				if (rc == SLURM_SUCCESS)
-					buffer = pack_slurmdbd_msg(
-						&msg, SLURM_PROTOCOL_VERSION);
-				else
-					buffer = NULL;
-			}
-			if (!buffer) {
+			/*
+			 * unpack and repack with new PROTOCOL_VERSION just so
+			 * we keep things up to date.
+			 */
+			if (!(buffer = _repack_dbd_rec(buffer, rpc_version))) {
 				error("no buffer given");
 				continue;
 			}
-			if (!list_enqueue(agent_list, buffer))
-				fatal("slurmdbd: list_enqueue, no memory");
+			_agent_enqueue(buffer);
 			recovered++;
 			buffer = NULL;
 		}
@@ -374,48 +977,13 @@ static void _load_dbd_state(void)
 	end_it:
 		verbose("slurmdbd: recovered %d pending RPCs", recovered);
 		(void) close(fd);
+		/* The RPCs are in the spool now, don't load them again */
+		if (spool_active)
+			(void) unlink(dbd_fname);
 	}
 	xfree(dbd_fname);
 }
 
-static int _save_dbd_rec(int fd, Buf buffer)
-{
-	ssize_t size, wrote;
-	uint32_t msg_size = get_buf_offset(buffer);
-	uint32_t magic = DBD_MAGIC;
-	char *msg = get_buf_data(buffer);
-
-	size = sizeof(msg_size);
-	wrote = write(fd, &msg_size, size);
-	if (wrote != size) {
-		error("slurmdbd: state save error: %m");
-		return SLURM_ERROR;
-	}
-
-	wrote = 0;
-	while (wrote < msg_size) {
-		wrote = write(fd, msg, msg_size);
-		if (wrote > 0) {
-			msg += wrote;
-			msg_size -= wrote;
-		} else if ((wrote == -1) && (errno == EINTR))
-			continue;
-		else {
-			error("slurmdbd: state save error: %m");
-			return SLURM_ERROR;
-		}
-	}
-
-	size = sizeof(magic);
-	wrote = write(fd, &magic, size);
-	if (wrote != size) {
-		error("slurmdbd: state save error: %m");
-		return SLURM_ERROR;
-	}
-
-	return SLURM_SUCCESS;
-}
-
 static void _save_dbd_state(void)
 {
 	char *dbd_fname;
@@ -579,17 +1147,12 @@ static void _sig_handler(int signal)
 
 static void *_agent(void *x)
 {
-	int cnt, rc;
-	Buf buffer;
+	int batch_cnt = 0, cnt, i, rc;
+	Buf batch[MAX_PIPELINE], buffer;
+	List recs[MAX_PIPELINE];
 	struct timespec abs_time;
 	static time_t fail_time = 0;
 	int sigarray[] = {SIGUSR1, 0};
-	slurmdbd_msg_t list_req;
-	dbd_list_msg_t list_msg;
-
-	list_req.msg_type = DBD_SEND_MULT_MSG;
-	list_req.data = &list_msg;
-	memset(&list_msg, 0, sizeof(dbd_list_msg_t));
 	/* DEF_TIMERS; */
 
 	/* Prepare to catch SIGUSR1 to interrupt pending
@@ -612,6 +1175,11 @@ static void *_agent(void *x)
 		}
 
 		slurm_mutex_lock(&agent_lock);
+		if (agent_list && spool_active &&
+		    (list_count(agent_list) < (SPOOL_MEM_RECS / 2)))
+			_spool_load(SPOOL_MEM_RECS);
+		if (agent_list)
+			_dequeue_delivered();
 		if (agent_list && slurmdbd_conn->fd)
 			cnt = list_count(agent_list);
 		else
@@ -629,27 +1197,15 @@ static void *_agent(void *x)
 			info("slurmdbd: agent queue size %u", cnt);
 		/* Leave item on the queue until processing complete */
 		if (agent_list) {
-			int handle_agent_count = 1000;
-			if (cnt > handle_agent_count) {
-				int agent_count = 0;
-				ListIterator agent_itr =
-					list_iterator_create(agent_list);
-				list_msg.my_list = list_create(NULL);
-				while ((buffer = list_next(agent_itr))) {
-					list_enqueue(list_msg.my_list, buffer);
-					agent_count++;
-					if (agent_count > handle_agent_count)
-						break;
-				}
-				list_iterator_destroy(agent_itr);
-				buffer = pack_slurmdbd_msg(
-					&list_req, SLURM_PROTOCOL_VERSION);
-			} else if (cnt > 1) {
-				list_msg.my_list = agent_list;
-				buffer = pack_slurmdbd_msg(
-					&list_req, SLURM_PROTOCOL_VERSION);
-			} else
+			/* Do not run further ahead of a failed record */
+			if (cnt > 1) {
+				batch_cnt = _pack_mult_msgs(batch, recs,
+							    !fail_time);
+				buffer = batch[0];
+			} else {
 				buffer = (Buf) list_peek(agent_list);
+				agent_in_flight = 1;
+			}
 		} else
 			buffer = NULL;
 		slurm_mutex_unlock(&agent_lock);
@@ -667,15 +1223,25 @@ static void *_agent(void *x)
 		/* NOTE: agent_lock is clear here, so we can add more
 		 * requests to the queue while waiting for this RPC to
 		 * complete. */
-		rc = slurm_persist_send_msg(slurmdbd_conn, buffer);
-		if (rc != SLURM_SUCCESS) {
+		if (batch_cnt) {
+			rc = _send_mult_msgs(batch, recs, batch_cnt);
+			for (i = 0; i < batch_cnt; i++) {
+				free_buf(batch[i]);
+				FREE_NULL_LIST(recs[i]);
+			}
+			batch_cnt = 0;
+			buffer = NULL;
+			if ((rc != SLURM_SUCCESS) && *slurmdbd_conn->shutdown) {
+				slurm_mutex_unlock(&slurmdbd_lock);
+				break;
+			}
+		} else if ((rc = slurm_persist_send_msg(slurmdbd_conn, buffer))
+			   != SLURM_SUCCESS) {
 			if (*slurmdbd_conn->shutdown) {
 				slurm_mutex_unlock(&slurmdbd_lock);
 				break;
 			}
 			error("slurmdbd: Failure sending message: %d: %m", rc);
-		} else if (list_msg.my_list) {
-			rc = _handle_mult_rc_ret();
 		} else {
 			rc = _get_return_code();
 			if (rc == EAGAIN) {
@@ -696,37 +1262,33 @@ static void *_agent(void *x)
 		slurm_mutex_lock(&agent_lock);
 		if (agent_list && (rc == SLURM_SUCCESS)) {
 			/*
-			 * If we sent a mult_msg we just need to free buffer,
-			 * we don't need to requeue, just mark list_msg.my_list
-			 * as NULL as that is the sign we sent a mult_msg.
+			 * The records of a mult_msg were already removed from
+			 * agent_list after their replies were read, buffer is
+			 * only set for a single record.
 			 */
-			if (list_msg.my_list) {
-				if (list_msg.my_list != agent_list)
-					FREE_NULL_LIST(list_msg.my_list);
-				list_msg.my_list = NULL;
-			} else
+			if (buffer) {
 				buffer = (Buf) list_dequeue(agent_list);
-
-			free_buf(buffer);
-			fail_time = 0;
-		} else {
-			/* We need to free a mult_msg even on failure */
-			if (list_msg.my_list) {
-				if (list_msg.my_list != agent_list)
-					FREE_NULL_LIST(list_msg.my_list);
-				list_msg.my_list = NULL;
+				_spool_ack(1);
 				free_buf(buffer);
 			}
-
+			fail_time = 0;
+		} else
 			fail_time = time(NULL);
-		}
+		agent_in_flight = 0;
 		slurm_mutex_unlock(&agent_lock);
 		/* END_TIMER; */
 		/* info("at the end with %s", TIME_STR); */
 	}
 
 	slurm_mutex_lock(&agent_lock);
-	_save_dbd_state();
+	if (spool_active) {
+		/* Everything pending is already on disk */
+		_spool_fini(false);
+	} else {
+		_save_dbd_state();
+		/* A disabled spool was read into memory and saved above */
+		_spool_fini(true);
+	}
 	FREE_NULL_LIST(agent_list);
 	slurm_mutex_unlock(&agent_lock);
 	return NULL;
@@ -740,6 +1302,7 @@ static void _create_agent(void)
 
 	if (agent_list == NULL) {
 		agent_list = list_create(slurmdbd_free_buffer);
+		(void) _spool_init();
 		_load_dbd_state();
 	}
 
@@ -752,7 +1315,7 @@ static void _create_agent(void)
  * RET number of records purged */
 static int _purge_step_req(void)
 {
-	int purged = 0;
+	int purged = 0, pos = 0;
 	ListIterator iter;
 	uint16_t msg_type;
 	uint32_t offset;
@@ -760,6 +1323,9 @@ static int _purge_step_req(void)
 
 	iter = list_iterator_create(agent_list);
 	while ((buffer = list_next(iter))) {
+		/* Records being sent are removed once answered */
+		if (pos++ < agent_in_flight)
+			continue;
 		offset = get_buf_offset(buffer);
 		if (offset < 2)
 			continue;
@@ -781,7 +1347,7 @@ static int _purge_step_req(void)
  * RET number of records purged */
 static int _purge_job_start_req(void)
 {
-	int purged = 0;
+	int purged = 0, pos = 0;
 	ListIterator iter;
 	uint16_t msg_type;
 	uint32_t offset;
@@ -789,6 +1355,9 @@ static int _purge_job_start_req(void)
 
 	iter = list_iterator_create(agent_list);
 	while ((buffer = list_next(iter))) {
+		/* Records being sent are removed once answered */
+		if (pos++ < agent_in_flight)
+			continue;
 		offset = get_buf_offset(buffer);
 		if (offset < 2)
 			continue;
@@ -1071,7 +1640,7 @@ extern int send_slurmdbd_msg(uint16_t rpc_version, slurmdbd_msg_t *req)
 			return SLURM_ERROR;
 		}
 	}
-	cnt = list_count(agent_list);
+	cnt = list_count(agent_list) + spool_backlog;
 	if ((cnt >= (max_agent_queue / 2)) &&
 	    (difftime(time(NULL), syslog_time) > 120)) {
 		/* Record critical error every 120 seconds */
@@ -1082,6 +1651,9 @@ extern int send_slurmdbd_msg(uint16_t rpc_version, slurmdbd_msg_t *req)
 		if (slurmdbd_conn->trigger_callbacks.dbd_fail)
 			(slurmdbd_conn->trigger_callbacks.dbd_fail)();
 	}
+	/* The spool is only bounded by the disk, nothing gets purged */
+	if (spool_active && (_spool_append(buffer) == SLURM_SUCCESS))
+		goto end_it;
 	if (cnt == (max_agent_queue - 1))
 		cnt -= _purge_step_req();
 	if (cnt == (max_agent_queue - 1))
@@ -1100,6 +1672,7 @@ extern int send_slurmdbd_msg(uint16_t rpc_version, slurmdbd_msg_t *req)
 		rc = SLURM_ERROR;
 	}
 
+end_it:
 	slurm_cond_broadcast(&agent_cond);
 	slurm_mutex_unlock(&agent_lock);
 	return rc;
@@ -1118,5 +1691,5 @@ extern int slurmdbd_agent_queue_count(void)
 {
 	if (!agent_list)
 		return 0;
-	return list_count(agent_list);
+	return list_count(agent_list) + spool_backlog;
 }
@@ -64,12 +64,12 @@
 #include "src/slurmd/common/proctrack.h"
 #include "hdf5_api.h"
 
-#define HDF5_CHUNK_SIZE 10
+#define HDF5_CHUNK_SIZE 64
 /* Compression level, a value of 0 through 9. Level 0 is faster but offers the
  * least compression; level 9 is slower but offers maximum compression.
  * A setting of -1 indicates that no compression is desired. */
 /* TODO: Make this configurable with a parameter */
-#define HDF5_COMPRESS 0
+#define HDF5_COMPRESS 1
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -48,6 +48,7 @@
 #define _GNU_SOURCE
 
 #include <dirent.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
 #include <stdio.h>
@@ -55,6 +56,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 
 #include "src/common/uid.h"
 #include "src/common/read_config.h"
@@ -133,9 +135,14 @@ typedef struct {
 	char *file_name;
 	int job_id;
 	char *node_name;
+	int part;		/* partial file holding this node for -P */
 	int step_id;
 } sh5util_file_t;
 
+/* Copy the data of one node-step into the Nodes group of its step */
+typedef int (*copy_node_f)(sh5util_file_t *sh5util_file, hid_t jgid_nodes,
+			   void *arg);
+
 static FILE* output_file;
 static bool group_mode = false;
 static const char *current_step;
@@ -184,6 +191,8 @@ static void _help_msg(void)
 	       "                      Default for extract is ./extract_$jobid.csv\n"
 	       " -p, --profiledir     Profile directory location where node-step files exist\n"
 	       "		               default is what is set in acct_gather.conf\n"
+	       " -P, --parallel       Number of processes merging node-step files at once\n"
+	       "                      (default 1)\n"
 	       " -S, --savefiles      Don't remove node-step files after merging them \n"
 	       " --user               User who profiled job. (Handy for root user, defaults to \n"
 	       "		               user running this command.)\n"
@@ -328,6 +337,7 @@ static void _init_opts(void)
 	memset(&params, 0, sizeof(sh5util_opts_t));
 	params.job_id = -1;
 	params.mode = SH5UTIL_MODE_MERGE;
+	params.parallel = 1;
 	params.step_id = -1;
 }
 
@@ -351,6 +361,7 @@ static int _set_options(const int argc, char **argv)
 		{"node", required_argument, 0, 'N'},
 		{"output", required_argument, 0, 'o'},
 		{"profiledir", required_argument, 0, 'p'},
+		{"parallel", required_argument, 0, 'P'},
 		{"series", required_argument, 0, 's'},
 		{"savefiles", no_argument, 0, 'S'},
 		{"usage", no_argument, 0, 'U'},
@@ -372,7 +383,7 @@ static int _set_options(const int argc, char **argv)
 
 	_init_opts();
 
-	while ((cc = getopt_long(argc, argv, "d:Ehi:Ij:l:LN:o:p:s:Su:UvV",
+	while ((cc = getopt_long(argc, argv, "d:Ehi:Ij:l:LN:o:p:P:s:Su:UvV",
 	                         long_options, &option_index)) != EOF) {
 		switch (cc) {
 		case 'd':
@@ -414,6 +425,14 @@ static int _set_options(const int argc, char **argv)
 		case 'p':
 			params.dir = xstrdup(optarg);
 			break;
+		case 'P':
+			params.parallel = strtol(optarg, &next_str, 10);
+			if ((params.parallel < 1) || next_str[0]) {
+				error("Bad value for --parallel=\"%s\"",
+				      optarg);
+				return -1;
+			}
+			break;
 		case 's':
 			if (xstrcmp(optarg, GRP_ENERGY)
 			    && xstrcmp(optarg, GRP_FILESYSTEM)
@@ -562,34 +581,280 @@ static int _merge_node_step_data(char* file_name, hid_t jgid_nodes,
 		error("%s: remove(%s): %m", __func__, file_name);
 
 endit:
+	H5Pclose(ocpypl_id);
+	H5Pclose(lcpl_id);
 	xfree(group_name);
 	H5Fclose(fid_nodestep);
 
 	return rc;
 }
 
-/* Look for step and node files and merge them together into one job file */
-static int _merge_step_files(void)
+/* copy_node_f for a node-step file found in the directory arg */
+static int _copy_node_file(sh5util_file_t *sh5util_file, hid_t jgid_nodes,
+			   void *arg)
+{
+	char *step_dir = arg;
+	char *step_path;
+	int rc;
+
+	step_path = xstrdup_printf("%s/%s", step_dir, sh5util_file->file_name);
+	rc = _merge_node_step_data(step_path, jgid_nodes, sh5util_file);
+	xfree(step_path);
+
+	return rc;
+}
+
+/* Name of the group of a step in a job file */
+static char *_step_group_name(int step_id)
+{
+	if (step_id == -2)
+		return xstrdup_printf("/%s/batch", GRP_STEPS);
+	return xstrdup_printf("/%s/%d", GRP_STEPS, step_id);
+}
+
+/* copy_node_f for a node already merged into the partial file arg[part] */
+static int _copy_node_part(sh5util_file_t *sh5util_file, hid_t jgid_nodes,
+			   void *arg)
+{
+	hid_t *fid_parts = arg;
+	hid_t fid_part = fid_parts[sh5util_file->part];
+	char *step_name, *node_path;
+	int rc = SLURM_SUCCESS;
+
+	if (fid_part < 0)
+		return SLURM_ERROR;
+
+	step_name = _step_group_name(sh5util_file->step_id);
+	node_path = xstrdup_printf("%s/%s/%s", step_name, GRP_NODES,
+				   sh5util_file->node_name);
+	/* The node may have failed to merge in the worker */
+	if (H5Lexists(fid_part, node_path, H5P_DEFAULT) <= 0) {
+		rc = SLURM_ERROR;
+	} else if (H5Ocopy(fid_part, node_path, jgid_nodes,
+			   sh5util_file->node_name, H5P_DEFAULT,
+			   H5P_DEFAULT) < 0) {
+		error("Failed to copy %s of %s into the job file",
+		      node_path, sh5util_file->file_name);
+		rc = SLURM_ERROR;
+	}
+	xfree(node_path);
+	xfree(step_name);
+
+	return rc;
+}
+
+/*
+ * Create the job file out_name holding every node-step of file_list, which
+ * must be sorted in step order.
+ */
+static int _merge_file_list(List file_list, const char *out_name,
+			    copy_node_f copy_node, void *arg)
 {
 	hid_t fid_job = -1;
 	hid_t jgid_steps = -1;
 	hid_t jgid_step = -1;
 	hid_t jgid_nodes = -1;
+	char *jgrp_nodes_name = NULL;
+	char *jgrp_step_name = NULL;
+	int node_cnt = 0;
+	int last_step = -1, step_cnt = 0;
+	int rc = SLURM_SUCCESS;
+	ListIterator itr;
+	sh5util_file_t *sh5util_file = NULL;
+
+	fid_job = H5Fcreate(out_name, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if (fid_job < 0) {
+		error("Failed create HDF5 file %s", out_name);
+		return -1;
+	}
+
+	jgid_steps = make_group(fid_job, GRP_STEPS);
+	if (jgid_steps < 0) {
+		error("Failed to create group %s",
+		      GRP_STEPS);
+		rc = -1;
+		goto endit;
+	}
+
+	itr = list_iterator_create(file_list);
+	while ((sh5util_file = list_next(itr))) {
+		/* make a group for each step */
+		if (sh5util_file->step_id != last_step) {
+			last_step = sh5util_file->step_id;
+			step_cnt++;
+			/* on to the next step, close down the last one */
+			if (jgid_step != -1) {
+				put_int_attribute(
+					jgid_step, ATTR_NNODES, node_cnt);
+				if (jgid_nodes != -1)
+					H5Gclose(jgid_nodes);
+				H5Gclose(jgid_step);
+				jgid_nodes = -1;
+				node_cnt = 0;
+			}
+
+			jgrp_step_name = _step_group_name(
+				sh5util_file->step_id);
+			jgid_step = make_group(fid_job, jgrp_step_name);
+			if (jgid_step < 0) {
+				error("Failed to create %s",
+				      jgrp_step_name);
+				xfree(jgrp_step_name);
+				continue;
+			}
+
+			jgrp_nodes_name = xstrdup_printf(
+				"%s/%s", jgrp_step_name, GRP_NODES);
+			xfree(jgrp_step_name);
+
+			jgid_nodes = make_group(
+				jgid_step, jgrp_nodes_name);
+			if (jgid_nodes < 0) {
+				error("Failed to create %s",
+				      jgrp_nodes_name);
+				xfree(jgrp_nodes_name);
+				continue;
+			}
+			xfree(jgrp_nodes_name);
+		}
+		if (jgid_nodes < 0)
+			continue;
+
+		node_cnt++;
+
+		/* append onto the step */
+		rc = (copy_node)(sh5util_file, jgid_nodes, arg);
+	}
+	list_iterator_destroy(itr);
+
+	if (jgid_step != -1)
+		put_int_attribute(jgid_step, ATTR_NNODES, node_cnt);
+	put_int_attribute(fid_job, ATTR_NSTEPS, step_cnt);
+
+endit:
+	if (jgid_nodes != -1)
+		H5Gclose(jgid_nodes);
+	if (jgid_step != -1)
+		H5Gclose(jgid_step);
+	if (jgid_steps != -1)
+		H5Gclose(jgid_steps);
+	H5Fclose(fid_job);
+
+	return rc;
+}
+
+/*
+ * Merge with params.parallel worker processes. The library is generally not
+ * built thread safe, so each worker is forked and merges a contiguous slice
+ * of the sorted node-step files into a partial job file. Opening and copying
+ * thousands of small files is the costly part of a merge and is spread
+ * across the workers; the partial files are then copied into the job file
+ * in one pass over a few open files.
+ */
+static int _merge_parallel(List file_list, char *step_dir)
+{
+	int file_cnt = list_count(file_list);
+	int part_cnt = MIN(params.parallel, file_cnt);
+	int per_part = (file_cnt + part_cnt - 1) / part_cnt;
+	int i, status, rc = SLURM_SUCCESS;
+	char **part_names;
+	hid_t *fid_parts;
+	pid_t *pids;
+	List *part_lists;
+	ListIterator itr;
+	sh5util_file_t *sh5util_file;
+
+	part_names = xmalloc(sizeof(char *) * part_cnt);
+	part_lists = xmalloc(sizeof(List) * part_cnt);
+	fid_parts = xmalloc(sizeof(hid_t) * part_cnt);
+	pids = xmalloc(sizeof(pid_t) * part_cnt);
+	for (i = 0; i < part_cnt; i++) {
+		part_names[i] = xstrdup_printf("%s.part%d", params.output, i);
+		part_lists[i] = list_create(NULL);
+		fid_parts[i] = -1;
+		pids[i] = -1;
+	}
+
+	i = 0;
+	itr = list_iterator_create(file_list);
+	while ((sh5util_file = list_next(itr))) {
+		sh5util_file->part = i++ / per_part;
+		list_append(part_lists[sh5util_file->part], sh5util_file);
+	}
+	list_iterator_destroy(itr);
+
+	/* Anything buffered now would be written again by every worker */
+	fflush(NULL);
+	for (i = 0; i < part_cnt; i++) {
+		if ((pids[i] = fork()) < 0) {
+			error("%s: fork: %m", __func__);
+			rc = SLURM_ERROR;
+			break;
+		} else if (pids[i] == 0) {
+			rc = _merge_file_list(part_lists[i], part_names[i],
+					      _copy_node_file, step_dir);
+			_exit(rc ? 1 : 0);
+		}
+	}
+
+	for (i = 0; i < part_cnt; i++) {
+		if (pids[i] <= 0)
+			continue;
+		while ((waitpid(pids[i], &status, 0) < 0) && (errno == EINTR))
+			;
+		if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+			error("Merge of %s did not complete", part_names[i]);
+			rc = SLURM_ERROR;
+		}
+	}
+
+	/* Copy whatever the workers merged, even if one of them failed */
+	for (i = 0; i < part_cnt; i++) {
+		if (pids[i] <= 0)
+			continue;
+		fid_parts[i] = H5Fopen(part_names[i], H5F_ACC_RDONLY,
+				       H5P_DEFAULT);
+		if (fid_parts[i] < 0) {
+			error("Failed to open %s", part_names[i]);
+			rc = SLURM_ERROR;
+		}
+	}
+	if (_merge_file_list(file_list, params.output, _copy_node_part,
+			     fid_parts) != SLURM_SUCCESS)
+		rc = SLURM_ERROR;
+
+	for (i = 0; i < part_cnt; i++) {
+		if (fid_parts[i] >= 0) {
+			H5Fclose(fid_parts[i]);
+			/* Only kept if the data it holds may be lost */
+			if ((rc == SLURM_SUCCESS) &&
+			    (remove(part_names[i]) == -1))
+				error("%s: remove(%s): %m", __func__,
+				      part_names[i]);
+		}
+		FREE_NULL_LIST(part_lists[i]);
+		xfree(part_names[i]);
+	}
+	xfree(part_names);
+	xfree(part_lists);
+	xfree(fid_parts);
+	xfree(pids);
+
+	return rc;
+}
+
+/* Look for step and node files and merge them together into one job file */
+static int _merge_step_files(void)
+{
 	DIR *dir;
 	struct  dirent *de;
 
 	char *file_name = NULL;
-	char *jgrp_nodes_name = NULL;
-	char *jgrp_step_name = NULL;
 	char *pos_char = NULL;
 	char *step_dir = NULL;
-	char *step_path = NULL;
 	char *stepno = NULL;
-	int node_cnt = -1;
-	int last_step = -1, step_cnt = 0;
 	int job_id;
 	int rc = SLURM_SUCCESS;
-	ListIterator itr;
 	List file_list = NULL;
 	sh5util_file_t *sh5util_file = NULL;
 
@@ -654,104 +919,20 @@ static int _merge_step_files(void)
 		goto endit;
 	}
 
-	fid_job = H5Fcreate(
-		params.output, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-	if (fid_job < 0) {
-		error("Failed create HDF5 file %s", params.output);
-		rc = -1;
-		goto endit;
-	}
-
-	jgid_steps = make_group(fid_job, GRP_STEPS);
-	if (jgid_steps < 0) {
-		error("Failed to create group %s",
-		      GRP_STEPS);
-		rc = -1;
-		goto endit;
-	}
-
 	/* sort the files so they are in step order */
 	list_sort(file_list, (ListCmpF) _sh5util_sort_files_dec);
 
-	node_cnt = 0;
-	itr = list_iterator_create(file_list);
-	while ((sh5util_file = list_next(itr))) {
-		//info("got file of %s", sh5util_file->file_name);
-
-		/* make a group for each step */
-		if (sh5util_file->step_id != last_step) {
-			last_step = sh5util_file->step_id;
-			step_cnt++;
-			/* on to the next step, close down the last one */
-			if (jgid_step) {
-				put_int_attribute(
-					jgid_step, ATTR_NNODES, node_cnt);
-				H5Gclose(jgid_nodes);
-				H5Gclose(jgid_step);
-				node_cnt = 0;
-			}
-
-			if (sh5util_file->step_id == -2)
-				jgrp_step_name = xstrdup_printf(
-					"/%s/batch", GRP_STEPS);
-			else
-				jgrp_step_name = xstrdup_printf(
-					"/%s/%d", GRP_STEPS,
-					sh5util_file->step_id);
-
-//			info("making group for step %d", sh5util_file->step_id);
-			jgid_step = make_group(fid_job, jgrp_step_name);
-			if (jgid_step < 0) {
-				error("Failed to create %s",
-				      jgrp_step_name);
-				xfree(jgrp_step_name);
-				continue;
-			}
-
-			jgrp_nodes_name = xstrdup_printf(
-				"%s/%s", jgrp_step_name, GRP_NODES);
-			xfree(jgrp_step_name);
-
-			jgid_nodes = make_group(
-				jgid_step, jgrp_nodes_name);
-			if (jgid_nodes < 0) {
-				error("Failed to create %s",
-				      jgrp_nodes_name);
-				xfree(jgrp_nodes_name);
-				continue;
-			}
-			xfree(jgrp_nodes_name);
-		}
-
-		node_cnt++;
-
-		/* append onto the step */
-		step_path = xstrdup_printf(
-			"%s/%s", step_dir, sh5util_file->file_name);
-		rc = _merge_node_step_data(
-			step_path, jgid_nodes, sh5util_file);
-		xfree(step_path);
-
-	}
-	list_iterator_destroy(itr);
-
-	put_int_attribute(fid_job, ATTR_NSTEPS, step_cnt);
-
+	if ((params.parallel > 1) && (list_count(file_list) > 1))
+		rc = _merge_parallel(file_list, step_dir);
+	else
+		rc = _merge_file_list(file_list, params.output,
+				      _copy_node_file, step_dir);
 
 endit:
 	FREE_NULL_LIST(file_list);
 	xfree(file_name);
 	xfree(step_dir);
 
-	if (jgid_steps != -1)
-		H5Gclose(jgid_steps);
-	if (jgid_step != -1)
-		H5Gclose(jgid_step);
-	if (jgid_nodes != -1)
-		H5Gclose(jgid_nodes);
-	if (fid_job != -1)
-		H5Fclose(fid_job);
-
 	return rc;
 }
 
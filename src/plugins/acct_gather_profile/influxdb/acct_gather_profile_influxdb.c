@@ -45,6 +45,8 @@
  *  Copyright (C) 2002 The Regents of the University of California.
  \*****************************************************************************/
 
+#include "config.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -55,15 +57,18 @@
 #include <inttypes.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
 #include <curl/curl.h>
 
 #include "src/common/slurm_xlator.h"
 #include "src/common/fd.h"
+#include "src/common/gzip.h"
 #include "src/common/slurm_acct_gather_profile.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/slurm_time.h"
 #include "src/common/macros.h"
+#include "src/common/xstring.h"
 #include "src/slurmd/common/proctrack.h"
 
 
@@ -96,6 +101,18 @@ const char plugin_name[] = "AcctGatherProfile influxdb plugin";
 const char plugin_type[] = "acct_gather_profile/influxdb";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
+/*
+ * Samples are queued raw by the sampling thread and turned into line
+ * protocol by a sender thread, which batches them into bodies of about
+ * BUF_SIZE bytes, compresses them and posts them over one kept alive
+ * connection. A body which can not be sent is retried with a growing delay
+ * while further samples are added to it, up to MAX_UNSENT_SIZE.
+ */
+#define MAX_QUEUED_SAMPLES	10000	/* samples waiting for the sender */
+#define MAX_UNSENT_SIZE		(64 * BUF_SIZE)	/* kept while failing */
+#define MAX_RETRY_DELAY		60	/* seconds between send attempts */
+#define SEND_TIMEOUT		30	/* seconds for one HTTP request */
+
 typedef struct {
 	char *host;
 	char *database;
@@ -123,13 +140,25 @@ union data_t{
 	double	 d;
 };
 
+typedef struct {
+	table_t table;		/* copy, its arrays never change once created */
+	time_t sample_time;
+	union data_t *data;	/* one value per table field */
+} sample_t;
+
 static slurm_influxdb_conf_t influxdb_conf;
 static uint32_t g_profile_running = ACCT_GATHER_PROFILE_NOT_SET;
 static stepd_step_rec_t *g_job = NULL;
 
-static char *datastr = NULL;
-static int datastrlen = 0;
+static pthread_mutex_t send_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t send_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t send_tid = 0;
+static List sample_list = NULL;		/* sample_t waiting for the sender */
+static bool send_flush = false;
+static bool send_stop = false;
+static uint32_t dropped_samples = 0;
 
+/* tables is protected by send_lock, samples carry a copy of their table */
 static table_t *tables = NULL;
 static size_t tables_max_len = 0;
 static size_t tables_cur_len = 0;
@@ -203,73 +232,131 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to send data to influxdb */
-static int _send_data(const char *data)
+static void _free_sample(void *x)
 {
-	CURL *curl_handle = NULL;
-	CURLcode res;
-	struct http_response chunk;
-	int rc = SLURM_SUCCESS;
-	long response_code;
-	static int error_cnt = 0;
-	char *url = NULL;
-	size_t length;
+	sample_t *sample = x;
 
-	debug3("%s %s called", plugin_type, __func__);
+	xfree(sample->data);
+	xfree(sample);
+}
 
-	/*
-	 * Every compute node which is sampling data will try to establish a
-	 * different connection to the influxdb server. In order to reduce the
-	 * number of connections, every time a new sampled data comes in, it
-	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
-	 * try to open the connection and send this buffer, instead of opening
-	 * one per sample.
-	 */
-	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
-		xstrcat(datastr, data);
-		length = strlen(data);
-		datastrlen += length;
-		if (slurm_get_debug_flags() & DEBUG_FLAG_PROFILE)
-			info("%s %s: %zu bytes of data added to buffer. New buffer size: %d",
-			     plugin_type, __func__, length, datastrlen);
-		return rc;
+/*
+ * Append the samples to body as line protocol, emptying the list.
+ * Called without send_lock, the list is no longer shared.
+ */
+static void _format_samples(List samples, char **body, size_t *body_len)
+{
+	table_t *table;
+	sample_t *sample;
+	char *pos = *body ? (*body + *body_len) : NULL;
+	int i;
+
+	while ((sample = list_dequeue(samples))) {
+		table = &sample->table;
+		for (i = 0; i < table->size; i++) {
+			switch (table->types[i]) {
+			case PROFILE_FIELD_UINT64:
+				xstrfmtcatat(*body, &pos,
+					     "%s,job=%d,step=%d,task=%s,"
+					     "host=%s value=%"PRIu64" "
+					     "%"PRIu64"\n", table->names[i],
+					     g_job->jobid, g_job->stepid,
+					     table->name, g_job->node_name,
+					     sample->data[i].u,
+					     (uint64_t) sample->sample_time);
+				break;
+			case PROFILE_FIELD_DOUBLE:
+				xstrfmtcatat(*body, &pos,
+					     "%s,job=%d,step=%d,task=%s,"
+					     "host=%s value=%.2f %"PRIu64""
+					     "\n", table->names[i],
+					     g_job->jobid, g_job->stepid,
+					     table->name, g_job->node_name,
+					     sample->data[i].d,
+					     (uint64_t) sample->sample_time);
+				break;
+			case PROFILE_FIELD_NOT_SET:
+				break;
+			}
+		}
+		_free_sample(sample);
 	}
 
-	DEF_TIMERS;
-	START_TIMER;
+	if (pos)
+		*body_len = pos - *body;
+}
 
-	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
-		error("%s %s: curl_global_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_global_init;
-	} else if ((curl_handle = curl_easy_init()) == NULL) {
+/* Set up the handle reused for every request, so the connection is kept */
+static CURL *_init_curl(struct curl_slist **gzip_hdr)
+{
+	CURL *curl_handle;
+	char *url = NULL;
+
+	if ((curl_handle = curl_easy_init()) == NULL) {
 		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+		return NULL;
 	}
 
 	xstrfmtcat(url, "%s/write?db=%s&rp=%s&precision=s", influxdb_conf.host,
 		   influxdb_conf.database, influxdb_conf.rt_policy);
-
-	chunk.message = xmalloc(1);
-	chunk.size = 0;
-
+	/* The URL is copied by libcurl */
 	curl_easy_setopt(curl_handle, CURLOPT_URL, url);
+	xfree(url);
 	if (influxdb_conf.password)
 		curl_easy_setopt(curl_handle, CURLOPT_PASSWORD,
 				 influxdb_conf.password);
-	curl_easy_setopt(curl_handle, CURLOPT_POST, 1);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, datastr);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, strlen(datastr));
 	if (influxdb_conf.username)
 		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
 				 influxdb_conf.username);
+	curl_easy_setopt(curl_handle, CURLOPT_POST, 1L);
+	curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(curl_handle, CURLOPT_CONNECTTIMEOUT, (long) SEND_TIMEOUT);
+	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, (long) SEND_TIMEOUT);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
+#if HAVE_LIBZ
+	*gzip_hdr = curl_slist_append(NULL, "Content-Encoding: gzip");
+#endif
+
+	return curl_handle;
+}
+
+/* Try to send data to influxdb */
+static int _send_data(CURL *curl_handle, struct curl_slist **gzip_hdr,
+		      const char *data, size_t length)
+{
+	CURLcode res;
+	struct http_response chunk;
+	int rc = SLURM_SUCCESS;
+	long response_code;
+	static int error_cnt = 0;
+	char *zdata = NULL;
+	size_t zlength = 0;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	DEF_TIMERS;
+	START_TIMER;
+
+#if HAVE_LIBZ
+	if (*gzip_hdr && (zdata = gzip_deflate(data, length, &zlength))) {
+		curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, *gzip_hdr);
+		curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, zdata);
+		curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, (long) zlength);
+	} else
+#endif
+	{
+		curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, NULL);
+		curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, data);
+		curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, (long) length);
+	}
+
+	chunk.message = xmalloc(1);
+	chunk.size = 0;
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk);
 
 	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
 		if ((error_cnt++ % 100) == 0)
-			error("%s %s: curl_easy_perform failed to send data (discarded). Reason: %s",
+			error("%s %s: curl_easy_perform failed to send data (will retry). Reason: %s",
 			      plugin_type, __func__, curl_easy_strerror(res));
 		rc = SLURM_ERROR;
 		goto cleanup;
@@ -293,14 +380,22 @@ static int _send_data(const char *data)
 		debug2("%s %s: data write success", plugin_type, __func__);
 		if (error_cnt > 0)
 			error_cnt = 0;
+	} else if (zdata && (response_code == 415)) {
+		/* Endpoint does not take compressed bodies, stop sending them */
+		info("%s %s: compressed data refused, sending uncompressed",
+		     plugin_type, __func__);
+		curl_slist_free_all(*gzip_hdr);
+		*gzip_hdr = NULL;
+		rc = SLURM_ERROR;
 	} else {
 		rc = SLURM_ERROR;
 		debug2("%s %s: data write failed, response code: %ld",
 		       plugin_type, __func__, response_code);
 		if (slurm_get_debug_flags() & DEBUG_FLAG_PROFILE) {
 			/* Strip any trailing newlines. */
-			while (chunk.message[strlen(chunk.message) - 1] == '\n')
-				chunk.message[strlen(chunk.message) - 1] = '\0';
+			while (chunk.size &&
+			       (chunk.message[chunk.size - 1] == '\n'))
+				chunk.message[--chunk.size] = '\0';
 			info("%s %s: JSON response body: %s", plugin_type,
 			     __func__, chunk.message);
 		}
@@ -308,26 +403,132 @@ static int _send_data(const char *data)
 
 cleanup:
 	xfree(chunk.message);
-	xfree(url);
-cleanup_easy_init:
-	curl_easy_cleanup(curl_handle);
-cleanup_global_init:
-	curl_global_cleanup();
+	xfree(zdata);
 
 	END_TIMER;
 	if (slurm_get_debug_flags() & DEBUG_FLAG_PROFILE)
-		debug("%s %s: took %s to send data", plugin_type, __func__,
-		      TIME_STR);
+		debug("%s %s: took %s to send %zu bytes (%zu compressed)",
+		      plugin_type, __func__, TIME_STR, length, zlength);
 
-	if (data) {
-		datastr = xstrdup(data);
-		datastrlen = strlen(data);
-	} else {
-		datastr[0] = '\0';
-		datastrlen = 0;
+	return rc;
+}
+
+/*
+ * Format and send queued samples. Every compute node which is sampling data
+ * posts to the influxdb server, so samples are gathered until about BUF_SIZE
+ * bytes of data are ready or a flush is requested, instead of one request
+ * per sample.
+ */
+static void *_sender(void *x)
+{
+	CURL *curl_handle;
+	struct curl_slist *gzip_hdr = NULL;
+	struct timespec ts;
+	List samples, tmp_list;
+	char *body = NULL;
+	size_t body_len = 0;
+	time_t now, retry_time = 0;
+	int rc, retry_delay = 0;
+	bool flush = false, gzip, stop = false;
+
+	curl_handle = _init_curl(&gzip_hdr);
+	samples = list_create(_free_sample);
+
+	while (!stop) {
+		slurm_mutex_lock(&send_lock);
+		if (!send_stop && !send_flush && !list_count(sample_list)) {
+			ts.tv_sec = time(NULL) + 1;
+			ts.tv_nsec = 0;
+			slurm_cond_timedwait(&send_cond, &send_lock, &ts);
+		}
+		/* Take the queued samples, format them once unlocked */
+		if (list_count(sample_list)) {
+			tmp_list = sample_list;
+			sample_list = samples;
+			samples = tmp_list;
+		}
+		flush |= send_flush;
+		send_flush = false;
+		stop = send_stop;
+		slurm_mutex_unlock(&send_lock);
+
+		_format_samples(samples, &body, &body_len);
+
+		now = time(NULL);
+		if (!body_len || !curl_handle ||
+		    ((body_len < BUF_SIZE) && !flush && !stop) ||
+		    (!stop && (now < retry_time)))
+			continue;
+
+		gzip = (gzip_hdr != NULL);
+		rc = _send_data(curl_handle, &gzip_hdr, body, body_len);
+		if ((rc != SLURM_SUCCESS) && gzip && !gzip_hdr)	/* got 415 */
+			rc = _send_data(curl_handle, &gzip_hdr, body, body_len);
+		if (rc == SLURM_SUCCESS) {
+			body[0] = '\0';
+			body_len = 0;
+			flush = false;
+			retry_delay = 0;
+			retry_time = 0;
+			continue;
+		}
+
+		retry_delay = MIN(MAX(retry_delay * 2, 1), MAX_RETRY_DELAY);
+		retry_time = now + retry_delay;
+		if (body_len > MAX_UNSENT_SIZE) {
+			error("%s %s: unable to send data, discarding %zu bytes",
+			      plugin_type, __func__, body_len);
+			body[0] = '\0';
+			body_len = 0;
+		}
 	}
 
-	return rc;
+	if (body_len)
+		error("%s %s: unable to send data, discarding %zu bytes",
+		      plugin_type, __func__, body_len);
+	if (dropped_samples)
+		error("%s %s: sender fell behind, %u samples discarded",
+		      plugin_type, __func__, dropped_samples);
+	FREE_NULL_LIST(samples);
+	xfree(body);
+	if (gzip_hdr)
+		curl_slist_free_all(gzip_hdr);
+	if (curl_handle)
+		curl_easy_cleanup(curl_handle);
+
+	return NULL;
+}
+
+static void _start_sender(void)
+{
+	slurm_mutex_lock(&send_lock);
+	if (!send_tid) {
+		sample_list = list_create(_free_sample);
+		send_stop = false;
+		dropped_samples = 0;
+		slurm_thread_create(&send_tid, _sender, NULL);
+	}
+	slurm_mutex_unlock(&send_lock);
+}
+
+/* Send everything queued and wait for the sender thread to end */
+static void _stop_sender(void)
+{
+	slurm_mutex_lock(&send_lock);
+	if (!send_tid) {
+		slurm_mutex_unlock(&send_lock);
+		return;
+	}
+	send_stop = true;
+	slurm_cond_signal(&send_cond);
+	slurm_mutex_unlock(&send_lock);
+
+	pthread_join(send_tid, NULL);
+
+	slurm_mutex_lock(&send_lock);
+	send_tid = 0;
+	FREE_NULL_LIST(sample_list);
+	slurm_mutex_unlock(&send_lock);
 }
 
 /*
@@ -341,7 +542,10 @@ extern int init(void)
 	if (!_run_in_daemon())
 		return SLURM_SUCCESS;
 
-	datastr = xmalloc(BUF_SIZE);
+	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+		error("%s %s: curl_global_init: %m", plugin_type, __func__);
+		return SLURM_ERROR;
+	}
 	return SLURM_SUCCESS;
 }
 
@@ -349,8 +553,11 @@ extern int fini(void)
 {
 	debug3("%s %s called", plugin_type, __func__);
 
+	if (_run_in_daemon()) {
+		_stop_sender();
+		curl_global_cleanup();
+	}
 	_free_tables();
-	xfree(datastr);
 	xfree(influxdb_conf.host);
 	xfree(influxdb_conf.database);
 	xfree(influxdb_conf.password);
@@ -461,6 +668,8 @@ extern int acct_gather_profile_p_node_step_start(stepd_step_rec_t* job)
 	debug2("%s %s: option --profile=%s", plugin_type, __func__,
 	       profile_str);
 	g_profile_running = _determine_profile();
+	if (g_profile_running > ACCT_GATHER_PROFILE_NONE)
+		_start_sender();
 	return rc;
 }
 
@@ -477,6 +686,8 @@ extern int acct_gather_profile_p_node_step_end(void)
 
 	xassert(_run_in_daemon());
 
+	_stop_sender();
+
 	return rc;
 }
 
@@ -502,7 +713,10 @@ extern int acct_gather_profile_p_task_end(pid_t taskpid)
 {
 	debug3("%s %s called", plugin_type, __func__);
 
-	_send_data(NULL);
+	slurm_mutex_lock(&send_lock);
+	send_flush = true;
+	slurm_cond_signal(&send_cond);
+	slurm_mutex_unlock(&send_lock);
 	return SLURM_SUCCESS;
 }
 
@@ -526,6 +740,7 @@ extern int acct_gather_profile_p_create_dataset(const char* name,
 	if (g_profile_running <= ACCT_GATHER_PROFILE_NONE)
 		return SLURM_ERROR;
 
+	slurm_mutex_lock(&send_lock);
 	/* compute the size of the type needed to create the table */
 	if (tables_cur_len == tables_max_len) {
 		if (tables_max_len == 0)
@@ -560,45 +775,37 @@ extern int acct_gather_profile_p_create_dataset(const char* name,
 		dataset_loc++;
 	}
 	++tables_cur_len;
+	slurm_mutex_unlock(&send_lock);
 	return tables_cur_len - 1;
 }
 
 extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 						 time_t sample_time)
 {
-	table_t *table = &tables[table_id];
-	int i = 0;
-	char *str = NULL;
+	sample_t *sample;
+	size_t size;
 
 	debug3("%s %s called", plugin_type, __func__);
 
-	for(; i < table->size; i++) {
-		switch (table->types[i]) {
-		case PROFILE_FIELD_UINT64:
-			xstrfmtcat(str, "%s,job=%d,step=%d,task=%s,"
-				   "host=%s value=%"PRIu64" "
-				   "%"PRIu64"\n", table->names[i],
-				   g_job->jobid, g_job->stepid,
-				   table->name, g_job->node_name,
-				   ((union data_t*)data)[i].u,
-				   sample_time);
-			break;
-		case PROFILE_FIELD_DOUBLE:
-			xstrfmtcat(str, "%s,job=%d,step=%d,task=%s,"
-				   "host=%s value=%.2f %"PRIu64""
-				   "\n", table->names[i],
-				   g_job->jobid, g_job->stepid,
-				   table->name, g_job->node_name,
-				   ((union data_t*)data)[i].d,
-				   sample_time);
-			break;
-		case PROFILE_FIELD_NOT_SET:
-			break;
-		}
+	/* Only copy the values here, the sender thread formats them */
+	slurm_mutex_lock(&send_lock);
+	if (!sample_list) {
+		slurm_mutex_unlock(&send_lock);
+		return SLURM_ERROR;
 	}
-
-	_send_data(str);
-	xfree(str);
+	size = sizeof(union data_t) * tables[table_id].size;
+	sample = xmalloc(sizeof(sample_t));
+	sample->table = tables[table_id];
+	sample->sample_time = sample_time;
+	sample->data = xmalloc_nz(size);
+	memcpy(sample->data, data, size);
+	if (list_count(sample_list) >= MAX_QUEUED_SAMPLES) {
+		_free_sample(list_dequeue(sample_list));
+		dropped_samples++;
+	}
+	list_enqueue(sample_list, sample);
+	slurm_cond_signal(&send_cond);
+	slurm_mutex_unlock(&send_lock);
 
 	return SLURM_SUCCESS;
 }
@@ -41,6 +41,7 @@
 
 #include <fcntl.h>
 #include <signal.h>
+#include <unistd.h>
 #include "src/common/slurm_xlator.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
@@ -94,13 +95,51 @@ const char plugin_name[] = "Job accounting gather cgroup plugin";
 const char plugin_type[] = "jobacct_gather/cgroup";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
+/*
+ * Read a task cgroup statistics file into buf. The file is opened once and
+ * re-read from the start at every poll, saving the path lookup, open() and
+ * close() of each sample.
+ * RET bytes read or -1 on error
+ */
+static ssize_t _read_task_stat(task_cg_info_t *task_cg, char *param,
+			       char *buf, size_t buf_size)
+{
+	char *file_path = NULL;
+	ssize_t n = -1;
+	int retry;
+
+	for (retry = 0; retry < 2; retry++) {
+		if (task_cg->stat_fd < 0) {
+			xstrfmtcat(file_path, "%s/%s",
+				   task_cg->task_cg.path, param);
+			task_cg->stat_fd = open(file_path,
+						O_RDONLY | O_CLOEXEC);
+			if (task_cg->stat_fd < 0) {
+				debug2("%s: unable to open %s: %m",
+				       __func__, file_path);
+				break;
+			}
+			xfree(file_path);
+		}
+		if ((n = pread(task_cg->stat_fd, buf, buf_size - 1, 0)) >= 0)
+			break;
+		/* The cgroup may have been recreated, reopen the file */
+		(void) close(task_cg->stat_fd);
+		task_cg->stat_fd = -1;
+	}
+	xfree(file_path);
+
+	if (n >= 0)
+		buf[n] = '\0';
+	return n;
+}
+
 static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 {
 	unsigned long utime, stime, total_rss, total_pgpgin;
-	char *cpu_time = NULL, *memory_stat = NULL, *ptr;
-	size_t cpu_time_size = 0, memory_stat_size = 0;
-	xcgroup_t *task_cpuacct_cg = NULL;;
-	xcgroup_t *task_memory_cg = NULL;
+	char cpu_time[256], memory_stat[8192], *ptr;
+	task_cg_info_t *task_cpuacct_cg = NULL;
+	task_cg_info_t *task_memory_cg = NULL;
 	bool exit_early = false;
 
 	/* Find which task cgroups to use */
@@ -132,9 +171,8 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 	//START_TIMER;
 	/* info("before"); */
 	/* print_jag_prec(prec); */
-	xcgroup_get_param(task_cpuacct_cg, "cpuacct.stat",
-			  &cpu_time, &cpu_time_size);
-	if (cpu_time == NULL) {
+	if (_read_task_stat(task_cpuacct_cg, "cpuacct.stat",
+			    cpu_time, sizeof(cpu_time)) < 0) {
 		debug2("%s: failed to collect cpuacct.stat pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -147,9 +185,8 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		prec->ssec = stime;
 	}
 
-	xcgroup_get_param(task_memory_cg, "memory.stat",
-			  &memory_stat, &memory_stat_size);
-	if (memory_stat == NULL) {
+	if (_read_task_stat(task_memory_cg, "memory.stat",
+			    memory_stat, sizeof(memory_stat)) < 0) {
 		debug2("%s: failed to collect memory.stat  pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -175,9 +212,6 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		}
 	}
 
-	xfree(cpu_time);
-	xfree(memory_stat);
-
 	/* FIXME: Enable when kernel support ready.
 	 *
 	 * "Read" and "Write" from blkio.throttle.io_service_bytes are
@@ -310,6 +344,11 @@ extern void jobacct_gather_p_poll_data(
 		memset(&callbacks, 0, sizeof(jag_callbacks_t));
 		first = 0;
 		callbacks.prec_extra = _prec_extra;
+		/*
+		 * The task cgroups account for all of a task's descendants,
+		 * only the task's own process needs to be read from /proc.
+		 */
+		callbacks.get_precs = jag_common_get_task_precs;
 	}
 
 	jag_common_poll_data(task_list, pgid_plugin, cont_id, &callbacks,
@@ -403,6 +442,8 @@ extern void free_task_cg_info(void *object)
 	task_cg_info_t *task_cg = (task_cg_info_t *)object;
 
 	if (task_cg) {
+		if (task_cg->stat_fd >= 0)
+			(void) close(task_cg->stat_fd);
 		xcgroup_destroy(&task_cg->task_cg);
 		xfree(task_cg);
 	}
@@ -359,6 +359,7 @@ jobacct_gather_cgroup_cpuacct_attach_task(pid_t pid, jobacct_id_t *jobacct_id)
 					     &taskid))) {
 		task_cg_info = xmalloc(sizeof(*task_cg_info));
 		task_cg_info->taskid = taskid;
+		task_cg_info->stat_fd = -1;
 		need_to_add = true;
 	}
 
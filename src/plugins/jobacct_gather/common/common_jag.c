@@ -581,6 +581,40 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 	}
 }
 
+/* Update consumed energy even if no process records are gathered */
+static void _update_energy_no_pids(struct jobacctinfo *jobacct)
+{
+	if (!jobacct)
+		return;
+
+	acct_gather_energy_g_get_data(energy_profile, &jobacct->energy);
+	jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.consumed_energy;
+	jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.current_watts;
+	debug2("%s: energy = %"PRIu64" watts = %"PRIu64,
+	       __func__,
+	       jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY],
+	       jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY]);
+}
+
+static void _get_pid_precs(List prec_list, pid_t *pids, int npids,
+			   jag_callbacks_t *callbacks, int tres_count)
+{
+	char	proc_stat_file[256];	/* Allow ~20x extra length */
+	char	proc_io_file[256];	/* Allow ~20x extra length */
+	char	proc_smaps_file[256];	/* Allow ~20x extra length */
+	int i;
+
+	for (i = 0; i < npids; i++) {
+		snprintf(proc_stat_file, 256, "/proc/%d/stat", pids[i]);
+		snprintf(proc_io_file, 256, "/proc/%d/io", pids[i]);
+		snprintf(proc_smaps_file, 256, "/proc/%d/smaps", pids[i]);
+		_handle_stats(prec_list, proc_stat_file, proc_io_file,
+			      proc_smaps_file, callbacks, tres_count);
+	}
+}
+
 static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 		       jag_callbacks_t *callbacks)
 {
@@ -602,34 +636,12 @@ static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 		/* get only the processes in the proctrack container */
 		proctrack_g_get_pids(cont_id, &pids, &npids);
 		if (!npids) {
-			/* update consumed energy even if pids do not exist */
-			if (jobacct) {
-				acct_gather_energy_g_get_data(
-					energy_profile,
-					&jobacct->energy);
-				jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
-					jobacct->energy.consumed_energy;
-				jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
-					jobacct->energy.current_watts;
-				debug2("%s: energy = %"PRIu64" watts = %"PRIu64,
-				       __func__,
-				       jobacct->tres_usage_in_tot[
-					       TRES_ARRAY_ENERGY],
-				       jobacct->tres_usage_out_tot[
-					       TRES_ARRAY_ENERGY]);
-			}
-
+			_update_energy_no_pids(jobacct);
 			debug4("no pids in this container %"PRIu64"", cont_id);
 			goto finished;
 		}
-		for (i = 0; i < npids; i++) {
-			snprintf(proc_stat_file, 256, "/proc/%d/stat", pids[i]);
-			snprintf(proc_io_file, 256, "/proc/%d/io", pids[i]);
-			snprintf(proc_smaps_file, 256, "/proc/%d/smaps", pids[i]);
-			_handle_stats(prec_list, proc_stat_file, proc_io_file,
-				      proc_smaps_file, callbacks,
-				      jobacct ? jobacct->tres_count : 0);
-		}
+		_get_pid_precs(prec_list, pids, npids, callbacks,
+			       jobacct ? jobacct->tres_count : 0);
 		xfree(pids);
 	} else {
 		struct dirent *slash_proc_entry;
@@ -727,6 +739,39 @@ finished:
 	return prec_list;
 }
 
+extern List jag_common_get_task_precs(List task_list, bool pgid_plugin,
+				      uint64_t cont_id,
+				      jag_callbacks_t *callbacks)
+{
+	List prec_list = list_create(destroy_jag_prec);
+	struct jobacctinfo *jobacct;
+	ListIterator itr;
+	pid_t *pids;
+	int npids = 0;
+
+	xassert(task_list);
+
+	pids = xmalloc(sizeof(pid_t) * (list_count(task_list) + 1));
+	itr = list_iterator_create(task_list);
+	while ((jobacct = list_next(itr))) {
+		if (jobacct->pid)
+			pids[npids++] = jobacct->pid;
+	}
+	list_iterator_destroy(itr);
+
+	jobacct = list_peek(task_list);
+	if (!npids) {
+		_update_energy_no_pids(jobacct);
+		debug4("no tasks in this container %"PRIu64"", cont_id);
+	} else {
+		_get_pid_precs(prec_list, pids, npids, callbacks,
+			       jobacct ? jobacct->tres_count : 0);
+	}
+	xfree(pids);
+
+	return prec_list;
+}
+
 static void _record_profile(struct jobacctinfo *jobacct)
 {
 	enum {
@@ -69,6 +69,16 @@ extern void jag_common_fini(void);
 extern void destroy_jag_prec(void *object);
 extern void print_jag_prec(jag_prec_t *prec);
 
+/*
+ * Build process records for the task leader processes in task_list only.
+ * For plugins which gather the usage of each task's descendants from
+ * elsewhere (e.g. per task cgroup counters) rather than by reading /proc for
+ * every process in the container. May be used as the get_precs callback.
+ */
+extern List jag_common_get_task_precs(List task_list, bool pgid_plugin,
+				      uint64_t cont_id,
+				      jag_callbacks_t *callbacks);
+
 extern void jag_common_poll_data(
 	List task_list, bool pgid_plugin, uint64_t cont_id,
 	jag_callbacks_t *callbacks, bool profile);
@@ -92,6 +92,7 @@
 #include "src/slurmctld/node_scheduler.h"
 #include "src/slurmctld/preempt.h"
 #include "src/slurmctld/reservation.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/srun_comm.h"
 #include "backfill.h"
@@ -1033,12 +1034,14 @@ static int _yield_locks(int64_t usec)
 	time_t job_update, node_update, part_update;
 	bool load_config = false;
 	int yield_rpc_cnt;
+	uint64_t trace_start;
 
 	yield_rpc_cnt = MAX((max_rpc_cnt / 10), 20);
 	job_update  = last_job_update;
 	node_update = last_node_update;
 	part_update = last_part_update;
 
+	trace_start = sched_trace_start();
 	unlock_slurmctld(all_locks);
 	while (!stop_backfill) {
 		bf_sleep_usec += _my_sleep(usec);
@@ -1049,6 +1052,8 @@ static int _yield_locks(int64_t usec)
 			slurmctld_config.server_thread_count);
 	}
 	lock_slurmctld(all_locks);
+	sched_trace(SCHED_TRACE_YIELD, 0, trace_start,
+		    slurmctld_config.server_thread_count);
 	slurm_mutex_lock(&config_lock);
 	if (config_flag)
 		load_config = true;
@@ -1299,7 +1304,7 @@ static int _set_hetjob_details(void *x, void *arg)
 static int _attempt_backfill(void)
 {
 	DEF_TIMERS;
-	List job_queue;
+	AList job_queue;
 	job_queue_rec_t *job_queue_rec;
 	int bb, i, j, k, node_space_recs, mcs_select = 0;
 	slurmdb_qos_rec_t *qos_ptr = NULL;
@@ -1321,6 +1326,7 @@ static int _attempt_backfill(void)
 	uint32_t *uid = NULL, nuser = 0, bf_parts = 0;
 	uint32_t *bf_part_jobs = NULL, *bf_part_resv = NULL;
 	uint16_t *njobs = NULL;
+	uint64_t trace_start;
 	bool already_counted;
 	uint32_t reject_array_job_id = 0;
 	struct part_record *reject_array_part = NULL;
@@ -1365,13 +1371,13 @@ static int _attempt_backfill(void)
 	gettimeofday(&start_tv, NULL);
 
 	job_queue = build_job_queue(true, true);
-	job_test_count = list_count(job_queue);
+	job_test_count = alist_count(job_queue);
 	if (job_test_count == 0) {
 		if (debug_flags & DEBUG_FLAG_BACKFILL)
 			info("backfill: no jobs to backfill");
 		else
 			debug("backfill: no jobs to backfill");
-		FREE_NULL_LIST(job_queue);
+		FREE_NULL_ALIST(job_queue);
 		return 0;
 	} else {
 		debug("backfill: %u jobs to backfill", job_test_count);
@@ -1464,7 +1470,7 @@ static int _attempt_backfill(void)
 			prio_reserve;
 		bool get_boot_time = false;
 
-		job_queue_rec = (job_queue_rec_t *) list_pop(job_queue);
+		job_queue_rec = (job_queue_rec_t *) alist_pop(job_queue);
 		if (!job_queue_rec) {
 			if (debug_flags & DEBUG_FLAG_BACKFILL)
 				info("backfill: reached end of job queue");
@@ -2125,6 +2131,7 @@ next_task:
 		if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
 			_dump_job_test(job_ptr, avail_bitmap, start_res);
 		test_fini = -1;
+		trace_start = sched_trace_start();
 		build_active_feature_bitmap(job_ptr, avail_bitmap,
 					    &active_bitmap);
 		job_ptr->bit_flags |= BACKFILL_TEST;
@@ -2204,6 +2211,8 @@ next_task:
 				job_ptr->details->whole_node = save_whole_node;
 			}
 		}
+		sched_trace(SCHED_TRACE_JOB_TEST, job_ptr->job_id, trace_start,
+			    j);
 		job_ptr->bit_flags &= ~BACKFILL_TEST;
 		job_ptr->bit_flags &= ~TEST_NOW_ONLY;
 
@@ -2607,6 +2616,8 @@ skip_start:
 		xfree(job_ptr->sched_nodes);
 		job_ptr->sched_nodes = bitmap2node_name(avail_bitmap);
 		bit_not(avail_bitmap);
+		sched_trace(SCHED_TRACE_RESERVE, job_ptr->job_id, 0,
+			    start_time);
 		_add_reservation(start_time, end_reserve,
 				 avail_bitmap, node_space, &node_space_recs);
 		if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
@@ -2672,7 +2683,7 @@ skip_start:
 			break;
 	}
 	xfree(node_space);
-	FREE_NULL_LIST(job_queue);
+	FREE_NULL_ALIST(job_queue);
 
 	gettimeofday(&bf_time2, NULL);
 	_do_diag_stats(&bf_time1, &bf_time2);
@@ -2697,6 +2708,7 @@ static int _start_job(struct job_record *job_ptr, bitstr_t *resv_bitmap)
 	bitstr_t *orig_exc_nodes = NULL;
 	bool is_job_array_head = false;
 	static uint32_t fail_jobid = 0;
+	uint64_t trace_start = sched_trace_start();
 
 	if (job_ptr->details->exc_node_bitmap) {
 		orig_exc_nodes = bit_copy(job_ptr->details->exc_node_bitmap);
@@ -2726,6 +2738,8 @@ static int _start_job(struct job_record *job_ptr, bitstr_t *resv_bitmap)
 		FREE_NULL_BITMAP(orig_exc_nodes);
 	if (rc == SLURM_SUCCESS) {
 		/* job initiated */
+		sched_trace(SCHED_TRACE_PLACE, job_ptr->job_id, trace_start,
+			    job_ptr->node_cnt);
 		last_job_update = time(NULL);
 		info("backfill: Started %pJ in %s on %s",
 		     job_ptr, job_ptr->part_ptr->name, job_ptr->nodes);
@@ -139,7 +139,7 @@ static void _load_config(void)
 static void _compute_start_times(void)
 {
 	int j, rc = SLURM_SUCCESS, job_cnt = 0;
-	List job_queue;
+	AList job_queue;
 	job_queue_rec_t *job_queue_rec;
 	List preemptee_candidates = NULL;
 	struct job_record *job_ptr;
@@ -155,7 +155,7 @@ static void _compute_start_times(void)
 	alloc_bitmap = bit_alloc(node_record_count);
 	job_queue = build_job_queue(true, false);
 	sort_job_queue(job_queue);
-	while ((job_queue_rec = (job_queue_rec_t *) list_pop(job_queue))) {
+	while ((job_queue_rec = (job_queue_rec_t *) alist_pop(job_queue))) {
 		job_ptr  = job_queue_rec->job_ptr;
 		part_ptr = job_queue_rec->part_ptr;
 		xfree(job_queue_rec);
@@ -232,7 +232,7 @@ static void _compute_start_times(void)
 			break;
 		}
 	}
-	FREE_NULL_LIST(job_queue);
+	FREE_NULL_ALIST(job_queue);
 	FREE_NULL_BITMAP(alloc_bitmap);
 }
 
@@ -35,6 +35,7 @@
 \*****************************************************************************/
 
 #include <string.h>
+#include "src/common/alist.h"
 #include "select_cons_tres.h"
 #include "dist_tasks.h"
 #include "job_test.h"
@@ -88,7 +89,7 @@ static void _block_whole_nodes(bitstr_t *node_bitmap,
 			       bitstr_t **orig_core_bitmap,
 			       bitstr_t **new_core_bitmap);
 static gres_mc_data_t *_build_gres_mc_data(struct job_record *job_ptr);
-static List _build_node_weight_list(bitstr_t *node_bitmap);
+static AList _build_node_weight_list(bitstr_t *node_bitmap);
 static int  _compare_support(const void *v, const void *v1);
 static void _cpus_to_use(uint16_t *avail_cpus, int64_t rem_cpus, int rem_nodes,
 			 struct job_details *details_ptr,
@@ -218,16 +219,16 @@ static int _node_weight_sort(void *x, void *y)
  * Given a bitmap of available nodes, return a list of node_weight_type
  * records in order of increasing "weight" (priority)
  */
-static List _build_node_weight_list(bitstr_t *node_bitmap)
+static AList _build_node_weight_list(bitstr_t *node_bitmap)
 {
 	int i, i_first, i_last;
-	List node_list;
+	AList node_list;
 	struct node_record *node_ptr;
 	node_weight_type *nwt;
 
 	xassert(node_bitmap);
 	/* Build list of node_weight_type records, one per node weight */
-	node_list = list_create(_node_weight_free);
+	node_list = alist_create(_node_weight_free);
 	i_first = bit_ffs(node_bitmap);
 	if (i_first == -1)
 		return node_list;
@@ -236,19 +237,19 @@ static List _build_node_weight_list(bitstr_t *node_bitmap)
 		if (!bit_test(node_bitmap, i))
 			continue;
 		node_ptr = node_record_table_ptr + i;
-		nwt = list_find_first(node_list, _node_weight_find,
+		nwt = alist_find_first(node_list, _node_weight_find,
 				      node_ptr->config_ptr);
 		if (!nwt) {
 			nwt = xmalloc(sizeof(node_weight_type));
 			nwt->node_bitmap = bit_alloc(select_node_cnt);
 			nwt->weight = node_ptr->config_ptr->weight;
-			list_append(node_list, nwt);
+			alist_append(node_list, nwt);
 		}
 		bit_set(nwt->node_bitmap, i);
 	}
 
 	/* Sort the list in order of increasing node weight */
-	list_sort(node_list, _node_weight_sort);
+	alist_sort(node_list, _node_weight_sort);
 
 	return node_list;
 }
@@ -2970,9 +2971,9 @@ static int _eval_nodes_spread(struct job_record *job_ptr,
 	bool all_done = false, gres_per_job;
 	uint16_t avail_cpus = 0;
 	struct node_record *node_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	node_weight_type *nwt;
-	ListIterator iter;
+	AListIterator iter;
 	bool enforce_binding = false;
 
 	if (job_ptr->gres_list && (job_ptr->bit_flags & GRES_ENFORCE_BIND))
@@ -3064,8 +3065,8 @@ static int _eval_nodes_spread(struct job_record *job_ptr,
 	if (max_nodes == 0)
 		all_done = true;
 	node_weight_list = _build_node_weight_list(orig_node_map);
-	iter = list_iterator_create(node_weight_list);
-	while (!all_done && (nwt = (node_weight_type *) list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!all_done && (nwt = (node_weight_type *) alist_next(iter))) {
 		for (i = i_start; i <= i_end; i++) {
 			if (!avail_res_array[i] ||
 			    !avail_res_array[i]->avail_cpus)
@@ -3114,7 +3115,7 @@ static int _eval_nodes_spread(struct job_record *job_ptr,
 			}
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (error_code == SLURM_SUCCESS) {
 		/* Already succeeded */
@@ -3127,7 +3128,7 @@ static int _eval_nodes_spread(struct job_record *job_ptr,
 		error_code = SLURM_SUCCESS;
 	}
 
-fini:	FREE_NULL_LIST(node_weight_list);
+fini:	FREE_NULL_ALIST(node_weight_list);
 	bit_free(orig_node_map);
 	return error_code;
 }
@@ -3154,9 +3155,9 @@ static int _eval_nodes_busy(struct job_record *job_ptr,
 	bool all_done = false, gres_per_job;
 	uint16_t avail_cpus = 0;
 	struct node_record *node_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	node_weight_type *nwt;
-	ListIterator iter;
+	AListIterator iter;
 	bool enforce_binding = false;
 
 	if (job_ptr->gres_list && (job_ptr->bit_flags & GRES_ENFORCE_BIND))
@@ -3253,8 +3254,8 @@ static int _eval_nodes_busy(struct job_record *job_ptr,
 	if (max_nodes == 0)
 		all_done = true;
 	node_weight_list = _build_node_weight_list(orig_node_map);
-	iter = list_iterator_create(node_weight_list);
-	while (!all_done && (nwt = (node_weight_type *) list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!all_done && (nwt = (node_weight_type *) alist_next(iter))) {
 		for (idle_test = 0; idle_test < 2; idle_test++) {
 			for (i = i_start; i <= i_end; i++) {
 				if (!avail_res_array[i] ||
@@ -3315,7 +3316,7 @@ static int _eval_nodes_busy(struct job_record *job_ptr,
 			}
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (error_code == SLURM_SUCCESS) {
 		/* Already succeeded */
@@ -3328,7 +3329,7 @@ static int _eval_nodes_busy(struct job_record *job_ptr,
 		error_code = SLURM_SUCCESS;
 	}
 
-fini:	FREE_NULL_LIST(node_weight_list);
+fini:	FREE_NULL_ALIST(node_weight_list);
 	bit_free(orig_node_map);
 	return error_code;
 }
@@ -3388,9 +3389,9 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	int best_cpu_cnt = 0, best_node_cnt = 0, req_node_cnt = 0;
 	List best_gres = NULL;
 	struct switch_record *switch_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	topo_weight_info_t *nw = NULL;
-	ListIterator iter;
+	AListIterator iter;
 	struct node_record *node_ptr;
 	uint16_t avail_cpus = 0;
 	int64_t rem_max_cpus;
@@ -3470,7 +3471,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	}
 	i_last = bit_fls(node_map);
 	avail_cpu_per_node = xmalloc(sizeof(uint16_t) * select_node_cnt);
-	node_weight_list = list_create(_topo_weight_free);
+	node_weight_list = alist_create(_topo_weight_free);
 	for (i = i_first; i <= i_last; i++) {
 		topo_weight_info_t nw_static;
 		if (!bit_test(node_map, i))
@@ -3504,13 +3505,13 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		nw_static.weight = node_ptr->sched_weight;
-		nw = list_find_first(node_weight_list, _topo_weight_find,
+		nw = alist_find_first(node_weight_list, _topo_weight_find,
 				     &nw_static);
 		if (!nw) {	/* New node weight to add */
 			nw = xmalloc(sizeof(topo_weight_info_t));
 			nw->node_bitmap = bit_alloc(select_node_cnt);
 			nw->weight = node_ptr->sched_weight;
-			list_append(node_weight_list, nw);
+			alist_append(node_weight_list, nw);
 		}
 		bit_set(nw->node_bitmap, i);
 		nw->node_cnt++;
@@ -3535,9 +3536,9 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 		bit_clear_all(node_map);
 	}
 
-	list_sort(node_weight_list, _topo_weight_sort);
+	alist_sort(node_weight_list, _topo_weight_sort);
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)
-		(void) list_for_each(node_weight_list, _topo_weight_log, NULL);
+		(void) alist_for_each(node_weight_list, _topo_weight_log, NULL);
 
 	/*
 	 * Identify the highest level switch to be used.
@@ -3550,7 +3551,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	switch_required    = xmalloc(sizeof(int)        * switch_record_cnt);
 
 	if (!req_nodes_bitmap)
-		nw = list_peek(node_weight_list);
+		nw = alist_peek(node_weight_list);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
 		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
@@ -3619,8 +3620,8 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	 * Later logic selects from those nodes to get the best topology.
 	 */
 	best_nodes_bitmap = bit_alloc(select_node_cnt);
-	iter = list_iterator_create(node_weight_list);
-	while (!sufficient && (nw = list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!sufficient && (nw = alist_next(iter))) {
 		if (best_node_cnt > 0) {
 			/*
 			 * All of the lower priority nodes should be included
@@ -3668,7 +3669,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 					job_ptr->gres_list, best_gres);
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE) {
 		char *gres_str = NULL, *gres_print = "";
@@ -3987,7 +3988,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	rc = SLURM_ERROR;
 
 fini:	FREE_NULL_LIST(best_gres);
-	FREE_NULL_LIST(node_weight_list);
+	FREE_NULL_ALIST(node_weight_list);
 	FREE_NULL_BITMAP(avail_nodes_bitmap);
 	FREE_NULL_BITMAP(req_nodes_bitmap);
 	FREE_NULL_BITMAP(req2_nodes_bitmap);
@@ -4022,9 +4023,9 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	int best_cpu_cnt = 0, best_node_cnt = 0, req_node_cnt = 0;
 	List best_gres = NULL;
 	struct switch_record *switch_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	topo_weight_info_t *nw = NULL;
-	ListIterator iter;
+	AListIterator iter;
 	struct node_record *node_ptr;
 	uint16_t avail_cpus = 0;
 	int64_t rem_max_cpus;
@@ -4098,7 +4099,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	}
 	i_last = bit_fls(node_map);
 	avail_cpu_per_node = xmalloc(sizeof(uint16_t) * select_node_cnt);
-	node_weight_list = list_create(_topo_weight_free);
+	node_weight_list = alist_create(_topo_weight_free);
 	for (i = i_first; i <= i_last; i++) {
 		topo_weight_info_t nw_static;
 		if (!bit_test(node_map, i))
@@ -4132,13 +4133,13 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		nw_static.weight = node_ptr->sched_weight;
-		nw = list_find_first(node_weight_list, _topo_weight_find,
+		nw = alist_find_first(node_weight_list, _topo_weight_find,
 				     &nw_static);
 		if (!nw) {	/* New node weight to add */
 			nw = xmalloc(sizeof(topo_weight_info_t));
 			nw->node_bitmap = bit_alloc(select_node_cnt);
 			nw->weight = node_ptr->sched_weight;
-			list_append(node_weight_list, nw);
+			alist_append(node_weight_list, nw);
 		}
 		bit_set(nw->node_bitmap, i);
 		nw->node_cnt++;
@@ -4163,9 +4164,9 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 		bit_clear_all(node_map);
 	}
 
-	list_sort(node_weight_list, _topo_weight_sort);
+	alist_sort(node_weight_list, _topo_weight_sort);
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)
-		(void) list_for_each(node_weight_list, _topo_weight_log, NULL);
+		(void) alist_for_each(node_weight_list, _topo_weight_log, NULL);
 
 	/*
 	 * Identify the highest level switch to be used.
@@ -4178,7 +4179,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	switch_required    = xmalloc(sizeof(int)        * switch_record_cnt);
 
 	if (!req_nodes_bitmap)
-		nw = list_peek(node_weight_list);
+		nw = alist_peek(node_weight_list);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
 		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
@@ -4247,8 +4248,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	 * Later logic selects from those nodes to get the best topology.
 	 */
 	best_nodes_bitmap = bit_alloc(select_node_cnt);
-	iter = list_iterator_create(node_weight_list);
-	while (!sufficient && (nw = list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!sufficient && (nw = alist_next(iter))) {
 		if (best_node_cnt > 0) {
 			/*
 			 * All of the lower priority nodes should be included
@@ -4296,7 +4297,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 					job_ptr->gres_list, best_gres);
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE) {
 		char *gres_str = NULL, *gres_print = "";
@@ -4562,7 +4563,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	rc = SLURM_ERROR;
 
 fini:	FREE_NULL_LIST(best_gres);
-	FREE_NULL_LIST(node_weight_list);
+	FREE_NULL_ALIST(node_weight_list);
 	FREE_NULL_BITMAP(avail_nodes_bitmap);
 	FREE_NULL_BITMAP(req_nodes_bitmap);
 	FREE_NULL_BITMAP(req2_nodes_bitmap);
@@ -4594,9 +4595,9 @@ static int _eval_nodes_lln(struct job_record *job_ptr,
 	bool all_done = false, gres_per_job;
 	uint16_t avail_cpus = 0;
 	struct node_record *node_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	node_weight_type *nwt;
-	ListIterator iter;
+	AListIterator iter;
 	uint16_t *avail_cpu_per_node = NULL;
 	bool enforce_binding = false;
 
@@ -4695,8 +4696,8 @@ static int _eval_nodes_lln(struct job_record *job_ptr,
 		all_done = true;
 	avail_cpu_per_node = xmalloc(sizeof(uint16_t) * select_node_cnt);
 	node_weight_list = _build_node_weight_list(orig_node_map);
-	iter = list_iterator_create(node_weight_list);
-	while (!all_done && (nwt = (node_weight_type *) list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!all_done && (nwt = (node_weight_type *) alist_next(iter))) {
 		int last_max_cpu_cnt = -1;
 		while (!all_done) {
 			int max_cpu_idx = -1;
@@ -4765,7 +4766,7 @@ static int _eval_nodes_lln(struct job_record *job_ptr,
 			}
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (error_code == SLURM_SUCCESS) {
 		/* Already succeeded */
@@ -4778,7 +4779,7 @@ static int _eval_nodes_lln(struct job_record *job_ptr,
 		error_code = SLURM_SUCCESS;
 	}
 
-fini:	FREE_NULL_LIST(node_weight_list);
+fini:	FREE_NULL_ALIST(node_weight_list);
 	bit_free(orig_node_map);
 	xfree(avail_cpu_per_node);
 	return error_code;
@@ -4806,9 +4807,9 @@ static int _eval_nodes_serial(struct job_record *job_ptr,
 	bool all_done = false, gres_per_job;
 	uint16_t avail_cpus = 0;
 	struct node_record *node_ptr;
-	List node_weight_list = NULL;
+	AList node_weight_list = NULL;
 	node_weight_type *nwt;
-	ListIterator iter;
+	AListIterator iter;
 	bool enforce_binding = false;
 
 	if (job_ptr->gres_list && (job_ptr->bit_flags & GRES_ENFORCE_BIND))
@@ -4900,8 +4901,8 @@ static int _eval_nodes_serial(struct job_record *job_ptr,
 	if (max_nodes == 0)
 		all_done = true;
 	node_weight_list = _build_node_weight_list(orig_node_map);
-	iter = list_iterator_create(node_weight_list);
-	while (!all_done && (nwt = (node_weight_type *) list_next(iter))) {
+	iter = alist_iterator_create(node_weight_list);
+	while (!all_done && (nwt = (node_weight_type *) alist_next(iter))) {
 		for (i = i_end; ((i >= i_start) && (max_nodes > 0)); i--) {
 			if (!avail_res_array[i] ||
 			    !avail_res_array[i]->avail_cpus)
@@ -4950,7 +4951,7 @@ static int _eval_nodes_serial(struct job_record *job_ptr,
 			}
 		}
 	}
-	list_iterator_destroy(iter);
+	alist_iterator_destroy(iter);
 
 	if (error_code == SLURM_SUCCESS) {
 		/* Already succeeded */
@@ -4963,7 +4964,7 @@ static int _eval_nodes_serial(struct job_record *job_ptr,
 		error_code = SLURM_SUCCESS;
 	}
 
-fini:	FREE_NULL_LIST(node_weight_list);
+fini:	FREE_NULL_ALIST(node_weight_list);
 	bit_free(orig_node_map);
 	return error_code;
 
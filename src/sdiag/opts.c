@@ -40,10 +40,13 @@
 #include <stdlib.h>
 #include <unistd.h>
 
-#include "src/common/xstring.h"
 #include "src/common/proc_args.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
 
 #define OPT_LONG_USAGE 0x101
+#define OPT_LONG_SCHED_TRACE      0x102
+#define OPT_LONG_SCHED_TRACE_JSON 0x103
 
 static void  _help( void );
 static void  _usage( void );
@@ -52,6 +55,8 @@ extern int  sdiag_param;
 extern bool sort_by_id;
 extern bool sort_by_time;
 extern bool sort_by_time2;
+extern char *sched_trace_file;
+extern char *sched_trace_json;
 
 /*
  * parse_command_line, fill in params data structure with data
@@ -64,6 +69,9 @@ extern void parse_command_line(int argc, char **argv)
 		{"all",		no_argument,	0,	'a'},
 		{"help",	no_argument,	0,	'h'},
 		{"reset",	no_argument,	0,	'r'},
+		{"sched-trace",	required_argument, 0,	OPT_LONG_SCHED_TRACE},
+		{"sched-trace-json", required_argument, 0,
+		 OPT_LONG_SCHED_TRACE_JSON},
 		{"sort-by-id",	no_argument,	0,	'i'},
 		{"sort-by-time",no_argument,	0,	't'},
 		{"sort-by-time2",no_argument,	0,	'T'},
@@ -98,6 +106,14 @@ extern void parse_command_line(int argc, char **argv)
 				print_slurm_version();
 				exit(0);
 				break;
+			case (int)OPT_LONG_SCHED_TRACE:
+				xfree(sched_trace_file);
+				sched_trace_file = xstrdup(optarg);
+				break;
+			case (int)OPT_LONG_SCHED_TRACE_JSON:
+				xfree(sched_trace_json);
+				sched_trace_json = xstrdup(optarg);
+				break;
 			case (int)OPT_LONG_USAGE:
 				_usage();
 				exit(0);
@@ -118,6 +134,9 @@ static void _help( void )
 Usage: sdiag [OPTIONS]\n\
   -a              all statistics\n\
   -r              reset statistics\n\
+  --sched-trace=FILE       save slurmctld's scheduling event trace to FILE\n\
+  --sched-trace-json=FILE  print a saved scheduling event trace in Chrome\n\
+                           trace event (JSON) format\n\
 \nHelp options:\n\
   --help          show this help message\n\
   --sort-by-id    sort RPCs by id\n\
@@ -36,13 +36,17 @@
 
 #include "config.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 
 #include <slurm.h>
 #include "src/common/macros.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
+#include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/slurm_protocol_pack.h"
 #include "src/common/slurm_time.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
@@ -55,10 +59,14 @@ int sdiag_param = STAT_COMMAND_GET;
 bool sort_by_id    = false;
 bool sort_by_time  = false;
 bool sort_by_time2 = false;
+char *sched_trace_file = NULL;
+char *sched_trace_json = NULL;
 
 stats_info_response_msg_t *buf;
 uint32_t *rpc_type_ave_time = NULL, *rpc_user_ave_time = NULL;
 
+static int  _get_sched_trace(char *file);
+static int  _print_sched_trace(char *file);
 static int  _print_stats(void);
 static void _sort_rpc(void);
 
@@ -73,7 +81,11 @@ int main(int argc, char **argv)
 	slurm_conf_init(NULL);
 	parse_command_line(argc, argv);
 
-	if (sdiag_param == STAT_COMMAND_RESET) {
+	if (sched_trace_json) {
+		rc = _print_sched_trace(sched_trace_json);
+	} else if (sched_trace_file) {
+		rc = _get_sched_trace(sched_trace_file);
+	} else if (sdiag_param == STAT_COMMAND_RESET) {
 		req.command_id = STAT_COMMAND_RESET;
 		rc = slurm_reset_statistics((stats_info_request_msg_t *)&req);
 		if (rc == SLURM_SUCCESS)
@@ -100,6 +112,145 @@ int main(int argc, char **argv)
 	exit(rc);
 }
 
+#define SCHED_TRACE_MAGIC "slurm_sched_trace"
+
+/* Retrieve slurmctld's scheduling event trace and save it to a file */
+static int _get_sched_trace(char *file)
+{
+	slurm_msg_t req_msg, resp_msg;
+	sched_trace_msg_t *trace = NULL;
+	Buf buffer;
+	FILE *fp;
+	int rc = SLURM_SUCCESS;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	req_msg.msg_type = REQUEST_SCHED_TRACE;
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					   working_cluster_rec) < 0) {
+		slurm_perror("slurm_send_recv_controller_msg");
+		return SLURM_ERROR;
+	}
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SCHED_TRACE:
+		trace = (sched_trace_msg_t *) resp_msg.data;
+		break;
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		slurm_seterrno(rc);
+		slurm_perror("REQUEST_SCHED_TRACE");
+		return SLURM_ERROR;
+	default:
+		slurm_seterrno(SLURM_UNEXPECTED_MSG_ERROR);
+		slurm_perror("REQUEST_SCHED_TRACE");
+		return SLURM_ERROR;
+	}
+
+	buffer = init_buf(BUF_SIZE);
+	packstr(SCHED_TRACE_MAGIC, buffer);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_sched_trace_msg(trace, buffer, SLURM_PROTOCOL_VERSION);
+
+	if (!(fp = fopen(file, "w"))) {
+		perror(file);
+		rc = SLURM_ERROR;
+	} else {
+		if ((fwrite(get_buf_data(buffer), get_buf_offset(buffer), 1,
+			    fp) != 1) || fclose(fp)) {
+			perror(file);
+			rc = SLURM_ERROR;
+		} else {
+			printf("Saved %u scheduling events from %u threads "
+			       "to %s\n", trace->rec_cnt, trace->thread_cnt,
+			       file);
+		}
+	}
+	free_buf(buffer);
+	slurm_free_sched_trace_msg(trace);
+
+	return rc;
+}
+
+static void _print_json_str(char *str)
+{
+	putchar('"');
+	for ( ; str && *str; str++) {
+		if ((*str == '"') || (*str == '\\'))
+			putchar('\\');
+		if ((unsigned char) *str >= ' ')
+			putchar(*str);
+	}
+	putchar('"');
+}
+
+/*
+ * Convert a file saved with --sched-trace to the Chrome trace event format,
+ * which can be loaded into chrome://tracing or Perfetto
+ */
+static int _print_sched_trace(char *file)
+{
+	static const char *names[] = {
+		NULL, "job_test", "place", "yield", "reserve", "preempt" };
+	static const char *args[] = {
+		NULL, "rc", "nodes", "rpcs", "start_time", "preemptor" };
+	sched_trace_msg_t *trace = NULL;
+	sched_trace_rec_t *rec;
+	char *magic = NULL;
+	uint32_t i, len;
+	uint16_t protocol_version = NO_VAL16, type;
+	Buf buffer;
+
+	if (!(buffer = create_mmap_buf(file))) {
+		perror(file);
+		return SLURM_ERROR;
+	}
+	safe_unpackstr_xmalloc(&magic, &len, buffer);
+	if (xstrcmp(magic, SCHED_TRACE_MAGIC))
+		goto unpack_error;
+	safe_unpack16(&protocol_version, buffer);
+	if (unpack_sched_trace_msg(&trace, buffer, protocol_version))
+		goto unpack_error;
+	xfree(magic);
+	free_buf(buffer);
+
+	printf("{\"traceEvents\":[\n");
+	for (i = 0; i < trace->thread_cnt; i++) {
+		printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		       "\"tid\":%u,\"args\":{\"name\":", i);
+		_print_json_str(trace->thread_name[i]);
+		printf("}},\n");
+	}
+	for (i = 0, rec = trace->recs; i < trace->rec_cnt; i++, rec++) {
+		type = (rec->type < (sizeof(names) / sizeof(names[0]))) ?
+		       rec->type : 0;
+		printf("{\"name\":\"%s\",\"cat\":\"sched\",\"pid\":1,"
+		       "\"tid\":%u,\"ts\":%"PRIu64",",
+		       type ? names[type] : "unknown", rec->thread,
+		       rec->start);
+		if (rec->duration)
+			printf("\"ph\":\"X\",\"dur\":%u,", rec->duration);
+		else
+			printf("\"ph\":\"i\",\"s\":\"t\",");
+		printf("\"args\":{\"job_id\":%u,\"%s\":%u}},\n",
+		       rec->job_id, type ? args[type] : "arg", rec->arg);
+	}
+	/* Ending with the process name avoids a trailing comma */
+	printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	       "\"args\":{\"name\":\"slurmctld\"}}\n]}\n");
+	slurm_free_sched_trace_msg(trace);
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	fprintf(stderr, "%s: not a scheduling trace file from a supported "
+		"Slurm version\n", file);
+	xfree(magic);
+	free_buf(buffer);
+	return SLURM_ERROR;
+}
+
 static int _print_stats(void)
 {
 	int i;
@@ -119,7 +270,9 @@ static int _print_stats(void)
 	printf("Server thread count:  %d\n", buf->server_thread_count);
 	printf("Agent queue size:     %d\n", buf->agent_queue_size);
 	printf("Agent count:          %d\n", buf->agent_count);
-	printf("DBD Agent queue size: %d\n\n", buf->dbd_agent_queue_size);
+	printf("DBD Agent queue size: %d\n", buf->dbd_agent_queue_size);
+	printf("Log queue size:       %u\n", buf->log_queue_len);
+	printf("Log messages dropped: %"PRIu64"\n\n", buf->log_drop_cnt);
 
 	printf("Jobs submitted: %d\n", buf->jobs_submitted);
 	printf("Jobs started:   %d\n", buf->jobs_started);
@@ -226,6 +379,17 @@ static int _print_stats(void)
 		       buf->rpc_dump_hostlist[i]);
 	}
 
+	if (buf->pool_count > 0)
+		printf("\nMemory pool statistics\n");
+	for (i = 0; i < buf->pool_count; i++) {
+		printf("\t%-16s obj_size:%-6u slabs:%-6u in_use:%-8u "
+		       "free:%-8u allocs:%-10"PRIu64" slabs_freed:%"PRIu64"\n",
+		       buf->pool_name[i], buf->pool_obj_size[i],
+		       buf->pool_slab_cnt[i], buf->pool_obj_in_use[i],
+		       buf->pool_obj_free[i], buf->pool_alloc_cnt[i],
+		       buf->pool_slab_free_cnt[i]);
+	}
+
 	return 0;
 }
 
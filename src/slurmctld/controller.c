@@ -113,6 +113,7 @@
 #include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/sched_plugin.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/slurmctld_plugstack.h"
 #include "src/slurmctld/srun_comm.h"
@@ -876,6 +877,7 @@ int main(int argc, char **argv)
 	purge_front_end_state();
 	resv_fini();
 	trigger_fini();
+	sched_trace_fini();
 	fed_mgr_fini();
 	assoc_mgr_fini(1);
 	reserve_port_config(NULL);
@@ -2861,6 +2863,12 @@ void update_logging(void)
 			      (int) slurm_user_id, (int) slurm_user_gid);
 		}
 	}
+
+	if (!test_config &&
+	    xstrcasestr(slurmctld_conf.slurmctld_params, "async_log"))
+		log_set_async(true);
+	else
+		log_set_async(false);
 }
 
 /* Reset slurmd nice value */
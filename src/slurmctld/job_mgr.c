@@ -147,6 +147,10 @@ time_t last_job_update;		/* time of last update to job records */
 
 List purge_files_list = NULL;	/* job files to delete */
 
+mem_pool_t *job_record_pool = NULL;	/* struct job_record allocator */
+mem_pool_t *job_details_pool = NULL;	/* struct job_details allocator */
+mem_pool_t *step_record_pool = NULL;	/* struct step_record allocator */
+
 /* Local variables */
 static int      bf_min_age_reserve = 0;
 static uint32_t delay_boot = 0;
@@ -161,6 +165,8 @@ static struct   job_record **job_array_hash_t = NULL;
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
+/* Fingerprint of the node table which job and step node bitmaps refer to */
+static uint64_t node_bitmap_fingerprint = 0;
 static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
 static bool     validate_cfgd_licenses = true;
@@ -171,6 +177,7 @@ static void _add_job_array_hash(struct job_record *job_ptr);
 static int  _checkpoint_job_record (struct job_record *job_ptr,
 				    char *image_dir);
 static void _clear_job_gres_details(struct job_record *job_ptr);
+static int  _clear_step_node_bitmap(void *x, void *arg);
 static int  _copy_job_desc_to_file(job_desc_msg_t * job_desc,
 				   uint32_t job_id);
 static int  _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
@@ -229,7 +236,8 @@ static void _remove_defunct_batch_dirs(List batch_dirs);
 static void _remove_job_hash(struct job_record *job_ptr,
 			     job_hash_type_t type);
 static int  _reset_detail_bitmaps(struct job_record *job_ptr);
-static void _reset_step_bitmaps(struct job_record *job_ptr);
+static void _reset_step_bitmaps(struct job_record *job_ptr,
+				bool keep_bitmaps);
 static void _resp_array_add(resp_array_struct_t **resp,
 			    struct job_record *job_ptr, uint32_t rc);
 static void _resp_array_add_id(resp_array_struct_t **resp, uint32_t job_id,
@@ -455,12 +463,12 @@ static job_array_resp_msg_t *_resp_array_xlate(resp_array_struct_t *resp,
  *    = 1 - simple job OR job array with one task
  *    > 1 - job array create with the task count as num_jobs
  * RET pointer to the record or NULL if error
- * NOTE: allocates memory that should be xfreed with _list_delete_job
+ * NOTE: allocates memory that should be freed with _list_delete_job
  */
 static struct job_record *_create_job_record(uint32_t num_jobs)
 {
-	struct job_record *job_ptr = xmalloc(sizeof(*job_ptr));
-	struct job_details *detail_ptr = xmalloc(sizeof(*detail_ptr));
+	struct job_record *job_ptr = mem_pool_alloc(job_record_pool);
+	struct job_details *detail_ptr = mem_pool_alloc(job_details_pool);
 
 	if ((job_count + num_jobs) >= slurmctld_conf.max_job_cnt) {
 		error("%s: MaxJobCount limit from slurm.conf reached (%u)",
@@ -538,10 +546,10 @@ static void _delete_job_details(struct job_record *job_entry)
 	FREE_NULL_BITMAP(job_entry->details->req_node_bitmap);
 	xfree(job_entry->details->req_nodes);
 	xfree(job_entry->details->restart_dir);
-	xfree(job_entry->details->work_dir);
+	str_intern_free(job_entry->details->work_dir);
 	xfree(job_entry->details->x11_magic_cookie);
 	xfree(job_entry->details->x11_target);
-	xfree(job_entry->details);	/* Must be last */
+	mem_pool_free(job_entry->details);	/* Must be last */
 }
 
 /*
@@ -714,13 +722,16 @@ int dump_all_job_state(void)
 	 * This is needed so that the job id remains persistent even after
 	 * slurmctld is restarted.
 	 */
+	lock_slurmctld(job_read_lock);
 	pack32( job_id_sequence, buffer);
 
 	debug3("Writing job id %u to header record of job_state file",
 	       job_id_sequence);
 
+	/* write header: node table the saved node bitmaps refer to */
+	pack64(node_conf_fingerprint(), buffer);
+
 	/* write individual job records */
-	lock_slurmctld(job_read_lock);
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		_dump_job_state(job_ptr, buffer);
@@ -973,6 +984,18 @@ extern int load_all_job_state(void)
 		job_id_sequence = MAX(saved_job_id, job_id_sequence);
 	debug3("Job id in job_state header is %u", saved_job_id);
 
+	/*
+	 * Saved node bitmaps are only usable if the node table is the same,
+	 * otherwise reset_job_bitmaps() rebuilds them from the node names.
+	 */
+	node_bitmap_fingerprint = 0;
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION)
+		safe_unpack64(&node_bitmap_fingerprint, buffer);
+	if (node_bitmap_fingerprint != node_conf_fingerprint()) {
+		debug("Node table changed, rebuilding job node bitmaps from node names");
+		node_bitmap_fingerprint = 0;
+	}
+
 	/*
 	 * Previously we locked the tres read lock before this loop.  It turned
 	 * out that created a double lock when steps were being loaded during
@@ -1238,6 +1261,9 @@ static void _dump_job_state(struct job_record *dump_job_ptr, Buf buffer)
 				     buffer, SLURM_PROTOCOL_VERSION);
 	pack_job_resources(dump_job_ptr->job_resrcs, buffer,
 			   SLURM_PROTOCOL_VERSION);
+	pack_bit_str_runs(dump_job_ptr->node_bitmap, buffer);
+	pack_bit_str_runs(dump_job_ptr->job_resrcs ?
+			  dump_job_ptr->job_resrcs->node_bitmap : NULL, buffer);
 
 	pack16(dump_job_ptr->ckpt_interval, buffer);
 	checkpoint_pack_jobinfo(dump_job_ptr->check_job, buffer,
@@ -1331,6 +1357,7 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	int error_code, i, qos_error;
 	dynamic_plugin_data_t *select_jobinfo = NULL;
 	job_resources_t *job_resources = NULL;
+	bitstr_t *node_bitmap = NULL, *resrcs_node_bitmap = NULL;
 	check_jobinfo_t check_job = NULL;
 	slurmdb_assoc_rec_t assoc_rec;
 	slurmdb_qos_rec_t qos_rec;
@@ -1507,6 +1534,8 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 		if (unpack_job_resources(&job_resources, buffer,
 					 protocol_version))
 			goto unpack_error;
+		unpack_bit_str_runs(&node_bitmap, buffer);
+		unpack_bit_str_runs(&resrcs_node_bitmap, buffer);
 
 		safe_unpack16(&ckpt_interval, buffer);
 		if (checkpoint_alloc_jobinfo(&check_job) ||
@@ -1546,6 +1575,9 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 				goto unpack_error;
 			safe_unpack16(&step_flag, buffer);
 		}
+		if (!node_bitmap_fingerprint)
+			list_for_each(job_ptr->step_list,
+				      _clear_step_node_bitmap, NULL);
 		safe_unpack32(&job_ptr->bit_flags, buffer);
 		job_ptr->bit_flags &= ~BACKFILL_TEST;
 		safe_unpackstr_xmalloc(&tres_alloc_str,
@@ -2072,10 +2104,9 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	job_ptr->tres_fmt_req_str = tres_fmt_req_str;
 	tres_fmt_req_str = NULL;
 
-	xfree(job_ptr->account);
-	job_ptr->account = account;
-	xstrtolower(job_ptr->account);
-	account          = NULL;  /* reused, nothing left to free */
+	str_intern_free(job_ptr->account);
+	xstrtolower(account);
+	job_ptr->account = str_intern_xfer(account);
 	xfree(job_ptr->alloc_node);
 	job_ptr->alloc_node   = alloc_node;
 	alloc_node             = NULL;	/* reused, nothing left to free */
@@ -2139,13 +2170,11 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	xfree(job_ptr->name);		/* in case duplicate record */
 	job_ptr->name         = name;
 	name                  = NULL;	/* reused, nothing left to free */
-	xfree(job_ptr->user_name);
-	job_ptr->user_name    = user_name;
-	user_name             = NULL;   /* reused, nothing left to free */
-	xfree(job_ptr->wckey);		/* in case duplicate record */
-	job_ptr->wckey        = wckey;
-	xstrtolower(job_ptr->wckey);
-	wckey                 = NULL;	/* reused, nothing left to free */
+	str_intern_free(job_ptr->user_name);
+	job_ptr->user_name    = str_intern_xfer(user_name);
+	str_intern_free(job_ptr->wckey);	/* in case duplicate record */
+	xstrtolower(wckey);
+	job_ptr->wckey        = str_intern_xfer(wckey);
 	xfree(job_ptr->network);
 	job_ptr->network      = network;
 	network               = NULL;  /* reused, nothing left to free */
@@ -2165,9 +2194,8 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	job_ptr->pack_job_id_set = pack_job_id_set;
 	pack_job_id_set       = NULL;	/* reused, nothing left to free */
 	job_ptr->pack_job_offset = pack_job_offset;
-	xfree(job_ptr->partition);
-	job_ptr->partition    = partition;
-	partition             = NULL;	/* reused, nothing left to free */
+	str_intern_free(job_ptr->partition);
+	job_ptr->partition    = str_intern_xfer(partition);
 	job_ptr->part_ptr = part_ptr;
 	job_ptr->part_ptr_list = part_ptr_list;
 	job_ptr->pre_sus_time = pre_sus_time;
@@ -2184,6 +2212,19 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 	resv_name             = NULL;	/* reused, nothing left to free */
 	job_ptr->select_jobinfo = select_jobinfo;
 	job_ptr->job_resrcs   = job_resources;
+	if (!node_bitmap_fingerprint) {
+		/* Saved for a different node table, rebuilt from names */
+		FREE_NULL_BITMAP(node_bitmap);
+		FREE_NULL_BITMAP(resrcs_node_bitmap);
+	}
+	FREE_NULL_BITMAP(job_ptr->node_bitmap);	/* in case duplicate record */
+	job_ptr->node_bitmap  = node_bitmap;
+	node_bitmap           = NULL;	/* reused, nothing left to free */
+	if (job_resources) {
+		job_resources->node_bitmap = resrcs_node_bitmap;
+		resrcs_node_bitmap = NULL;
+	}
+	FREE_NULL_BITMAP(resrcs_node_bitmap);
 	job_ptr->spank_job_env = spank_job_env;
 	job_ptr->spank_job_env_size = spank_job_env_size;
 	job_ptr->ckpt_interval = ckpt_interval;
@@ -2376,6 +2417,8 @@ unpack_error:
 	xfree(gres_used);
 	free_job_fed_details(&job_fed_details);
 	free_job_resources(&job_resources);
+	FREE_NULL_BITMAP(node_bitmap);
+	FREE_NULL_BITMAP(resrcs_node_bitmap);
 	xfree(resp_host);
 	xfree(licenses);
 	xfree(limit_set.tres);
@@ -2676,7 +2719,7 @@ static int _load_job_details(struct job_record *job_ptr, Buf buffer,
 	xfree(job_ptr->details->mem_bind);
 	xfree(job_ptr->details->std_out);
 	xfree(job_ptr->details->req_nodes);
-	xfree(job_ptr->details->work_dir);
+	str_intern_free(job_ptr->details->work_dir);
 	xfree(job_ptr->details->ckpt_dir);
 	xfree(job_ptr->details->restart_dir);
 
@@ -2732,7 +2775,7 @@ static int _load_job_details(struct job_record *job_ptr, Buf buffer,
 	job_ptr->details->submit_time = submit_time;
 	job_ptr->details->task_dist = task_dist;
 	job_ptr->details->whole_node = whole_node;
-	job_ptr->details->work_dir = work_dir;
+	job_ptr->details->work_dir = str_intern_xfer(work_dir);
 	job_ptr->details->ckpt_dir = ckpt_dir;
 	job_ptr->details->restart_dir = restart_dir;
 
@@ -3198,18 +3241,19 @@ static void _rebuild_part_name_list(struct job_record  *job_ptr)
 	bool job_active = false, job_pending = false;
 	struct part_record *part_ptr;
 	ListIterator part_iterator;
+	char *part_names = NULL;
 
-	xfree(job_ptr->partition);
+	str_intern_free(job_ptr->partition);
 
 	if (!job_ptr->part_ptr_list) {
-		job_ptr->partition = xstrdup(job_ptr->part_ptr->name);
+		job_ptr->partition = str_intern(job_ptr->part_ptr->name);
 		last_job_update = time(NULL);
 		return;
 	}
 
 	if (IS_JOB_RUNNING(job_ptr) || IS_JOB_SUSPENDED(job_ptr)) {
 		job_active = true;
-		job_ptr->partition = xstrdup(job_ptr->part_ptr->name);
+		part_names = xstrdup(job_ptr->part_ptr->name);
 	} else if (IS_JOB_PENDING(job_ptr))
 		job_pending = true;
 
@@ -3222,11 +3266,12 @@ static void _rebuild_part_name_list(struct job_record  *job_ptr)
 		}
 		if (job_active && (part_ptr == job_ptr->part_ptr))
 			continue;	/* already added */
-		if (job_ptr->partition)
-			xstrcat(job_ptr->partition, ",");
-		xstrcat(job_ptr->partition, part_ptr->name);
+		if (part_names)
+			xstrcat(part_names, ",");
+		xstrcat(part_names, part_ptr->name);
 	}
 	list_iterator_destroy(part_iterator);
+	job_ptr->partition = str_intern_xfer(part_names);
 	last_job_update = time(NULL);
 }
 
@@ -4267,6 +4312,23 @@ int init_job_conf(void)
 		purge_files_list = list_create(slurm_destroy_uint32_ptr);
 	}
 
+	/*
+	 * Job and step records are long lived and numerous. Allocate them
+	 * from slabs so that purging old records returns memory to the heap
+	 * rather than leaving it fragmented.
+	 */
+	if (!job_record_pool)
+		job_record_pool = mem_pool_create("job_record",
+						  sizeof(struct job_record), 0);
+	if (!job_details_pool)
+		job_details_pool = mem_pool_create("job_details",
+						   sizeof(struct job_details),
+						   0);
+	if (!step_record_pool)
+		step_record_pool = mem_pool_create("step_record",
+						   sizeof(struct step_record),
+						   0);
+
 	return SLURM_SUCCESS;
 }
 
@@ -4346,7 +4408,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	slurm_copy_priority_factors_object(job_ptr_pend->prio_factors,
 					   job_ptr->prio_factors);
 
-	job_ptr_pend->account = xstrdup(job_ptr->account);
+	job_ptr_pend->account = str_intern_ref(job_ptr->account);
 	job_ptr_pend->admin_comment = xstrdup(job_ptr->admin_comment);
 	job_ptr_pend->alias_list = xstrdup(job_ptr->alias_list);
 	job_ptr_pend->alloc_node = xstrdup(job_ptr->alloc_node);
@@ -4413,7 +4475,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	job_ptr_pend->node_bitmap_cg = NULL;
 	job_ptr_pend->nodes = NULL;
 	job_ptr_pend->nodes_completing = NULL;
-	job_ptr_pend->partition = xstrdup(job_ptr->partition);
+	job_ptr_pend->partition = str_intern_ref(job_ptr->partition);
 	job_ptr_pend->part_ptr_list = part_list_copy(job_ptr->part_ptr_list);
 	/* On jobs that are held the priority_array isn't set up yet,
 	 * so check to see if it exists before copying. */
@@ -4461,8 +4523,8 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	job_ptr_pend->tres_per_socket = xstrdup(job_ptr->tres_per_socket);
 	job_ptr_pend->tres_per_task = xstrdup(job_ptr->tres_per_task);
 
-	job_ptr_pend->user_name = xstrdup(job_ptr->user_name);
-	job_ptr_pend->wckey = xstrdup(job_ptr->wckey);
+	job_ptr_pend->user_name = str_intern_ref(job_ptr->user_name);
+	job_ptr_pend->wckey = str_intern_ref(job_ptr->wckey);
 	job_ptr_pend->deadline = job_ptr->deadline;
 
 	job_details = job_ptr->details;
@@ -4525,7 +4587,7 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	details_new->std_err = xstrdup(job_details->std_err);
 	details_new->std_in = xstrdup(job_details->std_in);
 	details_new->std_out = xstrdup(job_details->std_out);
-	details_new->work_dir = xstrdup(job_details->work_dir);
+	details_new->work_dir = str_intern_ref(job_details->work_dir);
 	details_new->x11_magic_cookie = xstrdup(job_details->x11_magic_cookie);
 
 	if (job_ptr->fed_details)
@@ -7874,7 +7936,7 @@ _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 		return SLURM_ERROR;
 
 	*job_rec_ptr = job_ptr;
-	job_ptr->partition = xstrdup(job_desc->partition);
+	job_ptr->partition = str_intern(job_desc->partition);
 	if (job_desc->profile != ACCT_GATHER_PROFILE_NOT_SET)
 		job_ptr->profile = job_desc->profile;
 
@@ -7887,7 +7949,7 @@ _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 	}
 
 	job_ptr->name = xstrdup(job_desc->name);
-	job_ptr->wckey = xstrdup(job_desc->wckey);
+	job_ptr->wckey = str_intern(job_desc->wckey);
 
 	/* Since this is only used in the slurmctld, copy it now. */
 	job_ptr->tres_req_cnt = job_desc->tres_req_cnt;
@@ -7908,7 +7970,7 @@ _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 		job_ptr->time_min = job_desc->time_min;
 	job_ptr->alloc_sid  = job_desc->alloc_sid;
 	job_ptr->alloc_node = xstrdup(job_desc->alloc_node);
-	job_ptr->account    = xstrdup(job_desc->account);
+	job_ptr->account    = str_intern(job_desc->account);
 	job_ptr->batch_features = xstrdup(job_desc->batch_features);
 	job_ptr->burst_buffer = xstrdup(job_desc->burst_buffer);
 	job_ptr->network    = xstrdup(job_desc->network);
@@ -8070,7 +8132,7 @@ _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 	detail_ptr->std_err = xstrdup(job_desc->std_err);
 	detail_ptr->std_in = xstrdup(job_desc->std_in);
 	detail_ptr->std_out = xstrdup(job_desc->std_out);
-	detail_ptr->work_dir = xstrdup(job_desc->work_dir);
+	detail_ptr->work_dir = str_intern(job_desc->work_dir);
 	if (job_desc->begin_time > time(NULL))
 		detail_ptr->begin_time = job_desc->begin_time;
 	job_ptr->select_jobinfo =
@@ -9208,7 +9270,7 @@ static void _list_delete_job(void *job_entry)
 	}
 
 	_delete_job_details(job_ptr);
-	xfree(job_ptr->account);
+	str_intern_free(job_ptr->account);
 	xfree(job_ptr->admin_comment);
 	xfree(job_ptr->alias_list);
 	xfree(job_ptr->alloc_node);
@@ -9254,7 +9316,7 @@ static void _list_delete_job(void *job_entry)
 	}
 	xfree(job_ptr->pack_job_id_set);
 	FREE_NULL_LIST(job_ptr->pack_job_list);
-	xfree(job_ptr->partition);
+	str_intern_free(job_ptr->partition);
 	FREE_NULL_LIST(job_ptr->part_ptr_list);
 	xfree(job_ptr->priority_array);
 	slurm_destroy_priority_factors_object(job_ptr->prio_factors);
@@ -9280,8 +9342,8 @@ static void _list_delete_job(void *job_entry)
 	xfree(job_ptr->tres_fmt_req_str);
 	step_list_purge(job_ptr);
 	select_g_select_jobinfo_free(job_ptr->select_jobinfo);
-	xfree(job_ptr->user_name);
-	xfree(job_ptr->wckey);
+	str_intern_free(job_ptr->user_name);
+	str_intern_free(job_ptr->wckey);
 	if (job_array_size > job_count) {
 		error("job_count underflow");
 		job_count = 0;
@@ -9289,7 +9351,7 @@ static void _list_delete_job(void *job_entry)
 		job_count -= job_array_size;
 	}
 	job_ptr->job_id = 0;
-	xfree(job_ptr);
+	mem_pool_free(job_ptr);
 }
 
 
@@ -10791,7 +10853,8 @@ extern int purge_job_record(uint32_t job_id)
 /*
  * reset_job_bitmaps - reestablish bitmaps for existing jobs.
  *	this should be called after rebuilding node information,
- *	but before using any job entries.
+ *	but before using any job entries. Node bitmaps are only rebuilt from
+ *	the node names if the node table has changed since they were built.
  * global: last_job_update - time of last job table update
  *	job_list - pointer to global job list
  */
@@ -10805,6 +10868,8 @@ void reset_job_bitmaps(void)
 	time_t now = time(NULL);
 	bool gang_flag = false;
 	static uint32_t cr_flag = NO_VAL;
+	uint64_t fingerprint = node_conf_fingerprint();
+	bool keep_bitmaps = (node_bitmap_fingerprint == fingerprint);
 
 	xassert(job_list);
 
@@ -10863,15 +10928,20 @@ void reset_job_bitmaps(void)
 			      job_ptr->nodes_completing, job_ptr);
 			job_fail = true;
 		}
-		FREE_NULL_BITMAP(job_ptr->node_bitmap);
-		if (job_ptr->nodes &&
-		    node_name2bitmap(job_ptr->nodes, false,
-				     &job_ptr->node_bitmap) && !job_fail) {
-			error("Invalid nodes (%s) for %pJ",
-			      job_ptr->nodes, job_ptr);
-			job_fail = true;
+		if (!keep_bitmaps || !job_ptr->nodes || !job_ptr->node_bitmap) {
+			FREE_NULL_BITMAP(job_ptr->node_bitmap);
+			if (job_ptr->nodes &&
+			    node_name2bitmap(job_ptr->nodes, false,
+					     &job_ptr->node_bitmap) &&
+			    !job_fail) {
+				error("Invalid nodes (%s) for %pJ",
+				      job_ptr->nodes, job_ptr);
+				job_fail = true;
+			}
 		}
-		if (reset_node_bitmap(job_ptr))
+		if ((!keep_bitmaps || !job_ptr->job_resrcs ||
+		     !job_ptr->job_resrcs->node_bitmap) &&
+		    reset_node_bitmap(job_ptr))
 			job_fail = true;
 		if (!job_fail && !IS_JOB_FINISHED(job_ptr) &&
 		    job_ptr->job_resrcs && (cr_flag || gang_flag) &&
@@ -10904,7 +10974,7 @@ void reset_job_bitmaps(void)
 			job_fail = true;
 		}
 
-		_reset_step_bitmaps(job_ptr);
+		_reset_step_bitmaps(job_ptr, keep_bitmaps);
 
 		/* Do not increase the job->node_cnt for completed jobs */
 		if (! IS_JOB_COMPLETED(job_ptr))
@@ -10954,6 +11024,7 @@ void reset_job_bitmaps(void)
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	node_bitmap_fingerprint = fingerprint;
 
 	last_job_update = now;
 }
@@ -10985,7 +11056,17 @@ static int _reset_detail_bitmaps(struct job_record *job_ptr)
 	return SLURM_SUCCESS;
 }
 
-static void _reset_step_bitmaps(struct job_record *job_ptr)
+/* Drop a step's node bitmap saved for a different node table */
+static int _clear_step_node_bitmap(void *x, void *arg)
+{
+	struct step_record *step_ptr = (struct step_record *) x;
+
+	FREE_NULL_BITMAP(step_ptr->step_node_bitmap);
+	return 0;
+}
+
+static void _reset_step_bitmaps(struct job_record *job_ptr,
+				bool keep_bitmaps)
 {
 	ListIterator step_iterator;
 	struct step_record *step_ptr;
@@ -10994,6 +11075,9 @@ static void _reset_step_bitmaps(struct job_record *job_ptr)
 	while ((step_ptr = (struct step_record *) list_next (step_iterator))) {
 		if (step_ptr->state < JOB_RUNNING)
 			continue;
+		if (keep_bitmaps && step_ptr->step_node_bitmap &&
+		    step_ptr->step_layout && step_ptr->step_layout->node_list)
+			continue;	/* still valid */
 		FREE_NULL_BITMAP(step_ptr->step_node_bitmap);
 		if (step_ptr->step_layout &&
 		    step_ptr->step_layout->node_list &&
@@ -12233,8 +12317,8 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 
 	if (new_assoc_ptr) {
 		/* Change account/association */
-		xfree(job_ptr->account);
-		job_ptr->account = xstrdup(new_assoc_ptr->acct);
+		str_intern_free(job_ptr->account);
+		job_ptr->account = str_intern(new_assoc_ptr->acct);
 		job_ptr->assoc_id = new_assoc_ptr->id;
 		job_ptr->assoc_ptr = new_assoc_ptr;
 
@@ -15002,6 +15086,12 @@ void job_fini (void)
 	FREE_NULL_LIST(purge_files_list);
 	FREE_NULL_BITMAP(requeue_exit);
 	FREE_NULL_BITMAP(requeue_exit_hold);
+	mem_pool_destroy(job_record_pool);
+	job_record_pool = NULL;
+	mem_pool_destroy(job_details_pool);
+	job_details_pool = NULL;
+	mem_pool_destroy(step_record_pool);
+	step_record_pool = NULL;
 }
 
 /* Record the start of one job array task */
@@ -16978,9 +17068,9 @@ extern int update_job_wckey(char *module, struct job_record *job_ptr,
 		}
 	}
 
-	xfree(job_ptr->wckey);
+	str_intern_free(job_ptr->wckey);
 	if (wckey_rec.name && wckey_rec.name[0] != '\0') {
-		job_ptr->wckey = xstrdup(wckey_rec.name);
+		job_ptr->wckey = str_intern(wckey_rec.name);
 		info("%s: setting wckey to %s for %pJ",
 		     module, wckey_rec.name, job_ptr);
 	} else {
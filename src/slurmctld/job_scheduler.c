@@ -88,6 +88,7 @@
 #include "src/slurmctld/preempt.h"
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/reservation.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/srun_comm.h"
 #include "src/slurmctld/state_save.h"
@@ -115,7 +116,7 @@ static char **	_build_env(struct job_record *job_ptr, bool is_epilog);
 static batch_job_launch_msg_t *_build_launch_job_msg(struct job_record *job_ptr,
 						     uint16_t protocol_version);
 static void	_depend_list_del(void *dep_ptr);
-static void	_job_queue_append(List job_queue, struct job_record *job_ptr,
+static void	_job_queue_append(AList job_queue, struct job_record *job_ptr,
 				  struct part_record *part_ptr, uint32_t priority);
 static void	_job_queue_rec_del(void *x);
 static bool	_job_runnable_test1(struct job_record *job_ptr,
@@ -231,7 +232,7 @@ static List _build_user_job_list(uint32_t user_id, char* job_name)
 	return job_queue;
 }
 
-static void _job_queue_append(List job_queue, struct job_record *job_ptr,
+static void _job_queue_append(AList job_queue, struct job_record *job_ptr,
 			      struct part_record *part_ptr, uint32_t prio)
 {
 	job_queue_rec_t *job_queue_rec;
@@ -242,7 +243,7 @@ static void _job_queue_append(List job_queue, struct job_record *job_ptr,
 	job_queue_rec->job_ptr  = job_ptr;
 	job_queue_rec->part_ptr = part_ptr;
 	job_queue_rec->priority = prio;
-	list_append(job_queue, job_queue_rec);
+	alist_append(job_queue, job_queue_rec);
 }
 
 static void _job_queue_rec_del(void *x)
@@ -397,12 +398,12 @@ static bool _job_runnable_test3(struct job_record *job_ptr,
  *		    true when called from sched/backfill or sched/builtin
  * IN backfill - true if running backfill scheduler, enforce min time limit
  * RET the job queue
- * NOTE: the caller must call FREE_NULL_LIST() on RET value to free memory
+ * NOTE: the caller must call FREE_NULL_ALIST() on RET value to free memory
  */
-extern List build_job_queue(bool clear_start, bool backfill)
+extern AList build_job_queue(bool clear_start, bool backfill)
 {
 	static time_t last_log_time = 0;
-	List job_queue;
+	AList job_queue;
 	ListIterator depend_iter, job_iterator, part_iterator;
 	struct job_record *job_ptr = NULL, *new_job_ptr;
 	struct part_record *part_ptr;
@@ -415,7 +416,7 @@ extern List build_job_queue(bool clear_start, bool backfill)
 
 	/* init the timer */
 	(void) slurm_delta_tv(&start_tv);
-	job_queue = list_create(_job_queue_rec_del);
+	job_queue = alist_create(_job_queue_rec_del);
 
 	/* Create individual job records for job arrays that need burst buffer
 	 * staging */
@@ -908,7 +909,7 @@ extern bool deadline_ok(struct job_record *job_ptr, char *func)
 static int _schedule(uint32_t job_limit)
 {
 	ListIterator job_iterator = NULL, part_iterator = NULL;
-	List job_queue = NULL;
+	AList job_queue = NULL;
 	int failed_part_cnt = 0, failed_resv_cnt = 0, job_cnt = 0;
 	int error_code, i, j, part_cnt, time_limit, pend_time;
 	uint32_t job_depth = 0, array_task_id;
@@ -942,6 +943,7 @@ static int _schedule(uint32_t job_limit)
 	bool fail_by_part;
 	uint32_t deadline_time_limit, save_time_limit = 0;
 	uint32_t prio_reserve;
+	uint64_t trace_start;
 #if HAVE_SYS_PRCTL_H
 	char get_name[16];
 #endif
@@ -1273,7 +1275,7 @@ static int _schedule(uint32_t job_limit)
 		job_iterator = list_iterator_create(job_list);
 	} else {
 		job_queue = build_job_queue(false, false);
-		slurmctld_diag_stats.schedule_queue_len = list_count(job_queue);
+		slurmctld_diag_stats.schedule_queue_len = alist_count(job_queue);
 		sort_job_queue(job_queue);
 	}
 	while (1) {
@@ -1321,7 +1323,7 @@ next_part:			part_ptr = (struct part_record *)
 					continue;
 			}
 		} else {
-			job_queue_rec = list_pop(job_queue);
+			job_queue_rec = alist_pop(job_queue);
 			if (!job_queue_rec)
 				break;
 			array_task_id = job_queue_rec->array_task_id;
@@ -1613,8 +1615,15 @@ next_task:
 			goto skip_start;
 		}
 
+		trace_start = sched_trace_start();
 		error_code = select_nodes(job_ptr, false, NULL, NULL, false,
 					  SLURMDB_JOB_FLAG_SCHED);
+		if (error_code == SLURM_SUCCESS)
+			sched_trace(SCHED_TRACE_PLACE, job_ptr->job_id,
+				    trace_start, job_ptr->node_cnt);
+		else
+			sched_trace(SCHED_TRACE_JOB_TEST, job_ptr->job_id,
+				    trace_start, error_code);
 
 		if (error_code == SLURM_SUCCESS) {
 			/*
@@ -1825,7 +1834,7 @@ fail_this_part:	if (fail_by_part) {
 		if (part_iterator)
 			list_iterator_destroy(part_iterator);
 	} else if (job_queue) {
-		FREE_NULL_LIST(job_queue);
+		FREE_NULL_ALIST(job_queue);
 	}
 	xfree(sched_part_ptr);
 	xfree(sched_part_jobs);
@@ -1853,9 +1862,9 @@ out:
  * sort_job_queue - sort job_queue in descending priority order
  * IN/OUT job_queue - sorted job queue
  */
-extern void sort_job_queue(List job_queue)
+extern void sort_job_queue(AList job_queue)
 {
-	list_sort(job_queue, sort_job_queue2);
+	alist_sort(job_queue, sort_job_queue2);
 }
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
@@ -2045,8 +2054,11 @@ static batch_job_launch_msg_t *_build_launch_job_msg(struct job_record *job_ptr,
 
 	if (slurmctld_config.send_groups_in_cred) {
 		/* fill in the job_record field if not yet filled in */
-		if (!job_ptr->user_name)
-			job_ptr->user_name = uid_to_string_or_null(job_ptr->user_id);
+		if (!job_ptr->user_name) {
+			char *user_name = uid_to_string_or_null(
+				job_ptr->user_id);
+			job_ptr->user_name = str_intern_xfer(user_name);
+		}
 		/* this may still be null, in which case the client will handle */
 		launch_msg_ptr->user_name = xstrdup(job_ptr->user_name);
 		/* lookup and send extended gids list */
@@ -4734,6 +4746,7 @@ extern void rebuild_job_part_list(struct job_record *job_ptr)
 {
 	ListIterator part_iterator;
 	struct part_record *part_ptr;
+	char *part_names;
 
 	if (!job_ptr->part_ptr_list)
 		return;
@@ -4743,17 +4756,19 @@ extern void rebuild_job_part_list(struct job_record *job_ptr)
 		return;
 	}
 
-	xfree(job_ptr->partition);
-	job_ptr->partition = xstrdup(job_ptr->part_ptr->name);
+	part_names = xstrdup(job_ptr->part_ptr->name);
 
 	part_iterator = list_iterator_create(job_ptr->part_ptr_list);
 	while ((part_ptr = (struct part_record *) list_next(part_iterator))) {
 		if (part_ptr == job_ptr->part_ptr)
 			continue;
-		xstrcat(job_ptr->partition, ",");
-		xstrcat(job_ptr->partition, part_ptr->name);
+		xstrcat(part_names, ",");
+		xstrcat(part_names, part_ptr->name);
 	}
 	list_iterator_destroy(part_iterator);
+
+	str_intern_free(job_ptr->partition);
+	job_ptr->partition = str_intern_xfer(part_names);
 }
 
 /* cleanup_completing()
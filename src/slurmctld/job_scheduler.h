@@ -42,6 +42,7 @@
 #ifndef _JOB_SCHEDULER_H
 #define _JOB_SCHEDULER_H
 
+#include "src/common/alist.h"
 #include "src/slurmctld/slurmctld.h"
 
 typedef struct job_queue_rec {
@@ -66,9 +67,9 @@ extern int build_feature_list(struct job_record *job_ptr);
  * IN clear_start - if set then clear the start_time for pending jobs
  * IN backfill - true if running backfill scheduler, enforce min time limit
  * RET the job queue
- * NOTE: the caller must call list_destroy() on RET value to free memory
+ * NOTE: the caller must call alist_destroy() on RET value to free memory
  */
-extern List build_job_queue(bool clear_start, bool backfill);
+extern AList build_job_queue(bool clear_start, bool backfill);
 
 /* Given a scheduled job, return a pointer to it batch_job_launch_msg_t data */
 extern batch_job_launch_msg_t *build_launch_job_msg(
@@ -199,7 +200,7 @@ extern void set_job_elig_time(void);
  * sort_job_queue - sort job_queue in decending priority order
  * IN/OUT job_queue - sorted job queue previously made by build_job_queue()
  */
-extern void sort_job_queue(List job_queue);
+extern void sort_job_queue(AList job_queue);
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
  *	in order of decreasing priority */
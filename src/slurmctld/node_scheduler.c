@@ -82,6 +82,7 @@
 #include "src/slurmctld/preempt.h"
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/reservation.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/slurmctld_plugstack.h"
 
@@ -2427,6 +2428,8 @@ static void _preempt_jobs(List preemptee_job_list, bool kill_pending,
 			      __func__, mode, job_ptr);
 			continue;
 		}
+		sched_trace(SCHED_TRACE_PREEMPT, job_ptr->job_id, 0,
+			    preemptor_ptr->job_id);
 
 		if (rc != SLURM_SUCCESS) {
 			if ((mode != PREEMPT_MODE_CANCEL)
@@ -3209,8 +3212,10 @@ extern void launch_prolog(struct job_record *job_ptr)
 	prolog_msg_ptr->pack_job_id = job_ptr->pack_job_id;
 	prolog_msg_ptr->uid = job_ptr->user_id;
 	prolog_msg_ptr->gid = job_ptr->group_id;
-	if (!job_ptr->user_name)
-		job_ptr->user_name = uid_to_string_or_null(job_ptr->user_id);
+	if (!job_ptr->user_name) {
+		char *user_name = uid_to_string_or_null(job_ptr->user_id);
+		job_ptr->user_name = str_intern_xfer(user_name);
+	}
 	prolog_msg_ptr->user_name = xstrdup(job_ptr->user_name);
 	prolog_msg_ptr->alias_list = xstrdup(job_ptr->alias_list);
 	prolog_msg_ptr->nodes = xstrdup(job_ptr->nodes);
@@ -3240,8 +3245,11 @@ extern void launch_prolog(struct job_record *job_ptr)
 	cred_arg.gid                 = job_ptr->group_id;
 	if (slurmctld_config.send_groups_in_cred) {
 		/* fill in the job_record field if not yet filled in */
-		if (!job_ptr->user_name)
-			job_ptr->user_name = uid_to_string_or_null(job_ptr->user_id);
+		if (!job_ptr->user_name) {
+			char *user_name = uid_to_string_or_null(
+				job_ptr->user_id);
+			job_ptr->user_name = str_intern_xfer(user_name);
+		}
 		/* this may still be null, in which case the client will handle */
 		cred_arg.user_name = job_ptr->user_name; /* avoid extra copy */
 		/* lookup and send extended gids list */
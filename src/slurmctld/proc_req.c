@@ -99,6 +99,7 @@
 #include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/sched_plugin.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/slurmctld_plugstack.h"
 #include "src/slurmctld/srun_comm.h"
@@ -141,6 +142,7 @@ inline static void  _slurm_rpc_checkpoint(slurm_msg_t * msg);
 inline static void  _slurm_rpc_checkpoint_comp(slurm_msg_t * msg);
 inline static void  _slurm_rpc_checkpoint_task_comp(slurm_msg_t * msg);
 inline static void  _slurm_rpc_control_status(slurm_msg_t * msg);
+inline static void  _slurm_rpc_sched_trace(slurm_msg_t * msg);
 inline static void  _slurm_rpc_delete_partition(slurm_msg_t * msg);
 inline static void  _slurm_rpc_complete_job_allocation(slurm_msg_t * msg);
 inline static void  _slurm_rpc_complete_batch_script(slurm_msg_t * msg,
@@ -590,6 +592,9 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	case REQUEST_CONTROL_STATUS:
 		_slurm_rpc_control_status(msg);
 		break;
+	case REQUEST_SCHED_TRACE:
+		_slurm_rpc_sched_trace(msg);
+		break;
 	case REQUEST_BURST_BUFFER_STATUS:
 		_slurm_rpc_burst_buffer_status(msg);
 		break;
@@ -1082,8 +1087,11 @@ static int _make_step_cred(struct step_record *step_ptr,
 	cred_arg.gid      = job_ptr->group_id;
 	if (slurmctld_config.send_groups_in_cred) {
 		/* fill in the job_record field if not yet filled in */
-		if (!job_ptr->user_name)
-			job_ptr->user_name = uid_to_string_or_null(job_ptr->user_id);
+		if (!job_ptr->user_name) {
+			char *user_name = uid_to_string_or_null(
+				job_ptr->user_id);
+			job_ptr->user_name = str_intern_xfer(user_name);
+		}
 		/* this may still be null, in which case the client will handle */
 		cred_arg.user_name = job_ptr->user_name; /* avoid extra copy */
 		/* lookup and send extended gids list */
@@ -3444,8 +3452,11 @@ static void _slurm_rpc_job_sbcast_cred(slurm_msg_t * msg)
 	sbcast_arg.gid = job_ptr->group_id;
 	if (slurmctld_config.send_groups_in_cred) {
 		/* fill in the job_record field if not yet filled in */
-		if (!job_ptr->user_name)
-			job_ptr->user_name = uid_to_string_or_null(job_ptr->user_id);
+		if (!job_ptr->user_name) {
+			char *user_name = uid_to_string_or_null(
+				job_ptr->user_id);
+			job_ptr->user_name = str_intern_xfer(user_name);
+		}
 		/* this may still be null, in which case the client will handle */
 		sbcast_arg.user_name = job_ptr->user_name; /* avoid extra copy */
 		/* lookup and send extended gids list */
@@ -6167,6 +6178,29 @@ inline static void _slurm_rpc_control_status(slurm_msg_t * msg)
 	slurm_send_node_msg(msg->conn_fd, &response_msg);
 }
 
+/* _slurm_rpc_sched_trace - process RPC for the scheduling event trace */
+inline static void _slurm_rpc_sched_trace(slurm_msg_t * msg)
+{
+	slurm_msg_t response_msg;
+	sched_trace_msg_t *trace;
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
+
+	debug2("Processing RPC: REQUEST_SCHED_TRACE from uid=%d", uid);
+	if (!validate_operator(uid)) {
+		error("Security violation, REQUEST_SCHED_TRACE RPC from uid=%d",
+		      uid);
+		slurm_send_rc_msg(msg, ESLURM_ACCESS_DENIED);
+		return;
+	}
+
+	trace = sched_trace_dump();
+	response_init(&response_msg, msg);
+	response_msg.msg_type = RESPONSE_SCHED_TRACE;
+	response_msg.data = trace;
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	slurm_free_sched_trace_msg(trace);
+}
+
 /* _slurm_rpc_dump_stats - process RPC for statistics information */
 inline static void _slurm_rpc_dump_stats(slurm_msg_t * msg)
 {
@@ -6197,11 +6231,15 @@ inline static void _slurm_rpc_dump_stats(slurm_msg_t * msg)
 		_clear_rpc_stats();
 		pack_all_stat(0, &dump, &dump_size, msg->protocol_version);
 		_pack_rpc_stats(0, &dump, &dump_size, msg->protocol_version);
+		pack_all_pool_stat(&dump, &dump_size, msg->protocol_version);
+		pack_all_log_stat(&dump, &dump_size, msg->protocol_version);
 		response_msg.data = dump;
 		response_msg.data_size = dump_size;
 	} else {
 		pack_all_stat(1, &dump, &dump_size, msg->protocol_version);
 		_pack_rpc_stats(1, &dump, &dump_size, msg->protocol_version);
+		pack_all_pool_stat(&dump, &dump_size, msg->protocol_version);
+		pack_all_log_stat(&dump, &dump_size, msg->protocol_version);
 		response_msg.data = dump;
 		response_msg.data_size = dump_size;
 	}
@@ -88,6 +88,7 @@
 #include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/sched_plugin.h"
+#include "src/slurmctld/sched_trace.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/srun_comm.h"
 #include "src/slurmctld/trigger_mgr.h"
@@ -196,35 +197,36 @@ static void _stat_slurm_dirs(void)
 	}
 }
 
+static int _node_name_cmp(const void *x, const void *y)
+{
+	const struct node_record *node_ptr1 = x, *node_ptr2 = y;
+
+	return strnatcmp(node_ptr1->name, node_ptr2->name);
+}
+
+static int _node_rank_cmp(const void *x, const void *y)
+{
+	const struct node_record *node_ptr1 = x, *node_ptr2 = y;
+
+	if (node_ptr1->node_rank < node_ptr2->node_rank)
+		return -1;
+	if (node_ptr1->node_rank > node_ptr2->node_rank)
+		return 1;
+	return strnatcmp(node_ptr1->name, node_ptr2->name);
+}
+
 /*
  * _reorder_nodes_by_name - order node table in ascending order of name
  */
 static void _reorder_nodes_by_name(void)
 {
-	struct node_record *node_ptr, *node_ptr2;
-	int i, j, min_inx;
-
-	/* Now we need to sort the node records */
-	for (i = 0; i < node_record_count; i++) {
-		min_inx = i;
-		for (j = i + 1; j < node_record_count; j++) {
-			if (strnatcmp(node_record_table_ptr[j].name,
-				      node_record_table_ptr[min_inx].name) < 0)
-				min_inx = j;
-		}
-
-		if (min_inx != i) {	/* swap records */
-			struct node_record node_record_tmp;
-
-			j = sizeof(struct node_record);
-			node_ptr  = node_record_table_ptr + i;
-			node_ptr2 = node_record_table_ptr + min_inx;
+#if _DEBUG
+	struct node_record *node_ptr;
+	int i;
+#endif
 
-			memcpy(&node_record_tmp, node_ptr, j);
-			memcpy(node_ptr, node_ptr2, j);
-			memcpy(node_ptr2, &node_record_tmp, j);
-		}
-	}
+	qsort(node_record_table_ptr, node_record_count,
+	      sizeof(struct node_record), _node_name_cmp);
 
 #if _DEBUG
 	/* Log the results */
@@ -242,33 +244,13 @@ static void _reorder_nodes_by_name(void)
  */
 static void _reorder_nodes_by_rank(void)
 {
-	struct node_record *node_ptr, *node_ptr2;
-	int i, j, min_inx;
-	uint32_t min_val;
-
-	/* Now we need to sort the node records */
-	for (i = 0; i < node_record_count; i++) {
-		min_val = node_record_table_ptr[i].node_rank;
-		min_inx = i;
-		for (j = i + 1; j < node_record_count; j++) {
-			if (node_record_table_ptr[j].node_rank < min_val) {
-				min_val = node_record_table_ptr[j].node_rank;
-				min_inx = j;
-			}
-		}
-
-		if (min_inx != i) {	/* swap records */
-			struct node_record node_record_tmp;
-
-			j = sizeof(struct node_record);
-			node_ptr  = node_record_table_ptr + i;
-			node_ptr2 = node_record_table_ptr + min_inx;
+#if _DEBUG
+	struct node_record *node_ptr;
+	int i;
+#endif
 
-			memcpy(&node_record_tmp, node_ptr, j);
-			memcpy(node_ptr, node_ptr2, j);
-			memcpy(node_ptr2, &node_record_tmp, j);
-		}
-	}
+	qsort(node_record_table_ptr, node_record_count,
+	      sizeof(struct node_record), _node_rank_cmp);
 
 #if _DEBUG
 	/* Log the results */
@@ -1181,6 +1163,7 @@ int read_slurm_conf(int recover, bool reconfig)
 			dump_config_state_lite();
 	}
 	update_logging();
+	sched_trace_reconfig();
 	g_slurm_jobcomp_init(slurmctld_conf.job_comp_loc);
 	if (slurm_sched_init() != SLURM_SUCCESS) {
 		if (test_config) {
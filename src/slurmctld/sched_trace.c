@@ -0,0 +1,235 @@
+/*****************************************************************************\
+ *  sched_trace.c - binary trace of slurmctld scheduling events
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#include "config.h"
+
+#if HAVE_SYS_PRCTL_H
+#  include <sys/prctl.h>
+#endif
+
+#include <pthread.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "src/common/macros.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/slurmctld/sched_trace.h"
+#include "src/slurmctld/slurmctld.h"
+
+#define TRACE_RING_SIZE	2048	/* records per thread */
+#define TRACE_RING_MAX	128	/* further threads are not traced */
+#define TRACE_NAME_LEN	16
+
+typedef struct {
+	pthread_mutex_t mutex;	/* only contended while dumping */
+	uint16_t inx;		/* index in rings, used as thread id */
+	bool in_use;		/* owned by a live thread */
+	char name[TRACE_NAME_LEN];
+	uint32_t next;		/* count of records ever written */
+	sched_trace_rec_t recs[TRACE_RING_SIZE];
+} trace_ring_t;
+
+bool sched_trace_enabled = false;
+
+static pthread_mutex_t rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ring_key;
+static bool ring_key_created = false;
+static trace_ring_t *rings[TRACE_RING_MAX];
+static uint16_t ring_cnt = 0;
+static __thread trace_ring_t *my_ring = NULL;
+static __thread bool my_ring_failed = false;
+
+static uint64_t _now_usec(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return ((uint64_t) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+/* Thread exit, let another thread of the same name have this ring */
+static void _ring_release(void *arg)
+{
+	trace_ring_t *ring = arg;
+
+	slurm_mutex_lock(&rings_mutex);
+	ring->in_use = false;
+	slurm_mutex_unlock(&rings_mutex);
+}
+
+static void _ring_key_create(void)
+{
+	if (!pthread_key_create(&ring_key, _ring_release))
+		ring_key_created = true;
+}
+
+/*
+ * Find a ring for the calling thread. Service threads come and go for
+ * each RPC, so a ring released by an exited thread of the same name is
+ * reused, and its older records remain attributed to the right name.
+ */
+static trace_ring_t *_ring_acquire(void)
+{
+	char name[TRACE_NAME_LEN] = "";
+	trace_ring_t *ring = NULL;
+	int i;
+
+#if HAVE_SYS_PRCTL_H
+	(void) prctl(PR_GET_NAME, name, NULL, NULL, NULL);
+	name[TRACE_NAME_LEN - 1] = '\0';
+#endif
+	pthread_once(&ring_key_once, _ring_key_create);
+
+	slurm_mutex_lock(&rings_mutex);
+	for (i = 0; i < ring_cnt; i++) {
+		if (!rings[i]->in_use && !xstrcmp(rings[i]->name, name)) {
+			ring = rings[i];
+			break;
+		}
+	}
+	if (!ring && (ring_cnt < TRACE_RING_MAX)) {
+		ring = xmalloc(sizeof(trace_ring_t));
+		slurm_mutex_init(&ring->mutex);
+		ring->inx = ring_cnt;
+		strlcpy(ring->name, name, sizeof(ring->name));
+		rings[ring_cnt++] = ring;
+	}
+	if (ring)
+		ring->in_use = true;
+	slurm_mutex_unlock(&rings_mutex);
+
+	if (ring)
+		pthread_setspecific(ring_key, ring);
+	else
+		my_ring_failed = true;
+	return ring;
+}
+
+extern void sched_trace_reconfig(void)
+{
+	sched_trace_enabled = (xstrcasestr(slurmctld_conf.slurmctld_params,
+					   "sched_trace") != NULL);
+}
+
+extern void sched_trace_fini(void)
+{
+	int i;
+
+	sched_trace_enabled = false;
+	slurm_mutex_lock(&rings_mutex);
+	/*
+	 * Threads still running keep their ring in thread local storage, but
+	 * with tracing disabled they no longer touch it. Deleting the key
+	 * stops _ring_release() from running for them after it is freed.
+	 */
+	if (ring_key_created) {
+		(void) pthread_key_delete(ring_key);
+		ring_key_created = false;
+	}
+	for (i = 0; i < ring_cnt; i++) {
+		slurm_mutex_destroy(&rings[i]->mutex);
+		xfree(rings[i]);
+	}
+	ring_cnt = 0;
+	slurm_mutex_unlock(&rings_mutex);
+}
+
+extern uint64_t sched_trace_start(void)
+{
+	if (!sched_trace_enabled)
+		return 0;
+	return _now_usec();
+}
+
+extern void sched_trace(uint16_t type, uint32_t job_id, uint64_t start,
+			uint32_t arg)
+{
+	sched_trace_rec_t *rec;
+	uint64_t now;
+
+	if (!sched_trace_enabled)
+		return;
+	if (!my_ring) {
+		if (my_ring_failed || !(my_ring = _ring_acquire()))
+			return;
+	}
+
+	now = _now_usec();
+	slurm_mutex_lock(&my_ring->mutex);
+	rec = &my_ring->recs[my_ring->next++ % TRACE_RING_SIZE];
+	if (start && (start <= now)) {
+		rec->start = start;
+		rec->duration = MIN(now - start, UINT32_MAX);
+	} else {
+		rec->start = now;
+		rec->duration = 0;
+	}
+	rec->job_id = job_id;
+	rec->arg = arg;
+	rec->type = type;
+	rec->thread = my_ring->inx;
+	slurm_mutex_unlock(&my_ring->mutex);
+}
+
+extern sched_trace_msg_t *sched_trace_dump(void)
+{
+	sched_trace_msg_t *msg = xmalloc(sizeof(sched_trace_msg_t));
+	trace_ring_t *ring;
+	uint32_t cnt, first, i, j;
+
+	slurm_mutex_lock(&rings_mutex);
+	msg->thread_cnt = ring_cnt;
+	msg->thread_name = xmalloc(sizeof(char *) * (ring_cnt + 1));
+	msg->recs = xmalloc(sizeof(sched_trace_rec_t) * TRACE_RING_SIZE *
+			    (ring_cnt + 1));
+	for (i = 0; i < ring_cnt; i++) {
+		ring = rings[i];
+		msg->thread_name[i] = xstrdup(ring->name);
+		slurm_mutex_lock(&ring->mutex);
+		cnt = MIN(ring->next, TRACE_RING_SIZE);
+		first = ring->next - cnt;
+		for (j = 0; j < cnt; j++) {
+			msg->recs[msg->rec_cnt++] =
+				ring->recs[(first + j) % TRACE_RING_SIZE];
+		}
+		slurm_mutex_unlock(&ring->mutex);
+	}
+	slurm_mutex_unlock(&rings_mutex);
+
+	return msg;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************\
+ *  sched_trace.h - binary trace of slurmctld scheduling events
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#ifndef _SLURM_SCHED_TRACE_H
+#define _SLURM_SCHED_TRACE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "src/common/slurm_protocol_defs.h"
+
+/*
+ * Scheduling events are recorded as fixed size records in a ring buffer
+ * per thread, so the oldest records of one thread are overwritten without
+ * affecting the others. Enabled with SlurmctldParameters=sched_trace and
+ * retrieved with "sdiag --sched-trace".
+ */
+
+extern bool sched_trace_enabled;
+
+/* Enable or disable tracing based upon SlurmctldParameters */
+extern void sched_trace_reconfig(void);
+
+/* Free all trace buffers at shutdown, tracing must not be enabled again */
+extern void sched_trace_fini(void);
+
+/*
+ * Return the current time in microseconds to pass as the start of an event
+ * to sched_trace(), or zero if tracing is disabled.
+ */
+extern uint64_t sched_trace_start(void);
+
+/*
+ * Record an event in the calling thread's ring buffer
+ * type IN - SCHED_TRACE_*
+ * job_id IN - job the event applies to, zero if none
+ * start IN - value returned by sched_trace_start() when the event began,
+ *	zero to record an instant event
+ * arg IN - event specific value, see SCHED_TRACE_* definitions
+ */
+extern void sched_trace(uint16_t type, uint32_t job_id, uint64_t start,
+			uint32_t arg);
+
+/* Copy the contents of all ring buffers, free with
+ * slurm_free_sched_trace_msg() */
+extern sched_trace_msg_t *sched_trace_dump(void);
+
+#endif /* !_SLURM_SCHED_TRACE_H */
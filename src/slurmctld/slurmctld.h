@@ -57,6 +57,8 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/mem_pool.h"
+#include "src/common/str_intern.h"
 #include "src/common/node_conf.h"
 #include "src/common/pack.h"
 #include "src/common/read_config.h" /* location of slurmctld_conf */
@@ -977,6 +979,9 @@ struct 	step_record {
 
 extern List job_list;			/* list of job_record entries */
 extern List purge_files_list;		/* list of job ids to purge files of */
+extern mem_pool_t *job_record_pool;	/* allocator for struct job_record */
+extern mem_pool_t *job_details_pool;	/* allocator for struct job_details */
+extern mem_pool_t *step_record_pool;	/* allocator for struct step_record */
 
 /*****************************************************************************\
  *  Consumable Resources parameters and data structures
@@ -2018,6 +2023,15 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 			  uint16_t protocol_version);
 
+/* Append memory pool statistics to a buffer built by pack_all_stat() */
+extern void pack_all_pool_stat(char **buffer_ptr, int *buffer_size,
+			       uint16_t protocol_version);
+
+/* Append asynchronous logging statistics to a buffer built by
+ * pack_all_stat() */
+extern void pack_all_log_stat(char **buffer_ptr, int *buffer_size,
+			      uint16_t protocol_version);
+
 /*
  * pack_ctld_job_step_info_response_msg - packs job step info
  * IN job_id - specific id or NO_VAL for all
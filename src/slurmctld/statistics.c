@@ -41,6 +41,7 @@
 #include "src/slurmctld/agent.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/common/list.h"
+#include "src/common/mem_pool.h"
 #include "src/common/pack.h"
 #include "src/common/xstring.h"
 #include "src/common/slurmdbd_defs.h"
@@ -203,6 +204,86 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 	buffer_ptr[0] = xfer_buf_data(buffer);
 }
 
+/* Append memory pool statistics to a buffer built by pack_all_stat() */
+extern void pack_all_pool_stat(char **buffer_ptr, int *buffer_size,
+			       uint16_t protocol_version)
+{
+	mem_pool_stats_t *stats = NULL;
+	char **name;
+	uint32_t *obj_size, *slab_cnt, *obj_in_use, *obj_free;
+	uint64_t *alloc_cnt, *slab_free_cnt;
+	uint32_t i, cnt;
+	Buf buffer;
+
+	if (protocol_version < SLURM_19_05_PROTOCOL_VERSION)
+		return;
+
+	cnt = mem_pool_get_stats(&stats);
+	name          = xmalloc(sizeof(char *)   * (cnt + 1));
+	obj_size      = xmalloc(sizeof(uint32_t) * (cnt + 1));
+	slab_cnt      = xmalloc(sizeof(uint32_t) * (cnt + 1));
+	obj_in_use    = xmalloc(sizeof(uint32_t) * (cnt + 1));
+	obj_free      = xmalloc(sizeof(uint32_t) * (cnt + 1));
+	alloc_cnt     = xmalloc(sizeof(uint64_t) * (cnt + 1));
+	slab_free_cnt = xmalloc(sizeof(uint64_t) * (cnt + 1));
+	for (i = 0; i < cnt; i++) {
+		name[i]          = stats[i].name;
+		obj_size[i]      = stats[i].obj_size;
+		slab_cnt[i]      = stats[i].slab_cnt;
+		obj_in_use[i]    = stats[i].obj_in_use;
+		obj_free[i]      = stats[i].obj_free;
+		alloc_cnt[i]     = stats[i].alloc_cnt;
+		slab_free_cnt[i] = stats[i].slab_free_cnt;
+	}
+
+	buffer = create_buf(*buffer_ptr, *buffer_size);
+	set_buf_offset(buffer, *buffer_size);
+
+	packstr_array(name, cnt, buffer);
+	pack32_array(obj_size, cnt, buffer);
+	pack32_array(slab_cnt, cnt, buffer);
+	pack32_array(obj_in_use, cnt, buffer);
+	pack32_array(obj_free, cnt, buffer);
+	pack64_array(alloc_cnt, cnt, buffer);
+	pack64_array(slab_free_cnt, cnt, buffer);
+
+	*buffer_size = get_buf_offset(buffer);
+	buffer_ptr[0] = xfer_buf_data(buffer);
+
+	xfree(name);
+	xfree(obj_size);
+	xfree(slab_cnt);
+	xfree(obj_in_use);
+	xfree(obj_free);
+	xfree(alloc_cnt);
+	xfree(slab_free_cnt);
+	mem_pool_stats_free(stats, cnt);
+}
+
+/* Append asynchronous logging statistics to a buffer built by
+ * pack_all_stat() */
+extern void pack_all_log_stat(char **buffer_ptr, int *buffer_size,
+			      uint16_t protocol_version)
+{
+	uint32_t queue_len;
+	uint64_t drop_cnt;
+	Buf buffer;
+
+	if (protocol_version < SLURM_19_05_PROTOCOL_VERSION)
+		return;
+
+	log_get_async_stats(&queue_len, &drop_cnt);
+
+	buffer = create_buf(*buffer_ptr, *buffer_size);
+	set_buf_offset(buffer, *buffer_size);
+
+	pack32(queue_len, buffer);
+	pack64(drop_cnt, buffer);
+
+	*buffer_size = get_buf_offset(buffer);
+	buffer_ptr[0] = xfer_buf_data(buffer);
+}
+
 /* Reset all scheduling statistics
  * level IN - clear backfilled_jobs count if set */
 extern void reset_stats(int level)
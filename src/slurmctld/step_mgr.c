@@ -178,7 +178,7 @@ static struct step_record * _create_step_record(struct job_record *job_ptr,
 		return NULL;
 	}
 
-	step_ptr = xmalloc(sizeof(struct step_record));
+	step_ptr = mem_pool_alloc(step_record_pool);
 
 	last_job_update = time(NULL);
 	step_ptr->job_ptr    = job_ptr;
@@ -426,7 +426,7 @@ static void _free_step_rec(struct step_record *step_ptr)
 	xfree(step_ptr->tres_per_node);
 	xfree(step_ptr->tres_per_socket);
 	xfree(step_ptr->tres_per_task);
-	xfree(step_ptr);
+	mem_pool_free(step_ptr);
 }
 
 /*
@@ -3996,6 +3996,7 @@ extern int dump_job_step_state(void *x, void *arg)
 	packstr(step_ptr->tres_per_node, buffer);
 	packstr(step_ptr->tres_per_socket, buffer);
 	packstr(step_ptr->tres_per_task, buffer);
+	pack_bit_str_runs(step_ptr->step_node_bitmap, buffer);
 	return 0;
 }
 
@@ -4011,6 +4012,7 @@ extern int load_step_state(struct job_record *job_ptr, Buf buffer,
 {
 	struct step_record *step_ptr = NULL;
 	bitstr_t *exit_node_bitmap = NULL, *core_bitmap_job = NULL;
+	bitstr_t *step_node_bitmap = NULL;
 	uint8_t no_kill;
 	uint16_t cyclic_alloc, port, batch_step;
 	uint16_t start_protocol_ver = SLURM_MIN_PROTOCOL_VERSION;
@@ -4102,6 +4104,8 @@ extern int load_step_state(struct job_record *job_ptr, Buf buffer,
 		safe_unpackstr_xmalloc(&tres_per_node, &name_len, buffer);
 		safe_unpackstr_xmalloc(&tres_per_socket, &name_len, buffer);
 		safe_unpackstr_xmalloc(&tres_per_task, &name_len, buffer);
+		if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION)
+			unpack_bit_str_runs(&step_node_bitmap, buffer);
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&step_id, buffer);
 		safe_unpack16(&cyclic_alloc, buffer);
@@ -4284,6 +4288,10 @@ extern int load_step_state(struct job_record *job_ptr, Buf buffer,
 		core_bitmap_job = NULL;
 	}
 
+	FREE_NULL_BITMAP(step_ptr->step_node_bitmap);
+	step_ptr->step_node_bitmap = step_node_bitmap;
+	step_node_bitmap = NULL;
+
 	if (step_ptr->step_layout && switch_tmp)
 		switch_g_job_step_allocated(switch_tmp,
 					    step_ptr->step_layout->node_list);
@@ -4300,6 +4308,7 @@ unpack_error:
 	FREE_NULL_LIST(gres_list);
 	bit_free(exit_node_bitmap);
 	bit_free(core_bitmap_job);
+	FREE_NULL_BITMAP(step_node_bitmap);
 	xfree(bit_fmt);
 	xfree(core_job);
 	if (switch_tmp)
@@ -4581,7 +4590,7 @@ extern int update_step(step_update_request_msg_t *req, uid_t uid)
 		 * the job's step_list.
 		 */
 		if (req->step_id == NO_VAL) {
-			step_ptr = xmalloc(sizeof(struct step_record));
+			step_ptr = mem_pool_alloc(step_record_pool);
 			step_ptr->job_ptr    = job_ptr;
 			step_ptr->exit_code  = NO_VAL;
 			step_ptr->time_limit = INFINITE;
@@ -4602,7 +4611,7 @@ extern int update_step(step_update_request_msg_t *req, uid_t uid)
 				 * remake the step so we can send the updated
 				 * parts to accounting.
 				 */
-				step_ptr = xmalloc(sizeof(struct step_record));
+				step_ptr = mem_pool_alloc(step_record_pool);
 				step_ptr->job_ptr    = job_ptr;
 				step_ptr->jobacct    = jobacctinfo_create(NULL);
 				step_ptr->requid     = -1;
@@ -98,6 +98,7 @@
 
 #include "src/slurmd/slurmd/get_mach_stat.h"
 #include "src/slurmd/slurmd/slurmd.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
 
 #include "src/slurmd/common/fname.h"
 #include "src/slurmd/common/job_container_plugin.h"
@@ -273,6 +274,24 @@ static uint32_t active_job_id[JOB_STATE_CNT] = {0};
 static pthread_mutex_t prolog_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t prolog_serial_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Recent step statistics replies, so that repeated sstat requests for the
+ * same step within the task accounting sampling interval are answered by
+ * slurmd without another round trip to (and poll by) the slurmstepd.
+ */
+typedef struct {
+	uint32_t job_id;
+	uint32_t step_id;
+	uid_t uid;		/* step owner */
+	time_t stat_time;
+	Buf jobacct_buf;	/* packed jobacctinfo, NULL if none */
+	uint32_t num_tasks;
+	uint32_t *pid;
+	uint32_t pid_cnt;
+} stat_cache_t;
+static pthread_mutex_t stat_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List stat_cache_list = NULL;
+
 #define FILE_BCAST_TIMEOUT 300
 static pthread_mutex_t file_bcast_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  file_bcast_cond  = PTHREAD_COND_INITIALIZER;
@@ -294,6 +313,9 @@ slurmd_req(slurm_msg_t *msg)
 			job_limits_loaded = false;
 		}
 		slurm_mutex_unlock(&job_limits_mutex);
+		slurm_mutex_lock(&stat_cache_mutex);
+		FREE_NULL_LIST(stat_cache_list);
+		slurm_mutex_unlock(&stat_cache_mutex);
 		return;
 	}
 
@@ -684,6 +706,62 @@ rwfail:
 }
 
 
+/*
+ * Send a slurmstepd its initialization data over the to_stepd pipe, then
+ * wait for it to send an "ok" message on the to_slurmd pipe and send back
+ * an acknowledgement.
+ */
+static int
+_init_slurmstepd(int to_stepd, int to_slurmd, uint16_t type, void *req,
+		 slurm_addr_t *cli, slurm_addr_t *self,
+		 const hostset_t step_hset, uint16_t protocol_version)
+{
+	int rc = SLURM_SUCCESS;
+#if (SLURMSTEPD_MEMCHECK == 0)
+	int i;
+	time_t start_time = time(NULL);
+#endif
+
+	if ((rc = _send_slurmstepd_init(to_stepd, type, req, cli, self,
+					step_hset, protocol_version)) != 0) {
+		error("Unable to init slurmstepd");
+		return rc;
+	}
+
+	/* If running under valgrind/memcheck, this pipe doesn't work
+	 * correctly so just skip it. */
+#if (SLURMSTEPD_MEMCHECK == 0)
+	i = read(to_slurmd, &rc, sizeof(int));
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else {
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			info("Warning: slurmstepd startup took %d sec, "
+			     "possible file system problem or full "
+			     "memory", delta_time);
+		}
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d", rc);
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd, &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
+		}
+	}
+#endif
+	return rc;
+}
+
 /*
  * Fork and exec the slurmstepd, then send the slurmstepd its
  * initialization data.  Then wait for slurmstepd to send an "ok"
@@ -691,6 +769,9 @@ rwfail:
  * the slurmstepd has created and begun listening on its unix
  * domain socket.
  *
+ * If an idle slurmstepd is available from the pool it is used instead of
+ * starting a new one.
+ *
  * Note that this code forks twice and it is the grandchild that
  * becomes the slurmstepd process, so the slurmstepd's parent process
  * will be init, not slurmd.
@@ -704,6 +785,26 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 	int to_stepd[2] = {-1, -1};
 	int to_slurmd[2] = {-1, -1};
 
+	if (stepd_pool_get(&to_stepd[1], &to_slurmd[0]) == SLURM_SUCCESS) {
+		int rc;
+
+		if (_add_starting_step(type, req)) {
+			error("%s: failed in _add_starting_step: %m", __func__);
+			close(to_stepd[1]);
+			close(to_slurmd[0]);
+			return SLURM_ERROR;
+		}
+		rc = _init_slurmstepd(to_stepd[1], to_slurmd[0], type, req,
+				      cli, self, step_hset, protocol_version);
+		if (_remove_starting_step(type, req))
+			error("Error cleaning up starting_step list");
+		if (close(to_stepd[1]) < 0)
+			error("close write to_stepd in parent: %m");
+		if (close(to_slurmd[0]) < 0)
+			error("close read to_slurmd in parent: %m");
+		return rc;
+	}
+
 	if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
 		error("_forkexec_slurmstepd pipe failed: %m");
 		return SLURM_ERROR;
@@ -723,11 +824,7 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 		_remove_starting_step(type, req);
 		return SLURM_ERROR;
 	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
-#if (SLURMSTEPD_MEMCHECK == 0)
-		int i;
-		time_t start_time = time(NULL);
-#endif
+		int rc;
 		/*
 		 * Parent sends initialization data to the slurmstepd
 		 * over the to_stepd pipe, and waits for the return code
@@ -738,46 +835,9 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 		if (close(to_slurmd[1]) < 0)
 			error("Unable to close write to_slurmd in parent: %m");
 
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, self,
-						step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
-		}
+		rc = _init_slurmstepd(to_stepd[1], to_slurmd[0], type, req,
+				      cli, self, step_hset, protocol_version);
 
-		/* If running under valgrind/memcheck, this pipe doesn't work
-		 * correctly so just skip it. */
-#if (SLURMSTEPD_MEMCHECK == 0)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				info("Warning: slurmstepd startup took %d sec, "
-				     "possible file system problem or full "
-				     "memory", delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d", rc);
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
-#endif
-	done:
 		if (_remove_starting_step(type, req))
 			error("Error cleaning up starting_step list");
 
@@ -3586,6 +3646,7 @@ _rpc_daemon_status(slurm_msg_t *msg)
 	resp->slurmd_debug       = conf->debug_level;
 	resp->slurmd_logfile     = xstrdup(conf->logfile);
 	resp->version            = xstrdup(SLURM_VERSION_STRING);
+	slurmd_get_rpc_stats(resp);
 
 	slurm_msg_t_copy(&resp_msg, msg);
 	resp_msg.msg_type = RESPONSE_SLURMD_STATUS;
@@ -3595,6 +3656,131 @@ _rpc_daemon_status(slurm_msg_t *msg)
 	return SLURM_SUCCESS;
 }
 
+static void _stat_cache_free(void *x)
+{
+	stat_cache_t *cache = (stat_cache_t *) x;
+
+	if (cache) {
+		FREE_NULL_BUFFER(cache->jobacct_buf);
+		xfree(cache->pid);
+		xfree(cache);
+	}
+}
+
+static int _stat_cache_expired(void *x, void *key)
+{
+	stat_cache_t *cache = (stat_cache_t *) x;
+	time_t *expire_time = (time_t *) key;
+
+	if (cache->stat_time <= *expire_time)
+		return 1;
+	return 0;
+}
+
+static int _stat_cache_match(void *x, void *key)
+{
+	stat_cache_t *cache = (stat_cache_t *) x;
+	job_step_id_msg_t *req = (job_step_id_msg_t *) key;
+
+	if ((cache->job_id == req->job_id) && (cache->step_id == req->step_id))
+		return 1;
+	return 0;
+}
+
+/* Seconds a step statistics reply may be reused, 0 if not at all */
+static int _stat_cache_ttl(void)
+{
+	if ((conf->acct_freq_task == NO_VAL16) || !conf->acct_freq_task)
+		return 0;
+	return conf->acct_freq_task;
+}
+
+/*
+ * Fill in resp from a recent reply for the step, if any.
+ * RET true if found, with *uid set to the step owner
+ */
+static bool _stat_cache_get(job_step_id_msg_t *req, job_step_stat_t *resp,
+			    uid_t *uid)
+{
+	stat_cache_t *cache;
+	time_t expire_time;
+	int ttl = _stat_cache_ttl();
+	bool found = false;
+
+	if (!ttl)
+		return false;
+
+	slurm_mutex_lock(&stat_cache_mutex);
+	if (!stat_cache_list) {
+		slurm_mutex_unlock(&stat_cache_mutex);
+		return false;
+	}
+	expire_time = time(NULL) - ttl;
+	(void) list_delete_all(stat_cache_list, _stat_cache_expired,
+			       &expire_time);
+	if ((cache = list_find_first(stat_cache_list, _stat_cache_match,
+				     req))) {
+		*uid = cache->uid;
+		resp->num_tasks = cache->num_tasks;
+		if (cache->jobacct_buf) {
+			set_buf_offset(cache->jobacct_buf, 0);
+			if (jobacctinfo_unpack(&resp->jobacct,
+					       SLURM_PROTOCOL_VERSION,
+					       PROTOCOL_TYPE_SLURM,
+					       cache->jobacct_buf, true) !=
+			    SLURM_SUCCESS)
+				goto fini;
+		}
+		if (cache->pid_cnt) {
+			resp->step_pids->pid = xmalloc(sizeof(uint32_t) *
+						       cache->pid_cnt);
+			memcpy(resp->step_pids->pid, cache->pid,
+			       sizeof(uint32_t) * cache->pid_cnt);
+			resp->step_pids->pid_cnt = cache->pid_cnt;
+		}
+		found = true;
+	}
+fini:
+	slurm_mutex_unlock(&stat_cache_mutex);
+
+	return found;
+}
+
+static void _stat_cache_add(job_step_id_msg_t *req, job_step_stat_t *resp,
+			    uid_t uid)
+{
+	stat_cache_t *cache;
+
+	if (!_stat_cache_ttl())
+		return;
+
+	cache = xmalloc(sizeof(stat_cache_t));
+	cache->job_id = req->job_id;
+	cache->step_id = req->step_id;
+	cache->uid = uid;
+	cache->stat_time = time(NULL);
+	cache->num_tasks = resp->num_tasks;
+	if (resp->jobacct) {
+		cache->jobacct_buf = init_buf(BUF_SIZE);
+		jobacctinfo_pack(resp->jobacct, SLURM_PROTOCOL_VERSION,
+				 PROTOCOL_TYPE_SLURM, cache->jobacct_buf);
+	}
+	if (resp->step_pids->pid_cnt) {
+		cache->pid = xmalloc(sizeof(uint32_t) *
+				     resp->step_pids->pid_cnt);
+		memcpy(cache->pid, resp->step_pids->pid,
+		       sizeof(uint32_t) * resp->step_pids->pid_cnt);
+		cache->pid_cnt = resp->step_pids->pid_cnt;
+	}
+
+	slurm_mutex_lock(&stat_cache_mutex);
+	if (!stat_cache_list)
+		stat_cache_list = list_create(_stat_cache_free);
+	(void) list_delete_all(stat_cache_list, _stat_cache_match, req);
+	list_append(stat_cache_list, cache);
+	slurm_mutex_unlock(&stat_cache_mutex);
+}
+
 static int
 _rpc_stat_jobacct(slurm_msg_t *msg)
 {
@@ -3605,16 +3791,37 @@ _rpc_stat_jobacct(slurm_msg_t *msg)
 	uint16_t protocol_version;
 	uid_t uid;
 	uid_t req_uid = g_slurm_auth_get_uid(msg->auth_cred);
+	bool stat_ok = true;
 
 	debug3("Entering _rpc_stat_jobacct");
 	/* step completion messages are only allowed from other slurmstepd,
 	   so only root or SlurmUser is allowed here */
 
+	resp = xmalloc(sizeof(job_step_stat_t));
+	resp->step_pids = xmalloc(sizeof(job_step_pids_t));
+	resp->step_pids->node_name = xstrdup(conf->node_name);
+	resp->return_code = SLURM_SUCCESS;
+
+	if (_stat_cache_get(req, resp, &uid)) {
+		debug3("%s: using cached statistics for step %u.%u",
+		       __func__, req->job_id, req->step_id);
+		if ((req_uid != uid) && (!_slurm_authorized_user(req_uid))) {
+			error("stat_jobacct from uid %ld for job %u "
+			      "owned by uid %ld",
+			      (long) req_uid, req->job_id, (long) uid);
+			slurm_free_job_step_stat(resp);
+			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
+			return ESLURM_USER_ID_MISSING;
+		}
+		goto send_resp;
+	}
+
 	fd = stepd_connect(conf->spooldir, conf->node_name,
 			   req->job_id, req->step_id, &protocol_version);
 	if (fd == -1) {
 		error("stepd_connect to %u.%u failed: %m",
 		      req->job_id, req->step_id);
+		slurm_free_job_step_stat(resp);
 		slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
 		return	ESLURM_INVALID_JOB_ID;
 	}
@@ -3623,6 +3830,7 @@ _rpc_stat_jobacct(slurm_msg_t *msg)
 		debug("stat_jobacct couldn't read from the step %u.%u: %m",
 		      req->job_id, req->step_id);
 		close(fd);
+		slurm_free_job_step_stat(resp);
 		if (msg->conn_fd >= 0)
 			slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
 		return	ESLURM_INVALID_JOB_ID;
@@ -3637,22 +3845,18 @@ _rpc_stat_jobacct(slurm_msg_t *msg)
 		      (long) req_uid, req->job_id, (long) uid);
 
 		if (msg->conn_fd >= 0) {
+			slurm_free_job_step_stat(resp);
 			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
 			close(fd);
 			return ESLURM_USER_ID_MISSING;/* or bad in this case */
 		}
 	}
 
-	resp = xmalloc(sizeof(job_step_stat_t));
-	resp->step_pids = xmalloc(sizeof(job_step_pids_t));
-	resp->step_pids->node_name = xstrdup(conf->node_name);
-	slurm_msg_t_copy(&resp_msg, msg);
-	resp->return_code = SLURM_SUCCESS;
-
 	if (stepd_stat_jobacct(fd, protocol_version, req, resp)
 	    == SLURM_ERROR) {
 		debug("accounting for nonexistent job %u.%u requested",
 		      req->job_id, req->step_id);
+		stat_ok = false;
 	}
 
 	/* FIX ME: This should probably happen in the
@@ -3662,10 +3866,16 @@ _rpc_stat_jobacct(slurm_msg_t *msg)
 			    &resp->step_pids->pid_cnt) == SLURM_ERROR) {
 		debug("No pids for nonexistent job %u.%u requested",
 		      req->job_id, req->step_id);
+		stat_ok = false;
 	}
 
 	close(fd);
 
+	if (stat_ok)
+		_stat_cache_add(req, resp, uid);
+
+send_resp:
+	slurm_msg_t_copy(&resp_msg, msg);
 	resp_msg.msg_type     = RESPONSE_JOB_STEP_STAT;
 	resp_msg.data         = resp;
 
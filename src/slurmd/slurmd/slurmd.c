@@ -97,6 +97,7 @@
 #include "src/common/slurm_topology.h"
 #include "src/common/stepd_api.h"
 #include "src/common/switch.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xcgroup_read_config.h"
 #include "src/common/xmalloc.h"
@@ -116,6 +117,7 @@
 #include "src/slurmd/slurmd/get_mach_stat.h"
 #include "src/slurmd/slurmd/req.h"
 #include "src/slurmd/slurmd/slurmd.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
 
 #ifndef MAXHOSTNAMELEN
 #  define MAXHOSTNAMELEN	64
@@ -148,8 +150,44 @@ static pthread_mutex_t fork_mutex     = PTHREAD_MUTEX_INITIALIZER;
 typedef struct connection {
 	int fd;
 	slurm_addr_t *cli_addr;
+	slurm_msg_t *msg;
 } conn_t;
 
+/*
+ * Connection worker pool
+ *
+ * The message engine only accepts connections and queues them. Up to
+ * MAX_THREADS worker threads are started on demand to receive and process
+ * them, and exit after WORKER_IDLE_TIME seconds without work. Once a request
+ * is received it is assigned a lane by message type. Requests in the bulk
+ * lane (step statistics and pids, status and energy queries, file
+ * broadcasts) may occupy at most BULK_LANE_MAX workers, further ones are
+ * parked until a bulk worker is done. This keeps workers available for job
+ * launch, termination, signal and ping requests when many sstat or listpids
+ * requests arrive at once.
+ */
+#define MAX_CONN_QUEUE		(MAX_THREADS * 4)
+#define BULK_LANE_MAX		(MAX_THREADS / 4)
+#define WORKER_IDLE_TIME	60
+
+static pthread_mutex_t worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  worker_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  queue_cond   = PTHREAD_COND_INITIALIZER;
+static List conn_queue  = NULL;	/* accepted, waiting for a worker */
+static List bulk_queue  = NULL;	/* received, waiting for the bulk lane */
+static int  worker_cnt  = 0;	/* worker threads in existence */
+static int  worker_idle = 0;	/* worker threads waiting for work */
+static int  bulk_active = 0;	/* workers processing bulk requests */
+
+/*
+ * Per RPC type processing statistics, reported by REQUEST_DAEMON_STATUS
+ */
+static pthread_mutex_t rpc_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int       rpc_type_size = 0;	/* Size of rpc_type_* arrays */
+static uint16_t *rpc_type_id   = NULL;
+static uint32_t *rpc_type_cnt  = NULL;
+static uint64_t *rpc_type_time = NULL;
+
 /*
  * Global data for resource specialization
  */
@@ -187,6 +225,7 @@ static void      _hup_handler(int);
 static void      _increment_thd_count(void);
 static void      _init_conf(void);
 static void      _install_fork_handlers(void);
+static bool      _is_bulk_rpc(uint16_t msg_type);
 static bool      _is_core_spec_cray(void);
 static void      _kill_old_slurmd(void);
 static int       _memory_spec_init(void);
@@ -202,7 +241,10 @@ static void      _resource_spec_fini(void);
 static int       _resource_spec_init(void);
 static int       _restore_cred_state(slurm_cred_ctx_t ctx);
 static void      _select_spec_cores(void);
-static void     *_service_connection(void *);
+static void      _service_cleanup(conn_t *con);
+static void      _service_connection(conn_t *con);
+static void      _service_request(conn_t *con);
+static void     *_service_worker(void *arg);
 static void      _set_msg_aggr_params(void);
 static int       _set_slurmd_spooldir(void);
 static int       _set_topo_info(void);
@@ -361,6 +403,7 @@ main (int argc, char **argv)
 			     conf->msg_aggr_window_msgs);
 
 	slurm_thread_create_detached(NULL, _registration_engine, NULL);
+	stepd_pool_init();
 
 	_msg_engine();
 
@@ -417,6 +460,8 @@ _msg_engine(void)
 
 	msg_pthread = pthread_self();
 	slurmd_req(NULL);	/* initialize timer */
+	conn_queue = list_create(NULL);
+	bulk_queue = list_create(NULL);
 	while (!_shutdown) {
 		if (_reconfig) {
 			verbose("got reconfigure request");
@@ -453,20 +498,14 @@ _decrement_thd_count(void)
 	slurm_mutex_unlock(&active_mutex);
 }
 
+/*
+ * Concurrency is bounded by the worker pool, this count is only used to wait
+ * for requests in progress (including parked ones) to complete.
+ */
 static void
 _increment_thd_count(void)
 {
-	bool logged = false;
-
 	slurm_mutex_lock(&active_mutex);
-	while (active_threads >= MAX_THREADS) {
-		if (!logged) {
-			info("active_threads == MAX_THREADS(%d)",
-			     MAX_THREADS);
-			logged = true;
-		}
-		slurm_cond_wait(&active_cond, &active_mutex);
-	}
 	active_threads++;
 	slurm_mutex_unlock(&active_mutex);
 }
@@ -501,24 +540,106 @@ _wait_for_all_threads(int secs)
 
 static void _handle_connection(int fd, slurm_addr_t *cli)
 {
-	conn_t *arg = xmalloc(sizeof(conn_t));
+	conn_t *con = xmalloc(sizeof(conn_t));
+	bool logged = false;
 
-	arg->fd       = fd;
-	arg->cli_addr = cli;
+	con->fd       = fd;
+	con->cli_addr = cli;
 
 	fd_set_close_on_exec(fd);
 
-	_increment_thd_count();
-	slurm_thread_create_detached(NULL, _service_connection, arg);
+	slurm_mutex_lock(&worker_mutex);
+	while (list_count(conn_queue) >= MAX_CONN_QUEUE) {
+		if (!logged) {
+			info("%s: %d connections queued for %d workers",
+			     __func__, list_count(conn_queue), worker_cnt);
+			logged = true;
+		}
+		slurm_cond_wait(&queue_cond, &worker_mutex);
+	}
+	list_enqueue(conn_queue, con);
+	if ((worker_idle < list_count(conn_queue)) &&
+	    (worker_cnt < MAX_THREADS)) {
+		worker_cnt++;
+		slurm_thread_create_detached(NULL, _service_worker, NULL);
+	} else
+		slurm_cond_signal(&worker_cond);
+	slurm_mutex_unlock(&worker_mutex);
 }
 
+/*
+ * Worker thread: process parked bulk requests when the bulk lane has room,
+ * otherwise the next queued connection. Exit after WORKER_IDLE_TIME seconds
+ * without work.
+ */
 static void *
-_service_connection(void *arg)
+_service_worker(void *arg)
+{
+	conn_t *con;
+	struct timespec ts;
+	int rc;
+
+	slurm_mutex_lock(&worker_mutex);
+	while (1) {
+		if ((bulk_active < BULK_LANE_MAX) &&
+		    (con = list_dequeue(bulk_queue))) {
+			bulk_active++;
+			slurm_mutex_unlock(&worker_mutex);
+			_service_request(con);
+			slurm_mutex_lock(&worker_mutex);
+			bulk_active--;
+			continue;
+		}
+		if ((con = list_dequeue(conn_queue))) {
+			slurm_cond_signal(&queue_cond);
+			slurm_mutex_unlock(&worker_mutex);
+			_service_connection(con);
+			slurm_mutex_lock(&worker_mutex);
+			continue;
+		}
+
+		ts.tv_sec  = time(NULL) + WORKER_IDLE_TIME;
+		ts.tv_nsec = 0;
+		worker_idle++;
+		rc = pthread_cond_timedwait(&worker_cond, &worker_mutex, &ts);
+		worker_idle--;
+		if ((rc == ETIMEDOUT) && !list_count(conn_queue))
+			break;
+	}
+	worker_cnt--;
+	slurm_mutex_unlock(&worker_mutex);
+
+	return NULL;
+}
+
+/*
+ * Return true for requests which only report state and may be delayed
+ * behind job launch, termination, signal and ping requests.
+ */
+static bool _is_bulk_rpc(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case REQUEST_ACCT_GATHER_ENERGY:
+	case REQUEST_ACCT_GATHER_UPDATE:
+	case REQUEST_DAEMON_STATUS:
+	case REQUEST_FILE_BCAST:
+	case REQUEST_JOB_STEP_PIDS:
+	case REQUEST_JOB_STEP_STAT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void
+_service_connection(conn_t *con)
 {
-	conn_t *con = (conn_t *) arg;
 	slurm_msg_t *msg = xmalloc(sizeof(slurm_msg_t));
 	int rc = SLURM_SUCCESS;
 
+	_increment_thd_count();
+	con->msg = msg;
+
 	debug3("in the service_connection");
 	slurm_msg_t_init(msg);
 	if ((rc = slurm_receive_msg_and_forward(con->fd, con->cli_addr, msg, 0))
@@ -528,14 +649,76 @@ _service_connection(void *arg)
 		   to are taken care of and sent back. This way the control
 		   also has a better idea what happened to us */
 		slurm_send_rc_msg(msg, rc);
-		goto cleanup;
+		_service_cleanup(con);
+		return;
 	}
 	debug2("got this type of message %d", msg->msg_type);
 
-	if (msg->msg_type != MESSAGE_COMPOSITE)
-		slurmd_req(msg);
+	if (msg->msg_type == MESSAGE_COMPOSITE) {
+		_service_cleanup(con);
+		return;
+	}
+
+	if (!_is_bulk_rpc(msg->msg_type)) {
+		_service_request(con);
+		return;
+	}
+
+	slurm_mutex_lock(&worker_mutex);
+	if (bulk_active >= BULK_LANE_MAX) {
+		/* Park it, the next bulk worker done will pick it up */
+		list_enqueue(bulk_queue, con);
+		slurm_mutex_unlock(&worker_mutex);
+		return;
+	}
+	bulk_active++;
+	slurm_mutex_unlock(&worker_mutex);
+
+	_service_request(con);
+
+	slurm_mutex_lock(&worker_mutex);
+	bulk_active--;
+	slurm_mutex_unlock(&worker_mutex);
+}
+
+/* Process a received request and record its processing time */
+static void
+_service_request(conn_t *con)
+{
+	uint16_t msg_type = con->msg->msg_type;
+	int i;
+	DEF_TIMERS;
+
+	START_TIMER;
+	slurmd_req(con->msg);
+	END_TIMER;
+
+	slurm_mutex_lock(&rpc_mutex);
+	if (rpc_type_size == 0) {
+		rpc_type_size = 100;  /* Capture info for first 100 RPC types */
+		rpc_type_id   = xmalloc(sizeof(uint16_t) * rpc_type_size);
+		rpc_type_cnt  = xmalloc(sizeof(uint32_t) * rpc_type_size);
+		rpc_type_time = xmalloc(sizeof(uint64_t) * rpc_type_size);
+	}
+	for (i = 0; i < rpc_type_size; i++) {
+		if (rpc_type_id[i] == 0)
+			rpc_type_id[i] = msg_type;
+		else if (rpc_type_id[i] != msg_type)
+			continue;
+		rpc_type_cnt[i]++;
+		rpc_type_time[i] += DELTA_TIMER;
+		break;
+	}
+	slurm_mutex_unlock(&rpc_mutex);
+
+	_service_cleanup(con);
+}
+
+static void
+_service_cleanup(conn_t *con)
+{
+	slurm_msg_t *msg = con->msg;
 
-cleanup:
 	if ((msg->conn_fd >= 0) && close(msg->conn_fd) < 0)
 		error ("close(%d): %m", con->fd);
 
@@ -543,7 +726,36 @@ cleanup:
 	xfree(con);
 	slurm_free_msg(msg);
 	_decrement_thd_count();
-	return NULL;
+}
+
+extern void slurmd_get_rpc_stats(slurmd_status_t *status)
+{
+	int i, cnt;
+
+	slurm_mutex_lock(&rpc_mutex);
+	for (cnt = 0; cnt < rpc_type_size; cnt++) {
+		if (rpc_type_id[cnt] == 0)
+			break;
+	}
+	status->rpc_type_size = cnt;
+	if (cnt) {
+		status->rpc_type_id   = xmalloc(sizeof(uint16_t) * cnt);
+		status->rpc_type_cnt  = xmalloc(sizeof(uint32_t) * cnt);
+		status->rpc_type_time = xmalloc(sizeof(uint64_t) * cnt);
+	}
+	for (i = 0; i < cnt; i++) {
+		status->rpc_type_id[i]   = rpc_type_id[i];
+		status->rpc_type_cnt[i]  = rpc_type_cnt[i];
+		status->rpc_type_time[i] = rpc_type_time[i];
+	}
+	slurm_mutex_unlock(&rpc_mutex);
+
+	slurm_mutex_lock(&worker_mutex);
+	status->worker_cnt     = worker_cnt;
+	status->worker_busy    = worker_cnt - worker_idle;
+	status->conn_queue_len = list_count(conn_queue);
+	status->bulk_queue_len = list_count(bulk_queue);
+	slurm_mutex_unlock(&worker_mutex);
 }
 
 static void _handle_node_reg_resp(slurm_msg_t *resp_msg)
@@ -1094,6 +1306,7 @@ _reconfigure(void)
 
 	msg_aggr_sender_reconfig(conf->msg_aggr_window_time,
 				 conf->msg_aggr_window_msgs);
+	stepd_pool_reconfig();
 
 	/*
 	 * In case the administrator changed the cpu frequency set capabilities
@@ -1736,6 +1949,7 @@ cleanup:
 static int
 _slurmd_fini(void)
 {
+	stepd_pool_fini();
 	assoc_mgr_fini(false);
 	node_features_g_fini();
 	core_spec_g_fini();
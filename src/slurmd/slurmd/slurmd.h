@@ -198,4 +198,10 @@ int run_script_health_check(void);
 /* Handler for SIGTERM; can also be called to shutdown the slurmd. */
 void slurmd_shutdown(int signum);
 
+/*
+ * Fill in the per RPC type statistics and worker pool state of a
+ * REQUEST_DAEMON_STATUS response
+ */
+void slurmd_get_rpc_stats(slurmd_status_t *status);
+
 #endif /* !_SLURMD_H */
@@ -0,0 +1,295 @@
+/*****************************************************************************\
+ *  src/slurmd/slurmd/stepd_pool.c - pool of idle slurmstepd processes
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Theory of operation:
+ * - An idle slurmstepd has been forked and exec'd and has initialized its
+ *   select and auth plugins, and is blocked waiting for its initialization
+ *   data on stdin. All other plugins are still loaded per step, after that
+ *   data arrives.
+ * - Launching a step takes an idle slurmstepd from the pool and sends it the
+ *   same initialization data over the same pipes as a freshly started one,
+ *   so nothing changes for the slurmstepd once data arrives.
+ * - An agent thread refills the pool in the background. Idle slurmstepd
+ *   processes are released by closing their stdin, on which they exit
+ *   quietly.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/common/fd.h"
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_api.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/slurmd/common/slurmstepd_init.h"
+#include "src/slurmd/slurmd/slurmd.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
+
+#define MAX_POOL_SIZE	64
+
+typedef struct {
+	int to_stepd;		/* write end of slurmstepd's stdin */
+	int to_slurmd;		/* read end of slurmstepd's stdout */
+} idle_stepd_t;
+
+extern int devnull;
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pool_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_t pool_thread = 0;
+static idle_stepd_t pool[MAX_POOL_SIZE];
+static int pool_cnt = 0;		/* idle slurmstepd processes */
+static int pool_size = 0;		/* configured idle slurmstepd count */
+static bool pool_shutdown = false;
+
+static int _get_pool_size(void)
+{
+	char *launch_params, *tmp_ptr;
+	int size = 0;
+
+	launch_params = slurm_get_launch_params();
+	if ((tmp_ptr = xstrcasestr(launch_params, "slurmstepd_pool="))) {
+		size = atoi(tmp_ptr + 16);
+		if (size < 0)
+			size = 0;
+		if (size > MAX_POOL_SIZE) {
+			error("%s: slurmstepd_pool=%d too large, using %d",
+			      __func__, size, MAX_POOL_SIZE);
+			size = MAX_POOL_SIZE;
+		}
+	}
+	xfree(launch_params);
+
+	return size;
+}
+
+static void _release_stepd(idle_stepd_t *stepd)
+{
+	(void) close(stepd->to_stepd);
+	(void) close(stepd->to_slurmd);
+}
+
+/*
+ * Fork and exec an idle slurmstepd. As in _forkexec_slurmstepd() the
+ * slurmstepd is a grandchild so its parent process will be init.
+ */
+static int _spawn_stepd(idle_stepd_t *stepd)
+{
+	char *const argv[2] = { (char *)conf->stepd_loc, NULL };
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	pid_t pid;
+	int i;
+
+	if ((pipe(to_stepd) < 0) || (pipe(to_slurmd) < 0)) {
+		error("%s: pipe failed: %m", __func__);
+		goto fail;
+	}
+
+	if ((pid = fork()) < 0) {
+		error("%s: fork: %m", __func__);
+		goto fail;
+	} else if (pid > 0) {
+		(void) close(to_stepd[0]);
+		(void) close(to_slurmd[1]);
+		if (waitpid(pid, NULL, 0) < 0)
+			error("%s: Unable to reap slurmd child process",
+			      __func__);
+		fd_set_close_on_exec(to_stepd[1]);
+		fd_set_close_on_exec(to_slurmd[0]);
+		stepd->to_stepd = to_stepd[1];
+		stepd->to_slurmd = to_slurmd[0];
+		return SLURM_SUCCESS;
+	}
+
+	/* Child forks and exits */
+	if (setsid() < 0)
+		_exit(1);
+	if ((pid = fork()) < 0)
+		_exit(1);
+	else if (pid > 0)
+		_exit(0);
+
+	/* Grandchild execs the slurmstepd */
+	for (i = 3; i < 256; i++)
+		(void) fcntl(i, F_SETFD, FD_CLOEXEC);
+	if ((to_stepd[0] != conf->lfd) && (to_slurmd[1] != conf->lfd))
+		(void) close(conf->lfd);
+	(void) close(to_stepd[1]);
+	(void) close(to_slurmd[0]);
+
+	if ((dup2(to_stepd[0], STDIN_FILENO) == -1) ||
+	    (dup2(to_slurmd[1], STDOUT_FILENO) == -1) ||
+	    (dup2(devnull, STDERR_FILENO) == -1))
+		_exit(1);
+	fd_set_noclose_on_exec(STDERR_FILENO);
+	log_fini();
+	execvp(argv[0], argv);
+	_exit(2);
+
+fail:
+	for (i = 0; i < 2; i++) {
+		if (to_stepd[i] >= 0)
+			(void) close(to_stepd[i]);
+		if (to_slurmd[i] >= 0)
+			(void) close(to_slurmd[i]);
+	}
+	return SLURM_ERROR;
+}
+
+/* Return true if an idle slurmstepd has exited or written something */
+static bool _stepd_dead(idle_stepd_t *stepd)
+{
+	struct pollfd pfd;
+
+	pfd.fd = stepd->to_slurmd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) != 0)
+		return true;
+
+	return false;
+}
+
+static void *_pool_agent(void *arg)
+{
+	idle_stepd_t stepd;
+	struct timespec ts = {0, 0};
+
+	slurm_mutex_lock(&pool_mutex);
+	while (!pool_shutdown) {
+		if (pool_cnt >= pool_size) {
+			slurm_cond_wait(&pool_cond, &pool_mutex);
+			continue;
+		}
+		slurm_mutex_unlock(&pool_mutex);
+
+		if (_spawn_stepd(&stepd) != SLURM_SUCCESS) {
+			/* Back off, do not spin on fork() failures */
+			slurm_mutex_lock(&pool_mutex);
+			ts.tv_sec = time(NULL) + 5;
+			slurm_cond_timedwait(&pool_cond, &pool_mutex, &ts);
+			continue;
+		}
+
+		slurm_mutex_lock(&pool_mutex);
+		if (pool_shutdown || (pool_cnt >= pool_size))
+			_release_stepd(&stepd);
+		else
+			pool[pool_cnt++] = stepd;
+	}
+	slurm_mutex_unlock(&pool_mutex);
+
+	return NULL;
+}
+
+extern void stepd_pool_init(void)
+{
+#if (SLURMSTEPD_MEMCHECK == 0)
+	slurm_mutex_lock(&pool_mutex);
+	pool_size = _get_pool_size();
+	pool_shutdown = false;
+	if (pool_size && !pool_thread) {
+		debug("%s: keeping %d idle slurmstepd processes",
+		      __func__, pool_size);
+		slurm_thread_create(&pool_thread, _pool_agent, NULL);
+	}
+	slurm_mutex_unlock(&pool_mutex);
+#endif
+}
+
+extern void stepd_pool_fini(void)
+{
+	pthread_t thread;
+
+	slurm_mutex_lock(&pool_mutex);
+	pool_shutdown = true;
+	while (pool_cnt)
+		_release_stepd(&pool[--pool_cnt]);
+	slurm_cond_broadcast(&pool_cond);
+	thread = pool_thread;
+	pool_thread = 0;
+	slurm_mutex_unlock(&pool_mutex);
+
+	if (thread)
+		pthread_join(thread, NULL);
+}
+
+extern void stepd_pool_reconfig(void)
+{
+	slurm_mutex_lock(&pool_mutex);
+	while (pool_cnt)
+		_release_stepd(&pool[--pool_cnt]);
+	pool_size = _get_pool_size();
+	slurm_cond_broadcast(&pool_cond);
+	slurm_mutex_unlock(&pool_mutex);
+
+	stepd_pool_init();
+}
+
+extern int stepd_pool_get(int *to_stepd, int *to_slurmd)
+{
+	idle_stepd_t stepd;
+	int rc = SLURM_ERROR;
+
+	slurm_mutex_lock(&pool_mutex);
+	while (pool_cnt) {
+		stepd = pool[--pool_cnt];
+		if (_stepd_dead(&stepd)) {
+			_release_stepd(&stepd);
+			continue;
+		}
+		*to_stepd = stepd.to_stepd;
+		*to_slurmd = stepd.to_slurmd;
+		rc = SLURM_SUCCESS;
+		break;
+	}
+	slurm_cond_signal(&pool_cond);
+	slurm_mutex_unlock(&pool_mutex);
+
+	return rc;
+}
@@ -56,6 +56,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -86,6 +87,9 @@ static bool _client_writable(eio_obj_t *);
 static int  _client_read(eio_obj_t *, List);
 static int  _client_write(eio_obj_t *, List);
 
+/* Queued messages gathered into a single writev() to a client socket */
+#define CLIENT_WRITE_IOV 16
+
 struct io_operations client_ops = {
 	.readable = &_client_readable,
 	.writable = &_client_writable,
@@ -427,14 +431,20 @@ _client_read(eio_obj_t *obj, List objs)
 }
 
 /*
- * Write outgoing packed messages to the client socket.
+ * Write outgoing packed messages to the client socket. The message in
+ * progress and up to CLIENT_WRITE_IOV - 1 messages queued behind it are
+ * written with one system call, so a task producing many small messages
+ * does not cost a write() per message.
  */
 static int
 _client_write(eio_obj_t *obj, List objs)
 {
 	struct client_io_info *client = (struct client_io_info *) obj->arg;
-	void *buf;
-	int n;
+	struct iovec iov[CLIENT_WRITE_IOV];
+	struct io_buf *msg;
+	ListIterator msgs;
+	int i, iovcnt = 0;
+	ssize_t n;
 
 	xassert(client->magic == CLIENT_IO_MAGIC);
 
@@ -457,13 +467,21 @@ _client_write(eio_obj_t *obj, List objs)
 
 	debug5("  client->out_remaining = %d", client->out_remaining);
 
+	iov[iovcnt].iov_base = client->out_msg->data +
+		(client->out_msg->length - client->out_remaining);
+	iov[iovcnt++].iov_len = client->out_remaining;
+	msgs = list_iterator_create(client->msg_queue);
+	while ((iovcnt < CLIENT_WRITE_IOV) && (msg = list_next(msgs))) {
+		iov[iovcnt].iov_base = msg->data;
+		iov[iovcnt++].iov_len = msg->length;
+	}
+	list_iterator_destroy(msgs);
+
 	/*
-	 * Write message to socket.
+	 * Write messages to socket.
 	 */
-	buf = client->out_msg->data +
-		(client->out_msg->length - client->out_remaining);
 again:
-	if ((n = write(obj->fd, buf, client->out_remaining)) < 0) {
+	if ((n = writev(obj->fd, iov, iovcnt)) < 0) {
 		if (errno == EINTR) {
 			goto again;
 		} else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
@@ -475,17 +493,25 @@ again:
 			return SLURM_SUCCESS;
 		}
 	}
-	if (n < client->out_remaining) {
-		error("Only wrote %d of %d bytes to socket",
-		      n, client->out_remaining);
-	} else
-		debug5("Wrote %d bytes to socket", n);
-	client->out_remaining -= n;
-	if (client->out_remaining > 0)
-		return SLURM_SUCCESS;
+	debug5("Wrote %zd bytes from %d messages to socket", n, iovcnt);
 
-	_free_outgoing_msg(client->out_msg, client->job);
-	client->out_msg = NULL;
+	/*
+	 * Release every message written in full. Messages routed while doing
+	 * so are appended to the queue, behind the ones gathered above.
+	 */
+	for (i = 0; i < iovcnt; i++) {
+		if (n < client->out_remaining) {
+			client->out_remaining -= n;
+			break;
+		}
+		n -= client->out_remaining;
+		_free_outgoing_msg(client->out_msg, client->job);
+		client->out_msg = NULL;
+		if ((i + 1) < iovcnt) {
+			client->out_msg = list_dequeue(client->msg_queue);
+			client->out_remaining = client->out_msg->length;
+		}
+	}
 
 	return SLURM_SUCCESS;
 }
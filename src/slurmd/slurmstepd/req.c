@@ -1642,8 +1642,6 @@ static int
 _handle_stat_jobacct(int fd, stepd_step_rec_t *job, uid_t uid)
 {
 	jobacctinfo_t *jobacct = NULL;
-	jobacctinfo_t *temp_jobacct = NULL;
-	int i = 0;
 	int num_tasks = 0;
 	debug("_handle_stat_jobacct for job %u.%u",
 	      job->jobid, job->stepid);
@@ -1662,14 +1660,8 @@ _handle_stat_jobacct(int fd, stepd_step_rec_t *job, uid_t uid)
 	jobacct = jobacctinfo_create(NULL);
 	debug3("num tasks = %d", job->node_tasks);
 
-	for (i = 0; i < job->node_tasks; i++) {
-		temp_jobacct = jobacct_gather_stat_task(job->task[i]->pid);
-		if (temp_jobacct) {
-			jobacctinfo_aggregate(jobacct, temp_jobacct);
-			jobacctinfo_destroy(temp_jobacct);
-			num_tasks++;
-		}
-	}
+	/* Poll once for all tasks rather than once per task */
+	num_tasks = jobacct_gather_stat_all_task(jobacct);
 
 	jobacctinfo_setinfo(jobacct, JOBACCT_DATA_PIPE, &fd,
 			    SLURM_PROTOCOL_VERSION);
@@ -40,6 +40,8 @@
 
 #include "config.h"
 
+#include <errno.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <sys/mman.h>
@@ -78,6 +80,7 @@ static int _init_from_slurmd(int sock, char **argv, slurm_addr_t **_cli,
 			     slurm_addr_t **_self, slurm_msg_t **_msg);
 
 static void _dump_user_env(void);
+static int _wait_for_slurmd(int sock);
 static void _send_ok_to_slurmd(int sock);
 static void _send_fail_to_slurmd(int sock);
 static void _got_ack_from_slurmd(int);
@@ -124,6 +127,10 @@ main (int argc, char **argv)
 	if (slurm_auth_init(NULL) != SLURM_SUCCESS)
 		fatal( "failed to initialize authentication plugin" );
 
+	/* An idle slurmstepd from the slurmd's pool may be released unused */
+	if (_wait_for_slurmd(STDIN_FILENO) < 0)
+		exit(0);
+
 	/* Receive job parameters from the slurmd */
 	_init_from_slurmd(STDIN_FILENO, argv, &cli, &self, &msg);
 
@@ -446,6 +453,27 @@ rwfail:
 #endif
 }
 
+/*
+ * Wait for initialization data from the slurmd.
+ * RET -1 if the slurmd closed the pipe without sending anything, 0 otherwise
+ */
+static int _wait_for_slurmd(int sock)
+{
+	struct pollfd pfd;
+
+	pfd.fd = sock;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	while (poll(&pfd, 1, -1) < 0) {
+		if ((errno != EINTR) && (errno != EAGAIN))
+			return 0;	/* let the read report the error */
+	}
+	if (pfd.revents & POLLIN)
+		return 0;
+
+	return -1;
+}
+
 static void _set_job_log_prefix(uint32_t jobid, uint32_t stepid)
 {
 	char *buf;
@@ -561,13 +561,28 @@ proc_req(void *conn, persist_msg_t *msg,
 		      slurmdbd_conn->conn->fd,
 		      slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->conn->rem_port
-		 && !slurmdbd_conf->commit_delay) {
+		 && !slurmdbd_conf->commit_delay
+		 && !slurmdbd_conn->in_mult_msg) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
 		*/
-		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
+		if ((acct_storage_g_commit(slurmdbd_conn->db_conn, 1)
+		     != SLURM_SUCCESS) && (rc == SLURM_SUCCESS)) {
+			/*
+			 * The transaction (including any batched writes)
+			 * was rolled back, make the slurmctld send the
+			 * whole RPC again instead of dropping it.
+			 */
+			comment = "Failed to commit to the database";
+			error("CONN:%u %s", slurmdbd_conn->conn->fd, comment);
+			rc = SLURM_ERROR;
+			free_buf(*out_buffer);
+			*out_buffer = slurm_persist_make_rc_msg(
+				slurmdbd_conn->conn, rc, comment,
+				msg->msg_type);
+		}
 	}
 
 	END_TIMER;
@@ -3339,6 +3354,7 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 	ListIterator itr = NULL;
 	Buf req_buf = NULL, ret_buf = NULL;
 	int rc = SLURM_SUCCESS;
+	bool in_mult_msg = slurmdbd_conn->in_mult_msg;
 	/* DEF_TIMERS; */
 
 	if (!_validate_slurm_user(*uid)) {
@@ -3352,6 +3368,11 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 	}
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
+	/*
+	 * The parts are not committed one by one, the commit for this
+	 * DBD_SEND_MULT_MSG in proc_req() covers all of them.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
 	/* START_TIMER; */
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
@@ -3375,6 +3396,7 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 			break;
 	}
 	list_iterator_destroy(itr);
+	slurmdbd_conn->in_mult_msg = in_mult_msg;
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -47,6 +47,8 @@ typedef struct {
 	slurm_persist_conn_t *conn;
 	void *db_conn; /* database connection */
 	char *tres_str;
+	bool in_mult_msg; /* processing the parts of a DBD_SEND_MULT_MSG,
+			   * commit is done once for the whole message */
 } slurmdbd_conn_t;
 
 /* Process an incoming RPC
@@ -1750,11 +1750,12 @@ int _print_job_fed_siblings_active_raw(job_info_t * job, int width,
 		_print_str("ACTIVE_SIBLINGS_RAW", width, right_justify, true);
 	else {
 		int bit = 1;
-		char *ids = NULL;
+		char *ids = NULL, *pos = NULL;
 		uint64_t tmp_sibs = job->fed_siblings_active;
 		while (tmp_sibs) {
 			if (tmp_sibs & 1)
-				xstrfmtcat(ids, "%s%d", (ids) ? "," : "", bit);
+				xstrfmtcatat(ids, &pos, "%s%d",
+					     (ids) ? "," : "", bit);
 
 			tmp_sibs >>= 1;
 			bit++;
@@ -1763,6 +1764,7 @@ int _print_job_fed_siblings_active_raw(job_info_t * job, int width,
 			_print_str(ids, width, right_justify, true);
 		else
 			_print_str("NA", width, right_justify, true);
+		xfree(ids);
 	}
 
 	if (suffix)
@@ -1795,11 +1797,12 @@ int _print_job_fed_siblings_viable_raw(job_info_t * job, int width,
 		_print_str("VIALBLE_SIBLINGS_RAW", width, right_justify, true);
 	else {
 		int bit = 1;
-		char *ids = NULL;
+		char *ids = NULL, *pos = NULL;
 		uint64_t tmp_sibs = job->fed_siblings_viable;
 		while (tmp_sibs) {
 			if (tmp_sibs & 1)
-				xstrfmtcat(ids, "%s%d", (ids) ? "," : "", bit);
+				xstrfmtcatat(ids, &pos, "%s%d",
+					     (ids) ? "," : "", bit);
 
 			tmp_sibs >>= 1;
 			bit++;
@@ -1808,6 +1811,7 @@ int _print_job_fed_siblings_viable_raw(job_info_t * job, int width,
 			_print_str(ids, width, right_justify, true);
 		else
 			_print_str("NA", width, right_justify, true);
+		xfree(ids);
 	}
 
 	if (suffix)
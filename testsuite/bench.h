@@ -0,0 +1,35 @@
+/*
+ * Helpers for the microbenchmarks of the unit tests. They only run when a
+ * test is started by hand with "--bench", so "make check" prints no
+ * timings and is not slowed down by them.
+ */
+
+#ifndef _TESTSUITE_BENCH_H
+#define _TESTSUITE_BENCH_H
+
+#include <stdbool.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* Return true if the test was asked to run its benchmark */
+static inline bool bench_wanted(int argc, char *argv[])
+{
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--bench"))
+			return true;
+	}
+	return false;
+}
+
+/* Return the current time in seconds */
+static inline double bench_now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + (tv.tv_usec / 1000000.0);
+}
+
+#endif
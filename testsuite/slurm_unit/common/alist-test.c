@@ -0,0 +1,223 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/alist.h>
+#include <src/common/list.h>
+#include <src/common/xmalloc.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define BENCH_CNT 1000000
+#define OP_CNT    20000
+#define VAL_CNT   64
+
+static int vals[VAL_CNT];
+static int del_cnt = 0;
+
+static void _del(void *x)
+{
+	del_cnt++;
+}
+
+static int _cmp(void *x, void *y)
+{
+	int a = **(int **) x, b = **(int **) y;
+
+	return (a > b) - (a < b);
+}
+
+static int _find(void *x, void *key)
+{
+	return (*(int *) x == *(int *) key);
+}
+
+static int _stop_at(void *x, void *arg)
+{
+	return (*(int *) x == *(int *) arg) ? -1 : 0;
+}
+
+/* Return non-zero if the list and alist hold different items */
+static int _diff(List l, AList al)
+{
+	ListIterator li = list_iterator_create(l);
+	AListIterator ai = alist_iterator_create(al);
+	void *a, *b;
+	int rc = (list_count(l) != alist_count(al));
+
+	do {
+		a = list_next(li);
+		b = alist_next(ai);
+		if (a != b)
+			rc = 1;
+	} while (a && b);
+	list_iterator_destroy(li);
+	alist_iterator_destroy(ai);
+
+	return rc;
+}
+
+/* Append, sort and pop BENCH_CNT items with a List and an AList */
+static void _bench(void)
+{
+	List l;
+	AList al;
+	double start, list_time, alist_time;
+	int i;
+
+	l = list_create(NULL);
+	start = bench_now();
+	for (i = 0; i < BENCH_CNT; i++)
+		list_append(l, &vals[i % VAL_CNT]);
+	list_sort(l, _cmp);
+	while (list_pop(l))
+		;
+	list_time = bench_now() - start;
+	FREE_NULL_LIST(l);
+
+	al = alist_create(NULL);
+	start = bench_now();
+	for (i = 0; i < BENCH_CNT; i++)
+		alist_append(al, &vals[i % VAL_CNT]);
+	alist_sort(al, _cmp);
+	while (alist_pop(al))
+		;
+	alist_time = bench_now() - start;
+	FREE_NULL_ALIST(al);
+
+	printf("append+sort+pop %d items: list %.1f ns/item, "
+	       "alist %.1f ns/item\n", BENCH_CNT,
+	       list_time * 1e9 / BENCH_CNT, alist_time * 1e9 / BENCH_CNT);
+}
+
+int main(int argc, char *argv[])
+{
+	List l;
+	AList al;
+	ListIterator li, li2;
+	AListIterator ai, ai2;
+	int i, op, bad = 0;
+	void *x;
+
+	for (i = 0; i < VAL_CNT; i++)
+		vals[i] = i;
+
+	/*
+	 * Apply the same random operations to a List and an AList, with two
+	 * iterators live on each, and compare every result.
+	 */
+	l = list_create(_del);
+	al = alist_create(_del);
+	li = list_iterator_create(l);
+	li2 = list_iterator_create(l);
+	ai = alist_iterator_create(al);
+	ai2 = alist_iterator_create(al);
+	srand(1);
+	for (i = 0; i < OP_CNT; i++) {
+		x = &vals[rand() % VAL_CNT];
+		op = rand() % 16;
+		switch (op) {
+		case 0:
+		case 1:
+		case 2:
+			if (list_append(l, x) != alist_append(al, x))
+				bad++;
+			break;
+		case 3:
+			if (list_prepend(l, x) != alist_prepend(al, x))
+				bad++;
+			break;
+		case 4:
+			if (list_pop(l) != alist_pop(al))
+				bad++;
+			break;
+		case 5:
+			if (list_dequeue(l) != alist_dequeue(al))
+				bad++;
+			break;
+		case 6:
+		case 7:
+			if (list_next(li) != alist_next(ai))
+				bad++;
+			break;
+		case 8:
+			if (list_next(li2) != alist_next(ai2))
+				bad++;
+			break;
+		case 9:
+			if (list_remove(li) != alist_remove(ai))
+				bad++;
+			break;
+		case 10:
+			if (list_insert(li, x) != alist_insert(ai, x))
+				bad++;
+			break;
+		case 11:
+			if (list_delete_item(li2) != alist_delete_item(ai2))
+				bad++;
+			break;
+		case 12:
+			if (((rand() % 8) == 0) &&
+			    (list_delete_all(l, _find, x) !=
+			     alist_delete_all(al, _find, x)))
+				bad++;
+			break;
+		case 13:
+			if (list_find_first(l, _find, x) !=
+			    alist_find_first(al, _find, x))
+				bad++;
+			if (list_for_each(l, _stop_at, x) !=
+			    alist_for_each(al, _stop_at, x))
+				bad++;
+			break;
+		case 14:
+			if (list_peek(l) != alist_peek(al))
+				bad++;
+			if (list_peek_next(li) != alist_peek_next(ai))
+				bad++;
+			break;
+		case 15:
+			if ((rand() % 16) == 0) {
+				list_iterator_reset(li);
+				alist_iterator_reset(ai);
+			}
+			if ((rand() % 64) == 0) {
+				list_sort(l, _cmp);
+				alist_sort(al, _cmp);
+			}
+			break;
+		}
+		if (_diff(l, al))
+			bad++;
+	}
+	TEST(bad, "alist operations match list");
+
+	TEST(list_flush(l) != alist_flush(al), "alist_flush");
+	TEST(alist_next(ai) || !alist_is_empty(al), "alist empty after flush");
+
+	for (i = 0; i < 10; i++)
+		alist_append(al, &vals[i]);
+	alist_sort(al, _cmp);
+	TEST(*(int *) alist_peek(al) != 0, "alist_sort");
+	del_cnt = 0;
+	FREE_NULL_ALIST(al);
+	TEST(al || (del_cnt != 10), "alist_destroy deletes items");
+	FREE_NULL_LIST(l);
+
+	if (bench_wanted(argc, argv))
+		_bench();
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,280 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/hostlist.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define HOST_CNT  20000
+#define RAND_CNT  200
+#define UNIVERSE  300
+
+/* Host "i" of the random test universe, spread over two prefixes and a
+ * few names without a numeric suffix */
+static void _host_name(int i, char *buf, size_t len)
+{
+	if (i < 10)
+		snprintf(buf, len, "login%c", 'a' + i);
+	else if (i & 1)
+		snprintf(buf, len, "tux%04d", i);
+	else
+		snprintf(buf, len, "n%d", i);
+}
+
+static char *_random_hosts(char *member)
+{
+	char name[32], *hosts = NULL;
+	int i;
+
+	for (i = 0; i < UNIVERSE; i++) {
+		member[i] = ((rand() % 3) == 0);
+		if (!member[i])
+			continue;
+		_host_name(i, name, sizeof(name));
+		xstrfmtcat(hosts, "%s%s", hosts ? "," : "", name);
+	}
+	return hosts;
+}
+
+/* Compare a hostset with the expected members, return count of errors */
+static int _check_set(hostset_t set, char *member)
+{
+	char name[32], *host;
+	int i, pos, cnt = 0, bad = 0;
+
+	for (i = 0; i < UNIVERSE; i++) {
+		_host_name(i, name, sizeof(name));
+		pos = hostset_find(set, name);
+		if ((pos >= 0) != member[i])
+			bad++;
+		if (pos >= 0) {
+			host = hostset_nth(set, pos);
+			if (xstrcmp(host, name))
+				bad++;
+			free(host);
+		}
+		cnt += member[i];
+	}
+	if (hostset_count(set) != cnt)
+		bad++;
+	return bad;
+}
+
+/* hostlist_for_each_range() callback, describe each range in a string */
+static int _print_range(const char *prefix, unsigned long lo,
+			unsigned long hi, int width, void *arg)
+{
+	char **str = arg;
+
+	xstrfmtcat(*str, "%s%s/%lu/%lu/%d", *str ? " " : "", prefix, lo, hi,
+		   width);
+	return 0;
+}
+
+static int _stop_range(const char *prefix, unsigned long lo,
+		       unsigned long hi, int width, void *arg)
+{
+	(*(int *) arg)++;
+	return (width < 0) ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	char *str, *hosts_a, *hosts_b;
+	char a[UNIVERSE], b[UNIVERSE], want[UNIVERSE];
+	char buf[256], name[32];
+	hostlist_t hl;
+	hostset_t set, set2;
+	int *order, i, j, n, tmp, bad, bad_cnt, cnt_a;
+	double start, uniq_time, insert_time, find_time;
+
+	/* hostlist_uniq() */
+	hl = hostlist_create("n[5-9],n[1-3],n[2-6],login,n10,login,m1");
+	hostlist_uniq(hl);
+	str = hostlist_ranged_string_xmalloc(hl);
+	TEST(xstrcmp(str, "login,m1,n[1-10]"), "hostlist_uniq joins ranges");
+	TEST(hostlist_count(hl) != 12, "hostlist_uniq host count");
+	xfree(str);
+	hostlist_destroy(hl);
+
+	/* hostlist_for_each_range() */
+	hl = hostlist_create("n[1-3,7],login,tux[008-012]");
+	str = NULL;
+	TEST(hostlist_for_each_range(hl, _print_range, &str) ||
+	     xstrcmp(str, "n/1/3/1 n/7/7/1 login/0/0/-1 tux/8/12/3"),
+	     "hostlist_for_each_range");
+	xfree(str);
+	n = 0;
+	TEST((hostlist_for_each_range(hl, _stop_range, &n) != -1) || (n != 3),
+	     "hostlist_for_each_range stops on non-zero return");
+	hostlist_destroy(hl);
+
+	/* hostset lookups */
+	set = hostset_create("n[1-3,5,7-9],tux[001-004],login");
+	TEST(hostset_find(set, "n5") != 4, "hostset_find position");
+	TEST(hostset_find(set, "tux003") != 10, "hostset_find padded position");
+	TEST(hostset_find(set, "login") != 0, "hostset_find single host");
+	TEST(hostset_find(set, "n4") != -1, "hostset_find missing host");
+	TEST(hostset_find(set, "tux3") != -1, "hostset_find wrong padding");
+	TEST(hostset_find(set, "n0") != -1, "hostset_find before range");
+	TEST(hostset_find(set, "zz") != -1, "hostset_find after set");
+	TEST(!hostset_within(set, "n[2-3],tux002,login"), "hostset_within");
+	TEST(hostset_within(set, "n[3-4]"), "hostset_within missing host");
+	TEST(!hostset_intersects(set, "n4,tux004"), "hostset_intersects");
+	TEST(hostset_intersects(set, "n[10-20],foo"),
+	     "hostset_intersects missing hosts");
+	TEST(hostset_insert(set, "n[4-6]") != 2, "hostset_insert count");
+	TEST(hostset_delete(set, "n[2-5],foo") != 4, "hostset_delete count");
+	TEST(hostset_delete_host(set, "n8") != 1, "hostset_delete_host");
+	TEST(hostset_delete_host(set, "n8") != 0,
+	     "hostset_delete_host missing host");
+	hostset_ranged_string(set, sizeof(buf), buf);
+	TEST(xstrcmp(buf, "login,n[1,6-7,9],tux[001-004]"),
+	     "hostset contents after insert and delete");
+	TEST(hostset_find(set, "tux002") != 6,
+	     "hostset_find position after insert and delete");
+	hostset_destroy(set);
+
+	/* Leading digits of the suffix folded into a range prefix */
+	set = hostset_create("nid0000[2-7]");
+	TEST(hostset_find(set, "nid00004") != 2, "hostset_find digit prefix");
+	TEST(!hostset_within(set, "nid[00002-00003]"),
+	     "hostset_within digit prefix");
+	hostset_destroy(set);
+
+	/* set operations against a brute force reference */
+	srand(1);
+	bad_cnt = 0;
+	for (i = 0; i < RAND_CNT; i++) {
+		hosts_a = _random_hosts(a);
+		hosts_b = _random_hosts(b);
+		set = hostset_create(hosts_a);
+		set2 = hostset_create(hosts_b);
+		bad = _check_set(set, a);
+		cnt_a = hostset_count(set);
+
+		for (j = 0, n = 0; j < UNIVERSE; j++) {
+			want[j] = a[j] || b[j];
+			n += want[j] && !a[j];
+		}
+		if (hostset_union(set, set2) != n)
+			bad++;
+		bad += _check_set(set, want);
+		hostset_destroy(set);
+
+		set = hostset_create(hosts_a);
+		for (j = 0, n = 0; j < UNIVERSE; j++)
+			n += want[j] = a[j] && b[j];
+		if (hostset_intersect(set, set2) != n)
+			bad++;
+		bad += _check_set(set, want);
+		if (hostset_within(set2, hosts_a) != (n == cnt_a))
+			bad++;
+		hostset_destroy(set);
+
+		set = hostset_create(hosts_a);
+		for (j = 0, n = 0; j < UNIVERSE; j++) {
+			want[j] = a[j] && !b[j];
+			n += a[j] && b[j];
+		}
+		if (hostset_subtract(set, set2) != n)
+			bad++;
+		bad += _check_set(set, want);
+		hostset_destroy(set);
+
+		set = hostset_create(hosts_a);
+		if (hostset_insert(set, hosts_b) != hostset_count(set2) - n)
+			bad++;
+		if (hostset_intersects(set2, hosts_a) != (n > 0))
+			bad++;
+		hostset_destroy(set);
+
+		/* one host at a time */
+		set = hostset_create(hosts_a);
+		for (j = 0, n = 0; j < UNIVERSE; j++) {
+			want[j] = a[j] || b[j];
+			if (!b[j])
+				continue;
+			_host_name(j, name, sizeof(name));
+			n += hostset_insert(set, name);
+		}
+		if (n != hostset_count(set) - cnt_a)
+			bad++;
+		bad += _check_set(set, want);
+		hostset_destroy(set);
+		hostset_destroy(set2);
+		xfree(hosts_a);
+		xfree(hosts_b);
+		if (bad)
+			bad_cnt++;
+	}
+	TEST(bad_cnt, "hostset set operations match reference");
+
+	/* Hosts pushed in random order, timed with --bench */
+	order = xmalloc(sizeof(int) * HOST_CNT);
+	for (i = 0; i < HOST_CNT; i++)
+		order[i] = i;
+	for (i = HOST_CNT - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	start = bench_now();
+	hl = hostlist_create(NULL);
+	for (i = 0; i < HOST_CNT; i++) {
+		snprintf(name, sizeof(name), "node%05d", order[i]);
+		hostlist_push_host(hl, name);
+	}
+	hostlist_uniq(hl);
+	uniq_time = bench_now() - start;
+	str = hostlist_ranged_string_xmalloc(hl);
+	TEST(xstrcmp(str, "node[00000-19999]"),
+	     "hostlist_uniq of shuffled hosts");
+	xfree(str);
+	hostlist_destroy(hl);
+
+	/* every other host, so each one is in a range of its own */
+	start = bench_now();
+	set = hostset_create(NULL);
+	for (i = 0; i < HOST_CNT; i++) {
+		if (order[i] & 1)
+			continue;
+		snprintf(name, sizeof(name), "node%05d", order[i]);
+		hostset_insert(set, name);
+	}
+	insert_time = bench_now() - start;
+	start = bench_now();
+	for (i = 0, n = 0; i < HOST_CNT; i++) {
+		snprintf(name, sizeof(name), "node%05d", i);
+		n += (hostset_find(set, name) >= 0);
+	}
+	find_time = bench_now() - start;
+	TEST(n != HOST_CNT / 2, "hostset_find of scattered hosts");
+	hostset_destroy(set);
+	xfree(order);
+
+	if (bench_wanted(argc, argv)) {
+		printf("%d hosts: push+uniq %.1f ms, hostset_insert %.1f ms, "
+		       "hostset_find %.1f us/host\n", HOST_CNT,
+		       uniq_time * 1e3, insert_time * 1e3,
+		       find_time * 1e6 / HOST_CNT);
+	}
+
+	totals();
+	return failed;
+}
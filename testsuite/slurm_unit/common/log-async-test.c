@@ -0,0 +1,204 @@
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <src/common/log.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define DEBUG_CNT  40000	/* more than the writer's queue holds */
+#define THREAD_CNT 4
+#define THREAD_MSG 5000
+#define BENCH_CNT  50000
+
+static int pipe_fd[2];
+static char *output = NULL;
+static size_t output_len = 0;
+
+/* Collect everything written to the pipe until the logger closes it */
+static void *_reader(void *arg)
+{
+	size_t size = 0;
+	ssize_t rc;
+
+	while (1) {
+		if ((size - output_len) < 4096) {
+			size = (size * 2) + 4096;
+			xrealloc(output, size + 1);
+		}
+		rc = read(pipe_fd[0], output + output_len,
+			  size - output_len);
+		if (rc <= 0)
+			break;
+		output_len += rc;
+	}
+	output[output_len] = '\0';
+	return NULL;
+}
+
+static void *_writer(void *arg)
+{
+	int i, id = *(int *) arg;
+
+	for (i = 0; i < THREAD_MSG; i++)
+		info("thread %d msg %d", id, i);
+	return NULL;
+}
+
+static void *_bench_writer(void *arg)
+{
+	int i;
+
+	for (i = 0; i < (BENCH_CNT / THREAD_CNT); i++)
+		info("benchmark message %d with some padding text", i);
+	return NULL;
+}
+
+/* Log BENCH_CNT messages from THREAD_CNT threads, return seconds taken */
+static double _run_bench(void)
+{
+	pthread_t tid[THREAD_CNT];
+	double start;
+	int i;
+
+	start = bench_now();
+	for (i = 0; i < THREAD_CNT; i++)
+		pthread_create(&tid[i], NULL, _bench_writer, NULL);
+	for (i = 0; i < THREAD_CNT; i++)
+		pthread_join(tid[i], NULL);
+	log_flush();
+	return bench_now() - start;
+}
+
+/* Compare logging to a file with and without the async writer */
+static void _bench(log_options_t log_opts)
+{
+	char path[] = "/tmp/log-async-test.XXXXXX";
+	double sync_time, async_time;
+	int fd;
+
+	if ((fd = mkstemp(path)) < 0) {
+		perror("mkstemp");
+		return;
+	}
+	close(fd);
+	log_opts.logfile_level = LOG_LEVEL_INFO;
+	log_init("log-async-test", log_opts, 0, path);
+	sync_time = _run_bench();
+	log_set_async(true);
+	async_time = _run_bench();
+	log_fini();
+	unlink(path);
+
+	printf("%d messages from %d threads: sync %.1f ns/msg, "
+	       "async %.1f ns/msg\n", BENCH_CNT, THREAD_CNT,
+	       sync_time * 1e9 / BENCH_CNT, async_time * 1e9 / BENCH_CNT);
+}
+
+int main(int argc, char *argv[])
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	pthread_t reader_tid, tid[THREAD_CNT];
+	int ids[THREAD_CNT], last[THREAD_CNT];
+	char *line, *next, *msg;
+	uint32_t queue_len;
+	uint64_t drop_cnt, drop_seen;
+	int i, n, id, last_debug = -1, debug_seen = 0, info_seen = 0;
+	int stamped = 0, errors_seen = 0, bad_order = 0, drop_note = 0;
+	FILE *fp;
+
+	log_opts.stderr_level = LOG_LEVEL_QUIET;
+	log_opts.syslog_level = LOG_LEVEL_QUIET;
+	log_opts.logfile_level = LOG_LEVEL_DEBUG;
+	log_init("log-async-test", log_opts, 0, NULL);
+
+	if (pipe(pipe_fd) < 0) {
+		perror("pipe");
+		return 1;
+	}
+	fp = fdopen(pipe_fd[1], "a");
+	log_alter_with_fp(log_opts, 0, fp);
+	log_set_async(true);
+
+	/*
+	 * Nobody reads the pipe yet, so the writer blocks and the queue fills
+	 * up. Debug messages are then dropped rather than blocking us.
+	 */
+	for (i = 0; i < DEBUG_CNT; i++)
+		debug("debug msg %d", i);
+	log_get_async_stats(&queue_len, &drop_cnt);
+	TEST(!drop_cnt, "debug messages dropped when the queue is full");
+	TEST(!queue_len, "queue length reported");
+
+	pthread_create(&reader_tid, NULL, _reader, NULL);
+	for (i = 0; i < THREAD_CNT; i++) {
+		ids[i] = i;
+		last[i] = -1;
+		pthread_create(&tid[i], NULL, _writer, &ids[i]);
+	}
+	for (i = 0; i < 100; i++)
+		error("error msg %d", i);
+	for (i = 0; i < THREAD_CNT; i++)
+		pthread_join(tid[i], NULL);
+	log_get_async_stats(&queue_len, &drop_seen);
+
+	/* Stops the writer after it empties the queue, closes the pipe */
+	log_fini();
+	pthread_join(reader_tid, NULL);
+
+	for (line = output; line && *line; line = next) {
+		if ((next = strchr(line, '\n')))
+			*next++ = '\0';
+		if (line[0] == '[')
+			stamped++;
+		if (!(msg = strstr(line, "] ")))
+			continue;
+		msg += 2;
+		if (!strncmp(msg, "error: Log queue full, dropped", 30)) {
+			drop_note++;
+		} else if (!strncmp(msg, "error: error msg", 16)) {
+			errors_seen++;
+		} else if (sscanf(msg, "debug:  debug msg %d", &n) == 1) {
+			if (n <= last_debug)
+				bad_order++;
+			last_debug = n;
+			debug_seen++;
+		} else if (sscanf(msg, "thread %d msg %d", &id, &n) == 2) {
+			if ((id < 0) || (id >= THREAD_CNT) || (n <= last[id]))
+				bad_order++;
+			else
+				last[id] = n;
+			info_seen++;
+		}
+	}
+	TEST(stamped != (debug_seen + info_seen + errors_seen + drop_note),
+	     "every line timestamped");
+	TEST(bad_order, "messages written in the order logged");
+	TEST(errors_seen != 100, "error messages never dropped");
+	TEST((debug_seen + info_seen + drop_seen) !=
+	     (DEBUG_CNT + (THREAD_CNT * THREAD_MSG)),
+	     "every message written or counted as dropped");
+	TEST(!drop_note, "dropped messages reported in the log");
+	xfree(output);
+
+	if (bench_wanted(argc, argv))
+		_bench(log_opts);
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,111 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/mem_pool.h>
+#include <src/common/xmalloc.h>
+
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define OBJ_CNT 1000
+
+typedef struct {
+	uint64_t id;
+	char name[40];
+} test_rec_t;
+
+static mem_pool_stats_t *_find_stats(mem_pool_stats_t *stats, uint32_t cnt,
+				     char *name)
+{
+	uint32_t i;
+
+	for (i = 0; i < cnt; i++) {
+		if (!strcmp(stats[i].name, name))
+			return &stats[i];
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	mem_pool_t *pool;
+	mem_pool_stats_t *stats = NULL, *rec;
+	test_rec_t *recs[OBJ_CNT], *tmp;
+	uint32_t cnt;
+	int i, bad;
+
+	pool = mem_pool_create("test_rec", sizeof(test_rec_t), 16);
+	TEST(pool == NULL, "mem_pool_create");
+
+	for (i = 0, bad = 0; i < OBJ_CNT; i++) {
+		recs[i] = mem_pool_alloc(pool);
+		if (recs[i]->id || recs[i]->name[0])
+			bad++;
+		recs[i]->id = i;
+		snprintf(recs[i]->name, sizeof(recs[i]->name), "rec%d", i);
+	}
+	TEST(bad, "mem_pool_alloc returns zeroed objects");
+
+	for (i = 0, bad = 0; i < OBJ_CNT; i++) {
+		if ((recs[i]->id != i) || (atoi(recs[i]->name + 3) != i))
+			bad++;
+	}
+	TEST(bad, "mem_pool objects do not overlap");
+
+	cnt = mem_pool_get_stats(&stats);
+	rec = _find_stats(stats, cnt, "test_rec");
+	TEST(!rec, "mem_pool_get_stats finds pool");
+	if (rec) {
+		TEST(rec->obj_in_use != OBJ_CNT, "mem_pool in use count");
+		TEST(rec->slab_cnt != (OBJ_CNT + 15) / 16, "mem_pool slab count");
+	}
+	mem_pool_stats_free(stats, cnt);
+
+	/* Free every other object, then reuse the holes */
+	for (i = 0; i < OBJ_CNT; i += 2)
+		mem_pool_free(recs[i]);
+	TEST(recs[0] != NULL, "mem_pool_free clears pointer");
+	for (i = 0; i < OBJ_CNT; i += 2)
+		recs[i] = mem_pool_alloc(pool);
+
+	cnt = mem_pool_get_stats(&stats);
+	rec = _find_stats(stats, cnt, "test_rec");
+	if (rec)
+		TEST(rec->slab_cnt != (OBJ_CNT + 15) / 16,
+		     "mem_pool reuses freed objects");
+	mem_pool_stats_free(stats, cnt);
+
+	/* Freeing everything must give back all but one cached slab */
+	for (i = 0; i < OBJ_CNT; i++)
+		mem_pool_free(recs[i]);
+	cnt = mem_pool_get_stats(&stats);
+	rec = _find_stats(stats, cnt, "test_rec");
+	if (rec) {
+		TEST(rec->obj_in_use != 0, "mem_pool all objects freed");
+		TEST(rec->slab_cnt != 1, "mem_pool releases empty slabs");
+	}
+	mem_pool_stats_free(stats, cnt);
+
+	tmp = NULL;
+	mem_pool_free(tmp);
+	TEST(tmp != NULL, "mem_pool_free of NULL");
+
+	mem_pool_destroy(pool);
+	cnt = mem_pool_get_stats(&stats);
+	TEST(_find_stats(stats, cnt, "test_rec") != NULL,
+	     "mem_pool_destroy unregisters pool");
+	mem_pool_stats_free(stats, cnt);
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,357 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/pack.h>
+#include <src/common/pack_schema.h>
+#include <src/common/slurmdb_defs.h>
+#include <src/common/slurmdb_pack.h>
+#include <src/common/slurm_protocol_common.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define FUZZ_CNT	5000
+#define BENCH_CNT	100000
+
+typedef struct {
+	uint16_t a16;
+	uint32_t a32;
+	char *s1;
+	uint64_t a64;
+	time_t t;
+	char *s2;
+	uint32_t b32;
+} test_rec_t;
+
+static void _pack_b32(void *rec, uint16_t protocol_version, Buf buffer)
+{
+	pack32(((test_rec_t *) rec)->b32, buffer);
+}
+
+static int _unpack_b32(void *rec, uint16_t protocol_version, Buf buffer)
+{
+	return unpack32(&((test_rec_t *) rec)->b32, buffer);
+}
+
+static const pack_field_t test_schema[] = {
+	PACK_U16(test_rec_t, a16, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U32(test_rec_t, a32, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(test_rec_t, s1, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_U64(test_rec_t, a64, SLURM_PROTOCOL_VERSION),
+	PACK_TIME(test_rec_t, t, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_FUNC(_pack_b32, _unpack_b32, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_STR(test_rec_t, s2, SLURM_MIN_PROTOCOL_VERSION),
+	PACK_END
+};
+
+/* What slurmdb_pack_job_rec() did before it was table driven */
+static void _legacy_pack_job_rec(slurmdb_job_rec_t *job,
+				 uint16_t protocol_version, Buf buffer)
+{
+	slurmdb_stats_t *stats = &job->stats;
+
+	packstr(job->account, buffer);
+	packstr(job->admin_comment, buffer);
+	packstr(job->alloc_gres, buffer);
+	pack32(job->alloc_nodes, buffer);
+	pack32(job->array_job_id, buffer);
+	pack32(job->array_max_tasks, buffer);
+	pack32(job->array_task_id, buffer);
+	packstr(job->array_task_str, buffer);
+
+	pack32(job->associd, buffer);
+	packstr(job->blockid, buffer);
+	packstr(job->cluster, buffer);
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION)
+		packstr(job->constraints, buffer);
+	pack32((uint32_t)job->derived_ec, buffer);
+	packstr(job->derived_es, buffer);
+	pack32(job->elapsed, buffer);
+	pack_time(job->eligible, buffer);
+	pack_time(job->end, buffer);
+	pack32((uint32_t)job->exitcode, buffer);
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION)
+		pack32(job->flags, buffer);
+	pack32(job->gid, buffer);
+	pack32(job->jobid, buffer);
+	packstr(job->jobname, buffer);
+	pack32(job->lft, buffer);
+	packstr(job->mcs_label, buffer);
+	packstr(job->nodes, buffer);
+	pack32(job->pack_job_id, buffer);
+	pack32(job->pack_job_offset, buffer);
+	packstr(job->partition, buffer);
+	pack32(job->priority, buffer);
+	pack32(job->qosid, buffer);
+	pack32(job->req_cpus, buffer);
+	packstr(job->req_gres, buffer);
+	pack64(job->req_mem, buffer);
+	pack32(job->requid, buffer);
+	packstr(job->resv_name, buffer);
+	pack32(job->resvid, buffer);
+	pack32(job->show_full, buffer);
+	pack_time(job->start, buffer);
+	pack32(job->state, buffer);
+	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION)
+		pack32(job->state_reason_prev, buffer);
+
+	packdouble(stats->act_cpufreq, buffer);
+	pack64(stats->consumed_energy, buffer);
+	packstr(stats->tres_usage_in_ave, buffer);
+	packstr(stats->tres_usage_in_max, buffer);
+	packstr(stats->tres_usage_in_max_nodeid, buffer);
+	packstr(stats->tres_usage_in_max_taskid, buffer);
+	packstr(stats->tres_usage_in_min, buffer);
+	packstr(stats->tres_usage_in_min_nodeid, buffer);
+	packstr(stats->tres_usage_in_min_taskid, buffer);
+	packstr(stats->tres_usage_in_tot, buffer);
+	packstr(stats->tres_usage_out_ave, buffer);
+	packstr(stats->tres_usage_out_max, buffer);
+	packstr(stats->tres_usage_out_max_nodeid, buffer);
+	packstr(stats->tres_usage_out_max_taskid, buffer);
+	packstr(stats->tres_usage_out_min, buffer);
+	packstr(stats->tres_usage_out_min_nodeid, buffer);
+	packstr(stats->tres_usage_out_min_taskid, buffer);
+	packstr(stats->tres_usage_out_tot, buffer);
+	pack32(0, buffer);	/* no steps */
+
+	pack_time(job->submit, buffer);
+	pack32(job->suspended, buffer);
+	packstr(job->system_comment, buffer);
+	pack32(job->sys_cpu_sec, buffer);
+	pack32(job->sys_cpu_usec, buffer);
+	pack32(job->timelimit, buffer);
+	pack32(job->tot_cpu_sec, buffer);
+	pack32(job->tot_cpu_usec, buffer);
+	pack16(job->track_steps, buffer);
+
+	packstr(job->tres_alloc_str, buffer);
+	packstr(job->tres_req_str, buffer);
+
+	pack32(job->uid, buffer);
+	packstr(job->user, buffer);
+	pack32(job->user_cpu_sec, buffer);
+	pack32(job->user_cpu_usec, buffer);
+	packstr(job->wckey, buffer);
+	pack32(job->wckeyid, buffer);
+	packstr(job->work_dir, buffer);
+}
+
+static void _fill_job(slurmdb_job_rec_t *job)
+{
+	memset(job, 0, sizeof(*job));
+	job->account = xstrdup("physics");
+	job->alloc_nodes = 128;
+	job->array_job_id = 1000;
+	job->array_task_id = NO_VAL;
+	job->cluster = xstrdup("cluster");
+	job->constraints = xstrdup("intel&ib");
+	job->derived_ec = -1;
+	job->eligible = 1550000000;
+	job->end = 1550003600;
+	job->exitcode = -2;
+	job->flags = 3;
+	job->jobid = 123456;
+	job->jobname = xstrdup("a job name");
+	job->nodes = xstrdup("node[0001-0128]");
+	job->partition = xstrdup("batch");
+	job->req_mem = 0x8000000000000400;
+	job->start = 1550000010;
+	job->state = 3;
+	job->state_reason_prev = 17;
+	job->stats.act_cpufreq = 2400.5;
+	job->stats.tres_usage_in_max = xstrdup("1=100,2=2048");
+	job->submit = 1549999000;
+	job->track_steps = 1;
+	job->tres_alloc_str = xstrdup("1=4096,2=262144,4=128");
+	job->uid = 1001;
+	job->user = xstrdup("user");
+	job->work_dir = xstrdup("/home/user/run");
+}
+
+int main(int argc, char *argv[])
+{
+	test_rec_t rec, *out;
+	slurmdb_job_rec_t job, *job_out = NULL;
+	Buf buffer, legacy, fuzz;
+	uint32_t size, i, bad;
+	double start, legacy_time, schema_time;
+	char *data;
+
+	/* Generic codec: round trip and sizing */
+	memset(&rec, 0, sizeof(rec));
+	rec.a16 = 0xbeef;
+	rec.a32 = 0xdeadbeef;
+	rec.s1 = "first";
+	rec.a64 = 0x0102030405060708;
+	rec.t = 1550000000;
+	rec.b32 = 42;
+	buffer = init_buf(0);
+	pack_schema(test_schema, &rec, SLURM_PROTOCOL_VERSION, buffer);
+	size = pack_schema_size(test_schema, &rec, SLURM_PROTOCOL_VERSION);
+	TEST(get_buf_offset(buffer) != size + 4, "pack_schema_size");
+
+	legacy = init_buf(0);
+	pack16(rec.a16, legacy);
+	pack32(rec.a32, legacy);
+	packstr(rec.s1, legacy);
+	pack64(rec.a64, legacy);
+	pack_time(rec.t, legacy);
+	pack32(rec.b32, legacy);
+	packstr(rec.s2, legacy);
+	TEST((get_buf_offset(buffer) != get_buf_offset(legacy)) ||
+	     memcmp(get_buf_data(buffer), get_buf_data(legacy),
+		    get_buf_offset(legacy)),
+	     "pack_schema matches pack.h encoding");
+
+	out = xmalloc(sizeof(test_rec_t));
+	set_buf_offset(buffer, 0);
+	TEST(unpack_schema(test_schema, out, SLURM_PROTOCOL_VERSION, buffer),
+	     "unpack_schema");
+	TEST((out->a16 != rec.a16) || (out->a32 != rec.a32) ||
+	     xstrcmp(out->s1, rec.s1) || (out->a64 != rec.a64) ||
+	     (out->t != rec.t) || (out->b32 != rec.b32) || out->s2,
+	     "unpack_schema values");
+	xfree(out->s1);
+	xfree(out);
+
+	/* Older protocol versions skip newer fields */
+	set_buf_offset(buffer, 0);
+	pack_schema(test_schema, &rec, SLURM_MIN_PROTOCOL_VERSION, buffer);
+	TEST(get_buf_offset(buffer) != get_buf_offset(legacy) - 8,
+	     "pack_schema skips newer fields");
+	free_buf(buffer);
+	free_buf(legacy);
+
+	/* slurmdb_job_rec_t against the hand written encoding */
+	_fill_job(&job);
+	buffer = init_buf(0);
+	legacy = init_buf(0);
+	slurmdb_pack_job_rec(&job, SLURM_PROTOCOL_VERSION, buffer);
+	_legacy_pack_job_rec(&job, SLURM_PROTOCOL_VERSION, legacy);
+	TEST((get_buf_offset(buffer) != get_buf_offset(legacy)) ||
+	     memcmp(get_buf_data(buffer), get_buf_data(legacy),
+		    get_buf_offset(legacy)),
+	     "slurmdb_pack_job_rec wire compatible");
+
+	set_buf_offset(buffer, 0);
+	set_buf_offset(legacy, 0);
+	slurmdb_pack_job_rec(&job, SLURM_18_08_PROTOCOL_VERSION, buffer);
+	_legacy_pack_job_rec(&job, SLURM_18_08_PROTOCOL_VERSION, legacy);
+	TEST((get_buf_offset(buffer) != get_buf_offset(legacy)) ||
+	     memcmp(get_buf_data(buffer), get_buf_data(legacy),
+		    get_buf_offset(legacy)),
+	     "slurmdb_pack_job_rec 18.08 wire compatible");
+
+	set_buf_offset(buffer, 0);
+	slurmdb_pack_job_rec(&job, SLURM_PROTOCOL_VERSION, buffer);
+	size = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	TEST(slurmdb_unpack_job_rec((void **) &job_out, SLURM_PROTOCOL_VERSION,
+				    buffer),
+	     "slurmdb_unpack_job_rec");
+	if (job_out) {
+		TEST((job_out->jobid != job.jobid) ||
+		     (job_out->derived_ec != -1) ||
+		     (job_out->exitcode != -2) ||
+		     (job_out->req_mem != job.req_mem) ||
+		     (job_out->end != job.end) ||
+		     (job_out->track_steps != 1) ||
+		     xstrcmp(job_out->nodes, job.nodes) ||
+		     xstrcmp(job_out->work_dir, job.work_dir) ||
+		     xstrcmp(job_out->stats.tres_usage_in_max,
+			     job.stats.tres_usage_in_max) ||
+		     job_out->admin_comment ||
+		     (get_buf_offset(buffer) != size),
+		     "slurmdb_unpack_job_rec values");
+		slurmdb_destroy_job_rec(job_out);
+	}
+
+	/*
+	 * Fuzz the decoder: every truncation must fail cleanly and random
+	 * corruption must never crash or read past the buffer.
+	 */
+	data = xmalloc(size);
+	memcpy(data, get_buf_data(buffer), size);
+	for (i = 0, bad = 0; i < size; i++) {
+		fuzz = create_buf(xmalloc(i + 1), i);
+		memcpy(get_buf_data(fuzz), data, i);
+		job_out = NULL;
+		if (slurmdb_unpack_job_rec((void **) &job_out,
+					   SLURM_PROTOCOL_VERSION, fuzz) !=
+		    SLURM_ERROR)
+			bad++;
+		if (job_out)
+			slurmdb_destroy_job_rec(job_out);
+		free_buf(fuzz);
+	}
+	TEST(bad, "slurmdb_unpack_job_rec rejects truncated data");
+
+	srand(1);
+	for (i = 0; i < FUZZ_CNT; i++) {
+		int j, flips = 1 + rand() % 4;
+
+		fuzz = create_buf(xmalloc(size), size);
+		memcpy(get_buf_data(fuzz), data, size);
+		for (j = 0; j < flips; j++)
+			get_buf_data(fuzz)[rand() % size] = rand();
+		job_out = NULL;
+		if ((slurmdb_unpack_job_rec((void **) &job_out,
+					    SLURM_PROTOCOL_VERSION, fuzz) ==
+		     SLURM_SUCCESS) && job_out)
+			slurmdb_destroy_job_rec(job_out);
+		free_buf(fuzz);
+	}
+	pass("slurmdb_unpack_job_rec survives corrupted data");
+	xfree(data);
+
+	if (bench_wanted(argc, argv)) {
+		start = bench_now();
+		for (i = 0; i < BENCH_CNT; i++) {
+			set_buf_offset(legacy, 0);
+			_legacy_pack_job_rec(&job, SLURM_PROTOCOL_VERSION,
+					     legacy);
+		}
+		legacy_time = bench_now() - start;
+		start = bench_now();
+		for (i = 0; i < BENCH_CNT; i++) {
+			set_buf_offset(buffer, 0);
+			slurmdb_pack_job_rec(&job, SLURM_PROTOCOL_VERSION,
+					     buffer);
+		}
+		schema_time = bench_now() - start;
+		printf("pack %d job records: hand written %.1f ns/rec, "
+		       "schema %.1f ns/rec\n", BENCH_CNT,
+		       legacy_time * 1e9 / BENCH_CNT,
+		       schema_time * 1e9 / BENCH_CNT);
+	}
+
+	free_buf(buffer);
+	free_buf(legacy);
+	slurmdb_free_slurmdb_stats_members(&job.stats);
+	xfree(job.account);
+	xfree(job.cluster);
+	xfree(job.constraints);
+	xfree(job.jobname);
+	xfree(job.nodes);
+	xfree(job.partition);
+	xfree(job.tres_alloc_str);
+	xfree(job.user);
+	xfree(job.work_dir);
+
+	totals();
+	return failed;
+}
@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <slurm/slurm.h>
+
+#include <src/common/bitstring.h>
 #include <src/common/pack.h>
 #include <src/common/xmalloc.h>
 
@@ -17,6 +20,19 @@
 		pass( _msg );       \
 } while (0)
 
+/* Unpack a bitmap packed with pack_bit_str_runs(), NULL on error */
+static bitstr_t *_unpack_runs(Buf buffer)
+{
+	bitstr_t *bitmap = NULL;
+
+	set_buf_offset(buffer, 0);
+	unpack_bit_str_runs(&bitmap, buffer);
+	return bitmap;
+
+unpack_error:
+	return NULL;
+}
+
 int main (int argc, char *argv[])
 {
 	Buf buffer;
@@ -29,6 +45,9 @@ int main (int argc, char *argv[])
 	int data_size;
 	long double test_double = 1340664754944.2132312, test_double2;
 	uint64_t test64;
+	uint32_t i, bad, grow_cnt, last_size;
+	uint32_t bad_runs[2] = { 2, 20 };
+	bitstr_t *bitmap, *bitmap2;
 
 	buffer = init_buf (0);
         pack16(test16, buffer);
@@ -83,6 +102,51 @@ int main (int argc, char *argv[])
 	xfree(outstring);
 
 	free_buf(buffer);
+
+	/* Buffers must grow geometrically, not one BUF_SIZE at a time */
+	buffer = init_buf(1);
+	last_size = size_buf(buffer);
+	for (i = 0, grow_cnt = 0; i < 1000000; i++) {
+		pack32(i, buffer);
+		if (size_buf(buffer) != last_size) {
+			last_size = size_buf(buffer);
+			grow_cnt++;
+		}
+	}
+	TEST(grow_cnt > 32, "geometric buffer growth");
+	set_buf_offset(buffer, 0);
+	for (i = 0, bad = 0; i < 1000000; i++) {
+		if (unpack32(&out32, buffer) || (out32 != i))
+			bad++;
+	}
+	TEST(bad, "un/pack32 across buffer growth");
+	free_buf(buffer);
+
+	bitmap = bit_alloc(100000);
+	bit_nset(bitmap, 0, 999);
+	bit_set(bitmap, 5000);
+	bit_nset(bitmap, 99990, 99999);
+	buffer = init_buf(0);
+	pack_bit_str_runs(bitmap, buffer);
+	TEST(get_buf_offset(buffer) > 64, "pack_bit_str_runs size");
+	bitmap2 = _unpack_runs(buffer);
+	TEST(!bitmap2 || !bit_equal(bitmap, bitmap2), "un/pack_bit_str_runs");
+	FREE_NULL_BITMAP(bitmap2);
+	FREE_NULL_BITMAP(bitmap);
+	free_buf(buffer);
+
+	buffer = init_buf(0);
+	pack_bit_str_runs(bitmap, buffer);
+	TEST(_unpack_runs(buffer) != NULL,
+	     "un/pack_bit_str_runs of NULL bitmap");
+	free_buf(buffer);
+
+	buffer = init_buf(0);
+	pack32(10, buffer);
+	pack32_array(bad_runs, 2, buffer);
+	TEST(_unpack_runs(buffer) != NULL, "unpack_bit_str_runs out of range");
+	free_buf(buffer);
+
 	totals();
 	return failed;
 
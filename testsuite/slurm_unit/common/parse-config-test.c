@@ -0,0 +1,126 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/parse_config.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define BENCH_CNT 200000
+
+static s_p_options_t options[] = {
+	{"Name", S_P_STRING},
+	{"Addr", S_P_STRING},
+	{"Feature", S_P_STRING},
+	{"Weight", S_P_UINT32},
+	{"Node.Count", S_P_UINT32},
+	{NULL}
+};
+
+/* Parse a line, return the value of key or NULL */
+static char *_parse(const char *line, char *key, int *rc, char **leftover)
+{
+	s_p_hashtbl_t *tbl = s_p_hashtbl_create(options);
+	char *value = NULL;
+
+	*leftover = NULL;
+	*rc = s_p_parse_line(tbl, line, leftover);
+	s_p_get_string(&value, key, tbl);
+	s_p_hashtbl_destroy(tbl);
+	return value;
+}
+
+/* Parse BENCH_CNT lines of four key=value pairs */
+static void _bench(void)
+{
+	s_p_hashtbl_t *tbl;
+	char *leftover, *line;
+	double start, parse_time;
+	int i;
+
+	line = xstrdup("Name=n00001 Addr=10.0.0.1 Weight=10 "
+		       "Feature=\"knl,cache quad\"");
+	tbl = s_p_hashtbl_create(options);
+	start = bench_now();
+	for (i = 0; i < BENCH_CNT; i++)
+		s_p_parse_line(tbl, line, &leftover);
+	parse_time = bench_now() - start;
+	s_p_hashtbl_destroy(tbl);
+	xfree(line);
+
+	printf("%d lines of 4 pairs: %.1f ns/line\n", BENCH_CNT,
+	       parse_time * 1e9 / BENCH_CNT);
+}
+
+int main(int argc, char *argv[])
+{
+	s_p_hashtbl_t *tbl;
+	slurm_parser_operator_t op;
+	char *value, *leftover;
+	const char *str;
+	uint32_t num = 0;
+	int rc;
+
+	/* Values, white space and operators */
+	tbl = s_p_hashtbl_create(options);
+	str = "  Name=n1 Addr = \"10.0.0.1 and more\"\tWeight+=5 Node.Count=2";
+	rc = s_p_parse_line(tbl, str, &leftover);
+	TEST(rc != 1, "s_p_parse_line rc");
+	TEST(!s_p_get_string(&value, "Name", tbl) || xstrcmp(value, "n1"),
+	     "unquoted value");
+	xfree(value);
+	TEST(!s_p_get_string(&value, "Addr", tbl) ||
+	     xstrcmp(value, "10.0.0.1 and more"), "quoted value");
+	xfree(value);
+	TEST(!s_p_get_uint32(&num, "Weight", tbl) || (num != 5),
+	     "value after operator");
+	TEST(!s_p_get_operator(&op, "Weight", tbl) ||
+	     (op != S_P_OPERATOR_ADD), "operator");
+	TEST(!s_p_get_uint32(&num, "Node.Count", tbl) || (num != 2),
+	     "key with '.'");
+	TEST(leftover != str + strlen(str), "leftover at end of line");
+	s_p_hashtbl_destroy(tbl);
+
+	/* Quotes not followed by white space are part of the value */
+	value = _parse("Feature=\"a b\"c d", "Feature", &rc, &leftover);
+	TEST(xstrcmp(value, "\"a"), "unterminated quoted value");
+	xfree(value);
+	value = _parse("Feature=\"\"", "Feature", &rc, &leftover);
+	TEST(xstrcmp(value, ""), "empty quoted value");
+	xfree(value);
+	value = _parse("Feature=a\"b c\"", "Feature", &rc, &leftover);
+	TEST(xstrcmp(value, "a\"b"), "quote within value");
+	xfree(value);
+
+	/* Parsing stops at anything other than a key=value pair */
+	value = _parse("Name=n1 junk Addr=x", "Addr", &rc, &leftover);
+	TEST((rc != 1) || value || xstrcmp(leftover, " junk Addr=x"),
+	     "stop at text without '='");
+	xfree(value);
+	value = _parse("Name= ", "Name", &rc, &leftover);
+	TEST(value, "missing value");
+	value = _parse("Name+ =n1", "Name", &rc, &leftover);
+	TEST(value, "white space after operator");
+	value = _parse("Name=n1 Bogus=1", "Name", &rc, &leftover);
+	TEST((rc != 0) || xstrcmp(value, "n1"), "unrecognized key");
+	xfree(value);
+
+	if (bench_wanted(argc, argv))
+		_bench();
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,147 @@
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <src/common/pack.h>
+#include <src/common/slurm_persist_conn.h>
+#include <src/common/slurm_protocol_common.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define MSG_CNT  20000	/* more than the socket buffers hold */
+#define MSG_SIZE 1024
+
+static pthread_mutex_t accept_lock = PTHREAD_MUTEX_INITIALIZER;
+static int accept_cnt = 0;
+static int listen_fd = -1;
+
+static int _read_all(int fd, void *buf, size_t len)
+{
+	ssize_t rc;
+
+	while (len) {
+		if ((rc = read(fd, buf, len)) <= 0)
+			return -1;
+		buf = (char *) buf + rc;
+		len -= rc;
+	}
+	return 0;
+}
+
+/* Read one message from each connection, then drop it */
+static void *_server(void *arg)
+{
+	uint32_t nw_size;
+	char *msg;
+	int fd;
+
+	while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+		pthread_mutex_lock(&accept_lock);
+		accept_cnt++;
+		pthread_mutex_unlock(&accept_lock);
+		if (!_read_all(fd, &nw_size, sizeof(nw_size))) {
+			msg = xmalloc(ntohl(nw_size));
+			(void) _read_all(fd, msg, ntohl(nw_size));
+			xfree(msg);
+		}
+		close(fd);
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	slurm_persist_conn_t conn;
+	struct sockaddr_in addr;
+	socklen_t addr_len = sizeof(addr);
+	pthread_t server_tid;
+	time_t shutdown_time = 0;
+	Buf *buffers;
+	int i, rc, sent, cnt;
+
+	signal(SIGPIPE, SIG_IGN);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if ((listen_fd < 0) ||
+	    bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) ||
+	    listen(listen_fd, 8) ||
+	    getsockname(listen_fd, (struct sockaddr *) &addr, &addr_len)) {
+		perror("listen");
+		return 1;
+	}
+	pthread_create(&server_tid, NULL, _server, NULL);
+
+	memset(&conn, 0, sizeof(conn));
+	conn.cluster_name = xstrdup("test");
+	conn.flags = PERSIST_FLAG_DBD | PERSIST_FLAG_RECONNECT |
+		     PERSIST_FLAG_SUPPRESS_ERR;
+	conn.persist_type = PERSIST_TYPE_DBD;
+	conn.rem_host = xstrdup("127.0.0.1");
+	conn.rem_port = ntohs(addr.sin_port);
+	conn.shutdown = &shutdown_time;
+	conn.timeout = 5000;
+	conn.version = SLURM_PROTOCOL_VERSION;
+	conn.fd = -1;
+	if (slurm_persist_conn_open_without_init(&conn) != SLURM_SUCCESS) {
+		fail("open connection");
+		return 1;
+	}
+
+	buffers = xmalloc(sizeof(Buf) * MSG_CNT);
+	for (i = 0; i < MSG_CNT; i++) {
+		buffers[i] = init_buf(MSG_SIZE);
+		memset(get_buf_data(buffers[i]), 'x', MSG_SIZE);
+		set_buf_offset(buffers[i], MSG_SIZE);
+	}
+
+	/*
+	 * The peer drops the connection after the first message, while
+	 * later ones still wait for space in the socket. They must fail
+	 * rather than go to a new connection, which would leave the caller
+	 * taking its replies for the messages written to the old one.
+	 */
+	sent = slurm_persist_send_msgs(&conn, buffers, MSG_CNT, &rc);
+	usleep(200000);
+	pthread_mutex_lock(&accept_lock);
+	cnt = accept_cnt;
+	pthread_mutex_unlock(&accept_lock);
+	TEST((sent < 1) || (sent >= MSG_CNT) || (rc == SLURM_SUCCESS),
+	     "slurm_persist_send_msgs stops at a lost connection");
+	TEST(cnt != 1, "no reconnect after the first message");
+	TEST(!(conn.flags & PERSIST_FLAG_RECONNECT),
+	     "reconnect flag restored");
+
+	for (i = 0; i < MSG_CNT; i++)
+		free_buf(buffers[i]);
+	xfree(buffers);
+	slurm_persist_conn_close(&conn);
+	xfree(conn.cluster_name);
+	xfree(conn.rem_host);
+	shutdown(listen_fd, SHUT_RDWR);
+	close(listen_fd);
+	pthread_join(server_tid, NULL);
+
+	totals();
+	return failed;
+}
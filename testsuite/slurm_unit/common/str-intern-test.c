@@ -0,0 +1,70 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/str_intern.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+int main(int argc, char *argv[])
+{
+	char buf[32], *a, *b, *c, *d, *tmp;
+	uint32_t strings;
+	uint64_t refs, bytes;
+
+	TEST(str_intern(NULL) != NULL, "str_intern of NULL");
+
+	snprintf(buf, sizeof(buf), "account1");
+	a = str_intern(buf);
+	buf[0] = 'A';
+	TEST(xstrcmp(a, "account1"), "str_intern copies string");
+
+	b = str_intern("account1");
+	TEST(!str_intern_eq(a, b), "str_intern returns shared copy");
+
+	c = str_intern("account2");
+	TEST(str_intern_eq(a, c), "str_intern distinct strings");
+
+	tmp = xstrdup("account2");
+	d = str_intern_xfer(tmp);
+	TEST(tmp != NULL, "str_intern_xfer clears pointer");
+	TEST(!str_intern_eq(c, d), "str_intern_xfer returns shared copy");
+
+	str_intern_stats(&strings, &refs, &bytes);
+	TEST(strings != 2, "str_intern_stats string count");
+	TEST(refs != 4, "str_intern_stats reference count");
+	TEST(bytes != 18, "str_intern_stats byte count");
+
+	str_intern_free(a);
+	TEST(a != NULL, "str_intern_free clears pointer");
+	TEST(xstrcmp(b, "account1"), "str_intern_free keeps other references");
+
+	a = str_intern_ref(b);
+	TEST(a != b, "str_intern_ref returns same string");
+
+	str_intern_free(a);
+	str_intern_free(b);
+	str_intern_free(c);
+	str_intern_free(d);
+	str_intern_stats(&strings, &refs, &bytes);
+	TEST(strings || refs || bytes, "str_intern_free releases last reference");
+
+	a = NULL;
+	str_intern_free(a);
+	TEST(str_intern_ref(a) != NULL, "str_intern_ref of NULL");
+
+	totals();
+	return failed;
+}
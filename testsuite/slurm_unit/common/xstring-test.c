@@ -0,0 +1,126 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include <testsuite/bench.h>
+#include <testsuite/dejagnu.h>
+
+/* Test for failure:
+*/
+#define TEST(_tst, _msg) do {			\
+	if (_tst)				\
+		fail( _msg );			\
+	else					\
+		pass( _msg );			\
+} while (0)
+
+#define BENCH_CNT 50000
+#define LONG_LEN  5000	/* more than is formatted on the stack */
+
+/* Append BENCH_CNT values with xstrfmtcat() and with xstrfmtcatat() */
+static void _bench(void)
+{
+	char *str = NULL, *str2 = NULL, *pos = NULL;
+	double start, cat_time, catat_time;
+	int i;
+
+	start = bench_now();
+	for (i = 0; i < BENCH_CNT; i++)
+		xstrfmtcat(str, "%s%d", str ? "," : "", i);
+	cat_time = bench_now() - start;
+
+	start = bench_now();
+	for (i = 0; i < BENCH_CNT; i++)
+		xstrfmtcatat(str2, &pos, "%s%d", str2 ? "," : "", i);
+	catat_time = bench_now() - start;
+	TEST(xstrcmp(str, str2), "xstrfmtcatat of many values");
+	xfree(str);
+	xfree(str2);
+
+	printf("%d appends: xstrfmtcat %.1f ns/append, "
+	       "xstrfmtcatat %.1f ns/append\n", BENCH_CNT,
+	       cat_time * 1e9 / BENCH_CNT, catat_time * 1e9 / BENCH_CNT);
+}
+
+int main(int argc, char *argv[])
+{
+	char *str = NULL, *str2 = NULL, *pos = NULL, *long_str;
+	int i, n, bad = 0;
+
+	/* xstrcat() and xstrfmtcat() */
+	xstrcat(str, "a");
+	xstrcat(str, NULL);
+	TEST(xstrcmp(str, "a(null)"), "xstrcat");
+	n = xstrfmtcat(str, "-%d-%s", 42, "b");
+	TEST((n != 5) || xstrcmp(str, "a(null)-42-b"), "xstrfmtcat");
+	xfree(str);
+	xstrfmtcat(str, "%s", "");
+	TEST(!str || str[0], "xstrfmtcat of empty string allocates");
+	xfree(str);
+
+	/* Arguments pointing into the string being appended to */
+	str = xstrdup("abc");
+	xstrfmtcat(str, "%s%s", str, str);
+	TEST(xstrcmp(str, "abcabcabc"), "xstrfmtcat of itself");
+	xfree(str);
+
+	/* Results longer than the stack buffer */
+	long_str = xmalloc(LONG_LEN + 1);
+	memset(long_str, 'x', LONG_LEN);
+	str = xstrdup("<");
+	n = xstrfmtcat(str, "%s>", long_str);
+	TEST((n != LONG_LEN + 1) || (strlen(str) != LONG_LEN + 2) ||
+	     (str[LONG_LEN + 1] != '>'), "xstrfmtcat of long string");
+	n = xstrfmtcat(str, "%s%s", str, str);
+	TEST((n != 2 * (LONG_LEN + 2)) || (strlen(str) != 3 * (LONG_LEN + 2)) ||
+	     (str[2 * LONG_LEN + 3] != '>'), "xstrfmtcat of itself, long");
+	xfree(str);
+	n = xstrfmtcat(str, "%s", long_str);
+	TEST((n != LONG_LEN) || xstrcmp(str, long_str),
+	     "xstrfmtcat of long string to empty string");
+	xfree(str);
+
+	/* The "at" variants match building without an end pointer */
+	for (i = 0; i < 1000; i++) {
+		if (i % 3) {
+			xstrfmtcat(str, "%d,", i);
+			xstrfmtcatat(str2, &pos, "%d,", i);
+		} else {
+			xstrcat(str, (i % 100) ? "ab" : long_str);
+			xstrcatat(str2, &pos, (i % 100) ? "ab" : long_str);
+		}
+		if (xstrcmp(str, str2) || (pos != str2 + strlen(str2)))
+			bad++;
+	}
+	TEST(bad, "xstrcatat and xstrfmtcatat");
+	xfree(str);
+	xfree(str2);
+
+	/* An unknown end pointer is found from the string */
+	str = xstrdup("abc");
+	pos = NULL;
+	xstrcatat(str, &pos, "def");
+	TEST(xstrcmp(str, "abcdef") || (pos != str + 6),
+	     "xstrcatat without end pointer");
+	xstrfmtcatat(str, &pos, "%s", "g");
+	TEST(xstrcmp(str, "abcdefg") || (pos != str + 7),
+	     "xstrfmtcatat after xstrcatat");
+
+	/* An end pointer left behind by another function is not used */
+	xstrcat(str, long_str);
+	xstrcatat(str, &pos, "h");
+	TEST((strlen(str) != LONG_LEN + 8) || (pos != str + LONG_LEN + 8),
+	     "xstrcatat after str moved");
+	xfree(str);
+	xfree(long_str);
+
+	if (bench_wanted(argc, argv))
+		_bench();
+
+	totals();
+	return failed;
+}